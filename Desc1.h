@@ -1,64 +1,62 @@
-// E:\BT\BLE\TI\TI_BLE_HID\Desc1.h
+// C export of Desc1.hid by tools/hid_desc_gen -x, do not edit;
+// change Desc1.hid and run make -C tools hid-desc-export.
 
 
-char ReportDescriptor[118] = {
-    0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
-    0x09, 0x05,                    // USAGE (Game Pad)
-    0xa1, 0x01,                    // COLLECTION (Application)
-    0x85, 0x03,                    //   REPORT_ID (3)
-    0x75, 0x01,                    //   REPORT_SIZE (1)
-    0x95, 0x08,                    //   REPORT_COUNT (8)
-    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-    0x25, 0x08,                    //   LOGICAL_MAXIMUM (8)
-    0x81, 0x01,                    //   INPUT (Cnst,Ary,Abs)
-    0x05, 0x01,                    //   USAGE_PAGE (Generic Desktop)
-    0x75, 0x08,                    //   REPORT_SIZE (8)
-    0x95, 0x01,                    //   REPORT_COUNT (1)
-    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-    0x25, 0x07,                    //   LOGICAL_MAXIMUM (7)
-    0x46, 0x3b, 0x01,              //   PHYSICAL_MAXIMUM (315)
-    0x65, 0x14,                    //   UNIT (Eng Rot:Angular Pos)
-    0x09, 0x39,                    //   USAGE (Hat switch)
-    0x81, 0x42,                    //   INPUT (Data,Var,Abs,Null)
-    0x65, 0x00,                    //   UNIT (None)
-    0x05, 0x09,                    //   USAGE_PAGE (Button)
-    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-    0x25, 0x01,                    //   LOGICAL_MAXIMUM (1)
-    0x19, 0x01,                    //   USAGE_MINIMUM (Button 1)
-    0x29, 0x0f,                    //   USAGE_MAXIMUM (Button 15)
-    0x75, 0x01,                    //   REPORT_SIZE (1)
-    0x95, 0x0f,                    //   REPORT_COUNT (15)
-    0x81, 0x02,                    //   INPUT (Data,Var,Abs)
-    0x75, 0x01,                    //   REPORT_SIZE (1)
-    0x95, 0x01,                    //   REPORT_COUNT (1)
-    0x81, 0x01,                    //   INPUT (Cnst,Ary,Abs)
-    0x05, 0x01,                    //   USAGE_PAGE (Generic Desktop)
-    0x75, 0x08,                    //   REPORT_SIZE (8)
-    0x95, 0x02,                    //   REPORT_COUNT (2)
-    0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
-    0x26, 0xff, 0x00,              //   LOGICAL_MAXIMUM (255)
-    0x35, 0x00,                    //   PHYSICAL_MINIMUM (0)
-    0x46, 0xff, 0x00,              //   PHYSICAL_MAXIMUM (255)
-    0xa1, 0x00,                    //   COLLECTION (Physical)
-    0x09, 0x30,                    //     USAGE (X)
-    0x09, 0x31,                    //     USAGE (Y)
-    0x81, 0x02,                    //     INPUT (Data,Var,Abs)
-    0xc0,                          //     END_COLLECTION
-    0xa1, 0x00,                    //   COLLECTION (Physical)
-    0x09, 0x32,                    //   USAGE (Z)
-    0x09, 0x35,                    //   USAGE (Rz)
-    0x81, 0x02,                    //   INPUT (Data,Var,Abs)
-    0xc0,                          // END_COLLECTION
-    0x05, 0x02,                    // USAGE_PAGE (Simulation Controls)
-    0x09, 0xc5,                    // USAGE (Brake)
-    0x09, 0xc4,                    // USAGE (Accelerator)
-    0x75, 0x08,                    // REPORT_SIZE (8)
-    0x95, 0x02,                    // REPORT_COUNT (2)
-    0x15, 0x00,                    // LOGICAL_MINIMUM (0)
-    0x26, 0xff, 0x00,              // LOGICAL_MAXIMUM (255)
-    0x35, 0x00,                    // PHYSICAL_MINIMUM (0)
-    0x46, 0xff, 0x00,              // PHYSICAL_MAXIMUM (255)
-    0x81, 0x02,                    // INPUT (Data,Var,Abs)
-    0xc0                           // END_COLLECTION
+char ReportDescriptor[112] = {
+    0x05, 0x01,                    // Usage Page (Generic Desktop)
+    0x09, 0x05,                    // Usage (Game Pad)
+    0xA1, 0x01,                    // Collection (Application)
+    0x85, 0x03,                    //   Report ID (3)
+    0x75, 0x01,                    //   Report Size (1)
+    0x95, 0x08,                    //   Report Count (8)
+    0x81, 0x01,                    //   Input: (Constant)
+    0x05, 0x01,                    //   Usage Page (Generic Desktop)
+    0x75, 0x08,                    //   Report Size (8)
+    0x95, 0x01,                    //   Report Count (1)
+    0x15, 0x00,                    //   Logical Min (0)
+    0x25, 0x07,                    //   Logical Max (7)
+    0x46, 0x3B, 0x01,              //   Physical Max (315)
+    0x65, 0x14,                    //   Unit (Eng Rot: Degrees)
+    0x09, 0x39,                    //   Usage (Hat Switch)
+    0x81, 0x42,                    //   Input: (Data, Variable, Absolute, Null)
+    0x65, 0x00,                    //   Unit (None)
+    0x05, 0x09,                    //   Usage Page (Button)
+    0x25, 0x01,                    //   Logical Max (1)
+    0x19, 0x01,                    //   Usage Min (0x01)
+    0x29, 0x0F,                    //   Usage Max (0x0F)
+    0x75, 0x01,                    //   Report Size (1)
+    0x95, 0x0F,                    //   Report Count (15)
+    0x81, 0x02,                    //   Input: (Data, Variable, Absolute)
+    0x75, 0x01,                    //   Report Size (1)
+    0x95, 0x01,                    //   Report Count (1)
+    0x81, 0x01,                    //   Input: (Constant)
+    0x05, 0x01,                    //   Usage Page (Generic Desktop)
+    0x75, 0x08,                    //   Report Size (8)
+    0x95, 0x02,                    //   Report Count (2)
+    0x15, 0x00,                    //   Logical Min (0)
+    0x26, 0xFF, 0x00,              //   Logical Max (255)
+    0x35, 0x00,                    //   Physical Min (0)
+    0x46, 0xFF, 0x00,              //   Physical Max (255)
+    0xA1, 0x00,                    //   Collection (Physical)
+    0x09, 0x30,                    //     Usage (X)
+    0x09, 0x31,                    //     Usage (Y)
+    0x81, 0x02,                    //     Input: (Data, Variable, Absolute)
+    0xC0,                          //   End Collection
+    0xA1, 0x00,                    //   Collection (Physical)
+    0x09, 0x32,                    //     Usage (Z)
+    0x09, 0x35,                    //     Usage (Rz)
+    0x81, 0x02,                    //     Input: (Data, Variable, Absolute)
+    0xC0,                          //   End Collection
+    0x05, 0x02,                    //   Usage Page (Simulation Controls)
+    0x09, 0xC5,                    //   Usage (Brake)
+    0x09, 0xC4,                    //   Usage (Accelerator)
+    0x75, 0x08,                    //   Report Size (8)
+    0x95, 0x02,                    //   Report Count (2)
+    0x15, 0x00,                    //   Logical Min (0)
+    0x26, 0xFF, 0x00,              //   Logical Max (255)
+    0x35, 0x00,                    //   Physical Min (0)
+    0x46, 0xFF, 0x00,              //   Physical Max (255)
+    0x81, 0x02,                    //   Input: (Data, Variable, Absolute)
+    0xC0                           // End Collection
 };
 
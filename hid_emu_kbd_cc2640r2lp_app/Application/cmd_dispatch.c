@@ -0,0 +1,624 @@
+/******************************************************************************
+
+ @file       cmd_dispatch.c
+
+ @brief This file contains the UART command dispatcher. Received bytes are
+        split into AT lines and binary frames (uart_frame.c). AT verbs are
+        looked up in a perfect hash table keyed on the two verb characters,
+        and their arguments are parsed against a schema string before the
+        handler is called. Frame types index a dense
+        handler table. Per-line cost does not depend on how many commands
+        are registered.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "uart_frame.h"
+#include "cmd_dispatch.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#if ((CMD_DISPATCH_TBL_SIZE & (CMD_DISPATCH_TBL_SIZE - 1)) != 0) || \
+    (CMD_DISPATCH_TBL_SIZE < 2) || (CMD_DISPATCH_TBL_SIZE > 256)
+#error "CMD_DISPATCH_TBL_SIZE must be a power of two, 2..256"
+#endif
+
+#define CMD_DISPATCH_TBL_MASK         (CMD_DISPATCH_TBL_SIZE - 1)
+
+// Verbs a table can hold, the most a perfect seed is searched for
+#define CMD_DISPATCH_MAX_VERBS        (CMD_DISPATCH_TBL_SIZE / 2)
+
+// "AT#" and the two verb characters
+#define CMD_PREFIX_LEN                3
+#define CMD_VERB_LEN                  2
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define CMD_IS_DIGIT(c)               (((c) >= '0') && ((c) <= '9'))
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Registered verbs, each in the slot its hash names
+static const cmdVerb_t *verbTbl[CMD_DISPATCH_TBL_SIZE];
+static uint8_t numVerbs = 0;
+
+// Odd multiplier of the verb hash, picked at registration
+static uint16_t verbSeed = 1;
+
+// Registered frame handlers, indexed by frame type
+static cmdFrameHandler_t frameTbl[CMD_DISPATCH_FRAME_TYPES];
+
+// Line being received, one extra byte for the terminating NUL
+static uint8_t cmdBuf[CMD_DISPATCH_LINE_LEN + 1];
+static uint8_t cmdLen = 0;
+
+// Binary frames share the stream with AT lines; a frame may only start
+// where a text line could start.
+static uartFrameDec_t frameDec;
+static uint8_t frameStatus = UART_FRAME_STATUS_OK;
+
+// Mirror of UARTFrame_isActive(&frameDec), so text bytes do not call into
+// the decoder
+static uint8_t frameActive = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      cmdDispatch_hash
+ *
+ * @brief   Hash a two character verb to a table slot.
+ *
+ * @param   c0, c1 - verb characters.
+ *
+ * @return  slot index
+ */
+static uint8_t cmdDispatch_hash(uint8_t c0, uint8_t c1)
+{
+  uint16_t key = (uint16_t)((c0 << 8) | c1);
+
+  return (uint8_t)(((uint16_t)(key * verbSeed) >> 8) & CMD_DISPATCH_TBL_MASK);
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_findVerb
+ *
+ * @brief   Look up a verb.
+ *
+ * @param   c0, c1 - verb characters.
+ *
+ * @return  table entry or NULL
+ */
+static const cmdVerb_t *cmdDispatch_findVerb(uint8_t c0, uint8_t c1)
+{
+  const cmdVerb_t *pVerb = verbTbl[cmdDispatch_hash(c0, c1)];
+
+  if ((pVerb != NULL) && (pVerb->verb[0] == c0) && (pVerb->verb[1] == c1))
+  {
+    return pVerb;
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_place
+ *
+ * @brief   Lay out verbTbl for a hash seed.
+ *
+ * @param   ppVerbs - verbs to place.
+ * @param   num - number of verbs.
+ * @param   seed - odd hash multiplier.
+ *
+ * @return  TRUE if every verb got a slot of its own, else verbTbl is
+ *          left partly filled
+ */
+static uint8_t cmdDispatch_place(const cmdVerb_t * const *ppVerbs,
+                                 uint8_t num, uint16_t seed)
+{
+  uint8_t i;
+
+  memset(verbTbl, 0, sizeof(verbTbl));
+  verbSeed = seed;
+
+  for (i = 0; i < num; i++)
+  {
+    uint8_t idx = cmdDispatch_hash(ppVerbs[i]->verb[0], ppVerbs[i]->verb[1]);
+
+    if (verbTbl[idx] != NULL)
+    {
+      return 0;
+    }
+
+    verbTbl[idx] = ppVerbs[i];
+  }
+
+  return 1;
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_hexNibble
+ *
+ * @brief   Convert a hex character.
+ *
+ * @param   c - character.
+ *
+ * @return  0..15, or 0xFF if not a hex digit
+ */
+static uint8_t cmdDispatch_hexNibble(uint8_t c)
+{
+  if (CMD_IS_DIGIT(c))
+  {
+    return c - '0';
+  }
+
+  c |= 0x20;
+  if ((c >= 'a') && (c <= 'f'))
+  {
+    return c - 'a' + 10;
+  }
+
+  return 0xFF;
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_parseArgs
+ *
+ * @brief   Parse the arguments of a line against a schema.
+ *
+ * @param   pSchema - argument schema.
+ * @param   pArgs - output.
+ *
+ * @return  TRUE if the line matches the schema
+ */
+static uint8_t cmdDispatch_parseArgs(const char *pSchema, cmdArgs_t *pArgs)
+{
+  const uint8_t *p = &cmdBuf[CMD_PREFIX_LEN + CMD_VERB_LEN];
+  const uint8_t *pEnd = &cmdBuf[cmdLen];
+  uint8_t optional = 0;
+
+  for (; *pSchema; pSchema++)
+  {
+    uint32_t v;
+
+    if (*pSchema == CMD_ARG_OPTIONAL)
+    {
+      optional = 1;
+      continue;
+    }
+
+    if ((p == pEnd) && (*pSchema != CMD_ARG_REST))
+    {
+      return optional;
+    }
+
+    if (pArgs->num == CMD_DISPATCH_MAX_ARGS)
+    {
+      return 0;
+    }
+
+    switch (*pSchema)
+    {
+      case CMD_ARG_MODIFIER:
+        // '0' none, '1'..'8' left ctrl .. right gui
+        if ((*p < '0') || (*p > '8'))
+        {
+          return 0;
+        }
+        v = (*p == '0') ? 0 : (1u << (*p - '1'));
+        p++;
+        break;
+
+      case CMD_ARG_DIGIT:
+        if (!CMD_IS_DIGIT(*p))
+        {
+          return 0;
+        }
+        v = *p++ - '0';
+        break;
+
+      case CMD_ARG_BYTE:
+        if ((pEnd - p < 3) || !CMD_IS_DIGIT(p[0]) || !CMD_IS_DIGIT(p[1]) ||
+            !CMD_IS_DIGIT(p[2]))
+        {
+          return 0;
+        }
+        v = (p[0] - '0') * 100 + (p[1] - '0') * 10 + (p[2] - '0');
+        if (v > 255)
+        {
+          return 0;
+        }
+        p += 3;
+        break;
+
+      case CMD_ARG_UINT:
+        if (!CMD_IS_DIGIT(*p))
+        {
+          return 0;
+        }
+        v = 0;
+        while ((p < pEnd) && CMD_IS_DIGIT(*p))
+        {
+          v = v * 10 + (*p++ - '0');
+        }
+        break;
+
+      case CMD_ARG_HEX:
+        {
+          uint8_t hi, lo;
+
+          if ((pEnd - p < 2) ||
+              ((hi = cmdDispatch_hexNibble(p[0])) == 0xFF) ||
+              ((lo = cmdDispatch_hexNibble(p[1])) == 0xFF))
+          {
+            return 0;
+          }
+          v = (hi << 4) | lo;
+          p += 2;
+        }
+        break;
+
+      case CMD_ARG_REST:
+        pArgs->pRest = p;
+        pArgs->restLen = (uint8_t)(pEnd - p);
+        v = pArgs->restLen;
+        p = pEnd;
+        break;
+
+      default:
+        return 0;
+    }
+
+    pArgs->val[pArgs->num++] = v;
+  }
+
+  // Nothing may follow the last argument
+  return (p == pEnd);
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_line
+ *
+ * @brief   Dispatch the received line.
+ *
+ * @param   none
+ *
+ * @return  CMD_DISPATCH_DONE, CMD_DISPATCH_UNKNOWN or CMD_DISPATCH_BAD_ARGS
+ */
+static uint8_t cmdDispatch_line(void)
+{
+  const cmdVerb_t *pVerb;
+  cmdArgs_t args;
+
+  if ((cmdLen < CMD_PREFIX_LEN + CMD_VERB_LEN) ||
+      (cmdBuf[0] != 'A') || (cmdBuf[1] != 'T') || (cmdBuf[2] != '#'))
+  {
+    return CMD_DISPATCH_UNKNOWN;
+  }
+
+  pVerb = cmdDispatch_findVerb(cmdBuf[3], cmdBuf[4]);
+  if (pVerb == NULL)
+  {
+    return CMD_DISPATCH_UNKNOWN;
+  }
+
+  cmdBuf[cmdLen] = '\0';
+  args.pLine = cmdBuf;
+  args.lineLen = cmdLen;
+  args.num = 0;
+  args.pRest = NULL;
+  args.restLen = 0;
+
+  if (!cmdDispatch_parseArgs(pVerb->pSchema, &args))
+  {
+    return CMD_DISPATCH_BAD_ARGS;
+  }
+
+  pVerb->pfnHandler(&args);
+
+  return CMD_DISPATCH_DONE;
+}
+
+/*********************************************************************
+ * @fn      cmdDispatch_frame
+ *
+ * @brief   Dispatch the received binary frame.
+ *
+ * @param   none
+ *
+ * @return  CMD_DISPATCH_DONE or CMD_DISPATCH_FRAME_ERROR
+ */
+static uint8_t cmdDispatch_frame(void)
+{
+  cmdFrameHandler_t pfnHandler = NULL;
+
+  if (frameDec.type < CMD_DISPATCH_FRAME_TYPES)
+  {
+    pfnHandler = frameTbl[frameDec.type];
+  }
+
+  frameStatus = (pfnHandler != NULL) ?
+                pfnHandler(frameDec.body, frameDec.len) :
+                UART_FRAME_STATUS_BAD_TYPE;
+
+  return (frameStatus == UART_FRAME_STATUS_OK) ? CMD_DISPATCH_DONE :
+                                                 CMD_DISPATCH_FRAME_ERROR;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      CmdDispatch_init
+ *
+ * @brief   Reset the line and frame parsers. Registrations are kept.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void CmdDispatch_init(void)
+{
+  cmdLen = 0;
+  frameStatus = UART_FRAME_STATUS_OK;
+  UARTFrame_init(&frameDec);
+  frameActive = 0;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_registerVerbs
+ *
+ * @brief   Register a table of AT verbs. The table is referenced, not
+ *          copied, so it must stay valid (normally a static const array).
+ *          The hash seed is searched again over all registered verbs so
+ *          each keeps a slot of its own.
+ *
+ * @param   pTbl - verb table.
+ * @param   num - number of entries.
+ *
+ * @return  TRUE if all verbs were registered, FALSE if one is already
+ *          registered or no seed separates them; the verbs registered
+ *          before are kept either way
+ */
+uint8_t CmdDispatch_registerVerbs(const cmdVerb_t *pTbl, uint8_t num)
+{
+  const cmdVerb_t *verbs[CMD_DISPATCH_MAX_VERBS];
+  uint16_t oldSeed = verbSeed;
+  uint16_t tries;
+  uint16_t seed;
+  uint16_t slot;
+  uint8_t total = 0;
+  uint8_t ret = 1;
+  uint8_t i;
+
+  for (slot = 0; slot < CMD_DISPATCH_TBL_SIZE; slot++)
+  {
+    if (verbTbl[slot] != NULL)
+    {
+      verbs[total++] = verbTbl[slot];
+    }
+  }
+
+  for (; num > 0; num--, pTbl++)
+  {
+    if ((cmdDispatch_findVerb(pTbl->verb[0], pTbl->verb[1]) != NULL) ||
+        (total == CMD_DISPATCH_MAX_VERBS))
+    {
+      ret = 0;
+      continue;
+    }
+
+    for (i = numVerbs; i < total; i++)
+    {
+      if ((verbs[i]->verb[0] == pTbl->verb[0]) &&
+          (verbs[i]->verb[1] == pTbl->verb[1]))
+      {
+        break;
+      }
+    }
+
+    if (i < total)
+    {
+      ret = 0;
+      continue;
+    }
+
+    verbs[total++] = pTbl;
+  }
+
+  for (tries = 0, seed = 1; tries < CMD_DISPATCH_SEED_TRIES;
+       tries++, seed += 2)
+  {
+    if (cmdDispatch_place(verbs, total, seed))
+    {
+      numVerbs = total;
+      return ret;
+    }
+  }
+
+  // No seed for the new set, back to the verbs registered before
+  cmdDispatch_place(verbs, numVerbs, oldSeed);
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_registerFrame
+ *
+ * @brief   Register a handler for a binary frame type.
+ *
+ * @param   type - frame type, below CMD_DISPATCH_FRAME_TYPES.
+ * @param   pfnHandler - handler, NULL to unregister.
+ *
+ * @return  TRUE if registered
+ */
+uint8_t CmdDispatch_registerFrame(uint8_t type, cmdFrameHandler_t pfnHandler)
+{
+  if (type >= CMD_DISPATCH_FRAME_TYPES)
+  {
+    return 0;
+  }
+
+  frameTbl[type] = pfnHandler;
+
+  return 1;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_input
+ *
+ * @brief   Feed one received byte. An AT line is dispatched on '\r', a
+ *          binary frame once its CRC has been checked.
+ *
+ * @param   c - received byte.
+ *
+ * @return  CMD_DISPATCH_* result
+ */
+uint8_t CmdDispatch_input(uint8_t c)
+{
+  if (frameActive || ((cmdLen == 0) && (c == UART_FRAME_SOF)))
+  {
+    uint8_t ret = UARTFrame_input(&frameDec, c);
+
+    frameActive = UARTFrame_isActive(&frameDec);
+
+    switch (ret)
+    {
+      case UART_FRAME_COMPLETE:
+        return cmdDispatch_frame();
+
+      case UART_FRAME_ERROR:
+        frameStatus = frameDec.status;
+        return CMD_DISPATCH_FRAME_ERROR;
+
+      default:
+        return CMD_DISPATCH_PENDING;
+    }
+  }
+
+  if (c == '\n')
+  {
+    cmdLen = 0;
+  }
+  else if (c == '\r')
+  {
+    uint8_t ret = cmdDispatch_line();
+
+    cmdLen = 0;
+
+    return ret;
+  }
+  else if (cmdLen < CMD_DISPATCH_LINE_LEN)
+  {
+    cmdBuf[cmdLen++] = c;
+  }
+
+  return CMD_DISPATCH_PENDING;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_inputBuf
+ *
+ * @brief   Feed received bytes, stopping after the first one that
+ *          completes a line or frame so the caller can act on the result
+ *          (e.g. wait for report queue space) before feeding the rest.
+ *          Text bytes are handled here without a call per byte.
+ *
+ * @param   pBuf - received bytes.
+ * @param   len - number of bytes.
+ * @param   pUsed - output, bytes consumed.
+ *
+ * @return  CMD_DISPATCH_* result of the last byte consumed
+ */
+uint8_t CmdDispatch_inputBuf(const uint8_t *pBuf, uint16_t len,
+                             uint16_t *pUsed)
+{
+  uint8_t ret = CMD_DISPATCH_PENDING;
+  uint8_t n = cmdLen;
+  uint16_t i = 0;
+
+  while (i < len)
+  {
+    uint8_t c = pBuf[i++];
+
+    if (frameActive || ((n == 0) && (c == UART_FRAME_SOF)))
+    {
+      cmdLen = n;
+      ret = CmdDispatch_input(c);
+      n = cmdLen;
+
+      if (ret != CMD_DISPATCH_PENDING)
+      {
+        break;
+      }
+    }
+    else if (c == '\r')
+    {
+      cmdLen = n;
+      ret = cmdDispatch_line();
+      n = 0;
+      break;
+    }
+    else if (c == '\n')
+    {
+      n = 0;
+    }
+    else if (n < CMD_DISPATCH_LINE_LEN)
+    {
+      cmdBuf[n++] = c;
+    }
+  }
+
+  cmdLen = n;
+  *pUsed = i;
+
+  return ret;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_getFrameStatus
+ *
+ * @brief   Status of the last rejected binary frame.
+ *
+ * @param   none
+ *
+ * @return  UART_FRAME_STATUS_* code
+ */
+uint8_t CmdDispatch_getFrameStatus(void)
+{
+  return frameStatus;
+}
+
+/*********************************************************************
+ * @fn      CmdDispatch_resetFrame
+ *
+ * @brief   Drop a partially received binary frame, e.g. after a framing
+ *          timeout. A partial AT line is kept.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void CmdDispatch_resetFrame(void)
+{
+  UARTFrame_init(&frameDec);
+  frameActive = 0;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,154 @@
+/******************************************************************************
+
+ @file       cmd_dispatch.h
+
+ @brief This file contains the interface to the UART command dispatcher.
+        AT verbs and binary frame types are registered with a handler at
+        run time, so modules can add commands without touching the parser.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef CMD_DISPATCH_H
+#define CMD_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Verb hash table slots, power of two up to 256. Registration picks a hash
+// seed that gives every verb a slot of its own, so a lookup is one probe;
+// keep about three times the number of registered verbs.
+#ifndef CMD_DISPATCH_TBL_SIZE
+#define CMD_DISPATCH_TBL_SIZE         64
+#endif
+
+// Hash seeds tried per registration before giving up
+#ifndef CMD_DISPATCH_SEED_TRIES
+#define CMD_DISPATCH_SEED_TRIES       4096
+#endif
+
+// Frame types that can carry a handler (0 .. CMD_DISPATCH_FRAME_TYPES - 1)
+#ifndef CMD_DISPATCH_FRAME_TYPES
+#define CMD_DISPATCH_FRAME_TYPES      16
+#endif
+
+// Longest AT line, "AT#" and verb included
+#define CMD_DISPATCH_LINE_LEN         64
+
+// Most arguments in a schema
+#define CMD_DISPATCH_MAX_ARGS         6
+
+// Argument schema characters, one argument each:
+//   'm'  modifier select '0'..'8', value is the modifier bitmap
+//   'd'  one decimal digit
+//   'b'  three decimal digits, 000..255
+//   'u'  unsigned decimal of any length
+//   'x'  two hex digits
+//   '*'  rest of the line, must be last; see pRest/restLen
+//   '?'  all following arguments may be omitted
+#define CMD_ARG_MODIFIER              'm'
+#define CMD_ARG_DIGIT                 'd'
+#define CMD_ARG_BYTE                  'b'
+#define CMD_ARG_UINT                  'u'
+#define CMD_ARG_HEX                   'x'
+#define CMD_ARG_REST                  '*'
+#define CMD_ARG_OPTIONAL              '?'
+
+// CmdDispatch_input results
+#define CMD_DISPATCH_PENDING          0   // Nothing complete yet
+#define CMD_DISPATCH_DONE             1   // A line or frame was handled
+#define CMD_DISPATCH_UNKNOWN          2   // Not an AT line or unknown verb
+#define CMD_DISPATCH_BAD_ARGS         3   // Arguments do not match schema
+#define CMD_DISPATCH_FRAME_ERROR      4   // See CmdDispatch_getFrameStatus
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Parsed AT command
+typedef struct
+{
+  const uint8_t *pLine;                     // Whole line, NUL terminated
+  uint8_t       lineLen;                    // Line length
+  uint8_t       num;                        // Arguments parsed
+  uint32_t      val[CMD_DISPATCH_MAX_ARGS]; // Argument values
+  const uint8_t *pRest;                     // '*' argument
+  uint8_t       restLen;                    // '*' argument length
+} cmdArgs_t;
+
+// AT verb handler
+typedef void (*cmdLineHandler_t)(const cmdArgs_t *pArgs);
+
+// Binary frame handler, returns a UART_FRAME_STATUS_* code
+typedef uint8_t (*cmdFrameHandler_t)(const uint8_t *pBody, uint8_t len);
+
+// AT verb table entry, e.g. { "HP", "mdb", handler } for AT#HP<m><d><ddd>
+typedef struct
+{
+  char              verb[2];    // Two characters after "AT#"
+  const char        *pSchema;   // Argument schema
+  cmdLineHandler_t  pfnHandler; // Handler
+} cmdVerb_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Reset the line and frame parsers. Registrations are kept.
+ */
+extern void CmdDispatch_init(void);
+
+/*
+ * Register a table of AT verbs. Entries must stay valid.
+ */
+extern uint8_t CmdDispatch_registerVerbs(const cmdVerb_t *pTbl, uint8_t num);
+
+/*
+ * Register a handler for a binary frame type.
+ */
+extern uint8_t CmdDispatch_registerFrame(uint8_t type,
+                                         cmdFrameHandler_t pfnHandler);
+
+/*
+ * Feed one received byte.
+ */
+extern uint8_t CmdDispatch_input(uint8_t c);
+
+/*
+ * Feed received bytes up to the first one that completes a line or frame.
+ */
+extern uint8_t CmdDispatch_inputBuf(const uint8_t *pBuf, uint16_t len,
+                                    uint16_t *pUsed);
+
+/*
+ * Status of the last rejected binary frame.
+ */
+extern uint8_t CmdDispatch_getFrameStatus(void);
+
+/*
+ * Drop a partially received binary frame.
+ */
+extern void CmdDispatch_resetFrame(void);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMD_DISPATCH_H */
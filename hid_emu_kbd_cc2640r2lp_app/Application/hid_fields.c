@@ -0,0 +1,1153 @@
+/******************************************************************************
+
+ @file       hid_fields.c
+
+ @brief This file contains the report descriptor parser and the field
+        packer. Parsing runs once per report map and resolves every usage
+        to its field; finding a field is then a hash probe and packing
+        it a bit store, with whole bytes stored directly.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <ctype.h>
+#include <string.h>
+
+#include "hid_fields.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Short item tags, size bits cleared
+#define HID_ITEM_INPUT                0x80
+#define HID_ITEM_OUTPUT               0x90
+#define HID_ITEM_FEATURE              0xB0
+#define HID_ITEM_COLLECTION           0xA0
+#define HID_ITEM_END_COLLECTION       0xC0
+#define HID_ITEM_USAGE_PAGE           0x04
+#define HID_ITEM_LOGICAL_MIN          0x14
+#define HID_ITEM_LOGICAL_MAX          0x24
+#define HID_ITEM_REPORT_SIZE          0x74
+#define HID_ITEM_REPORT_ID            0x84
+#define HID_ITEM_REPORT_COUNT         0x94
+#define HID_ITEM_PUSH                 0xA4
+#define HID_ITEM_POP                  0xB4
+#define HID_ITEM_USAGE                0x08
+#define HID_ITEM_USAGE_MIN            0x18
+#define HID_ITEM_USAGE_MAX            0x28
+
+// Long item prefix
+#define HID_ITEM_LONG                 0xFE
+
+// Main item constant flag
+#define HID_MAIN_CONSTANT             0x01
+
+// Usages of one main item
+#define HID_FIELDS_MAX_LOCAL          32
+
+// Push levels
+#define HID_FIELDS_STACK_DEPTH        2
+
+#if (HID_FIELDS_HASH_SLOTS & (HID_FIELDS_HASH_SLOTS - 1)) || \
+    (HID_FIELDS_HASH_SLOTS > 256)
+#error "HID_FIELDS_HASH_SLOTS must be a power of two, up to 256"
+#endif
+
+// Free hash slot
+#define HID_FIELDS_SLOT_FREE          0xFF
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Global items
+typedef struct
+{
+  int32_t  logicalMin;
+  int32_t  logicalMax;
+  uint32_t logicalMaxU;   // Logical Max zero extended
+  uint32_t size;
+  uint32_t count;
+  uint16_t page;
+  uint8_t  id;
+} hidFieldGlobals_t;
+
+// Local items
+typedef struct
+{
+  uint32_t usages[HID_FIELDS_MAX_LOCAL];  // Page << 16 | usage
+  uint32_t usageMin;
+  uint32_t usageMax;
+  uint8_t  numUsages;
+  uint8_t  haveRange;
+} hidFieldLocals_t;
+
+// Usage name
+typedef struct
+{
+  const char *pName;
+  uint16_t   page;
+  uint16_t   usage;
+} hidFieldName_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Usages with a name of their own
+static const hidFieldName_t hidFieldNames[] =
+{
+  { "x",           0x01, 0x30 },
+  { "y",           0x01, 0x31 },
+  { "z",           0x01, 0x32 },
+  { "rx",          0x01, 0x33 },
+  { "ry",          0x01, 0x34 },
+  { "rz",          0x01, 0x35 },
+  { "slider",      0x01, 0x36 },
+  { "dial",        0x01, 0x37 },
+  { "wheel",       0x01, 0x38 },
+  { "hat",         0x01, 0x39 },
+  { "rudder",      0x02, 0xBA },
+  { "throttle",    0x02, 0xBB },
+  { "accelerator", 0x02, 0xC4 },
+  { "brake",       0x02, 0xC5 }
+};
+
+// Pages whose usages are named by number, usage unused
+static const hidFieldName_t hidFieldPages[] =
+{
+  { "desktop",     0x01, 0 },
+  { "key",         0x07, 0 },
+  { "led",         0x08, 0 },
+  { "button",      0x09, 0 },
+  { "consumer",    0x0C, 0 }
+};
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      hidFields_rpt
+ *
+ * @brief   Find a report, adding it if new.
+ *
+ * @param   pTbl - field table.
+ * @param   id - report ID.
+ * @param   type - HID_FIELDS_INPUT/OUTPUT/FEATURE.
+ *
+ * @return  report index, HID_FIELDS_MAX_RPTS if the table is full
+ */
+static uint8_t hidFields_rpt(hidFieldTbl_t *pTbl, uint8_t id, uint8_t type)
+{
+  uint8_t i;
+
+  for (i = 0; i < pTbl->numRpts; i++)
+  {
+    if ((pTbl->rpts[i].id == id) && (pTbl->rpts[i].type == type))
+    {
+      return i;
+    }
+  }
+
+  if (i < HID_FIELDS_MAX_RPTS)
+  {
+    pTbl->rpts[i].id = id;
+    pTbl->rpts[i].type = type;
+    pTbl->rpts[i].bits = 0;
+    pTbl->numRpts++;
+  }
+
+  return i;
+}
+
+/*********************************************************************
+ * @fn      hidFields_add
+ *
+ * @brief   Append a field.
+ *
+ * @param   pTbl - field table.
+ * @param   pG - globals of the main item.
+ * @param   rpt - report index.
+ * @param   flags - main item flags.
+ * @param   bitOffset - first bit.
+ * @param   count - elements.
+ * @param   usage - page << 16 | usage of element 0.
+ *
+ * @return  new field, NULL if the table is full
+ */
+static hidField_t *hidFields_add(hidFieldTbl_t *pTbl,
+                                 const hidFieldGlobals_t *pG, uint8_t rpt,
+                                 uint8_t flags, uint16_t bitOffset,
+                                 uint8_t count, uint32_t usage)
+{
+  hidField_t *pField;
+
+  if (pTbl->numFields >= HID_FIELDS_MAX_FIELDS)
+  {
+    return NULL;
+  }
+
+  pField = &pTbl->fields[pTbl->numFields++];
+  memset(pField, 0, sizeof(hidField_t));
+
+  // Logical Max 255 in one byte reads -1; take it unsigned when the
+  // minimum is not negative
+  pField->logicalMin = pG->logicalMin;
+  pField->logicalMax = ((pG->logicalMin >= 0) && (pG->logicalMax < 0)) ?
+                       (int32_t)pG->logicalMaxU : pG->logicalMax;
+  pField->page = (uint16_t)(usage >> 16);
+  pField->usage = (uint16_t)usage;
+  pField->usageMax = (uint16_t)usage;
+  pField->bitOffset = bitOffset;
+  pField->size = (uint8_t)pG->size;
+  pField->count = count;
+  pField->rpt = rpt;
+  pField->type = pTbl->rpts[rpt].type;
+  pField->flags = flags & (HID_FIELDS_FLAG_VARIABLE |
+                           HID_FIELDS_FLAG_RELATIVE |
+                           HID_FIELDS_FLAG_NULL_STATE);
+
+  return pField;
+}
+
+/*********************************************************************
+ * @fn      hidFields_slot
+ *
+ * @brief   Probe the usage hash for a usage of a report type.
+ *
+ * @param   pTbl - field table.
+ * @param   type - HID_FIELDS_INPUT/OUTPUT/FEATURE.
+ * @param   page - usage page.
+ * @param   usage - usage.
+ *
+ * @return  slot holding the usage, else the free slot it would take
+ */
+static uint8_t hidFields_slot(const hidFieldTbl_t *pTbl, uint8_t type,
+                              uint16_t page, uint16_t usage)
+{
+  const hidFieldSlot_t *pSlot;
+  const hidField_t *pField;
+  uint32_t key = ((((uint32_t)page << 16) | usage) << 2) + type;
+  uint8_t slot = (uint8_t)((key * 0x9E3779B1u) >> 24) &
+                 (HID_FIELDS_HASH_SLOTS - 1);
+
+  for (;;)
+  {
+    pSlot = &pTbl->hash[slot];
+    if (pSlot->field == HID_FIELDS_SLOT_FREE)
+    {
+      return slot;
+    }
+
+    pField = &pTbl->fields[pSlot->field];
+    if ((pField->page == page) && (pField->type == type) &&
+        (((pField->flags & HID_FIELDS_FLAG_VARIABLE) ?
+          (uint32_t)pField->usage + pSlot->idx :
+          pTbl->usages[pField->usageIdx + pSlot->idx]) == usage))
+    {
+      return slot;
+    }
+
+    slot = (slot + 1) & (HID_FIELDS_HASH_SLOTS - 1);
+  }
+}
+
+/*********************************************************************
+ * @fn      hidFields_hashUsages
+ *
+ * @brief   Enter the usages of a new field in the usage hash. A usage
+ *          already there stays with the earlier field. An array over a
+ *          usage range goes to the range list instead.
+ *
+ * @param   pTbl - field table.
+ * @param   field - index of the field, the last one added.
+ *
+ * @return  HID_FIELDS_SUCCESS or HID_FIELDS_TOO_BIG
+ */
+static uint8_t hidFields_hashUsages(hidFieldTbl_t *pTbl, uint8_t field)
+{
+  const hidField_t *pField = &pTbl->fields[field];
+  uint32_t usage;
+  uint16_t num;
+  uint16_t i;
+  uint8_t slot;
+
+  if (!(pField->flags & HID_FIELDS_FLAG_VARIABLE) && (pField->numUsages == 0))
+  {
+    if (pTbl->numRanges >= HID_FIELDS_MAX_RANGES)
+    {
+      return HID_FIELDS_TOO_BIG;
+    }
+    pTbl->ranges[pTbl->numRanges++] = field;
+    return HID_FIELDS_SUCCESS;
+  }
+
+  num = (pField->flags & HID_FIELDS_FLAG_VARIABLE) ? pField->count :
+        pField->numUsages;
+
+  for (i = 0; i < num; i++)
+  {
+    usage = (pField->flags & HID_FIELDS_FLAG_VARIABLE) ?
+            (uint32_t)pField->usage + i :
+            pTbl->usages[pField->usageIdx + i];
+
+    // Elements past usage 0xFFFF have no usage to find them by
+    if (usage > 0xFFFF)
+    {
+      break;
+    }
+
+    slot = hidFields_slot(pTbl, pField->type, pField->page, (uint16_t)usage);
+    if (pTbl->hash[slot].field != HID_FIELDS_SLOT_FREE)
+    {
+      continue;
+    }
+
+    if (pTbl->numHashed >= HID_FIELDS_HASH_SLOTS - 1)
+    {
+      return HID_FIELDS_TOO_BIG;
+    }
+
+    pTbl->hash[slot].field = field;
+    pTbl->hash[slot].idx = (uint8_t)i;
+    pTbl->numHashed++;
+  }
+
+  return HID_FIELDS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      hidFields_main
+ *
+ * @brief   Turn an Input, Output or Feature item into fields.
+ *
+ * @param   pTbl - field table.
+ * @param   pG - globals.
+ * @param   pL - locals.
+ * @param   type - HID_FIELDS_INPUT/OUTPUT/FEATURE.
+ * @param   flags - main item data.
+ *
+ * @return  HID_FIELDS_SUCCESS, HID_FIELDS_BAD_MAP or HID_FIELDS_TOO_BIG
+ */
+static uint8_t hidFields_main(hidFieldTbl_t *pTbl, const hidFieldGlobals_t *pG,
+                              const hidFieldLocals_t *pL, uint8_t type,
+                              uint32_t flags)
+{
+  hidField_t *pField;
+  uint32_t bits;
+  uint16_t bitOffset;
+  uint8_t rpt;
+  uint8_t i;
+
+  if ((pG->size == 0) || (pG->size > 32) || (pG->count > 0xFF))
+  {
+    return HID_FIELDS_BAD_MAP;
+  }
+
+  rpt = hidFields_rpt(pTbl, pG->id, type);
+  if (rpt >= HID_FIELDS_MAX_RPTS)
+  {
+    return HID_FIELDS_TOO_BIG;
+  }
+
+  bitOffset = pTbl->rpts[rpt].bits;
+  bits = bitOffset + pG->size * pG->count;
+  if (bits > 0xFFFF)
+  {
+    return HID_FIELDS_BAD_MAP;
+  }
+  pTbl->rpts[rpt].bits = (uint16_t)bits;
+
+  if ((flags & HID_MAIN_CONSTANT) || (pG->count == 0))
+  {
+    return HID_FIELDS_SUCCESS;
+  }
+
+  if ((flags & HID_FIELDS_FLAG_VARIABLE) && !pL->haveRange &&
+      (pL->numUsages > 0) && (pG->count > 1))
+  {
+    // One field per element, the last usage repeating
+    for (i = 0; i < pG->count; i++)
+    {
+      pField = hidFields_add(pTbl, pG, rpt, (uint8_t)flags,
+                             bitOffset + i * pG->size, 1,
+                             pL->usages[(i < pL->numUsages) ?
+                                        i : (pL->numUsages - 1)]);
+      if ((pField == NULL) ||
+          (hidFields_hashUsages(pTbl, pTbl->numFields - 1) !=
+           HID_FIELDS_SUCCESS))
+      {
+        return HID_FIELDS_TOO_BIG;
+      }
+    }
+
+    return HID_FIELDS_SUCCESS;
+  }
+
+  pField = hidFields_add(pTbl, pG, rpt, (uint8_t)flags, bitOffset,
+                         (uint8_t)pG->count,
+                         pL->haveRange ? pL->usageMin :
+                         (pL->numUsages > 0) ? pL->usages[0] :
+                         ((uint32_t)pG->page << 16));
+  if (pField == NULL)
+  {
+    return HID_FIELDS_TOO_BIG;
+  }
+
+  if (flags & HID_FIELDS_FLAG_VARIABLE)
+  {
+    return hidFields_hashUsages(pTbl, pTbl->numFields - 1);
+  }
+
+  // Array: a usage range or a usage list
+  if (pL->haveRange)
+  {
+    pField->usageMax = (uint16_t)pL->usageMax;
+  }
+  else if (pL->numUsages > 0)
+  {
+    if (pTbl->numUsages + pL->numUsages > HID_FIELDS_MAX_USAGES)
+    {
+      return HID_FIELDS_TOO_BIG;
+    }
+
+    pField->usageIdx = pTbl->numUsages;
+    pField->numUsages = pL->numUsages;
+    for (i = 0; i < pL->numUsages; i++)
+    {
+      pTbl->usages[pTbl->numUsages++] = (uint16_t)pL->usages[i];
+    }
+  }
+
+  return hidFields_hashUsages(pTbl, pTbl->numFields - 1);
+}
+
+/*********************************************************************
+ * @fn      hidFields_fits
+ *
+ * @brief   Check that a value can be stored in a field element.
+ *
+ * @param   pField - field.
+ * @param   value - value.
+ *
+ * @return  TRUE if it fits
+ */
+static uint8_t hidFields_fits(const hidField_t *pField, int32_t value)
+{
+  int64_t lo, hi;
+
+  if (pField->logicalMin < 0)
+  {
+    lo = -((int64_t)1 << (pField->size - 1));
+    hi = ((int64_t)1 << (pField->size - 1)) - 1;
+  }
+  else
+  {
+    lo = 0;
+    hi = ((int64_t)1 << pField->size) - 1;
+  }
+
+  return (value >= lo) && (value <= hi);
+}
+
+/*********************************************************************
+ * @fn      hidFields_store
+ *
+ * @brief   HidFields_put, a byte or two on a byte boundary stored
+ *          directly.
+ *
+ * @param   pBuf - report.
+ * @param   bitOffset - first bit.
+ * @param   size - bits, 1..32.
+ * @param   value - value.
+ *
+ * @return  none
+ */
+static void hidFields_store(uint8_t *pBuf, uint16_t bitOffset, uint8_t size,
+                            uint32_t value)
+{
+  uint8_t *p = &pBuf[bitOffset >> 3];
+
+  if ((bitOffset & 7) == 0)
+  {
+    if (size == 8)
+    {
+      p[0] = (uint8_t)value;
+      return;
+    }
+    if (size == 16)
+    {
+      p[0] = (uint8_t)value;
+      p[1] = (uint8_t)(value >> 8);
+      return;
+    }
+  }
+
+  HidFields_put(pBuf, bitOffset, size, value);
+}
+
+/*********************************************************************
+ * @fn      hidFields_load
+ *
+ * @brief   HidFields_get, a byte or two on a byte boundary loaded
+ *          directly.
+ *
+ * @param   pBuf - report.
+ * @param   bitOffset - first bit.
+ * @param   size - bits, 1..32.
+ *
+ * @return  value
+ */
+static uint32_t hidFields_load(const uint8_t *pBuf, uint16_t bitOffset,
+                               uint8_t size)
+{
+  const uint8_t *p = &pBuf[bitOffset >> 3];
+
+  if ((bitOffset & 7) == 0)
+  {
+    if (size == 8)
+    {
+      return p[0];
+    }
+    if (size == 16)
+    {
+      return p[0] | ((uint32_t)p[1] << 8);
+    }
+  }
+
+  return HidFields_get(pBuf, bitOffset, size);
+}
+
+/*********************************************************************
+ * @fn      hidFields_setArray
+ *
+ * @brief   HidFields_set of an array field.
+ *
+ * @param   pField - array field.
+ * @param   idx - usage index.
+ * @param   value - held (!= 0) or not.
+ * @param   pBuf - report, report ID excluded.
+ *
+ * @return  HID_FIELDS_SUCCESS, HID_FIELDS_RANGE or HID_FIELDS_FULL
+ */
+static uint8_t hidFields_setArray(const hidField_t *pField, uint16_t idx,
+                                  int32_t value, uint8_t *pBuf)
+{
+  uint16_t bitOffset = pField->bitOffset;
+  uint16_t freeOffset = 0xFFFF;
+  uint32_t code;
+  uint32_t slot;
+  uint8_t i;
+
+  // Array slots hold logical minimum + usage index, 0 when free
+  if ((int32_t)(pField->logicalMin + idx) > pField->logicalMax)
+  {
+    return HID_FIELDS_RANGE;
+  }
+  code = (uint32_t)(pField->logicalMin + idx);
+
+  for (i = 0; i < pField->count; i++, bitOffset += pField->size)
+  {
+    slot = hidFields_load(pBuf, bitOffset, pField->size);
+    if (slot == code)
+    {
+      if (value == 0)
+      {
+        hidFields_store(pBuf, bitOffset, pField->size, 0);
+      }
+      return HID_FIELDS_SUCCESS;
+    }
+
+    if ((slot == 0) && (freeOffset == 0xFFFF))
+    {
+      freeOffset = bitOffset;
+    }
+  }
+
+  if (value == 0)
+  {
+    return HID_FIELDS_SUCCESS;
+  }
+
+  if (freeOffset == 0xFFFF)
+  {
+    return HID_FIELDS_FULL;
+  }
+
+  hidFields_store(pBuf, freeOffset, pField->size, code);
+  return HID_FIELDS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      hidFields_nameEq
+ *
+ * @brief   Compare a name with a table entry, ignoring case.
+ *
+ * @param   pName - name, not terminated.
+ * @param   len - name length.
+ * @param   pEntry - table name, NUL terminated.
+ *
+ * @return  TRUE if equal
+ */
+static uint8_t hidFields_nameEq(const char *pName, uint8_t len,
+                                const char *pEntry)
+{
+  uint8_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    if ((pEntry[i] == '\0') ||
+        (tolower((unsigned char)pName[i]) != pEntry[i]))
+    {
+      return 0;
+    }
+  }
+
+  return pEntry[len] == '\0';
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      HidFields_parse
+ *
+ * @brief   Parse a report map into a field table. Main items read the
+ *          Usage Page, Logical Min/Max, Report Size/Count and Report ID
+ *          globals and the Usage and Usage Min/Max locals; other items
+ *          are skipped.
+ *
+ * @param   pTbl - output, field table.
+ * @param   pMap - report map.
+ * @param   len - report map length.
+ *
+ * @return  HID_FIELDS_SUCCESS, HID_FIELDS_BAD_MAP or HID_FIELDS_TOO_BIG
+ */
+uint8_t HidFields_parse(hidFieldTbl_t *pTbl, const uint8_t *pMap,
+                        uint16_t len)
+{
+  hidFieldGlobals_t g;
+  hidFieldGlobals_t stack[HID_FIELDS_STACK_DEPTH];
+  hidFieldLocals_t l;
+  uint32_t data;
+  int32_t sdata;
+  uint32_t i = 0;
+  uint8_t depth = 0;
+  uint8_t size;
+  uint8_t tag;
+  uint8_t status = HID_FIELDS_SUCCESS;
+  uint8_t k;
+
+  memset(pTbl, 0, sizeof(hidFieldTbl_t));
+  memset(pTbl->hash, HID_FIELDS_SLOT_FREE, sizeof(pTbl->hash));
+  memset(&g, 0, sizeof(g));
+  memset(&l, 0, sizeof(l));
+
+  while ((i < len) && (status == HID_FIELDS_SUCCESS))
+  {
+    if (pMap[i] == HID_ITEM_LONG)
+    {
+      if (i + 1 >= len)
+      {
+        return HID_FIELDS_BAD_MAP;
+      }
+      i += 3 + pMap[i + 1];
+      continue;
+    }
+
+    tag = pMap[i] & 0xFC;
+    size = pMap[i] & 0x03;
+    if (size == 3)
+    {
+      size = 4;
+    }
+    if (i + 1 + size > len)
+    {
+      return HID_FIELDS_BAD_MAP;
+    }
+
+    data = 0;
+    for (k = 0; k < size; k++)
+    {
+      data |= (uint32_t)pMap[i + 1 + k] << (8 * k);
+    }
+    sdata = ((size == 0) || (size == 4)) ? (int32_t)data :
+            ((int32_t)(data << (32 - 8 * size)) >> (32 - 8 * size));
+    i += 1 + size;
+
+    switch (tag)
+    {
+      case HID_ITEM_INPUT:
+        status = hidFields_main(pTbl, &g, &l, HID_FIELDS_INPUT, data);
+        memset(&l, 0, sizeof(l));
+        break;
+
+      case HID_ITEM_OUTPUT:
+        status = hidFields_main(pTbl, &g, &l, HID_FIELDS_OUTPUT, data);
+        memset(&l, 0, sizeof(l));
+        break;
+
+      case HID_ITEM_FEATURE:
+        status = hidFields_main(pTbl, &g, &l, HID_FIELDS_FEATURE, data);
+        memset(&l, 0, sizeof(l));
+        break;
+
+      case HID_ITEM_COLLECTION:
+      case HID_ITEM_END_COLLECTION:
+        memset(&l, 0, sizeof(l));
+        break;
+
+      case HID_ITEM_USAGE_PAGE:
+        g.page = (uint16_t)data;
+        break;
+
+      case HID_ITEM_LOGICAL_MIN:
+        g.logicalMin = sdata;
+        break;
+
+      case HID_ITEM_LOGICAL_MAX:
+        g.logicalMax = sdata;
+        g.logicalMaxU = data;
+        break;
+
+      case HID_ITEM_REPORT_SIZE:
+        g.size = data;
+        break;
+
+      case HID_ITEM_REPORT_ID:
+        if ((data == 0) || (data > 0xFF))
+        {
+          return HID_FIELDS_BAD_MAP;
+        }
+        g.id = (uint8_t)data;
+        break;
+
+      case HID_ITEM_REPORT_COUNT:
+        g.count = data;
+        break;
+
+      case HID_ITEM_PUSH:
+        if (depth >= HID_FIELDS_STACK_DEPTH)
+        {
+          return HID_FIELDS_TOO_BIG;
+        }
+        stack[depth++] = g;
+        break;
+
+      case HID_ITEM_POP:
+        if (depth == 0)
+        {
+          return HID_FIELDS_BAD_MAP;
+        }
+        g = stack[--depth];
+        break;
+
+      // Usages without a page take the current one
+      case HID_ITEM_USAGE:
+        if (l.numUsages >= HID_FIELDS_MAX_LOCAL)
+        {
+          return HID_FIELDS_TOO_BIG;
+        }
+        l.usages[l.numUsages++] = (size == 4) ? data :
+                                  (((uint32_t)g.page << 16) | data);
+        break;
+
+      case HID_ITEM_USAGE_MIN:
+        l.usageMin = (size == 4) ? data : (((uint32_t)g.page << 16) | data);
+        l.haveRange = 1;
+        break;
+
+      case HID_ITEM_USAGE_MAX:
+        l.usageMax = (size == 4) ? data : (((uint32_t)g.page << 16) | data);
+        l.haveRange = 1;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn      HidFields_find
+ *
+ * @brief   Find the field of a report type carrying a usage, the first
+ *          one if several do: the usage hash, then the arrays over a
+ *          usage range that come before the field it gives.
+ *
+ * @param   pTbl - field table.
+ * @param   type - HID_FIELDS_INPUT/OUTPUT/FEATURE.
+ * @param   page - usage page.
+ * @param   usage - usage.
+ * @param   pIdx - output, element of a variable field or usage index of
+ *                 an array field.
+ *
+ * @return  field, NULL if none carries the usage
+ */
+const hidField_t *HidFields_find(const hidFieldTbl_t *pTbl, uint8_t type,
+                                 uint16_t page, uint16_t usage,
+                                 uint16_t *pIdx)
+{
+  const hidFieldSlot_t *pSlot;
+  const hidField_t *pField;
+  uint8_t i;
+
+  pSlot = &pTbl->hash[hidFields_slot(pTbl, type, page, usage)];
+
+  // Range list is in field order
+  for (i = 0; (i < pTbl->numRanges) && (pTbl->ranges[i] < pSlot->field); i++)
+  {
+    pField = &pTbl->fields[pTbl->ranges[i]];
+    if ((pField->page == page) && (pField->type == type) &&
+        (usage >= pField->usage) && (usage <= pField->usageMax))
+    {
+      *pIdx = usage - pField->usage;
+      return pField;
+    }
+  }
+
+  if (pSlot->field == HID_FIELDS_SLOT_FREE)
+  {
+    return NULL;
+  }
+
+  *pIdx = pSlot->idx;
+  return &pTbl->fields[pSlot->field];
+}
+
+/*********************************************************************
+ * @fn      HidFields_set
+ *
+ * @brief   Set a field. A variable field element takes value, which must
+ *          be in the logical range or, for a null state field, fit the
+ *          element. An array field is a set of held usages: value != 0
+ *          puts usage index idx in the first free slot, 0 takes it out.
+ *
+ * @param   pField - field, from HidFields_find.
+ * @param   idx - element or usage index, from HidFields_find.
+ * @param   value - element value, or held (!= 0) or not for an array.
+ * @param   pBuf - report, report ID excluded.
+ *
+ * @return  HID_FIELDS_SUCCESS, HID_FIELDS_RANGE or HID_FIELDS_FULL
+ */
+uint8_t HidFields_set(const hidField_t *pField, uint16_t idx, int32_t value,
+                      uint8_t *pBuf)
+{
+  uint16_t bitOffset;
+  uint8_t *p;
+  uint8_t shift;
+
+  if (!(pField->flags & HID_FIELDS_FLAG_VARIABLE))
+  {
+    return hidFields_setArray(pField, idx, value, pBuf);
+  }
+
+  if ((idx >= pField->count) ||
+      (((value < pField->logicalMin) || (value > pField->logicalMax)) &&
+       !((pField->flags & HID_FIELDS_FLAG_NULL_STATE) &&
+         hidFields_fits(pField, value))))
+  {
+    return HID_FIELDS_RANGE;
+  }
+
+  bitOffset = pField->bitOffset + idx * pField->size;
+  p = &pBuf[bitOffset >> 3];
+  shift = bitOffset & 7;
+
+  // Buttons, modifiers and whole bytes stored here, the rest by put
+  if (pField->size == 1)
+  {
+    *p = (uint8_t)((*p & ~(1u << shift)) | ((value & 1) << shift));
+  }
+  else if ((pField->size == 8) && (shift == 0))
+  {
+    *p = (uint8_t)value;
+  }
+  else
+  {
+    HidFields_put(pBuf, bitOffset, pField->size, (uint32_t)value);
+  }
+
+  return HID_FIELDS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      HidFields_setBits
+ *
+ * @brief   Set a run of one bit elements of a variable field, such as
+ *          buttons, with one store rather than a HidFields_set each.
+ *
+ * @param   pField - variable field of one bit elements.
+ * @param   idx - first element, from HidFields_find.
+ * @param   count - elements, 1..32.
+ * @param   bits - element idx + i in bit i.
+ * @param   pBuf - report, report ID excluded.
+ *
+ * @return  HID_FIELDS_SUCCESS or HID_FIELDS_RANGE
+ */
+uint8_t HidFields_setBits(const hidField_t *pField, uint16_t idx,
+                          uint8_t count, uint32_t bits, uint8_t *pBuf)
+{
+  if (!(pField->flags & HID_FIELDS_FLAG_VARIABLE) || (pField->size != 1) ||
+      (count == 0) || (count > 32) || (idx + count > pField->count) ||
+      (pField->logicalMin > 0) || (pField->logicalMax < 1))
+  {
+    return HID_FIELDS_RANGE;
+  }
+
+  HidFields_put(pBuf, pField->bitOffset + idx, count, bits);
+
+  return HID_FIELDS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      HidFields_initReport
+ *
+ * @brief   Put a report at rest: all zero, each null state field one past
+ *          its logical maximum when that fits (a centered hat switch).
+ *
+ * @param   pTbl - field table.
+ * @param   rpt - report index.
+ * @param   pBuf - output, HID_FIELDS_RPT_LEN bytes.
+ *
+ * @return  none
+ */
+void HidFields_initReport(const hidFieldTbl_t *pTbl, uint8_t rpt,
+                          uint8_t *pBuf)
+{
+  const hidField_t *pField;
+  uint8_t i, k;
+
+  memset(pBuf, 0, HID_FIELDS_RPT_LEN(pTbl, rpt));
+
+  for (i = 0; i < pTbl->numFields; i++)
+  {
+    pField = &pTbl->fields[i];
+
+    if ((pField->rpt == rpt) &&
+        ((pField->flags & (HID_FIELDS_FLAG_VARIABLE |
+                           HID_FIELDS_FLAG_NULL_STATE)) ==
+         (HID_FIELDS_FLAG_VARIABLE | HID_FIELDS_FLAG_NULL_STATE)) &&
+        (pField->logicalMax < INT32_MAX) &&
+        hidFields_fits(pField, pField->logicalMax + 1))
+    {
+      for (k = 0; k < pField->count; k++)
+      {
+        HidFields_put(pBuf, pField->bitOffset + k * pField->size,
+                      pField->size, (uint32_t)(pField->logicalMax + 1));
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidFields_put
+ *
+ * @brief   Store the low size bits of value at bitOffset, least
+ *          significant bit first as HID reports are laid out.
+ *
+ * @param   pBuf - report.
+ * @param   bitOffset - first bit.
+ * @param   size - bits, 1..32.
+ * @param   value - value.
+ *
+ * @return  none
+ */
+void HidFields_put(uint8_t *pBuf, uint16_t bitOffset, uint8_t size,
+                   uint32_t value)
+{
+  uint8_t *p = &pBuf[bitOffset >> 3];
+  uint8_t shift = bitOffset & 7;
+  uint8_t bits;
+  uint8_t mask;
+
+  // Buttons and keyboard modifiers
+  if (size == 1)
+  {
+    *p = (uint8_t)((*p & ~(1u << shift)) | ((value & 1) << shift));
+    return;
+  }
+
+  // Whole bytes, most fields
+  if ((shift == 0) && ((size & 7) == 0))
+  {
+    for (; size > 0; size -= 8)
+    {
+      *p++ = (uint8_t)value;
+      value >>= 8;
+    }
+    return;
+  }
+
+  while (size > 0)
+  {
+    bits = 8 - shift;
+    if (bits > size)
+    {
+      bits = size;
+    }
+
+    mask = (uint8_t)(((1u << bits) - 1) << shift);
+    *p = (uint8_t)((*p & ~mask) | ((value << shift) & mask));
+
+    value >>= bits;
+    size -= bits;
+    shift = 0;
+    p++;
+  }
+}
+
+/*********************************************************************
+ * @fn      HidFields_get
+ *
+ * @brief   Load size bits at bitOffset, zero extended.
+ *
+ * @param   pBuf - report.
+ * @param   bitOffset - first bit.
+ * @param   size - bits, 1..32.
+ *
+ * @return  value
+ */
+uint32_t HidFields_get(const uint8_t *pBuf, uint16_t bitOffset, uint8_t size)
+{
+  const uint8_t *p = &pBuf[bitOffset >> 3];
+  uint8_t shift = bitOffset & 7;
+  uint8_t done = 0;
+  uint8_t bits;
+  uint32_t value = 0;
+
+  while (done < size)
+  {
+    bits = 8 - shift;
+    if (bits > size - done)
+    {
+      bits = size - done;
+    }
+
+    value |= (uint32_t)((*p >> shift) & ((1u << bits) - 1)) << done;
+
+    done += bits;
+    shift = 0;
+    p++;
+  }
+
+  return value;
+}
+
+/*********************************************************************
+ * @fn      HidFields_usageByName
+ *
+ * @brief   Usage of a name, ignoring case: an entry of hidFieldNames, or
+ *          an entry of hidFieldPages followed by a usage number, decimal
+ *          or 0x hex, e.g. "button 3", "consumer 0xE9", "key4".
+ *
+ * @param   pName - name, not terminated.
+ * @param   len - name length.
+ * @param   pPage - output, usage page.
+ * @param   pUsage - output, usage.
+ *
+ * @return  HID_FIELDS_SUCCESS or HID_FIELDS_NOT_FOUND
+ */
+uint8_t HidFields_usageByName(const char *pName, uint8_t len,
+                              uint16_t *pPage, uint16_t *pUsage)
+{
+  uint32_t num = 0;
+  uint8_t base = 10;
+  uint8_t word = 0;
+  uint8_t i, k;
+  uint8_t digit;
+
+  while ((len > 0) && (*pName == ' '))
+  {
+    pName++;
+    len--;
+  }
+  while ((len > 0) && (pName[len - 1] == ' '))
+  {
+    len--;
+  }
+
+  while ((word < len) && isalpha((unsigned char)pName[word]))
+  {
+    word++;
+  }
+
+  if (word == len)
+  {
+    for (k = 0; k < sizeof(hidFieldNames) / sizeof(hidFieldNames[0]); k++)
+    {
+      if (hidFields_nameEq(pName, len, hidFieldNames[k].pName))
+      {
+        *pPage = hidFieldNames[k].page;
+        *pUsage = hidFieldNames[k].usage;
+        return HID_FIELDS_SUCCESS;
+      }
+    }
+
+    return HID_FIELDS_NOT_FOUND;
+  }
+
+  // Page name and usage number
+  i = word;
+  while ((i < len) && (pName[i] == ' '))
+  {
+    i++;
+  }
+  if ((i + 1 < len) && (pName[i] == '0') &&
+      ((pName[i + 1] == 'x') || (pName[i + 1] == 'X')))
+  {
+    base = 16;
+    i += 2;
+  }
+  if (i == len)
+  {
+    return HID_FIELDS_NOT_FOUND;
+  }
+
+  for (; i < len; i++)
+  {
+    if (isdigit((unsigned char)pName[i]))
+    {
+      digit = pName[i] - '0';
+    }
+    else if ((base == 16) && isxdigit((unsigned char)pName[i]))
+    {
+      digit = (uint8_t)(tolower((unsigned char)pName[i]) - 'a' + 10);
+    }
+    else
+    {
+      return HID_FIELDS_NOT_FOUND;
+    }
+
+    num = num * base + digit;
+    if (num > 0xFFFF)
+    {
+      return HID_FIELDS_NOT_FOUND;
+    }
+  }
+
+  for (k = 0; k < sizeof(hidFieldPages) / sizeof(hidFieldPages[0]); k++)
+  {
+    if (hidFields_nameEq(pName, word, hidFieldPages[k].pName))
+    {
+      *pPage = hidFieldPages[k].page;
+      *pUsage = (uint16_t)num;
+      return HID_FIELDS_SUCCESS;
+    }
+  }
+
+  return HID_FIELDS_NOT_FOUND;
+}
+
+/*********************************************************************
+*********************************************************************/
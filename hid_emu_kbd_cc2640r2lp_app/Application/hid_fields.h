@@ -0,0 +1,202 @@
+/******************************************************************************
+
+ @file       hid_fields.h
+
+ @brief This file contains the interface to the report descriptor parser.
+        It walks the short items of a report map into a flat table of
+        fields (report, bit offset, bit size, logical range, usage) and
+        packs reports from that table by usage, so any loaded report map
+        can be driven without per-report C code.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef HID_FIELDS_H
+#define HID_FIELDS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Table sizes; the composite report map needs 14 fields, 6 reports,
+// 31 listed usages, 67 hashed usages and 1 usage range
+#ifndef HID_FIELDS_MAX_FIELDS
+#define HID_FIELDS_MAX_FIELDS         24
+#endif
+
+#ifndef HID_FIELDS_MAX_RPTS
+#define HID_FIELDS_MAX_RPTS           8
+#endif
+
+#ifndef HID_FIELDS_MAX_USAGES
+#define HID_FIELDS_MAX_USAGES         48
+#endif
+
+#ifndef HID_FIELDS_MAX_RANGES
+#define HID_FIELDS_MAX_RANGES         4
+#endif
+
+// Usage hash slots, a power of two up to 256; one per usage of a
+// variable field or array usage list, and one always left free
+#ifndef HID_FIELDS_HASH_SLOTS
+#define HID_FIELDS_HASH_SLOTS         128
+#endif
+
+// Report types, the values of the report reference descriptor
+#define HID_FIELDS_INPUT              1
+#define HID_FIELDS_OUTPUT             2
+#define HID_FIELDS_FEATURE            3
+
+// Main item flags kept in hidField_t.flags
+#define HID_FIELDS_FLAG_VARIABLE      0x02  // Else an array of usage indexes
+#define HID_FIELDS_FLAG_RELATIVE      0x04
+#define HID_FIELDS_FLAG_NULL_STATE    0x40  // Out of range values mean none
+
+// Results
+#define HID_FIELDS_SUCCESS            0
+#define HID_FIELDS_BAD_MAP            1   // Truncated or unsupported item
+#define HID_FIELDS_TOO_BIG            2   // A table above is too small
+#define HID_FIELDS_NOT_FOUND          3   // No field carries the usage
+#define HID_FIELDS_RANGE              4   // Value outside the logical range
+#define HID_FIELDS_FULL               5   // Every array slot is in use
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// One Input, Output or Feature item. Variable items listing several
+// usages are split into one field per usage; constant items only move
+// the bit offset.
+typedef struct
+{
+  int32_t  logicalMin;
+  int32_t  logicalMax;
+  uint16_t page;        // Usage page
+  uint16_t usage;       // Variable: usage of element 0, element i is
+                        // usage + i. Array over a range: first usage
+  uint16_t usageMax;    // Array over a range: last usage
+  uint16_t bitOffset;   // First bit, counted after the report ID
+  uint8_t  size;        // Bits per element, 1..32
+  uint8_t  count;       // Elements
+  uint8_t  rpt;         // Index in hidFieldTbl_t.rpts
+  uint8_t  type;        // HID_FIELDS_INPUT/OUTPUT/FEATURE of the report
+  uint8_t  flags;       // HID_FIELDS_FLAG_*
+  uint8_t  usageIdx;    // Array over a list: first usage in .usages
+  uint8_t  numUsages;   // Array over a list: usages, 0 for a range
+} hidField_t;
+
+// One report of the map
+typedef struct
+{
+  uint8_t  id;          // Report ID, 0 when the map has none
+  uint8_t  type;        // HID_FIELDS_INPUT/OUTPUT/FEATURE
+  uint16_t bits;        // Length in bits, report ID excluded
+} hidFieldRpt_t;
+
+// A usage resolved at parse time, slotted by hash of type, page, usage
+typedef struct
+{
+  uint8_t  field;       // Index in hidFieldTbl_t.fields, 0xFF when free
+  uint8_t  idx;         // Element or usage index, as HidFields_find gives
+} hidFieldSlot_t;
+
+// Parsed report map
+typedef struct
+{
+  hidField_t      fields[HID_FIELDS_MAX_FIELDS];
+  hidFieldRpt_t   rpts[HID_FIELDS_MAX_RPTS];
+  uint16_t        usages[HID_FIELDS_MAX_USAGES];  // Usage lists of arrays
+  hidFieldSlot_t  hash[HID_FIELDS_HASH_SLOTS];    // Usages of the rest
+  uint8_t         ranges[HID_FIELDS_MAX_RANGES];  // Arrays over a range
+  uint8_t         numFields;
+  uint8_t         numRpts;
+  uint8_t         numUsages;
+  uint8_t         numHashed;
+  uint8_t         numRanges;
+} hidFieldTbl_t;
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Report length in bytes, report ID excluded
+#define HID_FIELDS_RPT_LEN(pTbl, rpt)  (((pTbl)->rpts[rpt].bits + 7) >> 3)
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Parse a report map into a field table.
+ */
+extern uint8_t HidFields_parse(hidFieldTbl_t *pTbl, const uint8_t *pMap,
+                               uint16_t len);
+
+/*
+ * Find the field of a report type carrying a usage. *pIdx is the element
+ * of a variable field or the usage index of an array field.
+ */
+extern const hidField_t *HidFields_find(const hidFieldTbl_t *pTbl,
+                                        uint8_t type, uint16_t page,
+                                        uint16_t usage, uint16_t *pIdx);
+
+/*
+ * Set a field: element idx of a variable field to value, or press
+ * (value != 0) or release usage index idx of an array field.
+ */
+extern uint8_t HidFields_set(const hidField_t *pField, uint16_t idx,
+                             int32_t value, uint8_t *pBuf);
+
+/*
+ * Set count one bit elements of a variable field from element idx, element
+ * idx + i to bit i of bits, with one store (a run of buttons).
+ */
+extern uint8_t HidFields_setBits(const hidField_t *pField, uint16_t idx,
+                                 uint8_t count, uint32_t bits, uint8_t *pBuf);
+
+/*
+ * Put a report at rest: all zero, null state fields out of range.
+ */
+extern void HidFields_initReport(const hidFieldTbl_t *pTbl, uint8_t rpt,
+                                 uint8_t *pBuf);
+
+/*
+ * Store the low size bits of value at bitOffset, little endian.
+ */
+extern void HidFields_put(uint8_t *pBuf, uint16_t bitOffset, uint8_t size,
+                          uint32_t value);
+
+/*
+ * Load size bits at bitOffset, little endian, zero extended.
+ */
+extern uint32_t HidFields_get(const uint8_t *pBuf, uint16_t bitOffset,
+                              uint8_t size);
+
+/*
+ * Usage of a name: x, y, z, rx, ry, rz, slider, dial, wheel, hat,
+ * rudder, throttle, accelerator, brake, or "button", "key", "led",
+ * "consumer" or "desktop" followed by a usage number.
+ */
+extern uint8_t HidFields_usageByName(const char *pName, uint8_t len,
+                                     uint16_t *pPage, uint16_t *pUsage);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_FIELDS_H */
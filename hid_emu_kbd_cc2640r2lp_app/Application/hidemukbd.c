@@ -73,6 +73,10 @@
 
 #include "hidemukbd.h"
 #include "npi_tl_uart.h"
+#include "uart_frame.h"
+#include "cmd_dispatch.h"
+#include "kbd_state.h"
+#include "hid_fields.h"
 #include "util.h"
 
 /*********************************************************************
@@ -90,7 +94,35 @@
 #define MOUSE_BUTTON_NONE           0x00
 
 // HID keyboard input report length
-#define HID_KEYBOARD_IN_RPT_LEN     8
+#define HID_KEY_IN_RPT_LEN          HID_DESC_KEYBOARD_IN_LEN
+
+// Largest input report built by HidEmuKbd_buildReport
+#define HID_MAX_IN_RPT_LEN          HID_KEY_IN_RPT_LEN
+
+// AT#HP collection ids, by report ID (0 is the keyboard too)
+#define HP_ID_KEYBOARD              HID_RPT_ID_KEY_IN
+#define HP_ID_CONSUMER              HID_RPT_ID_CC_IN
+#define HP_ID_GAMEPAD               HID_RPT_ID_GAMEPAD_IN
+#define HP_ID_SYSTEM                HID_RPT_ID_SYS_IN
+
+// Gamepad controls, as laid out in the report map (hid_desc.h)
+#define GAMEPAD_BUTTONS             HID_DESC_GAMEPAD_IN_BUTTONS_SIZE
+#define GAMEPAD_HAT_MAX             HID_DESC_GAMEPAD_IN_HAT_MAX
+#define GAMEPAD_HAT_CENTERED        (GAMEPAD_HAT_MAX + 1)  // Null state
+#define GAMEPAD_AXES                6     // X, Y, Z, Rz, brake, accelerator
+#define GAMEPAD_AXIS_MAX            HID_DESC_GAMEPAD_IN_X_MAX
+#define GAMEPAD_AXIS_CENTERED       0x80  // X, Y, Z, Rz at rest
+
+// Consumer and system control usages, each sent as its index in the
+// report map's usage list plus the logical minimum
+#define CONSUMER_NUM_USAGES         (HID_DESC_CONSUMER_IN_USAGE_MAX - \
+                                     HID_DESC_CONSUMER_IN_USAGE_MIN + 1)
+#define SYSTEM_NUM_USAGES           (HID_DESC_SYSTEM_IN_USAGE_MAX - \
+                                     HID_DESC_SYSTEM_IN_USAGE_MIN + 1)
+
+// AT#SF images of the input reports of the report map, all together
+#define FIELD_RPT_DATA_LEN          64
+#define FIELD_RPT_NONE              0xFF  // Report without an image
 
 // HID LED output report length
 #define HID_LED_OUT_RPT_LEN         1
@@ -165,9 +197,64 @@
 // Task Events
 #define HIDEMUKBD_ICALL_EVT                   ICALL_MSG_EVENT_ID // Event_Id_31
 #define HIDEMUKBD_QUEUE_EVT                   UTIL_QUEUE_EVENT_ID // Event_Id_30
-#define UART_RX_PERIODIC_EVT                  Event_Id_00
+#define UART_RX_EVT                           Event_Id_00
+#define UART_RX_TIMEOUT_EVT                   Event_Id_01
+#define HIDEMUKBD_TEXT_EVT                    Event_Id_02
+#define HIDEMUKBD_UART_CFG_EVT                Event_Id_03
+#define UART_RX_HOLD_EVT                      Event_Id_04
+
+// UART commands are parsed as soon as a line or frame terminator arrives.
+// Define HIDEMUKBD_UART_RX_POLLED to parse on a one-shot clock started by
+// each received chunk instead.
 #define UART_RX_PERIODIC                      (100) //100ms
 
+// UART receive ring between the UART callback and the command parser, in
+// bytes. Must be a power of two.
+#ifndef UART_RX_RING_SIZE
+#define UART_RX_RING_SIZE                     512
+#endif
+
+#if (UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) != 0
+#error "UART_RX_RING_SIZE must be a power of two"
+#endif
+
+#define UART_RX_RING_MASK                     (UART_RX_RING_SIZE - 1)
+
+// UART reception stops once the receive ring could not take another full
+// read, and starts again when the parser has drained it to this level.
+// Meanwhile RTS, or XOFF when RTS/CTS is off, holds the host off.
+#define UART_RX_RESUME_LEVEL                  (UART_RX_RING_SIZE / 2)
+
+// Software flow control characters
+#define UART_XON                              0x11
+#define UART_XOFF                             0x13
+
+// Text waiting to be typed by AT#TS or a text frame, in bytes
+#ifndef HIDEMUKBD_TEXT_BUF_LEN
+#define HIDEMUKBD_TEXT_BUF_LEN                128
+#endif
+
+// Shift flag in asciiUsageTbl entries
+#define ASCII_USAGE_SHIFT                     0x80
+
+// Time in ms after the last byte of an incomplete binary frame before the
+// partial frame is dropped.
+#ifndef HIDEMUKBD_UART_FRAME_TIMEOUT
+#define HIDEMUKBD_UART_FRAME_TIMEOUT          20
+#endif
+
+// AT#BR/AT#FC: time in ms to let "OK" drain at the old setting before the
+// switch, and to wait for AT#BC at the new setting before rolling back.
+#define HIDEMUKBD_UART_SWITCH_DELAY           10
+#ifndef HIDEMUKBD_UART_CONFIRM_TIMEOUT
+#define HIDEMUKBD_UART_CONFIRM_TIMEOUT        2000
+#endif
+
+// UART setting change states
+#define UART_CFG_IDLE                         0
+#define UART_CFG_SWITCH                       1   // OK sent, switch pending
+#define UART_CFG_CONFIRM                      2   // Waiting for AT#BC
+
 // Application events
 #define SBP_STATE_CHANGE_EVT                  0x0001
 #define SBP_CHAR_CHANGE_EVT                   0x0002
@@ -176,7 +263,11 @@
 
 #define HIDEMUKBD_ALL_EVENTS                  (HIDEMUKBD_ICALL_EVT | \
                                                HIDEMUKBD_QUEUE_EVT|\
-                                               UART_RX_PERIODIC_EVT)
+                                               UART_RX_EVT|\
+                                               UART_RX_TIMEOUT_EVT|\
+                                               HIDEMUKBD_TEXT_EVT|\
+                                               HIDEMUKBD_UART_CFG_EVT|\
+                                               UART_RX_HOLD_EVT)
 
 /*********************************************************************
  * TYPEDEFS
@@ -188,6 +279,14 @@ typedef struct
   appEvtHdr_t hdr; // Event header
 } hidEmuKbdEvt_t;
 
+// Gamepad controls, packed into a report on every change
+typedef struct
+{
+  uint16_t buttons;                     // Bit n - 1 is button n
+  uint8_t hat;                          // GAMEPAD_HAT_CENTERED at rest
+  uint8_t axes[GAMEPAD_AXES];           // X, Y, Z, Rz, brake, accelerator
+} gamepadState_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -274,10 +373,128 @@ static hidDevCfg_t hidEmuKbdCfg =
   HID_KBD_FLAGS               // HID feature flags
 };
 
-#ifdef USE_HID_MOUSE
-// TRUE if boot mouse enabled
-static uint8_t hidBootMouseEnabled = FALSE;
-#endif // USE_HID_MOUSE
+// Text being typed. textIdx is the next character, textRelease is TRUE
+// when its press report is queued and the release is still due.
+static uint8_t textBuf[HIDEMUKBD_TEXT_BUF_LEN];
+static uint8_t textLen = 0;
+static uint8_t textIdx = 0;
+static uint8_t textRelease = FALSE;
+
+// Keys frame being typed, [modifier usage] pairs. keysIdx is the next
+// pair, keysRelease as textRelease.
+static uint8_t keysBuf[UART_FRAME_MAX_BODY];
+static uint8_t keysLen = 0;
+static uint8_t keysIdx = 0;
+static uint8_t keysRelease = FALSE;
+
+// TRUE while text or keys wait for HidDev report queue space; the command
+// parser leaves later input in the receive ring until they are queued.
+#define typingPending()                       ((textIdx < textLen) || \
+                                               (keysIdx < keysLen))
+
+// Printable ASCII to keyboard usage, US layout. ASCII_USAGE_SHIFT marks
+// characters that need Left Shift held. Zero entries are not typed.
+static const uint8_t asciiUsageTbl[128] =
+{
+  ['\b'] = HID_KEYBOARD_DELETE,
+  ['\t'] = HID_KEYBOARD_TAB,
+  ['\n'] = HID_KEYBOARD_RETURN,
+  [' ']  = HID_KEYBOARD_SPACEBAR,
+  ['!']  = HID_KEYBOARD_1 | ASCII_USAGE_SHIFT,
+  ['"']  = HID_KEYBOARD_SGL_QUOTE | ASCII_USAGE_SHIFT,
+  ['#']  = HID_KEYBOARD_3 | ASCII_USAGE_SHIFT,
+  ['$']  = HID_KEYBOARD_4 | ASCII_USAGE_SHIFT,
+  ['%']  = HID_KEYBOARD_5 | ASCII_USAGE_SHIFT,
+  ['&']  = HID_KEYBOARD_7 | ASCII_USAGE_SHIFT,
+  ['\''] = HID_KEYBOARD_SGL_QUOTE,
+  ['(']  = HID_KEYBOARD_9 | ASCII_USAGE_SHIFT,
+  [')']  = HID_KEYBOARD_0 | ASCII_USAGE_SHIFT,
+  ['*']  = HID_KEYBOARD_8 | ASCII_USAGE_SHIFT,
+  ['+']  = HID_KEYBOARD_EQUAL | ASCII_USAGE_SHIFT,
+  [',']  = HID_KEYBOARD_COMMA,
+  ['-']  = HID_KEYBOARD_MINUS,
+  ['.']  = HID_KEYBOARD_DOT,
+  ['/']  = HID_KEYBOARD_FWD_SLASH,
+  ['0']  = HID_KEYBOARD_0,
+  ['1']  = HID_KEYBOARD_1,
+  ['2']  = HID_KEYBOARD_2,
+  ['3']  = HID_KEYBOARD_3,
+  ['4']  = HID_KEYBOARD_4,
+  ['5']  = HID_KEYBOARD_5,
+  ['6']  = HID_KEYBOARD_6,
+  ['7']  = HID_KEYBOARD_7,
+  ['8']  = HID_KEYBOARD_8,
+  ['9']  = HID_KEYBOARD_9,
+  [':']  = HID_KEYBOARD_SEMI_COLON | ASCII_USAGE_SHIFT,
+  [';']  = HID_KEYBOARD_SEMI_COLON,
+  ['<']  = HID_KEYBOARD_COMMA | ASCII_USAGE_SHIFT,
+  ['=']  = HID_KEYBOARD_EQUAL,
+  ['>']  = HID_KEYBOARD_DOT | ASCII_USAGE_SHIFT,
+  ['?']  = HID_KEYBOARD_FWD_SLASH | ASCII_USAGE_SHIFT,
+  ['@']  = HID_KEYBOARD_2 | ASCII_USAGE_SHIFT,
+  ['A']  = HID_KEYBOARD_A | ASCII_USAGE_SHIFT,
+  ['B']  = HID_KEYBOARD_B | ASCII_USAGE_SHIFT,
+  ['C']  = HID_KEYBOARD_C | ASCII_USAGE_SHIFT,
+  ['D']  = HID_KEYBOARD_D | ASCII_USAGE_SHIFT,
+  ['E']  = HID_KEYBOARD_E | ASCII_USAGE_SHIFT,
+  ['F']  = HID_KEYBOARD_F | ASCII_USAGE_SHIFT,
+  ['G']  = HID_KEYBOARD_G | ASCII_USAGE_SHIFT,
+  ['H']  = HID_KEYBOARD_H | ASCII_USAGE_SHIFT,
+  ['I']  = HID_KEYBOARD_I | ASCII_USAGE_SHIFT,
+  ['J']  = HID_KEYBOARD_J | ASCII_USAGE_SHIFT,
+  ['K']  = HID_KEYBOARD_K | ASCII_USAGE_SHIFT,
+  ['L']  = HID_KEYBOARD_L | ASCII_USAGE_SHIFT,
+  ['M']  = HID_KEYBOARD_M | ASCII_USAGE_SHIFT,
+  ['N']  = HID_KEYBOARD_N | ASCII_USAGE_SHIFT,
+  ['O']  = HID_KEYBOARD_O | ASCII_USAGE_SHIFT,
+  ['P']  = HID_KEYBOARD_P | ASCII_USAGE_SHIFT,
+  ['Q']  = HID_KEYBOARD_Q | ASCII_USAGE_SHIFT,
+  ['R']  = HID_KEYBOARD_R | ASCII_USAGE_SHIFT,
+  ['S']  = HID_KEYBOARD_S | ASCII_USAGE_SHIFT,
+  ['T']  = HID_KEYBOARD_T | ASCII_USAGE_SHIFT,
+  ['U']  = HID_KEYBOARD_U | ASCII_USAGE_SHIFT,
+  ['V']  = HID_KEYBOARD_V | ASCII_USAGE_SHIFT,
+  ['W']  = HID_KEYBOARD_W | ASCII_USAGE_SHIFT,
+  ['X']  = HID_KEYBOARD_X | ASCII_USAGE_SHIFT,
+  ['Y']  = HID_KEYBOARD_Y | ASCII_USAGE_SHIFT,
+  ['Z']  = HID_KEYBOARD_Z | ASCII_USAGE_SHIFT,
+  ['[']  = HID_KEYBOARD_LEFT_BRKT,
+  ['\\'] = HID_KEYBOARD_BACK_SLASH,
+  [']']  = HID_KEYBOARD_RIGHT_BRKT,
+  ['^']  = HID_KEYBOARD_6 | ASCII_USAGE_SHIFT,
+  ['_']  = HID_KEYBOARD_MINUS | ASCII_USAGE_SHIFT,
+  ['`']  = HID_KEYBOARD_GRV_ACCENT,
+  ['a']  = HID_KEYBOARD_A,
+  ['b']  = HID_KEYBOARD_B,
+  ['c']  = HID_KEYBOARD_C,
+  ['d']  = HID_KEYBOARD_D,
+  ['e']  = HID_KEYBOARD_E,
+  ['f']  = HID_KEYBOARD_F,
+  ['g']  = HID_KEYBOARD_G,
+  ['h']  = HID_KEYBOARD_H,
+  ['i']  = HID_KEYBOARD_I,
+  ['j']  = HID_KEYBOARD_J,
+  ['k']  = HID_KEYBOARD_K,
+  ['l']  = HID_KEYBOARD_L,
+  ['m']  = HID_KEYBOARD_M,
+  ['n']  = HID_KEYBOARD_N,
+  ['o']  = HID_KEYBOARD_O,
+  ['p']  = HID_KEYBOARD_P,
+  ['q']  = HID_KEYBOARD_Q,
+  ['r']  = HID_KEYBOARD_R,
+  ['s']  = HID_KEYBOARD_S,
+  ['t']  = HID_KEYBOARD_T,
+  ['u']  = HID_KEYBOARD_U,
+  ['v']  = HID_KEYBOARD_V,
+  ['w']  = HID_KEYBOARD_W,
+  ['x']  = HID_KEYBOARD_X,
+  ['y']  = HID_KEYBOARD_Y,
+  ['z']  = HID_KEYBOARD_Z,
+  ['{']  = HID_KEYBOARD_LEFT_BRKT | ASCII_USAGE_SHIFT,
+  ['|']  = HID_KEYBOARD_BACK_SLASH | ASCII_USAGE_SHIFT,
+  ['}']  = HID_KEYBOARD_RIGHT_BRKT | ASCII_USAGE_SHIFT,
+  ['~']  = HID_KEYBOARD_GRV_ACCENT | ASCII_USAGE_SHIFT,
+};
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -296,11 +513,67 @@ static void HidEmuKbd_keyPressHandler(uint8_t keys);
 static void HidEmuKbd_handleKeys(uint8_t shift, uint8_t keys);
 
 // HID reports.
+static uint8_t HidEmuKbd_buildReport(uint8_t key_type, uint8_t keycode,
+                                     uint8_t *buf);
 static void HidEmuKbd_sendReport(uint8_t key_type,uint8_t keycode);
+static uint8_t HidEmuKbd_typeText(const uint8_t *pText, uint8_t len);
+static void HidEmuKbd_pumpText(void);
+static void HidEmuKbd_pumpKeys(void);
+static bStatus_t HidEmuKbd_queueKeyReport(uint8_t len, uint8_t *pBuf);
 #ifdef USE_HID_MOUSE
 static void HidEmuKbd_sendMouseReport(uint8_t buttons);
 #endif // USE_HID_MOUSE
 static uint8_t HidEmuKbd_receiveReport(uint8_t len, uint8_t *pData);
+static void HidEmuKbd_latencySample(void);
+static void HidEmuKbd_printLatency(void);
+static void HidEmuKbd_printRxStats(void);
+static char *HidEmuKbd_appendNum(char *p, const char *name, uint32 value);
+static void HidEmuKbd_sendFrameStatus(uint8_t status);
+
+// UART commands.
+static void HidEmuKbd_cmdMZ(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdMY(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdLT(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdRX(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdTS(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdHP(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdKD(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdKU(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdKR(const cmdArgs_t *pArgs);
+static void HidEmuKbd_keyStateResult(uint8_t result);
+static void HidEmuKbd_cmdCU(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdSY(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdGD(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdGU(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdGH(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdGA(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdGR(const cmdArgs_t *pArgs);
+static uint8_t HidEmuKbd_usageIndex(const uint16_t *pUsages, uint8_t numUsages,
+                                    uint32 usage);
+static uint8_t HidEmuKbd_clickConsumer(uint32 usage);
+static uint8_t HidEmuKbd_clickSystem(uint32 usage);
+static uint8_t HidEmuKbd_gamepadButton(uint32 button, uint8_t pressed);
+static void HidEmuKbd_gamepadReset(void);
+static void HidEmuKbd_packGamepad(uint8_t *pBuf);
+static void HidEmuKbd_sendGamepad(void);
+static void HidEmuKbd_fieldsInit(void);
+static void HidEmuKbd_fieldsLoad(uint8_t *pData);
+static void HidEmuKbd_fieldsStore(const uint8_t *pData, uint32_t changed);
+static void HidEmuKbd_fieldsRest(uint8_t id);
+static uint8_t HidEmuKbd_parseValue(const char *pStr, uint8_t len,
+                                    int32_t *pValue);
+static void HidEmuKbd_cmdSF(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdBR(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdFC(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdBC(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdCP(const cmdArgs_t *pArgs);
+static void HidEmuKbd_cmdCQ(const cmdArgs_t *pArgs);
+static void HidEmuKbd_uartCfgRequest(uint32 baud, uint8 flowCtrl);
+static void HidEmuKbd_uartCfgEvt(void);
+static uint8_t HidEmuKbd_frameReport(const uint8_t *pBody, uint8_t len);
+static uint8_t HidEmuKbd_frameKeys(const uint8_t *pBody, uint8_t len);
+static uint8_t HidEmuKbd_frameText(const uint8_t *pBody, uint8_t len);
+static uint8_t HidEmuKbd_frameChord(const uint8_t *pBody, uint8_t len);
 static uint8_t HidEmuKbd_reportCB(uint8_t id, uint8_t type, uint16_t uuid,
                                   uint8_t oper, uint16_t *pLen, uint8_t *pData);
 static void HidEmuKbd_hidEventCB(uint8_t evt);
@@ -340,110 +613,236 @@ RIGHT_ALT=0X40,
 RIGHT_GUI=0X80
 }MODIFIER_TYPE;
 
-typedef enum {
-ENUM_DEFAULT = 0x30,
-ENUM_LEFT_CONTROL,
-ENUM_LEFT_SHIFT,
-ENUM_LEFT_ALT,
-ENUM_LEFT_GUI,
-ENUM_RIGHT_CONTROL,
-ENUM_RIGHT_SHIFT,
-ENUM_RIGHT_ALT,
-ENUM_RIGHT_GUI
-}SELECT_MODIFIER_ENUM;
-
 static Clock_Struct periodicClock;
+static Clock_Struct frameTimeoutClock;
+static Clock_Struct uartCfgClock;
+
+// AT#BR/AT#FC negotiation
+static uint8 uartCfgState = UART_CFG_IDLE;
+static uint32 uartCfgBaud;
+static uint8 uartCfgFlowCtrl;
+static uint32 uartCfgPrevBaud;
+static uint8 uartCfgPrevFlowCtrl;
 uint8 uart_rxBuf[256];
-uint8 commandBuf[256];
 uint8 uart_txBuf[256];
-uint8 commandBufLen = 0;
+
+// Single producer (UART callback), single consumer (app task) byte ring.
+// Head and tail are free running; each side only writes its own index, so
+// neither side needs a critical section to hand bytes over.
+static volatile uint8 rxRing[UART_RX_RING_SIZE];
+static volatile uint16 rxRingHead = 0;
+static volatile uint16 rxRingTail = 0;
+static uint32 rxRingDropped = 0;
+static uint16 rxRingHighWater = 0;
+
+// UART reception held for a full receive ring, and how often
+static volatile uint8 rxHeld = FALSE;
+static uint32 rxRingHolds = 0;
+
+// Receive boundary scanner, run on each byte in the UART callback. It only
+// tracks enough of the framing to know when a line or frame has ended;
+// LEN and the count of bytes left are taken after unescaping.
+static uint8 rxScanLineStart = TRUE;
+static uint8 rxScanLenNext = FALSE;
+static uint8 rxScanEsc = FALSE;
+static uint16 rxScanFrameLeft = 0;
+
+// UART to HidDev_Report latency, in clock ticks
+static uint32 rxStampTick;
+static uint8 rxStampValid = FALSE;
+static uint32 latCount = 0;
+static uint32 latSum = 0;
+static uint32 latMax = 0;
+
+static uint8 npiUART_scanByte(uint8 c){
+  if(rxScanLenNext || rxScanFrameLeft){
+      if(rxScanEsc){
+          rxScanEsc = FALSE;
+          c ^= UART_FRAME_ESC_XOR;
+      }else if(UART_FRAME_ESC == c){
+          rxScanEsc = TRUE;
+          return FALSE;
+      }
+  }
+  if(rxScanLenNext){
+      rxScanLenNext = FALSE;
+      rxScanFrameLeft = (uint16)c + 3; // TYPE, body, CRC16
+      return FALSE;
+  }
+  if(rxScanFrameLeft){
+      if(--rxScanFrameLeft == 0){
+          rxScanLineStart = TRUE;
+          return TRUE;
+      }
+      return FALSE;
+  }
+  if(rxScanLineStart && (UART_FRAME_SOF == c)){
+      rxScanLenNext = TRUE;
+      return FALSE;
+  }
+  if(('\r' == c) || ('\n' == c)){
+      rxScanLineStart = TRUE;
+      return TRUE;
+  }
+  rxScanLineStart = FALSE;
+  return FALSE;
+}
 
 static void npiUART_cb(uint16 rxlen, uint16 txlen){
+  uint16 i;
+  uint16 head = rxRingHead;
+  uint16 used = head - rxRingTail;
+  uint8 done = FALSE;
 
   if(rxlen > 0){
+      if(rxlen > UART_RX_RING_SIZE - used){
+          rxRingDropped += rxlen - (UART_RX_RING_SIZE - used);
+          rxlen = UART_RX_RING_SIZE - used;
+      }
+      for(i = 0; i < rxlen; i++){
+          rxRing[head++ & UART_RX_RING_MASK] = uart_rxBuf[i];
+          done |= npiUART_scanByte(uart_rxBuf[i]);
+      }
+      // Publish only after the bytes are in place
+      rxRingHead = head;
 
-      commandBufLen = (uint8)(rxlen & 0xFF);
-      memcpy(commandBuf, uart_rxBuf, rxlen);
+      used += rxlen;
+      if(used > rxRingHighWater){
+          rxRingHighWater = used;
+      }
+      // The next read might not fit, hold the host off until the parser
+      // has caught up
+      if(!rxHeld && (UART_RX_RING_SIZE - used < UART_ISR_BUF_SIZE)){
+          rxHeld = TRUE;
+          rxRingHolds++;
+          NPITLUART_holdRead(TRUE);
+          Event_post(syncEvent, UART_RX_HOLD_EVT);
+      }
+      if(done && !rxStampValid){
+          rxStampTick = Clock_getTicks();
+          rxStampValid = TRUE;
+      }
+#ifdef HIDEMUKBD_UART_RX_POLLED
       Util_startClock(&periodicClock);
+#else
+      if(done){
+          Event_post(syncEvent, UART_RX_EVT);
+      }
+      if(rxScanLenNext || rxScanFrameLeft){
+          Util_restartClock(&frameTimeoutClock, HIDEMUKBD_UART_FRAME_TIMEOUT);
+      }else{
+          Util_stopClock(&frameTimeoutClock);
+      }
+#endif // HIDEMUKBD_UART_RX_POLLED
   }
 }
 
 static void receiveDataClockHandler(UArg arg)
 {
+  if(UART_RX_TIMEOUT_EVT == arg){
+      ICall_CSState key = ICall_enterCriticalSection();
+
+      // Partial frame timed out, resynchronize on the next line
+      rxScanLenNext = FALSE;
+      rxScanEsc = FALSE;
+      rxScanFrameLeft = 0;
+      rxScanLineStart = TRUE;
+      ICall_leaveCriticalSection(key);
+  }
+
   // Wake up the application.
   Event_post(syncEvent, arg);
 }
-//AT#HP[key_type:1][keyValue:3Bytes]\r\n
-static uint8 cmdBuf[64]={0};
-static uint8 cmdLen = 0;
-static MODIFIER_TYPE keyType;
-static uint16 keyCodeValue = 0;
-static uint8 reprot_ID = 0;
+// Keys held by AT#KD and chord frames
+static kbdState_t kbdState;
+// Gamepad controls, sent whole on every AT#G* change
+static gamepadState_t gamepadState;
+// Usage lists of the consumer and system control reports
+static const uint16_t consumerUsages[CONSUMER_NUM_USAGES] =
+  HID_DESC_CONSUMER_IN_USAGE_USAGES;
+static const uint16_t systemUsages[SYSTEM_NUM_USAGES] =
+  HID_DESC_SYSTEM_IN_USAGE_USAGES;
+// Fields of the report map, parsed at init for AT#SF
+static hidFieldTbl_t fieldTbl;
+// Where each input report of fieldTbl goes in an AT#SF image
+static uint8_t fieldRptOffset[HID_FIELDS_MAX_RPTS];
+// AT#SF state of the reports with none of their own (consumer and system
+// controls, which AT#CU/AT#SY only click), at fieldRptOffset[rpt]
+static uint8_t fieldRptData[FIELD_RPT_DATA_LEN];
 static void  keyBoardCmdHandler(void){
-    uint8 i;
-     for(i=0;i<commandBufLen;i++){
-         if('\n' == commandBuf[i]){
-             cmdLen = 0;
-             memset(cmdBuf,0,sizeof(cmdBuf));
-             continue;
+    uint16 tail = rxRingTail;
+    uint16 len;
+    uint16 used;
+    uint8 c;
+     // Stop behind a command whose reports wait for queue space
+     while((tail != rxRingHead) && !typingPending()){
+         // Bytes up to the head or the end of the ring, whichever is first
+         len = rxRingHead - tail;
+         if(len > UART_RX_RING_SIZE - (tail & UART_RX_RING_MASK)){
+             len = UART_RX_RING_SIZE - (tail & UART_RX_RING_MASK);
          }
-         if('\r' == commandBuf[i]){
-              if((0 == memcmp(&cmdBuf[0],"AT#",3)) && (0 == memcmp(&cmdBuf[3],"MZ",2))){
-
-              }else if((0 == memcmp(&cmdBuf[0],"AT#",3)) && (0 == memcmp(&cmdBuf[3],"MY",2))){
-                  DebugPrint("\r\n20191231\r\n");
-              }
-              else if((0 == memcmp(&cmdBuf[0],"AT#",3)) && (0 == memcmp(&cmdBuf[3],"HP",2))){
-                  switch((cmdBuf[5]) ){ //modifier
-                      case ENUM_DEFAULT:
-                          keyType = DEFAULT_MODIFIER;
-                          break;
-                      case ENUM_LEFT_CONTROL:
-                          keyType = LEFT_CONTROL;
-                          break;
-                      case ENUM_LEFT_SHIFT:
-                          keyType = LEFT_SHIFT;
-                          break;
-                      case ENUM_LEFT_ALT:
-                          keyType = LEFT_ALT;
-                          break;
-                      case ENUM_LEFT_GUI:
-                          keyType = LEFT_GUI;
-                          break;
-                      case ENUM_RIGHT_CONTROL:
-                          keyType = RIGHT_CONTROL;
-                          break;
-                      case ENUM_RIGHT_SHIFT:
-                          keyType = RIGHT_SHIFT;
-                          break;
-                      case ENUM_RIGHT_ALT:
-                          keyType = RIGHT_ALT;
-                          break;
-                      case ENUM_RIGHT_GUI:
-                          keyType = RIGHT_GUI;
-                          break;
-                      default:
-                          DebugPrint("\r\nER\r\n");
-                          cmdLen = 0;
-                          memset(cmdBuf,0,sizeof(cmdBuf));
-                          continue;
-                  }
-                  reprot_ID    = cmdBuf[6]-'0';
-                  keyCodeValue = (cmdBuf[7]-'0')*100 + (cmdBuf[8]-'0')*10 + (cmdBuf[9]-'0');
-                  DebugPrint((char *)cmdBuf);
-                  DebugPrint("\r\n");
-                  HidEmuKbd_sendReport(keyType,keyCodeValue);
-                  HidEmuKbd_sendReport(0,KEY_NONE);
-                  DebugPrint("\r\nOK\r\n");
-              }
-              cmdLen = 0;
-              memset(cmdBuf,0,sizeof(cmdBuf));
-         } else {
-            if(cmdLen < sizeof(cmdBuf)/sizeof(cmdBuf[0])) cmdBuf[cmdLen++] = commandBuf[i];
+         c = CmdDispatch_inputBuf((const uint8 *)&rxRing[tail & UART_RX_RING_MASK],
+                                  len, &used);
+         // Hand the slots back to the UART callback straight away
+         tail += used;
+         rxRingTail = tail;
+         switch(c){
+             case CMD_DISPATCH_BAD_ARGS:
+                 DebugPrint("\r\nER\r\n");
+                 break;
+             case CMD_DISPATCH_FRAME_ERROR:
+                 HidEmuKbd_sendFrameStatus(CmdDispatch_getFrameStatus());
+                 break;
+             default:
+                 break;
+         }
+     }
+     if(rxHeld && ((uint16)(rxRingHead - rxRingTail) <= UART_RX_RESUME_LEVEL)){
+         rxHeld = FALSE;
+         if(!NPITLUART_getFlowCtrl()){
+             c = UART_XON;
+             NPITLUART_writeBuf(&c, 1);
          }
+         NPITLUART_holdRead(FALSE);
      }
-     commandBufLen = 0;
 }
+
+// AT verbs handled by the application
+static const cmdVerb_t hidEmuKbdVerbs[] =
+{
+  { {'M','Z'}, "",    HidEmuKbd_cmdMZ },  // AT#MZ
+  { {'M','Y'}, "",    HidEmuKbd_cmdMY },  // AT#MY, firmware date
+  { {'L','T'}, "",    HidEmuKbd_cmdLT },  // AT#LT, UART to report latency
+  { {'R','X'}, "",    HidEmuKbd_cmdRX },  // AT#RX, receive ring stats
+  { {'T','S'}, "*",   HidEmuKbd_cmdTS },  // AT#TS<text>
+  { {'H','P'}, "mdb", HidEmuKbd_cmdHP },  // AT#HP<modifier><id><ddd>
+  { {'K','D'}, "b",   HidEmuKbd_cmdKD },  // AT#KD<ddd>, hold a usage
+  { {'K','U'}, "b",   HidEmuKbd_cmdKU },  // AT#KU<ddd>, release a usage
+  { {'K','R'}, "",    HidEmuKbd_cmdKR },  // AT#KR, release everything
+  { {'C','U'}, "u",   HidEmuKbd_cmdCU },  // AT#CU<usage>, consumer control
+  { {'S','Y'}, "b",   HidEmuKbd_cmdSY },  // AT#SY<ddd>, system control
+  { {'G','D'}, "b",   HidEmuKbd_cmdGD },  // AT#GD<ddd>, hold a gamepad button
+  { {'G','U'}, "b",   HidEmuKbd_cmdGU },  // AT#GU<ddd>, release a button
+  { {'G','H'}, "d",   HidEmuKbd_cmdGH },  // AT#GH<d>, hat 0..7, 8 centered
+  { {'G','A'}, "db",  HidEmuKbd_cmdGA },  // AT#GA<axis><ddd>
+  { {'G','R'}, "",    HidEmuKbd_cmdGR },  // AT#GR, gamepad at rest
+  { {'S','F'}, "*",   HidEmuKbd_cmdSF },  // AT#SF<usage>=<value>,...
+  { {'B','R'}, "u",   HidEmuKbd_cmdBR },  // AT#BR<baud>, then AT#BC
+  { {'F','C'}, "d",   HidEmuKbd_cmdFC },  // AT#FC<0|1>, RTS/CTS, then AT#BC
+  { {'B','C'}, "",    HidEmuKbd_cmdBC },  // AT#BC, confirm new UART setting
+  { {'C','P'}, "*",   HidEmuKbd_cmdCP },  // AT#CP<profile>, connection params
+  { {'C','Q'}, "u",   HidEmuKbd_cmdCQ },  // AT#CQ<ms>, quiet time of AT#CPauto
+};
+
+// AT#CP profile names, by HID_DEV_CONN_PROFILE_* value
+static const char * const hidEmuKbdConnProfiles[] =
+{
+  "auto",
+  "gaming",
+  "typing",
+  "idle"
+};
+
 /*********************************************************************
  * PROFILE CALLBACKS
  */
@@ -513,9 +912,28 @@ void HidEmuKbd_init(void)
   // Create an RTOS queue for message from profile to be sent to app.
   appMsgQueue = Util_constructQueue(&appMsg);
 
+  // UART commands, binary frames start idle and AT text is the default.
+  CmdDispatch_init();
+  CmdDispatch_registerVerbs(hidEmuKbdVerbs,
+                            sizeof(hidEmuKbdVerbs) / sizeof(hidEmuKbdVerbs[0]));
+  CmdDispatch_registerFrame(UART_FRAME_TYPE_REPORT, HidEmuKbd_frameReport);
+  CmdDispatch_registerFrame(UART_FRAME_TYPE_KEYS, HidEmuKbd_frameKeys);
+  CmdDispatch_registerFrame(UART_FRAME_TYPE_TEXT, HidEmuKbd_frameText);
+  CmdDispatch_registerFrame(UART_FRAME_TYPE_CHORD, HidEmuKbd_frameChord);
+
+  // Nothing held
+  KbdState_init(&kbdState);
+  HidEmuKbd_gamepadReset();
+
   // Create one-shot clocks for uart receive data handle.
   Util_constructClock(&periodicClock, receiveDataClockHandler,
-                      UART_RX_PERIODIC, 0, false, UART_RX_PERIODIC_EVT);
+                      UART_RX_PERIODIC, 0, false, UART_RX_EVT);
+  Util_constructClock(&frameTimeoutClock, receiveDataClockHandler,
+                      HIDEMUKBD_UART_FRAME_TIMEOUT, 0, false,
+                      UART_RX_TIMEOUT_EVT);
+  Util_constructClock(&uartCfgClock, receiveDataClockHandler,
+                      HIDEMUKBD_UART_SWITCH_DELAY, 0, false,
+                      HIDEMUKBD_UART_CFG_EVT);
   // Setup the GAP
   VOID GAP_SetParamValue(TGAP_CONN_PAUSE_PERIPHERAL,
                          DEFAULT_CONN_PAUSE_PERIPHERAL);
@@ -583,6 +1001,9 @@ void HidEmuKbd_init(void)
   // Set up HID keyboard service
   HidKbd_AddService();
 
+  // Fields of its report map, for AT#SF
+  HidEmuKbd_fieldsInit();
+
   // Register for HID Dev callback
   HidDev_Register(&hidEmuKbdCfg, &hidEmuKbdHidCBs);
 
@@ -602,8 +1023,9 @@ void HidEmuKbd_init(void)
   HCI_LE_ReadLocalSupportedFeaturesCmd();
 #endif // !defined (USE_LL_CONN_PARAM_UPDATE)
   
-  // Use default data Tx / Rx data length and times
-  HCI_EXT_SetMaxDataLenCmd(LL_MIN_LINK_DATA_LEN, LL_MIN_LINK_DATA_TIME, LL_MIN_LINK_DATA_LEN, LL_MIN_LINK_DATA_TIME);
+  // Use the longest Tx / Rx data length and times, so a long report or a
+  // report map Read Blob response at a large ATT MTU takes one packet
+  HCI_EXT_SetMaxDataLenCmd(LL_MAX_LINK_DATA_LEN, LL_MAX_LINK_DATA_TIME, LL_MAX_LINK_DATA_LEN, LL_MAX_LINK_DATA_TIME);
 
   NPITLUART_initializeTransport((void *)&uart_rxBuf, (void *)&uart_txBuf, npiUART_cb);
 //  NPITLUART_initializeTransport((void *)&uart_rxBuf, (void *)&uart_txBuf, NULL);
@@ -671,11 +1093,40 @@ void HidEmuKbd_taskFxn(UArg a0, UArg a1)
           }
         }
       }
-      if (events & UART_RX_PERIODIC_EVT)
+      if (events & UART_RX_EVT)
+      {
+         keyBoardCmdHandler();
+      }
+      if (events & UART_RX_TIMEOUT_EVT)
       {
-//       Util_startClock(&periodicClock);
          keyBoardCmdHandler();
-//         DebugPrint("\nUART_RX_PERIODIC_EVT\n");
+         CmdDispatch_resetFrame();
+      }
+      if (events & HIDEMUKBD_TEXT_EVT)
+      {
+        HidEmuKbd_pumpKeys();
+        HidEmuKbd_pumpText();
+
+        // Carry on with the input held behind them
+        if (!typingPending())
+        {
+          keyBoardCmdHandler();
+        }
+      }
+      if (events & UART_RX_HOLD_EVT)
+      {
+        // RTS already holds the host off; without it ask for a pause
+        if (rxHeld && !NPITLUART_getFlowCtrl())
+        {
+          uint8 c = UART_XOFF;
+
+          NPITLUART_writeBuf(&c, 1);
+        }
+        keyBoardCmdHandler();
+      }
+      if (events & HIDEMUKBD_UART_CFG_EVT)
+      {
+        HidEmuKbd_uartCfgEvt();
       }
     }
   }
@@ -858,7 +1309,7 @@ static void HidEmuKbd_handleKeys(uint8_t shift, uint8_t keys)
   if (keys & KEY_SELECT)
   {
       DebugPrint("KEY_SELECT\n");
-    if (hidBootMouseEnabled)
+    if (HidDev_IsNotifyEnabled(HID_RPT_ID_MOUSE_IN, HID_REPORT_TYPE_INPUT))
     {
       // Key Press.
       HidEmuKbd_sendMouseReport(KEY_SELECT_HID_BINDING);
@@ -897,188 +1348,1602 @@ static void HidEmuKbd_handleKeys(uint8_t shift, uint8_t keys)
 }
 
 /*********************************************************************
- * @fn      HidEmuKbd_sendReport
+ * @fn      HidEmuKbd_buildReport
  *
- * @brief   Build and send a HID keyboard report.
+ * @brief   Build a HID keyboard report for the held keys plus, for this
+ *          report only, extra modifiers and a keycode.
  *
- * @param   keycode - HID keycode.
+ * @param   key_type - extra modifier bitmap.
+ * @param   keycode - extra HID keycode, KEY_NONE for the held keys only.
+ * @param   buf - output, HID_KEY_IN_RPT_LEN bytes.
  *
- * @return  none
+ * @return  report length
  */
-static void HidEmuKbd_sendReport(uint8_t key_type,uint8_t keycode)
+static uint8_t HidEmuKbd_buildReport(uint8_t key_type, uint8_t keycode,
+                                     uint8_t *buf)
 {
+  kbdState_t state = kbdState;
 
+  state.modifiers |= key_type;
+  if (keycode != KEY_NONE)
+  {
+    (void)KbdState_press(&state, keycode);
+  }
 
-#if defined(CUSTOMER)
-  uint8_t buf[2];
-  (void)key_type;
-  buf[0] = 1;         // Reserved
-  buf[1] = keycode;   // Keycode 1
-  HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT,2, buf);
-#elif defined(GAME_PAD)
-  uint8_t buf[11];
-  buf[0] = 0X03;  // Modifier keys
-  buf[1] = 0; // Reserved
-  buf[2] = 0X0F;
-  buf[3] = keycode;
-  buf[4] = 0;         // Keycode 3 z
-  buf[5] = 0x80;         // Keycode 4 x
-  buf[6] = 0x80;         // Keycode 5 select/start
-  buf[7] = 0x80;         // Keycode 6
-  buf[8] = 0x80;
-  buf[9] = 0x00;
-  buf[10] = 0x00;
-  HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT,11, buf);
-
-#else //KEYBOAD
-  uint8_t buf[HID_KEYBOARD_IN_RPT_LEN];
-  buf[0] = key_type;  // Modifier keys
-  buf[1] = reprot_ID; // Reserved
-  buf[2] = keycode;   // Keycode 1
-  buf[3] = 0;//keycode;   // Keycode 2
-  buf[4] = 0;         // Keycode 3 z
-  buf[5] = 0;         // Keycode 4 x
-  buf[6] = 0;         // Keycode 5 select/start
-  buf[7] = 0;         // Keycode 6
-  HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT,HID_KEYBOARD_IN_RPT_LEN, buf);
-#endif
-
+  HidDesc_packKeyboardIn(buf, state.modifiers, state.keys);
+  return HID_KEY_IN_RPT_LEN;
 }
 
-#ifdef USE_HID_MOUSE
 /*********************************************************************
- * @fn      HidEmuKbd_sendMouseReport
+ * @fn      HidEmuKbd_sendReport
  *
- * @brief   Build and send a HID mouse report.
+ * @brief   Build and send a HID keyboard report, see
+ *          HidEmuKbd_buildReport. The report is built in place in a
+ *          buffer reserved from HidDev when one is available.
  *
- * @param   buttons - Mouse button code
+ * @param   key_type - extra modifier bitmap.
+ * @param   keycode - extra HID keycode, KEY_NONE for the held keys only.
  *
  * @return  none
  */
-static void HidEmuKbd_sendMouseReport(uint8_t buttons)
+static void HidEmuKbd_sendReport(uint8_t key_type,uint8_t keycode)
 {
-  uint8_t buf[HID_MOUSE_IN_RPT_LEN];
+  uint8_t buf[HID_MAX_IN_RPT_LEN];
+  uint8_t *pBuf;
+  uint8_t len;
 
-  buf[0] = buttons;   // Buttons
-  buf[1] = 0;         // X
-  buf[2] = 0;         // Y
-  buf[3] = 0;         // Wheel
-  buf[4] = 0;         // AC Pan
+  HidEmuKbd_latencySample();
 
-  HidDev_Report(HID_RPT_ID_MOUSE_IN, HID_REPORT_TYPE_INPUT,
-                HID_MOUSE_IN_RPT_LEN, buf);
+  pBuf = HidDev_ReserveReport(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT,
+                              HID_KEY_IN_RPT_LEN);
+  if (pBuf != NULL)
+  {
+    len = HidEmuKbd_buildReport(key_type, keycode, pBuf);
+    HidDev_CommitReport(len);
+  }
+  else
+  {
+    len = HidEmuKbd_buildReport(key_type, keycode, buf);
+    HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT, len, buf);
+  }
 }
-#endif // USE_HID_MOUSE
 
 /*********************************************************************
- * @fn      HidEmuKbd_receiveReport
+ * @fn      HidEmuKbd_typeText
  *
- * @brief   Process an incoming HID keyboard report.
+ * @brief   Append text to be typed. Each printable ASCII character and
+ *          \b, \t, \n becomes a press and a release report; other bytes,
+ *          including UTF-8 sequences, are skipped.
  *
- * @param   len - Length of report.
- * @param   pData - Report data.
+ * @param   pText - text.
+ * @param   len - text length.
  *
- * @return  status
+ * @return  TRUE if accepted, FALSE if it does not fit
  */
-static uint8_t HidEmuKbd_receiveReport(uint8_t len, uint8_t *pData)
+static uint8_t HidEmuKbd_typeText(const uint8_t *pText, uint8_t len)
 {
-  // Verify data length
-  if (len == HID_LED_OUT_RPT_LEN)
+  // Reclaim the buffer once everything has been typed
+  if (textIdx == textLen)
   {
-    // Set keyfob LEDs
-    //HalLedSet(HAL_LED_1, ((*pData & LED_CAPS_LOCK) == LED_CAPS_LOCK));
-    //HalLedSet(HAL_LED_2, ((*pData & LED_NUM_LOCK) == LED_NUM_LOCK));
-
-    return SUCCESS;
+    textIdx = textLen = 0;
   }
-  else
+
+  if (len > sizeof(textBuf) - textLen)
   {
-    return ATT_ERR_INVALID_VALUE_SIZE;
+    return FALSE;
   }
+
+  memcpy(&textBuf[textLen], pText, len);
+  textLen += len;
+
+  HidEmuKbd_pumpText();
+
+  return TRUE;
 }
 
 /*********************************************************************
- * @fn      HidEmuKbd_reportCB
+ * @fn      HidEmuKbd_pumpText
  *
- * @brief   HID Dev report callback.
+ * @brief   Queue press/release reports for pending text until the HidDev
+ *          report queue is full. HID_DEV_REPORT_Q_SPACE_EVT resumes it.
  *
- * @param   id - HID report ID.
- * @param   type - HID report type.
- * @param   uuid - attribute uuid.
- * @param   oper - operation:  read, write, etc.
- * @param   len - Length of report.
- * @param   pData - Report data.
+ * @param   none
  *
- * @return  GATT status code.
+ * @return  none
  */
-static uint8_t HidEmuKbd_reportCB(uint8_t id, uint8_t type, uint16_t uuid,
-                                  uint8_t oper, uint16_t *pLen, uint8_t *pData)
+static void HidEmuKbd_pumpText(void)
 {
-  uint8_t status = SUCCESS;
+  uint8_t buf[HID_MAX_IN_RPT_LEN];
+  uint8_t len;
+  uint8_t usage;
+  bStatus_t status;
 
-  // Write
-  if (oper == HID_DEV_OPER_WRITE)
+  while (textIdx < textLen)
   {
-    if (uuid == REPORT_UUID)
+    usage = (textBuf[textIdx] & 0x80) ? 0 : asciiUsageTbl[textBuf[textIdx]];
+    if (usage == 0)
     {
-      // Process write to LED output report; ignore others
-      if (type == HID_REPORT_TYPE_OUTPUT)
-      {
-        status = HidEmuKbd_receiveReport(*pLen, pData);
-      }
+      textIdx++;
+      continue;
     }
 
-    if (status == SUCCESS)
+    if (!textRelease)
     {
-      status = HidKbd_SetParameter(id, type, uuid, *pLen, pData);
+      len = HidEmuKbd_buildReport((usage & ASCII_USAGE_SHIFT) ? LEFT_SHIFT : 0,
+                                  usage & ~ASCII_USAGE_SHIFT, buf);
+    }
+    else
+    {
+      len = HidEmuKbd_buildReport(0, KEY_NONE, buf);
     }
-  }
-  // Read
-  else if (oper == HID_DEV_OPER_READ)
-  {
-    uint8_t len;
 
-    status = HidKbd_GetParameter(id, type, uuid, &len, pData);
-    if (status == SUCCESS)
+    status = HidEmuKbd_queueKeyReport(len, buf);
+    if (status == bleNoResources)
     {
-      *pLen = len;
+      // Wait for HID_DEV_REPORT_Q_SPACE_EVT
+      return;
+    }
+    else if (status != SUCCESS)
+    {
+      textIdx = textLen;
+      textRelease = FALSE;
+      return;
+    }
+
+    HidEmuKbd_latencySample();
+    if (textRelease)
+    {
+      textIdx++;
     }
+    textRelease = !textRelease;
   }
-  // Notifications enabled
-  else if (oper == HID_DEV_OPER_ENABLE)
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_pumpKeys
+ *
+ * @brief   Queue press/release reports for the pending keys frame until
+ *          the HidDev report queue is full, as HidEmuKbd_pumpText does.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_pumpKeys(void)
+{
+  uint8_t buf[HID_MAX_IN_RPT_LEN];
+  uint8_t len;
+  bStatus_t status;
+
+  while (keysIdx < keysLen)
   {
-    if (id == HID_RPT_ID_MOUSE_IN && type == HID_REPORT_TYPE_INPUT)
+    if (!keysRelease)
     {
-#ifdef USE_HID_MOUSE
-      hidBootMouseEnabled = TRUE;
-#endif // USE_HID_MOUSE
+      len = HidEmuKbd_buildReport(keysBuf[keysIdx], keysBuf[keysIdx + 1], buf);
+    }
+    else
+    {
+      len = HidEmuKbd_buildReport(0, KEY_NONE, buf);
+    }
+
+    status = HidEmuKbd_queueKeyReport(len, buf);
+    if (status == bleNoResources)
+    {
+      // Wait for HID_DEV_REPORT_Q_SPACE_EVT
+      return;
+    }
+    else if (status != SUCCESS)
+    {
+      keysIdx = keysLen;
+      keysRelease = FALSE;
+      return;
     }
+
+    HidEmuKbd_latencySample();
+    if (keysRelease)
+    {
+      keysIdx += 2;
+    }
+    keysRelease = !keysRelease;
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_queueKeyReport
+ *
+ * @brief   Queue a keyboard input report for the text and keys pumps.
+ *          With no bonded host to keep it for, send it as AT#HP does,
+ *          which starts advertising.
+ *
+ * @param   len - report length.
+ * @param   pBuf - report.
+ *
+ * @return  SUCCESS, bleNoResources when the queue is full, or the
+ *          HidDev_QueueReport failure
+ */
+static bStatus_t HidEmuKbd_queueKeyReport(uint8_t len, uint8_t *pBuf)
+{
+  bStatus_t status;
+
+  status = HidDev_QueueReport(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT,
+                              len, pBuf);
+  if (status == bleIncorrectMode)
+  {
+    HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT, len, pBuf);
+    status = SUCCESS;
   }
-  // Notifications disabled
-  else if (oper == HID_DEV_OPER_DISABLE)
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_latencySample
+ *
+ * @brief   Record the time from the UART callback seeing a command
+ *          terminator to the first HID report it produces.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_latencySample(void)
+{
+  uint32 ticks;
+
+  if (rxStampValid)
   {
-    if (id == HID_RPT_ID_MOUSE_IN && type == HID_REPORT_TYPE_INPUT)
+    ticks = Clock_getTicks() - rxStampTick;
+    rxStampValid = FALSE;
+
+    latCount++;
+    latSum += ticks;
+    if (ticks > latMax)
     {
-#ifdef USE_HID_MOUSE
-      hidBootMouseEnabled = FALSE;
-#endif // USE_HID_MOUSE
+      latMax = ticks;
     }
   }
+}
 
-  return status;
+/*********************************************************************
+ * @fn      HidEmuKbd_printLatency
+ *
+ * @brief   Print and reset the UART to report latency statistics, as
+ *          "n=<count> avg=<us> max=<us>".
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_printLatency(void)
+{
+  char str[48];
+  char *p = str;
+
+  p = HidEmuKbd_appendNum(p, "\r\nn=", latCount);
+  p = HidEmuKbd_appendNum(p, " avg=",
+                          latCount ? (latSum / latCount) * Clock_tickPeriod : 0);
+  p = HidEmuKbd_appendNum(p, " max=", latMax * Clock_tickPeriod);
+  strcpy(p, "\r\n");
+  DebugPrint(str);
+
+  latCount = 0;
+  latSum = 0;
+  latMax = 0;
 }
 
 /*********************************************************************
- * @fn      HidEmuKbd_hidEventCB
+ * @fn      HidEmuKbd_printRxStats
  *
- * @brief   HID Dev event callback.
+ * @brief   Print the UART ring statistics and the reports HidDev did not
+ *          send as duplicates or as too long for the ATT MTU, as
+ *          "drop=<bytes> hw=<bytes>/<size> hold=<count> txdrop=<bytes>
+ *          dedup=<reports> mtudrop=<reports>".
  *
- * @param   evt - event ID.
+ * @param   none
  *
- * @return  HID response code.
+ * @return  none
  */
-static void HidEmuKbd_hidEventCB(uint8_t evt)
+static void HidEmuKbd_printRxStats(void)
+{
+  char str[128];
+  char *p = str;
+  uint32_t skipped = 0;
+  uint32_t tooLong = 0;
+
+  VOID HidDev_GetParameter(HIDDEV_DEDUP_SKIPPED, &skipped);
+  VOID HidDev_GetParameter(HIDDEV_MTU_DROPPED, &tooLong);
+
+  p = HidEmuKbd_appendNum(p, "\r\ndrop=", rxRingDropped);
+  p = HidEmuKbd_appendNum(p, " hw=", rxRingHighWater);
+  p = HidEmuKbd_appendNum(p, "/", UART_RX_RING_SIZE);
+  p = HidEmuKbd_appendNum(p, " hold=", rxRingHolds);
+  p = HidEmuKbd_appendNum(p, " txdrop=", NPITLUART_txDropped());
+  p = HidEmuKbd_appendNum(p, " dedup=", skipped);
+  p = HidEmuKbd_appendNum(p, " mtudrop=", tooLong);
+  strcpy(p, "\r\n");
+  DebugPrint(str);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_appendNum
+ *
+ * @brief   Append a label and a decimal value to a string.
+ *
+ * @param   p - end of the string being built.
+ * @param   name - label.
+ * @param   value - value.
+ *
+ * @return  new end of the string
+ */
+static char *HidEmuKbd_appendNum(char *p, const char *name, uint32 value)
+{
+  char digits[10];
+  uint8 n = 0;
+
+  while (*name)
+  {
+    *p++ = *name++;
+  }
+
+  do
+  {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value);
+
+  while (n)
+  {
+    *p++ = digits[--n];
+  }
+  *p = '\0';
+
+  return p;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdMZ
+ *
+ * @brief   AT#MZ, accepted and ignored.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdMZ(const cmdArgs_t *pArgs)
 {
+  (void)pArgs;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdMY
+ *
+ * @brief   AT#MY, print the firmware date.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdMY(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  DebugPrint("\r\n20191231\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdLT
+ *
+ * @brief   AT#LT, print and reset the latency statistics.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdLT(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  HidEmuKbd_printLatency();
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdRX
+ *
+ * @brief   AT#RX, print the receive ring statistics.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdRX(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  HidEmuKbd_printRxStats();
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdTS
+ *
+ * @brief   AT#TS<text>, type a string.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdTS(const cmdArgs_t *pArgs)
+{
+  DebugPrint(HidEmuKbd_typeText(pArgs->pRest, pArgs->restLen) ?
+             "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdHP
+ *
+ * @brief   AT#HP<modifier><id><ddd>, press and release one usage of the
+ *          collection with report ID id: a key (0 or 1, with the
+ *          modifiers), a consumer usage (2), a gamepad button 1..15 (3)
+ *          or a system usage (4), usages as listed in the report map.
+ *
+ * @param   pArgs - parsed command, val[] = modifier bitmap, id, usage.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdHP(const cmdArgs_t *pArgs)
+{
+  uint8_t ok = TRUE;
+
+  DebugPrint((char *)pArgs->pLine);
+  DebugPrint("\r\n");
+
+  switch (pArgs->val[1])
+  {
+    case 0:
+    case HP_ID_KEYBOARD:
+      HidEmuKbd_sendReport((uint8_t)pArgs->val[0], (uint8_t)pArgs->val[2]);
+      HidEmuKbd_sendReport(0, KEY_NONE);
+      break;
+
+    case HP_ID_CONSUMER:
+      ok = HidEmuKbd_clickConsumer(pArgs->val[2]);
+      break;
+
+    case HP_ID_GAMEPAD:
+      ok = HidEmuKbd_gamepadButton(pArgs->val[2], TRUE) &&
+           HidEmuKbd_gamepadButton(pArgs->val[2], FALSE);
+      break;
+
+    case HP_ID_SYSTEM:
+      ok = HidEmuKbd_clickSystem(pArgs->val[2]);
+      break;
+
+    default:
+      ok = FALSE;
+      break;
+  }
+
+  DebugPrint(ok ? "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdKD
+ *
+ * @brief   AT#KD<ddd>, hold a usage until AT#KU or AT#KR. Usages 224..231
+ *          are the modifiers.
+ *
+ * @param   pArgs - parsed command, val[0] = usage.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdKD(const cmdArgs_t *pArgs)
+{
+  HidEmuKbd_keyStateResult(KbdState_press(&kbdState, (uint8_t)pArgs->val[0]));
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdKU
+ *
+ * @brief   AT#KU<ddd>, release a usage.
+ *
+ * @param   pArgs - parsed command, val[0] = usage.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdKU(const cmdArgs_t *pArgs)
+{
+  HidEmuKbd_keyStateResult(KbdState_release(&kbdState,
+                                            (uint8_t)pArgs->val[0]));
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdKR
+ *
+ * @brief   AT#KR, release all keys and modifiers.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdKR(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  HidEmuKbd_keyStateResult(KbdState_releaseAll(&kbdState));
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_keyStateResult
+ *
+ * @brief   Send one report if the key state changed and answer the host.
+ *
+ * @param   result - KBD_STATE_* result.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_keyStateResult(uint8_t result)
+{
+  if (result == KBD_STATE_CHANGED)
+  {
+    HidEmuKbd_sendReport(0, KEY_NONE);
+  }
+
+  DebugPrint((result <= KBD_STATE_CHANGED) ? "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdCU
+ *
+ * @brief   AT#CU<usage>, press and release one consumer control usage
+ *          of the report map, in decimal (e.g. 233 volume up, 176 play).
+ *
+ * @param   pArgs - parsed command, val[0] = usage.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdCU(const cmdArgs_t *pArgs)
+{
+  DebugPrint(HidEmuKbd_clickConsumer(pArgs->val[0]) ?
+             "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdSY
+ *
+ * @brief   AT#SY<ddd>, press and release one system control usage of
+ *          the report map: 128 system control, 133..141 menu navigation.
+ *
+ * @param   pArgs - parsed command, val[0] = usage.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdSY(const cmdArgs_t *pArgs)
+{
+  DebugPrint(HidEmuKbd_clickSystem(pArgs->val[0]) ?
+             "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdGD
+ *
+ * @brief   AT#GD<ddd>, hold gamepad button 1..15 until AT#GU or AT#GR.
+ *
+ * @param   pArgs - parsed command, val[0] = button.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdGD(const cmdArgs_t *pArgs)
+{
+  DebugPrint(HidEmuKbd_gamepadButton(pArgs->val[0], TRUE) ?
+             "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdGU
+ *
+ * @brief   AT#GU<ddd>, release gamepad button 1..15.
+ *
+ * @param   pArgs - parsed command, val[0] = button.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdGU(const cmdArgs_t *pArgs)
+{
+  DebugPrint(HidEmuKbd_gamepadButton(pArgs->val[0], FALSE) ?
+             "\r\nOK\r\n" : "\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdGH
+ *
+ * @brief   AT#GH<d>, set the hat switch: 0..7 clockwise from up, 8
+ *          centered.
+ *
+ * @param   pArgs - parsed command, val[0] = direction.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdGH(const cmdArgs_t *pArgs)
+{
+  if (pArgs->val[0] > GAMEPAD_HAT_CENTERED)
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  gamepadState.hat = (uint8_t)pArgs->val[0];
+  HidEmuKbd_sendGamepad();
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdGA
+ *
+ * @brief   AT#GA<axis><ddd>, set axis 0..5 (X, Y, Z, Rz, brake,
+ *          accelerator) to 0..255.
+ *
+ * @param   pArgs - parsed command, val[] = axis, value.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdGA(const cmdArgs_t *pArgs)
+{
+  if ((pArgs->val[0] >= GAMEPAD_AXES) || (pArgs->val[1] > GAMEPAD_AXIS_MAX))
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  gamepadState.axes[pArgs->val[0]] = (uint8_t)pArgs->val[1];
+  HidEmuKbd_sendGamepad();
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdGR
+ *
+ * @brief   AT#GR, release all gamepad buttons, center the hat and the
+ *          sticks and let go of the pedals.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdGR(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  HidEmuKbd_gamepadReset();
+  HidEmuKbd_sendGamepad();
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_usageIndex
+ *
+ * @brief   Find a usage in the usage list of an array field.
+ *
+ * @param   pUsages - usage list, in report map order.
+ * @param   numUsages - entries in pUsages.
+ * @param   usage - usage to find.
+ *
+ * @return  index in pUsages, numUsages if not listed
+ */
+static uint8_t HidEmuKbd_usageIndex(const uint16_t *pUsages, uint8_t numUsages,
+                                    uint32 usage)
+{
+  uint8_t i;
+
+  for (i = 0; (i < numUsages) && (pUsages[i] != usage); i++)
+  {
+  }
+
+  return i;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_clickConsumer
+ *
+ * @brief   Send a consumer control press and release report.
+ *
+ * @param   usage - consumer usage, one of consumerUsages.
+ *
+ * @return  TRUE if sent, FALSE if usage is not in the report map
+ */
+static uint8_t HidEmuKbd_clickConsumer(uint32 usage)
+{
+  uint8_t buf[HID_DESC_CONSUMER_IN_LEN];
+  uint8_t idx;
+
+  idx = HidEmuKbd_usageIndex(consumerUsages, CONSUMER_NUM_USAGES, usage);
+  if (idx >= CONSUMER_NUM_USAGES)
+  {
+    return FALSE;
+  }
+
+  HidEmuKbd_latencySample();
+
+  HidDesc_packConsumerIn(buf, HID_DESC_CONSUMER_IN_USAGE_MIN + idx);
+  HidDev_Report(HID_RPT_ID_CC_IN, HID_REPORT_TYPE_INPUT, sizeof(buf), buf);
+
+  // Below the logical minimum: no usage
+  HidDesc_packConsumerIn(buf, 0);
+  HidDev_Report(HID_RPT_ID_CC_IN, HID_REPORT_TYPE_INPUT, sizeof(buf), buf);
+  HidEmuKbd_fieldsRest(HID_RPT_ID_CC_IN);
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_clickSystem
+ *
+ * @brief   Send a system control press and release report.
+ *
+ * @param   usage - Generic Desktop usage, one of systemUsages.
+ *
+ * @return  TRUE if sent, FALSE if usage is not in the report map
+ */
+static uint8_t HidEmuKbd_clickSystem(uint32 usage)
+{
+  uint8_t buf[HID_DESC_SYSTEM_IN_LEN];
+  uint8_t idx;
+
+  idx = HidEmuKbd_usageIndex(systemUsages, SYSTEM_NUM_USAGES, usage);
+  if (idx >= SYSTEM_NUM_USAGES)
+  {
+    return FALSE;
+  }
+
+  HidEmuKbd_latencySample();
+
+  HidDesc_packSystemIn(buf, HID_DESC_SYSTEM_IN_USAGE_MIN + idx);
+  HidDev_Report(HID_RPT_ID_SYS_IN, HID_REPORT_TYPE_INPUT, sizeof(buf), buf);
+
+  HidDesc_packSystemIn(buf, 0);
+  HidDev_Report(HID_RPT_ID_SYS_IN, HID_REPORT_TYPE_INPUT, sizeof(buf), buf);
+  HidEmuKbd_fieldsRest(HID_RPT_ID_SYS_IN);
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_gamepadButton
+ *
+ * @brief   Press or release a gamepad button and send the gamepad report
+ *          if that changed it.
+ *
+ * @param   button - 1..GAMEPAD_BUTTONS.
+ * @param   pressed - TRUE to press, FALSE to release.
+ *
+ * @return  TRUE if valid, FALSE if button is out of range
+ */
+static uint8_t HidEmuKbd_gamepadButton(uint32 button, uint8_t pressed)
+{
+  uint16_t buttons;
+  uint16_t mask;
+
+  if ((button == 0) || (button > GAMEPAD_BUTTONS))
+  {
+    return FALSE;
+  }
+
+  buttons = gamepadState.buttons;
+  mask = 1 << (button - 1);
+
+  if (((buttons & mask) != 0) != (pressed != FALSE))
+  {
+    gamepadState.buttons = buttons ^ mask;
+    HidEmuKbd_sendGamepad();
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_gamepadReset
+ *
+ * @brief   Put the gamepad controls at rest, without sending them.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_gamepadReset(void)
+{
+  uint8_t i;
+
+  memset(&gamepadState, 0, sizeof(gamepadState));
+  gamepadState.hat = GAMEPAD_HAT_CENTERED;
+
+  // Sticks centered, pedals (the last two axes) released
+  for (i = 0; i < GAMEPAD_AXES - 2; i++)
+  {
+    gamepadState.axes[i] = GAMEPAD_AXIS_CENTERED;
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_packGamepad
+ *
+ * @brief   Pack the gamepad report from the gamepad controls.
+ *
+ * @param   pBuf - output, HID_DESC_GAMEPAD_IN_LEN bytes.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_packGamepad(uint8_t *pBuf)
+{
+  HidDesc_packGamepadIn(pBuf, gamepadState.hat, gamepadState.buttons,
+                        gamepadState.axes[0], gamepadState.axes[1],
+                        gamepadState.axes[2], gamepadState.axes[3],
+                        gamepadState.axes[4], gamepadState.axes[5]);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_sendGamepad
+ *
+ * @brief   Pack and send the gamepad report.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_sendGamepad(void)
+{
+  uint8_t buf[HID_DESC_GAMEPAD_IN_LEN];
+
+  HidEmuKbd_latencySample();
+  HidEmuKbd_packGamepad(buf);
+  HidDev_Report(HID_RPT_ID_GAMEPAD_IN, HID_REPORT_TYPE_INPUT, sizeof(buf),
+                buf);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_fieldsInit
+ *
+ * @brief   Parse the report map of the HID service, lay out the AT#SF
+ *          image of its input reports and put those without state of
+ *          their own at rest. A map that does not parse leaves AT#SF
+ *          answering ER.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_fieldsInit(void)
+{
+  const uint8 *pMap;
+  uint16 mapLen;
+  uint8_t offset = 0;
+  uint8_t len;
+  uint8_t i;
+
+  pMap = HidKbd_GetReportMap(&mapLen);
+  if (HidFields_parse(&fieldTbl, pMap, mapLen) != HID_FIELDS_SUCCESS)
+  {
+    // An empty map, no fields or usages
+    HidFields_parse(&fieldTbl, pMap, 0);
+  }
+
+  for (i = 0; i < HID_FIELDS_MAX_RPTS; i++)
+  {
+    fieldRptOffset[i] = FIELD_RPT_NONE;
+
+    if ((i < fieldTbl.numRpts) && (fieldTbl.rpts[i].type == HID_FIELDS_INPUT))
+    {
+      len = HID_FIELDS_RPT_LEN(&fieldTbl, i);
+      if (offset + len <= FIELD_RPT_DATA_LEN)
+      {
+        fieldRptOffset[i] = offset;
+        HidFields_initReport(&fieldTbl, i, &fieldRptData[offset]);
+        offset += len;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_fieldsLoad
+ *
+ * @brief   Build the AT#SF image of the input reports: the keyboard from
+ *          the held keys, the gamepad from its controls and the others
+ *          from their AT#SF state.
+ *
+ * @param   pData - output, FIELD_RPT_DATA_LEN bytes.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_fieldsLoad(uint8_t *pData)
+{
+  uint8_t *pRpt;
+  uint8_t i;
+
+  for (i = 0; i < fieldTbl.numRpts; i++)
+  {
+    if (fieldRptOffset[i] == FIELD_RPT_NONE)
+    {
+      continue;
+    }
+
+    pRpt = &pData[fieldRptOffset[i]];
+    switch (fieldTbl.rpts[i].id)
+    {
+      case HID_RPT_ID_KEY_IN:
+        (void)HidEmuKbd_buildReport(0, KEY_NONE, pRpt);
+        break;
+
+      case HID_RPT_ID_GAMEPAD_IN:
+        HidEmuKbd_packGamepad(pRpt);
+        break;
+
+      default:
+        memcpy(pRpt, &fieldRptData[fieldRptOffset[i]],
+               HID_FIELDS_RPT_LEN(&fieldTbl, i));
+        break;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_fieldsStore
+ *
+ * @brief   Take changed reports of an AT#SF image back into the held
+ *          keys, the gamepad controls or their AT#SF state, so the key
+ *          and gamepad commands and key frames carry on from them.
+ *
+ * @param   pData - AT#SF image.
+ * @param   changed - bit per fieldTbl report to take.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_fieldsStore(const uint8_t *pData, uint32_t changed)
+{
+  // Bit offsets of the gamepad axes, in gamepadState.axes order
+  static const uint8_t gamepadAxisBit[GAMEPAD_AXES] =
+  {
+    HID_DESC_GAMEPAD_IN_X_BIT, HID_DESC_GAMEPAD_IN_Y_BIT,
+    HID_DESC_GAMEPAD_IN_Z_BIT, HID_DESC_GAMEPAD_IN_RZ_BIT,
+    HID_DESC_GAMEPAD_IN_BRAKE_BIT, HID_DESC_GAMEPAD_IN_ACCELERATOR_BIT
+  };
+  const uint8_t *pRpt;
+  uint8_t usage;
+  uint8_t i, k;
+
+  for (i = 0; i < fieldTbl.numRpts; i++)
+  {
+    if (!(changed & (1UL << i)))
+    {
+      continue;
+    }
+
+    pRpt = &pData[fieldRptOffset[i]];
+    switch (fieldTbl.rpts[i].id)
+    {
+      case HID_RPT_ID_KEY_IN:
+        KbdState_init(&kbdState);
+        kbdState.modifiers = (uint8_t)HidFields_get(pRpt,
+                               HID_DESC_KEYBOARD_IN_MODIFIERS_BIT,
+                               HID_DESC_KEYBOARD_IN_MODIFIERS_SIZE);
+        for (k = 0; k < HID_DESC_KEYBOARD_IN_KEYS_COUNT; k++)
+        {
+          usage = (uint8_t)HidFields_get(pRpt,
+                    HID_DESC_KEYBOARD_IN_KEYS_BIT +
+                    k * HID_DESC_KEYBOARD_IN_KEYS_SIZE,
+                    HID_DESC_KEYBOARD_IN_KEYS_SIZE);
+          if (usage != KEY_NONE)
+          {
+            (void)KbdState_press(&kbdState, usage);
+          }
+        }
+        break;
+
+      case HID_RPT_ID_GAMEPAD_IN:
+        gamepadState.hat = (uint8_t)HidFields_get(pRpt,
+                             HID_DESC_GAMEPAD_IN_HAT_BIT,
+                             HID_DESC_GAMEPAD_IN_HAT_SIZE);
+        gamepadState.buttons = (uint16_t)HidFields_get(pRpt,
+                                 HID_DESC_GAMEPAD_IN_BUTTONS_BIT,
+                                 HID_DESC_GAMEPAD_IN_BUTTONS_SIZE);
+        for (k = 0; k < GAMEPAD_AXES; k++)
+        {
+          gamepadState.axes[k] = (uint8_t)HidFields_get(pRpt,
+                                   gamepadAxisBit[k], 8);
+        }
+        break;
+
+      default:
+        memcpy(&fieldRptData[fieldRptOffset[i]], pRpt,
+               HID_FIELDS_RPT_LEN(&fieldTbl, i));
+        break;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_fieldsRest
+ *
+ * @brief   Put the AT#SF state of an input report at rest, as a click
+ *          on it leaves it on the host.
+ *
+ * @param   id - report ID.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_fieldsRest(uint8_t id)
+{
+  uint8_t i;
+
+  for (i = 0; i < fieldTbl.numRpts; i++)
+  {
+    if ((fieldTbl.rpts[i].id == id) &&
+        (fieldTbl.rpts[i].type == HID_FIELDS_INPUT) &&
+        (fieldRptOffset[i] != FIELD_RPT_NONE))
+    {
+      HidFields_initReport(&fieldTbl, i, &fieldRptData[fieldRptOffset[i]]);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_parseValue
+ *
+ * @brief   Parse a signed decimal value, spaces around it allowed.
+ *
+ * @param   pStr - text, not terminated.
+ * @param   len - text length.
+ * @param   pValue - output, value.
+ *
+ * @return  TRUE if valid
+ */
+static uint8_t HidEmuKbd_parseValue(const char *pStr, uint8_t len,
+                                    int32_t *pValue)
+{
+  int32_t value = 0;
+  uint8_t negative = FALSE;
+  uint8_t digits = 0;
+
+  while ((len > 0) && (*pStr == ' '))
+  {
+    pStr++;
+    len--;
+  }
+  while ((len > 0) && (pStr[len - 1] == ' '))
+  {
+    len--;
+  }
+
+  if ((len > 0) && (*pStr == '-'))
+  {
+    negative = TRUE;
+    pStr++;
+    len--;
+  }
+
+  for (; len > 0; pStr++, len--)
+  {
+    if ((*pStr < '0') || (*pStr > '9') || (++digits > 9))
+    {
+      return FALSE;
+    }
+    value = value * 10 + (*pStr - '0');
+  }
+
+  *pValue = negative ? -value : value;
+
+  return (digits > 0);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdSF
+ *
+ * @brief   AT#SF<usage>=<value>[,<usage>=<value>]..., set input report
+ *          fields of the report map by usage, e.g. AT#SFx=200,button 3=1
+ *          (names as HidFields_usageByName takes them). Array fields,
+ *          such as keys and consumer usages, hold a usage on 1 and
+ *          release it on 0. Each changed report is sent once; on any
+ *          error nothing changes and nothing is sent. The keyboard and
+ *          gamepad reports start from and update the held keys and the
+ *          gamepad controls.
+ *
+ * @param   pArgs - parsed command, pRest = assignments.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdSF(const cmdArgs_t *pArgs)
+{
+  uint8_t data[FIELD_RPT_DATA_LEN];
+  const hidField_t *pField = NULL;
+  const char *p = (const char *)pArgs->pRest;
+  const char *pEnd = p + pArgs->restLen;
+  const char *pNext;
+  const char *pEq;
+  int32_t value;
+  uint32_t changed = 0;
+  uint16_t page, usage, idx;
+  uint8_t ok = (pArgs->restLen > 0);
+  uint8_t i;
+
+  HidEmuKbd_fieldsLoad(data);
+
+  while (ok && (p < pEnd))
+  {
+    for (pNext = p; (pNext < pEnd) && (*pNext != ','); pNext++)
+    {
+    }
+    for (pEq = p; (pEq < pNext) && (*pEq != '='); pEq++)
+    {
+    }
+
+    ok = (pEq < pNext) &&
+         (HidFields_usageByName(p, (uint8_t)(pEq - p), &page, &usage) ==
+          HID_FIELDS_SUCCESS) &&
+         HidEmuKbd_parseValue(pEq + 1, (uint8_t)(pNext - pEq - 1), &value);
+
+    if (ok)
+    {
+      pField = HidFields_find(&fieldTbl, HID_FIELDS_INPUT, page, usage, &idx);
+      ok = (pField != NULL) &&
+           (fieldRptOffset[pField->rpt] != FIELD_RPT_NONE) &&
+           (HidFields_set(pField, idx, value,
+                          &data[fieldRptOffset[pField->rpt]]) ==
+            HID_FIELDS_SUCCESS);
+    }
+
+    if (ok)
+    {
+      changed |= 1UL << pField->rpt;
+    }
+
+    p = pNext + 1;
+  }
+
+  if (!ok)
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  HidEmuKbd_fieldsStore(data, changed);
+  HidEmuKbd_latencySample();
+
+  for (i = 0; i < fieldTbl.numRpts; i++)
+  {
+    if (changed & (1UL << i))
+    {
+      HidDev_Report(fieldTbl.rpts[i].id, HID_REPORT_TYPE_INPUT,
+                    HID_FIELDS_RPT_LEN(&fieldTbl, i),
+                    &data[fieldRptOffset[i]]);
+    }
+  }
+
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdBR
+ *
+ * @brief   AT#BR<baud>, switch the UART baud rate. OK is sent at the old
+ *          rate; the host then switches too and sends AT#BC at the new
+ *          rate within HIDEMUKBD_UART_CONFIRM_TIMEOUT, else the device
+ *          goes back to the old rate.
+ *
+ * @param   pArgs - parsed command, val[0] = baud rate.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdBR(const cmdArgs_t *pArgs)
+{
+  HidEmuKbd_uartCfgRequest(pArgs->val[0], NPITLUART_getFlowCtrl());
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdFC
+ *
+ * @brief   AT#FC<0|1>, turn RTS/CTS flow control off or on, confirmed
+ *          with AT#BC like AT#BR.
+ *
+ * @param   pArgs - parsed command, val[0] = 0 or 1.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdFC(const cmdArgs_t *pArgs)
+{
+  if (pArgs->val[0] > 1)
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  HidEmuKbd_uartCfgRequest(NPITLUART_getBaud(), (uint8)pArgs->val[0]);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdBC
+ *
+ * @brief   AT#BC, keep the new UART setting.
+ *
+ * @param   pArgs - parsed command.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdBC(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+
+  if (uartCfgState != UART_CFG_CONFIRM)
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  Util_stopClock(&uartCfgClock);
+  uartCfgState = UART_CFG_IDLE;
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdCP
+ *
+ * @brief   AT#CP<profile>, pin the connection parameters to gaming,
+ *          typing or idle, or let auto follow the input.
+ *
+ * @param   pArgs - parsed command, pRest = profile name.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdCP(const cmdArgs_t *pArgs)
+{
+  uint8_t i;
+
+  for (i = 0;
+       i < sizeof(hidEmuKbdConnProfiles) / sizeof(hidEmuKbdConnProfiles[0]);
+       i++)
+  {
+    if ((pArgs->restLen == strlen(hidEmuKbdConnProfiles[i])) &&
+        (memcmp(pArgs->pRest, hidEmuKbdConnProfiles[i], pArgs->restLen) == 0))
+    {
+      DebugPrint((HidDev_SetParameter(HIDDEV_CONN_PROFILE, sizeof(uint8_t),
+                                      &i) == SUCCESS) ?
+                 "\r\nOK\r\n" : "\r\nER\r\n");
+      return;
+    }
+  }
+
+  DebugPrint("\r\nER\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_cmdCQ
+ *
+ * @brief   AT#CQ<ms>, set how long input has to be quiet before the auto
+ *          profile relaxes to idle.
+ *
+ * @param   pArgs - parsed command, val[0] = time in ms, 1..65535.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_cmdCQ(const cmdArgs_t *pArgs)
+{
+  uint16_t quietTime = (uint16_t)pArgs->val[0];
+
+  if ((pArgs->val[0] > 0xFFFF) ||
+      (HidDev_SetParameter(HIDDEV_CONN_QUIET_TIME, sizeof(uint16_t),
+                           &quietTime) != SUCCESS))
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  DebugPrint("\r\nOK\r\n");
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_uartCfgRequest
+ *
+ * @brief   Accept a UART setting change and schedule the switch once the
+ *          answer has gone out.
+ *
+ * @param   baud - new baud rate.
+ * @param   flowCtrl - new RTS/CTS setting.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_uartCfgRequest(uint32 baud, uint8 flowCtrl)
+{
+  if ((uartCfgState != UART_CFG_IDLE) ||
+      (baud < NPI_UART_BR_MIN) || (baud > NPI_UART_BR_MAX))
+  {
+    DebugPrint("\r\nER\r\n");
+    return;
+  }
+
+  uartCfgBaud = baud;
+  uartCfgFlowCtrl = flowCtrl;
+  uartCfgState = UART_CFG_SWITCH;
+  DebugPrint("\r\nOK\r\n");
+  Util_restartClock(&uartCfgClock, HIDEMUKBD_UART_SWITCH_DELAY);
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_uartCfgEvt
+ *
+ * @brief   Switch to the requested UART setting, or roll back if it was
+ *          not confirmed in time.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void HidEmuKbd_uartCfgEvt(void)
+{
+  if (uartCfgState == UART_CFG_SWITCH)
+  {
+    // Still sending at the old setting
+    if (!NPITLUART_txIdle())
+    {
+      Util_restartClock(&uartCfgClock, HIDEMUKBD_UART_SWITCH_DELAY);
+      return;
+    }
+
+    uartCfgPrevBaud = NPITLUART_getBaud();
+    uartCfgPrevFlowCtrl = NPITLUART_getFlowCtrl();
+    if (!NPITLUART_reconfigure(uartCfgBaud, uartCfgFlowCtrl))
+    {
+      uartCfgState = UART_CFG_IDLE;
+      return;
+    }
+
+    uartCfgState = UART_CFG_CONFIRM;
+    Util_restartClock(&uartCfgClock, HIDEMUKBD_UART_CONFIRM_TIMEOUT);
+  }
+  else if (uartCfgState == UART_CFG_CONFIRM)
+  {
+    // No AT#BC, the host cannot hear us at the new setting
+    NPITLUART_reconfigure(uartCfgPrevBaud, uartCfgPrevFlowCtrl);
+    uartCfgState = UART_CFG_IDLE;
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_frameReport
+ *
+ * @brief   Report frame, send each [id len data] record as is.
+ *
+ * @param   pBody - frame body.
+ * @param   len - frame body length.
+ *
+ * @return  UART_FRAME_STATUS_* code
+ */
+static uint8_t HidEmuKbd_frameReport(const uint8_t *pBody, uint8_t len)
+{
+  uint8_t offset = 0;
+  uint8_t id;
+  uint8_t rptLen;
+  const uint8_t *pData;
+  uint8_t ret;
+
+  while ((ret = UARTFrame_nextRecord(pBody, len, &offset, &id, &rptLen,
+                                     &pData)) == UART_FRAME_COMPLETE)
+  {
+    HidEmuKbd_latencySample();
+    HidDev_Report(id, HID_REPORT_TYPE_INPUT, rptLen, (uint8_t *)pData);
+  }
+
+  return (ret == UART_FRAME_ERROR) ? UART_FRAME_STATUS_BAD_RECORD :
+                                     UART_FRAME_STATUS_OK;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_frameKeys
+ *
+ * @brief   Keys frame, the same press/release pair as AT#HP for each
+ *          [modifier usage]. A body of odd length is refused whole.
+ *
+ * @param   pBody - frame body.
+ * @param   len - frame body length.
+ *
+ * @return  UART_FRAME_STATUS_* code
+ */
+static uint8_t HidEmuKbd_frameKeys(const uint8_t *pBody, uint8_t len)
+{
+  if (len & 1)
+  {
+    return UART_FRAME_STATUS_BAD_RECORD;
+  }
+
+  // The parser holds the next command until these are queued
+  keysLen = len;
+  keysIdx = 0;
+  keysRelease = FALSE;
+  memcpy(keysBuf, pBody, keysLen);
+
+  HidEmuKbd_pumpKeys();
+
+  return UART_FRAME_STATUS_OK;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_frameText
+ *
+ * @brief   Text frame, type the body.
+ *
+ * @param   pBody - frame body.
+ * @param   len - frame body length.
+ *
+ * @return  UART_FRAME_STATUS_* code
+ */
+static uint8_t HidEmuKbd_frameText(const uint8_t *pBody, uint8_t len)
+{
+  return HidEmuKbd_typeText(pBody, len) ? UART_FRAME_STATUS_OK :
+                                          UART_FRAME_STATUS_BAD_LEN;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_frameChord
+ *
+ * @brief   Chord frame, replace the whole key state with [modifiers
+ *          usage...] and send it as one report. A single zero byte
+ *          releases everything.
+ *
+ * @param   pBody - frame body.
+ * @param   len - frame body length.
+ *
+ * @return  UART_FRAME_STATUS_* code
+ */
+static uint8_t HidEmuKbd_frameChord(const uint8_t *pBody, uint8_t len)
+{
+  uint8_t i;
+
+  if ((len == 0) || (len > 1 + KBD_STATE_MAX_KEYS))
+  {
+    return UART_FRAME_STATUS_BAD_RECORD;
+  }
+
+  KbdState_init(&kbdState);
+  kbdState.modifiers = pBody[0];
+  for (i = 1; i < len; i++)
+  {
+    (void)KbdState_press(&kbdState, pBody[i]);
+  }
+
+  HidEmuKbd_sendReport(0, KEY_NONE);
+
+  return UART_FRAME_STATUS_OK;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_sendFrameStatus
+ *
+ * @brief   Send a status frame to the host.
+ *
+ * @param   status - UART_FRAME_STATUS_*.
+ *
+ * @return  none
+ */
+static void HidEmuKbd_sendFrameStatus(uint8_t status)
+{
+  uint8_t frame[UART_FRAME_ENC_MAX(1)];
+
+  NPITLUART_writeBuf(frame, UARTFrame_encode(UART_FRAME_TYPE_STATUS, &status,
+                                             1, frame));
+}
+
+#ifdef USE_HID_MOUSE
+/*********************************************************************
+ * @fn      HidEmuKbd_sendMouseReport
+ *
+ * @brief   Build and send a HID mouse report.
+ *
+ * @param   buttons - Mouse button code
+ *
+ * @return  none
+ */
+static void HidEmuKbd_sendMouseReport(uint8_t buttons)
+{
+  uint8_t buf[HID_MOUSE_IN_RPT_LEN];
+
+  buf[0] = buttons;   // Buttons
+  buf[1] = 0;         // X
+  buf[2] = 0;         // Y
+  buf[3] = 0;         // Wheel
+  buf[4] = 0;         // AC Pan
+
+  HidDev_Report(HID_RPT_ID_MOUSE_IN, HID_REPORT_TYPE_INPUT,
+                HID_MOUSE_IN_RPT_LEN, buf);
+}
+#endif // USE_HID_MOUSE
+
+/*********************************************************************
+ * @fn      HidEmuKbd_receiveReport
+ *
+ * @brief   Process an incoming HID keyboard report.
+ *
+ * @param   len - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  status
+ */
+static uint8_t HidEmuKbd_receiveReport(uint8_t len, uint8_t *pData)
+{
+  // Verify data length
+  if (len == HID_LED_OUT_RPT_LEN)
+  {
+    // Set keyfob LEDs
+    //HalLedSet(HAL_LED_1, ((*pData & LED_CAPS_LOCK) == LED_CAPS_LOCK));
+    //HalLedSet(HAL_LED_2, ((*pData & LED_NUM_LOCK) == LED_NUM_LOCK));
+
+    return SUCCESS;
+  }
+  else
+  {
+    return ATT_ERR_INVALID_VALUE_SIZE;
+  }
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_reportCB
+ *
+ * @brief   HID Dev report callback.
+ *
+ * @param   id - HID report ID.
+ * @param   type - HID report type.
+ * @param   uuid - attribute uuid.
+ * @param   oper - operation:  read, write, etc.
+ * @param   len - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  GATT status code.
+ */
+static uint8_t HidEmuKbd_reportCB(uint8_t id, uint8_t type, uint16_t uuid,
+                                  uint8_t oper, uint16_t *pLen, uint8_t *pData)
+{
+  uint8_t status = SUCCESS;
+
+  // Write
+  if (oper == HID_DEV_OPER_WRITE)
+  {
+    if (uuid == REPORT_UUID)
+    {
+      // Process write to LED output report; ignore others
+      if (type == HID_REPORT_TYPE_OUTPUT)
+      {
+        status = HidEmuKbd_receiveReport(*pLen, pData);
+      }
+    }
+
+    if (status == SUCCESS)
+    {
+      status = HidKbd_SetParameter(id, type, uuid, *pLen, pData);
+    }
+  }
+  // Read
+  else if (oper == HID_DEV_OPER_READ)
+  {
+    uint8_t len;
+
+    status = HidKbd_GetParameter(id, type, uuid, &len, pData);
+    if (status == SUCCESS)
+    {
+      *pLen = len;
+    }
+  }
+  // Nothing to do on notifications being enabled or disabled; the mouse
+  // report is only sent while HidDev_IsNotifyEnabled says so.
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn      HidEmuKbd_hidEventCB
+ *
+ * @brief   HID Dev event callback.
+ *
+ * @param   evt - event ID.
+ *
+ * @return  HID response code.
+ */
+static void HidEmuKbd_hidEventCB(uint8_t evt)
+{
+  // Runs in the HidDev task; resume typing in our own task.
+  if (evt == HID_DEV_REPORT_Q_SPACE_EVT)
+  {
+    Event_post(syncEvent, HIDEMUKBD_TEXT_EVT);
+  }
+
   // Process enter/exit suspend or enter/exit boot mode
   return;
 }
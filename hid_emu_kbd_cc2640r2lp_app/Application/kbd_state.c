@@ -0,0 +1,217 @@
+/******************************************************************************
+
+ @file       kbd_state.c
+
+ @brief This file contains the keyboard state engine. Keys stay held until
+        they are released, so the host sees real holds and chords and each
+        state change costs exactly one report.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "kbd_state.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define KBD_STATE_IS_MOD(u)   (((u) >= KBD_STATE_USAGE_MOD_FIRST) && \
+                               ((u) <= KBD_STATE_USAGE_MOD_LAST))
+
+#define KBD_STATE_MOD_BIT(u)  ((uint8_t)(1 << ((u) - KBD_STATE_USAGE_MOD_FIRST)))
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      kbdState_find
+ *
+ * @brief   Find a held usage.
+ *
+ * @param   pState - keyboard state.
+ * @param   usage - HID usage.
+ *
+ * @return  slot index, or KBD_STATE_MAX_KEYS if not held
+ */
+static uint8_t kbdState_find(const kbdState_t *pState, uint8_t usage)
+{
+  uint8_t i;
+
+  for (i = 0; i < pState->numKeys; i++)
+  {
+    if (pState->keys[i] == usage)
+    {
+      return i;
+    }
+  }
+
+  return KBD_STATE_MAX_KEYS;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      KbdState_init
+ *
+ * @brief   Release everything.
+ *
+ * @param   pState - keyboard state.
+ *
+ * @return  none
+ */
+void KbdState_init(kbdState_t *pState)
+{
+  memset(pState, 0, sizeof(kbdState_t));
+}
+
+/*********************************************************************
+ * @fn      KbdState_press
+ *
+ * @brief   Press a usage. Modifier usages (0xE0..0xE7) set their bit in
+ *          the modifier byte and never take a keycode slot.
+ *
+ * @param   pState - keyboard state.
+ * @param   usage - HID usage.
+ *
+ * @return  KBD_STATE_CHANGED, KBD_STATE_UNCHANGED if already held,
+ *          KBD_STATE_FULL if six keys are held, KBD_STATE_INVALID for 0
+ */
+uint8_t KbdState_press(kbdState_t *pState, uint8_t usage)
+{
+  if (usage == 0)
+  {
+    return KBD_STATE_INVALID;
+  }
+
+  if (KBD_STATE_IS_MOD(usage))
+  {
+    if (pState->modifiers & KBD_STATE_MOD_BIT(usage))
+    {
+      return KBD_STATE_UNCHANGED;
+    }
+
+    pState->modifiers |= KBD_STATE_MOD_BIT(usage);
+    return KBD_STATE_CHANGED;
+  }
+
+  if (kbdState_find(pState, usage) < KBD_STATE_MAX_KEYS)
+  {
+    return KBD_STATE_UNCHANGED;
+  }
+
+  if (pState->numKeys == KBD_STATE_MAX_KEYS)
+  {
+    return KBD_STATE_FULL;
+  }
+
+  pState->keys[pState->numKeys++] = usage;
+
+  return KBD_STATE_CHANGED;
+}
+
+/*********************************************************************
+ * @fn      KbdState_release
+ *
+ * @brief   Release a usage. Later keys move down one slot so the report
+ *          keeps press order without gaps.
+ *
+ * @param   pState - keyboard state.
+ * @param   usage - HID usage.
+ *
+ * @return  KBD_STATE_CHANGED or KBD_STATE_UNCHANGED if not held
+ */
+uint8_t KbdState_release(kbdState_t *pState, uint8_t usage)
+{
+  uint8_t i;
+
+  if (KBD_STATE_IS_MOD(usage))
+  {
+    if (!(pState->modifiers & KBD_STATE_MOD_BIT(usage)))
+    {
+      return KBD_STATE_UNCHANGED;
+    }
+
+    pState->modifiers &= (uint8_t)~KBD_STATE_MOD_BIT(usage);
+    return KBD_STATE_CHANGED;
+  }
+
+  i = kbdState_find(pState, usage);
+  if (i == KBD_STATE_MAX_KEYS)
+  {
+    return KBD_STATE_UNCHANGED;
+  }
+
+  pState->numKeys--;
+  for (; i < pState->numKeys; i++)
+  {
+    pState->keys[i] = pState->keys[i + 1];
+  }
+  pState->keys[pState->numKeys] = 0;
+
+  return KBD_STATE_CHANGED;
+}
+
+/*********************************************************************
+ * @fn      KbdState_releaseAll
+ *
+ * @brief   Release all keys and modifiers.
+ *
+ * @param   pState - keyboard state.
+ *
+ * @return  KBD_STATE_CHANGED if anything was held, else KBD_STATE_UNCHANGED
+ */
+uint8_t KbdState_releaseAll(kbdState_t *pState)
+{
+  if ((pState->modifiers == 0) && (pState->numKeys == 0))
+  {
+    return KBD_STATE_UNCHANGED;
+  }
+
+  KbdState_init(pState);
+
+  return KBD_STATE_CHANGED;
+}
+
+/*********************************************************************
+ * @fn      KbdState_lastKey
+ *
+ * @brief   Most recently pressed usage, for reports with a single keycode.
+ *
+ * @param   pState - keyboard state.
+ *
+ * @return  HID usage, 0 if no key is held
+ */
+uint8_t KbdState_lastKey(const kbdState_t *pState)
+{
+  return (pState->numKeys > 0) ? pState->keys[pState->numKeys - 1] : 0;
+}
+
+/*********************************************************************
+ * @fn      KbdState_buildReport
+ *
+ * @brief   Build the boot keyboard report.
+ *
+ * @param   pState - keyboard state.
+ * @param   pBuf - output, KBD_STATE_RPT_LEN bytes.
+ *
+ * @return  none
+ */
+void KbdState_buildReport(const kbdState_t *pState, uint8_t *pBuf)
+{
+  pBuf[0] = pState->modifiers;
+  pBuf[1] = 0;
+  memcpy(&pBuf[2], pState->keys, KBD_STATE_MAX_KEYS);
+}
+
+/*********************************************************************
+*********************************************************************/
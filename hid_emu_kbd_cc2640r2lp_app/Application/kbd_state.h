@@ -0,0 +1,100 @@
+/******************************************************************************
+
+ @file       kbd_state.h
+
+ @brief This file contains the interface to the keyboard state engine. It
+        tracks held modifiers and up to six held usages and builds the
+        matching 8 byte boot keyboard report.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef KBD_STATE_H
+#define KBD_STATE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Keycode slots in a boot keyboard report
+#define KBD_STATE_MAX_KEYS            6
+
+// Boot keyboard report: modifiers, reserved, six keycodes
+#define KBD_STATE_RPT_LEN             (2 + KBD_STATE_MAX_KEYS)
+
+// Modifier usages 0xE0 (left control) .. 0xE7 (right GUI) map to bits 0..7
+#define KBD_STATE_USAGE_MOD_FIRST     0xE0
+#define KBD_STATE_USAGE_MOD_LAST      0xE7
+
+// KbdState_press/release results
+#define KBD_STATE_UNCHANGED           0   // Already in that state, no report
+#define KBD_STATE_CHANGED             1   // Send one report
+#define KBD_STATE_FULL                2   // Six keys already held
+#define KBD_STATE_INVALID             3   // Usage 0 cannot be held
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Keyboard state
+typedef struct
+{
+  uint8_t modifiers;                    // Modifier bitmap
+  uint8_t numKeys;                      // Keys held
+  uint8_t keys[KBD_STATE_MAX_KEYS];     // Held usages in press order
+} kbdState_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Release everything.
+ */
+extern void KbdState_init(kbdState_t *pState);
+
+/*
+ * Press a usage, modifier usages set a modifier bit.
+ */
+extern uint8_t KbdState_press(kbdState_t *pState, uint8_t usage);
+
+/*
+ * Release a usage.
+ */
+extern uint8_t KbdState_release(kbdState_t *pState, uint8_t usage);
+
+/*
+ * Release everything, returns KBD_STATE_CHANGED if anything was held.
+ */
+extern uint8_t KbdState_releaseAll(kbdState_t *pState);
+
+/*
+ * Most recently pressed usage, 0 if none.
+ */
+extern uint8_t KbdState_lastKey(const kbdState_t *pState);
+
+/*
+ * Build the boot keyboard report, KBD_STATE_RPT_LEN bytes.
+ */
+extern void KbdState_buildReport(const kbdState_t *pState, uint8_t *pBuf);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KBD_STATE_H */
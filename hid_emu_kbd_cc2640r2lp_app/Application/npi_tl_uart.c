@@ -62,11 +62,21 @@
 #include "npi_tl_uart.h"
 #include <ti/drivers/UART.h>
 #include <ti/drivers/uart/UARTCC26XX.h>
+#include <ti/drivers/PIN.h>
+#include <ti/drivers/pin/PINCC26XX.h>
+#include <driverlib/ioc.h>
+#include <driverlib/uart.h>
 
 // ****************************************************************************
 // defines
 // ****************************************************************************
 
+#if (NPI_UART_TX_RING_SIZE & (NPI_UART_TX_RING_SIZE - 1)) != 0
+#error "NPI_UART_TX_RING_SIZE must be a power of two"
+#endif
+
+#define NPI_UART_TX_RING_MASK (NPI_UART_TX_RING_SIZE - 1)
+
 // ****************************************************************************
 // typedefs
 // ****************************************************************************
@@ -80,6 +90,29 @@ static UART_Handle uartHandle;
 //! \brief UART ISR Rx Buffer
 static Char isrRxBuf[UART_ISR_BUF_SIZE];
 
+//! \brief Current baud rate and RTS/CTS setting
+static uint32 uartBaud = NPI_UART_BR;
+static uint8 uartFlowCtrl = FALSE;
+
+//! \brief Set while the port is being reopened; callbacks must not start
+//!        new transfers on the old handle
+static volatile uint8 uartReopen = FALSE;
+
+//! \brief Set to stop reading once the read in progress completes, and
+//!        whether that has happened with no read left pending
+static volatile uint8 uartRxHold = FALSE;
+static volatile uint8 uartRxHeld = FALSE;
+
+//! \brief RTS/CTS pins, held only while hardware flow control is on
+static PIN_State uartFcPinState;
+static PIN_Handle uartFcPins = NULL;
+static PIN_Config uartFcPinCfg[] =
+{
+    NPI_UART_CTS_PIN | PIN_INPUT_EN | PIN_NOPULL,
+    NPI_UART_RTS_PIN | PIN_GPIO_OUTPUT_EN | PIN_GPIO_HIGH | PIN_PUSHPULL,
+    PIN_TERMINATE
+};
+
 //! \brief NPI TL call back function for the end of a UART transaction
 static npiCB_t npiTransmitCB = NULL;
 
@@ -106,6 +139,19 @@ static Char* TransportTxBuf;
 //! \brief Length of bytes to send from NPI TL Tx Buffer
 static uint16 TransportTxLen = 0;
 
+//! \brief UART TX ring. Head is only moved by writers in task context, tail
+//!        only by the write callback; both run free and are masked on use.
+//!        Writers from different tasks are serialized with Task_disable.
+static uint8 txRing[NPI_UART_TX_RING_SIZE];
+static volatile uint16 txRingHead = 0;
+static volatile uint16 txRingTail = 0;
+
+//! \brief Bytes handed to the in-flight UART_write, 0 when idle
+static volatile uint16 txRingActive = 0;
+
+//! \brief Bytes dropped because the TX ring was full
+static uint32 txRingDropped = 0;
+
 //! \brief UART Object. Initialized in board specific files
 extern UARTCC26XX_Object uartCC26XXObjects[];
 
@@ -122,6 +168,12 @@ static void NPITLUART_writeCallBack(UART_Handle handle, void *ptr, size_t size);
 //! \brief UART Callback invoked after readsize has been read or timeout
 static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size);
 
+//! \brief Start a UART_write of the next contiguous run of the TX ring
+static void NPITLUART_kickTx(void);
+
+//! \brief Open the UART with the current baud rate and flow control
+static void NPITLUART_openPort(void);
+
 // -----------------------------------------------------------------------------
 //! \brief      This routine initializes the transport layer and opens the port
 //!             of the device.
@@ -135,8 +187,6 @@ static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size);
 // -----------------------------------------------------------------------------
 void NPITLUART_initializeTransport(Char *tRxBuf, Char *tTxBuf, npiCB_t npiCBack)
 {
-    UART_Params params;
-
     TransportRxBuf = tRxBuf;
     TransportTxBuf = tTxBuf;
     npiTransmitCB = npiCBack;
@@ -144,9 +194,30 @@ void NPITLUART_initializeTransport(Char *tRxBuf, Char *tTxBuf, npiCB_t npiCBack)
     // Initialize the UART driver
     Board_initUART();
 
+    NPITLUART_openPort();
+
+#if (NPI_FLOW_CTRL == 0)
+    // This call will start repeated Uart Reads when Power Savings is disabled
+    NPITLUART_readTransport();
+#endif // NPI_FLOW_CTRL = 0
+
+    return;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine opens the UART with the current baud rate and
+//!             RTS/CTS setting.
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+static void NPITLUART_openPort(void)
+{
+    UART_Params params;
+    uint32 base;
+
     // Configure UART parameters.
     UART_Params_init(&params);
-    params.baudRate = NPI_UART_BR;
+    params.baudRate = uartBaud;
     params.readDataMode = UART_DATA_BINARY;
     params.writeDataMode = UART_DATA_BINARY;
     params.dataLength = UART_LEN_8;
@@ -163,13 +234,149 @@ void NPITLUART_initializeTransport(Char *tRxBuf, Char *tTxBuf, npiCB_t npiCBack)
     //Enable Partial Reads on all subsequent UART_read()
     UART_control(uartHandle, UARTCC26XX_CMD_RETURN_PARTIAL_ENABLE,  NULL);
 
+    // The board file leaves CTS/RTS unassigned, so route them here. The
+    // UART holds off standby while a read is pending, so the setting is
+    // not lost to a power down.
+    base = ((UARTCC26XX_HWAttrsV2 const *)(uartHandle->hwAttrs))->baseAddr;
+    if ( uartFlowCtrl )
+    {
+        if ( uartFcPins == NULL )
+        {
+            uartFcPins = PIN_open(&uartFcPinState, uartFcPinCfg);
+        }
+        if ( uartFcPins != NULL )
+        {
+            PINCC26XX_setMux(uartFcPins, NPI_UART_CTS_PIN, IOC_PORT_MCU_UART0_CTS);
+            PINCC26XX_setMux(uartFcPins, NPI_UART_RTS_PIN, IOC_PORT_MCU_UART0_RTS);
+            UARTHwFlowControlEnable(base);
+        }
+        else
+        {
+            uartFlowCtrl = FALSE;
+        }
+    }
+    else
+    {
+        UARTHwFlowControlDisable(base);
+        if ( uartFcPins != NULL )
+        {
+            PIN_close(uartFcPins);
+            uartFcPins = NULL;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine reopens the UART with a new baud rate and flow
+//!             control setting. Bytes received before the switch are still
+//!             handed to the NPI TL callback; pending output is dropped, so
+//!             callers wait for NPITLUART_txIdle first.
+//!
+//! \param[in]  baud - baud rate, NPI_UART_BR_MIN .. NPI_UART_BR_MAX
+//! \param[in]  flowCtrl - TRUE for RTS/CTS hardware flow control
+//!
+//! \return     uint8 - TRUE if the UART was reopened
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_reconfigure(uint32 baud, uint8 flowCtrl)
+{
+    ICall_CSState key;
+
+    if ( (uartHandle == NULL) || (baud < NPI_UART_BR_MIN) ||
+         (baud > NPI_UART_BR_MAX) )
+    {
+        return FALSE;
+    }
+
+    uartReopen = TRUE;
+    UART_readCancel(uartHandle);
+    UART_writeCancel(uartHandle);
+    UART_close(uartHandle);
+
+    key = ICall_enterCriticalSection();
+    txRingTail = txRingHead;
+    txRingActive = 0;
+    ICall_leaveCriticalSection(key);
+
+    uartBaud = baud;
+    uartFlowCtrl = flowCtrl ? TRUE : FALSE;
+    NPITLUART_openPort();
+    uartReopen = FALSE;
 
 #if (NPI_FLOW_CTRL == 0)
-    // This call will start repeated Uart Reads when Power Savings is disabled
     NPITLUART_readTransport();
 #endif // NPI_FLOW_CTRL = 0
 
-    return;
+    // Send anything queued while the port was closed
+    key = ICall_enterCriticalSection();
+    if ( txRingActive == 0 )
+    {
+        NPITLUART_kickTx();
+    }
+    ICall_leaveCriticalSection(key);
+
+    return TRUE;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine stops or resumes reading the UART. While held no
+//!             read is pending, so the RX FIFO fills and, with RTS/CTS on,
+//!             RTS holds the host off. Callable from the NPI TL callback.
+//!
+//! \param[in]  hold - TRUE to stop after the read in progress, FALSE to
+//!             read again
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITLUART_holdRead(uint8 hold)
+{
+    ICall_CSState key;
+    key = ICall_enterCriticalSection();
+
+    uartRxHold = hold;
+
+    // Restart reading if the read callback already stopped
+    if ( !hold && uartRxHeld )
+    {
+        uartRxHeld = FALSE;
+        if ( !uartReopen && (uartHandle != NULL) )
+        {
+            TransportRxLen = 0;
+            UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+        }
+    }
+
+    ICall_leaveCriticalSection(key);
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the current baud rate.
+//!
+//! \return     uint32 - baud rate
+// -----------------------------------------------------------------------------
+uint32 NPITLUART_getBaud(void)
+{
+    return uartBaud;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns whether RTS/CTS flow control is on.
+//!
+//! \return     uint8 - TRUE if on
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_getFlowCtrl(void)
+{
+    return uartFlowCtrl;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns TRUE when the TX ring is empty and no
+//!             write is in flight.
+//!
+//! \return     uint8 - TRUE if idle
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_txIdle(void)
+{
+    return (txRingHead == txRingTail) && (txRingActive == 0);
 }
 
 #if (NPI_FLOW_CTRL == 1)
@@ -259,6 +466,17 @@ static void NPITLUART_writeCallBack(UART_Handle handle, void *ptr, size_t size)
     ICall_CSState key;
     key = ICall_enterCriticalSection();
 
+    // Release the bytes just sent and chain the next write, if any
+    if ( txRingActive )
+    {
+        txRingTail += txRingActive;
+        txRingActive = 0;
+        if ( !uartReopen )
+        {
+            NPITLUART_kickTx();
+        }
+    }
+
 #if (NPI_FLOW_CTRL == 1)
     if ( !RxActive )
     {
@@ -335,7 +553,15 @@ static void NPITLUART_readCallBack(UART_Handle handle, void *ptr, size_t size)
         npiTransmitCB(size,0);
     }
     TransportRxLen = 0;
-    UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+    if ( uartRxHold )
+    {
+        // Leave the bytes in the FIFO until NPITLUART_holdRead(FALSE)
+        uartRxHeld = TRUE;
+    }
+    else if ( !uartReopen )
+    {
+        UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
+    }
 #endif // NPI_FLOW_CTRL = 1
     ICall_leaveCriticalSection(key);
 //  DebugPrint(TransportRxBuf);
@@ -380,6 +606,7 @@ void NPITLUART_readTransport(void)
 #endif // NPI_FLOW_CTRL = 1
 
     TransportRxLen = 0;
+    uartRxHeld = FALSE;
     UART_read(uartHandle, &isrRxBuf[0], UART_ISR_BUF_SIZE);
 
     ICall_leaveCriticalSection(key);
@@ -408,30 +635,137 @@ uint16 NPITLUART_writeTransport(uint16 len)
     // device
     NPITLUART_readTransport();
 #else
-    // Check to see if transport is successful. If not, reset TxLen to allow
-    // another write to be processed
-    if(UART_write(uartHandle, TransportTxBuf, TransportTxLen) == UART_ERROR )
-    {
-      TransportTxLen = 0;
-    }
+    // Queue behind any pending output instead of writing over it
+    ICall_leaveCriticalSection(key);
+    return NPITLUART_writeBuf((const uint8 *)TransportTxBuf, len);
 #endif // NPI_FLOW_CTRL = 1
     ICall_leaveCriticalSection(key);
 
     return TransportTxLen;
 }
 
-void DebugPrint(const char *strings)
+// -----------------------------------------------------------------------------
+//! \brief      This routine starts a UART_write of the next contiguous run of
+//!             the TX ring. Must be called with interrupts disabled and no
+//!             write in flight.
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+static void NPITLUART_kickTx(void)
+{
+    uint16 tail = txRingTail;
+    uint16 len = txRingHead - tail;
+    uint16 toEnd = NPI_UART_TX_RING_SIZE - (tail & NPI_UART_TX_RING_MASK);
+
+    if ( len == 0 )
+    {
+        return;
+    }
+
+    // A write cannot wrap; the rest follows from the write callback
+    if ( len > toEnd )
+    {
+        len = toEnd;
+    }
+
+    txRingActive = len;
+    if ( UART_write(uartHandle, &txRing[tail & NPI_UART_TX_RING_MASK], len) == UART_ERROR )
+    {
+        // Drop what is queued rather than stall the ring
+        txRingDropped += (uint16)(txRingHead - tail);
+        txRingTail = txRingHead;
+        txRingActive = 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine queues bytes on the UART TX ring and starts a
+//!             write if none is in flight. Callable from any task, not from
+//!             a Hwi or Swi. The copy only holds off other tasks; interrupts
+//!             are disabled just to publish the head and start the write.
+//!
+//! \param[in]  pData - bytes to send
+//! \param[in]  len - number of bytes
+//!
+//! \return     uint16 - len if queued, 0 if the ring has no room for all of it
+// -----------------------------------------------------------------------------
+uint16 NPITLUART_writeBuf(const uint8 *pData, uint16 len)
 {
-    if(NULL == TransportTxBuf||NULL==strings) return;
     ICall_CSState key;
-    uint16 len= strlen(strings);
-    if(len == 0) return;
+    UInt taskKey;
+    uint16 head;
+    uint16 idx;
+    uint16 toEnd;
+
+    if ( (uartHandle == NULL) || (pData == NULL) || (len == 0) )
+    {
+        return 0;
+    }
+
+    taskKey = Task_disable();
+
+    head = txRingHead;
+    idx = head & NPI_UART_TX_RING_MASK;
+    toEnd = NPI_UART_TX_RING_SIZE - idx;
+
+    // All or nothing, so responses are never cut in half
+    if ( (uint16)(NPI_UART_TX_RING_SIZE - (uint16)(head - txRingTail)) < len )
+    {
+        txRingDropped += len;
+        Task_restore(taskKey);
+        return 0;
+    }
+
+    if ( len > toEnd )
+    {
+        memcpy(&txRing[idx], pData, toEnd);
+        memcpy(&txRing[0], pData + toEnd, len - toEnd);
+    }
+    else
+    {
+        memcpy(&txRing[idx], pData, len);
+    }
+
     key = ICall_enterCriticalSection();
-    TransportTxLen = (len >= 256?255:len);
-    memcpy(TransportTxBuf,strings,len);
-    if(UART_write(uartHandle, TransportTxBuf, TransportTxLen) == UART_ERROR )
+
+    txRingHead = head + len;
+    if ( (txRingActive == 0) && !uartReopen )
     {
-      TransportTxLen = 0;
+        NPITLUART_kickTx();
     }
+
     ICall_leaveCriticalSection(key);
+
+    Task_restore(taskKey);
+
+    return len;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the number of bytes dropped because the
+//!             UART TX ring was full.
+//!
+//! \return     uint32 - dropped bytes since power up
+// -----------------------------------------------------------------------------
+uint32 NPITLUART_txDropped(void)
+{
+    return txRingDropped;
+}
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine queues a NUL terminated string, see
+//!             NPITLUART_writeBuf.
+//!
+//! \param[in]  strings - string to send
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void DebugPrint(const char *strings)
+{
+    if ( NULL == strings )
+    {
+        return;
+    }
+
+    NPITLUART_writeBuf((const uint8 *)strings, strlen(strings));
 }
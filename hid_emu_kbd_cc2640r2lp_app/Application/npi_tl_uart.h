@@ -75,6 +75,24 @@ extern "C"
 #define UART_ISR_BUF_SIZE 32
 #define UART_ISR_BUF_CNT 2
 
+// Baud rate range accepted by NPITLUART_reconfigure
+#define NPI_UART_BR_MIN 9600
+#define NPI_UART_BR_MAX 3000000
+
+// RTS/CTS pins used when hardware flow control is on (LaunchPad defaults)
+#if !defined(NPI_UART_CTS_PIN)
+#define NPI_UART_CTS_PIN IOID_19
+#endif
+#if !defined(NPI_UART_RTS_PIN)
+#define NPI_UART_RTS_PIN IOID_18
+#endif
+
+// UART TX ring, power of two. DebugPrint and NPITLUART_writeBuf queue
+// here and the write callback chains UART_write calls until it is empty.
+#if !defined(NPI_UART_TX_RING_SIZE)
+#define NPI_UART_TX_RING_SIZE 512
+#endif
+
 // ****************************************************************************
 // typedefs
 // ****************************************************************************
@@ -140,7 +158,78 @@ void NPITLUART_stopTransfer(void);
 // -----------------------------------------------------------------------------
 void NPITLUART_handleMrdyEvent(void);
 
+// -----------------------------------------------------------------------------
+//! \brief      This routine reopens the UART with a new baud rate and flow
+//!             control setting. Pending output is dropped.
+//!
+//! \param[in]  baud - baud rate, NPI_UART_BR_MIN .. NPI_UART_BR_MAX
+//! \param[in]  flowCtrl - TRUE for RTS/CTS hardware flow control
+//!
+//! \return     uint8 - TRUE if the UART was reopened
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_reconfigure(uint32 baud, uint8 flowCtrl);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the current baud rate.
+//!
+//! \return     uint32 - baud rate
+// -----------------------------------------------------------------------------
+uint32 NPITLUART_getBaud(void);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine stops or resumes reading the UART. While held no
+//!             read is pending, so the RX FIFO fills and, with RTS/CTS on,
+//!             RTS holds the host off. Callable from the NPI TL callback.
+//!
+//! \param[in]  hold - TRUE to stop after the read in progress, FALSE to
+//!             read again
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
+void NPITLUART_holdRead(uint8 hold);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns whether RTS/CTS flow control is on.
+//!
+//! \return     uint8 - TRUE if on
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_getFlowCtrl(void);
 
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns TRUE when the TX ring is empty and no
+//!             write is in flight.
+//!
+//! \return     uint8 - TRUE if idle
+// -----------------------------------------------------------------------------
+uint8 NPITLUART_txIdle(void);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine queues bytes on the UART TX ring and starts a
+//!             write if none is in flight. It never blocks.
+//!
+//! \param[in]  pData - bytes to send
+//! \param[in]  len - number of bytes
+//!
+//! \return     uint16 - len if queued, 0 if the ring has no room for all of it
+// -----------------------------------------------------------------------------
+uint16 NPITLUART_writeBuf(const uint8 *pData, uint16 len);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine returns the number of bytes dropped because the
+//!             UART TX ring was full.
+//!
+//! \return     uint32 - dropped bytes since power up
+// -----------------------------------------------------------------------------
+uint32 NPITLUART_txDropped(void);
+
+// -----------------------------------------------------------------------------
+//! \brief      This routine queues a NUL terminated string, see
+//!             NPITLUART_writeBuf.
+//!
+//! \param[in]  strings - string to send
+//!
+//! \return     void
+// -----------------------------------------------------------------------------
 void DebugPrint(const char *strings);
 #ifdef __cplusplus
 }
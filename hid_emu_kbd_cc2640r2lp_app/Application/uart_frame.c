@@ -0,0 +1,355 @@
+/******************************************************************************
+
+ @file       uart_frame.c
+
+ @brief This file contains the binary framed UART protocol used to inject
+        HID reports alongside the AT text commands. A frame is length
+        prefixed and CRC checked and may carry several reports, so a burst
+        of reports costs a few bytes each instead of one ASCII line each.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "uart_frame.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Decoder states
+#define FRAME_STATE_IDLE              0   // Waiting for SOF
+#define FRAME_STATE_LEN               1
+#define FRAME_STATE_TYPE              2
+#define FRAME_STATE_BODY              3
+#define FRAME_STATE_CRC_LO            4
+#define FRAME_STATE_CRC_HI            5
+#define FRAME_STATE_HUNT              6   // Discarding until SOF or '\n'
+
+#define FRAME_CRC_INIT                0xFFFF
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Nibble table for CRC-16/CCITT, poly 0x1021
+static const uint16_t crcNibbleTbl[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      uartFrame_crcByte
+ *
+ * @brief   Update a CRC-16/CCITT with one byte.
+ *
+ * @param   crc - running CRC.
+ * @param   byte - data byte.
+ *
+ * @return  updated CRC
+ */
+static uint16_t uartFrame_crcByte(uint16_t crc, uint8_t byte)
+{
+  crc = (uint16_t)(crc << 4) ^ crcNibbleTbl[(crc >> 12) ^ (byte >> 4)];
+  crc = (uint16_t)(crc << 4) ^ crcNibbleTbl[(crc >> 12) ^ (byte & 0x0F)];
+
+  return crc;
+}
+
+/*********************************************************************
+ * @fn      uartFrame_put
+ *
+ * @brief   Write one frame byte after SOF, escaped if need be.
+ *
+ * @param   pBuf - output position.
+ * @param   byte - frame byte.
+ *
+ * @return  number of bytes written
+ */
+static uint8_t uartFrame_put(uint8_t *pBuf, uint8_t byte)
+{
+  // XON, XOFF and the escape byte
+  if ((byte == 0x11) || (byte == 0x13) || (byte == UART_FRAME_ESC))
+  {
+    pBuf[0] = UART_FRAME_ESC;
+    pBuf[1] = byte ^ UART_FRAME_ESC_XOR;
+
+    return 2;
+  }
+
+  pBuf[0] = byte;
+
+  return 1;
+}
+
+/*********************************************************************
+ * @fn      uartFrame_fail
+ *
+ * @brief   Drop the current frame and resynchronize.
+ *
+ * @param   pDec - decoder.
+ * @param   status - reason the frame was dropped.
+ *
+ * @return  UART_FRAME_ERROR
+ */
+static uint8_t uartFrame_fail(uartFrameDec_t *pDec, uint8_t status)
+{
+  pDec->status = status;
+  pDec->state = FRAME_STATE_HUNT;
+
+  return UART_FRAME_ERROR;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      UARTFrame_init
+ *
+ * @brief   Reset a frame decoder to wait for the next start of frame.
+ *
+ * @param   pDec - decoder.
+ *
+ * @return  none
+ */
+void UARTFrame_init(uartFrameDec_t *pDec)
+{
+  pDec->state = FRAME_STATE_IDLE;
+  pDec->status = UART_FRAME_STATUS_OK;
+  pDec->len = 0;
+  pDec->type = 0;
+  pDec->idx = 0;
+  pDec->esc = 0;
+  pDec->crc = FRAME_CRC_INIT;
+}
+
+/*********************************************************************
+ * @fn      UARTFrame_isActive
+ *
+ * @brief   Check whether the decoder owns the incoming byte stream. This is
+ *          the case inside a frame and while resynchronizing after a bad
+ *          frame; otherwise bytes belong to the AT text parser.
+ *
+ * @param   pDec - decoder.
+ *
+ * @return  TRUE if active, FALSE if idle
+ */
+uint8_t UARTFrame_isActive(uartFrameDec_t *pDec)
+{
+  return (pDec->state != FRAME_STATE_IDLE);
+}
+
+/*********************************************************************
+ * @fn      UARTFrame_input
+ *
+ * @brief   Feed one received byte to the decoder. While idle only
+ *          UART_FRAME_SOF is accepted. After a bad frame the decoder drops
+ *          bytes until the next SOF or the end of a text line. Escaped
+ *          bytes inside a frame are restored before they are used.
+ *
+ * @param   pDec - decoder.
+ * @param   byte - received byte.
+ *
+ * @return  UART_FRAME_PENDING, UART_FRAME_COMPLETE or UART_FRAME_ERROR
+ */
+uint8_t UARTFrame_input(uartFrameDec_t *pDec, uint8_t byte)
+{
+  if ((pDec->state != FRAME_STATE_IDLE) && (pDec->state != FRAME_STATE_HUNT))
+  {
+    if (pDec->esc)
+    {
+      pDec->esc = 0;
+      byte ^= UART_FRAME_ESC_XOR;
+    }
+    else if (byte == UART_FRAME_ESC)
+    {
+      pDec->esc = 1;
+      return UART_FRAME_PENDING;
+    }
+  }
+
+  switch (pDec->state)
+  {
+    case FRAME_STATE_IDLE:
+    case FRAME_STATE_HUNT:
+      if (byte == UART_FRAME_SOF)
+      {
+        pDec->crc = FRAME_CRC_INIT;
+        pDec->state = FRAME_STATE_LEN;
+      }
+      else if (byte == '\n')
+      {
+        pDec->state = FRAME_STATE_IDLE;
+      }
+      break;
+
+    case FRAME_STATE_LEN:
+      if (byte > UART_FRAME_MAX_BODY)
+      {
+        return uartFrame_fail(pDec, UART_FRAME_STATUS_BAD_LEN);
+      }
+
+      pDec->len = byte;
+      pDec->idx = 0;
+      pDec->crc = uartFrame_crcByte(pDec->crc, byte);
+      pDec->state = FRAME_STATE_TYPE;
+      break;
+
+    case FRAME_STATE_TYPE:
+      pDec->type = byte;
+      pDec->crc = uartFrame_crcByte(pDec->crc, byte);
+      pDec->state = (pDec->len > 0) ? FRAME_STATE_BODY : FRAME_STATE_CRC_LO;
+      break;
+
+    case FRAME_STATE_BODY:
+      pDec->body[pDec->idx++] = byte;
+      pDec->crc = uartFrame_crcByte(pDec->crc, byte);
+      if (pDec->idx == pDec->len)
+      {
+        pDec->state = FRAME_STATE_CRC_LO;
+      }
+      break;
+
+    case FRAME_STATE_CRC_LO:
+      if (byte != (uint8_t)(pDec->crc & 0xFF))
+      {
+        return uartFrame_fail(pDec, UART_FRAME_STATUS_BAD_CRC);
+      }
+
+      pDec->state = FRAME_STATE_CRC_HI;
+      break;
+
+    case FRAME_STATE_CRC_HI:
+      if (byte != (uint8_t)(pDec->crc >> 8))
+      {
+        return uartFrame_fail(pDec, UART_FRAME_STATUS_BAD_CRC);
+      }
+
+      pDec->state = FRAME_STATE_IDLE;
+      return UART_FRAME_COMPLETE;
+
+    default:
+      UARTFrame_init(pDec);
+      break;
+  }
+
+  return UART_FRAME_PENDING;
+}
+
+/*********************************************************************
+ * @fn      UARTFrame_nextRecord
+ *
+ * @brief   Walk the report records of a UART_FRAME_TYPE_REPORT body. Each
+ *          record is a report ID, a data length and the report data.
+ *
+ * @param   pBody - frame body.
+ * @param   len - frame body length.
+ * @param   pOffset - in/out offset of the next record, start at 0.
+ * @param   pId - output, report ID.
+ * @param   pLen - output, report length.
+ * @param   ppData - output, pointer to the report data in the frame body.
+ *
+ * @return  UART_FRAME_COMPLETE if a record was returned, UART_FRAME_PENDING
+ *          at the end of the body, UART_FRAME_ERROR if a record is truncated
+ */
+uint8_t UARTFrame_nextRecord(const uint8_t *pBody, uint8_t len,
+                             uint8_t *pOffset, uint8_t *pId, uint8_t *pLen,
+                             const uint8_t **ppData)
+{
+  uint8_t offset = *pOffset;
+  uint8_t rptLen;
+
+  if (offset >= len)
+  {
+    return UART_FRAME_PENDING;
+  }
+
+  if ((len - offset) < UART_FRAME_RECORD_HDR_LEN)
+  {
+    return UART_FRAME_ERROR;
+  }
+
+  rptLen = pBody[offset + 1];
+  if ((len - offset - UART_FRAME_RECORD_HDR_LEN) < rptLen)
+  {
+    return UART_FRAME_ERROR;
+  }
+
+  *pId = pBody[offset];
+  *pLen = rptLen;
+  *ppData = &pBody[offset + UART_FRAME_RECORD_HDR_LEN];
+  *pOffset = offset + UART_FRAME_RECORD_HDR_LEN + rptLen;
+
+  return UART_FRAME_COMPLETE;
+}
+
+/*********************************************************************
+ * @fn      UARTFrame_encode
+ *
+ * @brief   Encode a frame, escaping the bytes after SOF. pBuf must hold
+ *          UART_FRAME_ENC_MAX(len) bytes.
+ *
+ * @param   type - frame type.
+ * @param   pBody - frame body, may be NULL if len is 0.
+ * @param   len - body length.
+ * @param   pBuf - output buffer.
+ *
+ * @return  number of bytes written to pBuf
+ */
+uint16_t UARTFrame_encode(uint8_t type, const uint8_t *pBody, uint8_t len,
+                          uint8_t *pBuf)
+{
+  uint16_t crc = FRAME_CRC_INIT;
+  uint16_t pos = 1;
+  uint8_t i;
+
+  pBuf[0] = UART_FRAME_SOF;
+  pos += uartFrame_put(&pBuf[pos], len);
+  pos += uartFrame_put(&pBuf[pos], type);
+  crc = uartFrame_crcByte(crc, len);
+  crc = uartFrame_crcByte(crc, type);
+  for (i = 0; i < len; i++)
+  {
+    pos += uartFrame_put(&pBuf[pos], pBody[i]);
+    crc = uartFrame_crcByte(crc, pBody[i]);
+  }
+
+  pos += uartFrame_put(&pBuf[pos], (uint8_t)(crc & 0xFF));
+  pos += uartFrame_put(&pBuf[pos], (uint8_t)(crc >> 8));
+
+  return pos;
+}
+
+/*********************************************************************
+ * @fn      UARTFrame_crc16
+ *
+ * @brief   CRC-16/CCITT update over a buffer.
+ *
+ * @param   crc - running CRC, 0xFFFF for a new frame.
+ * @param   pData - data.
+ * @param   len - data length.
+ *
+ * @return  updated CRC
+ */
+uint16_t UARTFrame_crc16(uint16_t crc, const uint8_t *pData, uint16_t len)
+{
+  while (len--)
+  {
+    crc = uartFrame_crcByte(crc, *pData++);
+  }
+
+  return crc;
+}
+
+/*********************************************************************
+*********************************************************************/
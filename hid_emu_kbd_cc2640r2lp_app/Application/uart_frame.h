@@ -0,0 +1,142 @@
+/******************************************************************************
+
+ @file       uart_frame.h
+
+ @brief This file contains the interface to the binary framed UART protocol
+        used to inject HID reports alongside the AT text commands.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Frame layout on the wire (CRC is little endian, computed over LEN..BODY):
+//
+//   | SOF | LEN | TYPE | BODY[LEN] | CRC16 |
+//
+// SOF is not a printable character, so a frame can never be mistaken for
+// the start of an AT command line.
+#define UART_FRAME_SOF                0xA5
+
+// After SOF the XON and XOFF characters (0x11, 0x13) and the escape byte
+// itself go out as UART_FRAME_ESC and the byte XOR UART_FRAME_ESC_XOR, so
+// software flow control never finds them inside a frame. LEN counts and
+// the CRC covers the bytes before escaping.
+#define UART_FRAME_ESC                0x7D
+#define UART_FRAME_ESC_XOR            0x20
+
+// Bytes added around the body: SOF, LEN, TYPE and the two CRC bytes
+#define UART_FRAME_OVERHEAD           5
+
+// Largest encoded frame for a body of len bytes, all escaped
+#define UART_FRAME_ENC_MAX(len)       (1 + 2 * ((len) + UART_FRAME_OVERHEAD - 1))
+
+// Largest body accepted by the decoder
+#ifndef UART_FRAME_MAX_BODY
+#define UART_FRAME_MAX_BODY           64
+#endif
+
+// Frame types
+#define UART_FRAME_TYPE_REPORT        0x01  // [id len data[len]]...
+#define UART_FRAME_TYPE_KEYS          0x02  // [modifier usage]..., press+release
+#define UART_FRAME_TYPE_TEXT          0x03  // ASCII text typed by the device
+#define UART_FRAME_TYPE_CHORD         0x04  // [modifiers usage[0..6]], held
+#define UART_FRAME_TYPE_STATUS        0x7F  // [status], device to host only
+
+// Size of a report record header in a UART_FRAME_TYPE_REPORT body
+#define UART_FRAME_RECORD_HDR_LEN     2
+
+// Decoder results
+#define UART_FRAME_PENDING            0     // Frame incomplete, feed more bytes
+#define UART_FRAME_COMPLETE           1     // Frame received, CRC checked
+#define UART_FRAME_ERROR              2     // Bad length or CRC, frame dropped
+
+// Status codes carried by UART_FRAME_TYPE_STATUS
+#define UART_FRAME_STATUS_OK          0x00
+#define UART_FRAME_STATUS_BAD_CRC     0x01
+#define UART_FRAME_STATUS_BAD_LEN     0x02
+#define UART_FRAME_STATUS_BAD_TYPE    0x03
+#define UART_FRAME_STATUS_BAD_RECORD  0x04
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Frame decoder state
+typedef struct
+{
+  uint8_t  state;                       // Receive state
+  uint8_t  status;                      // Status of last failed frame
+  uint8_t  len;                         // Body length of current frame
+  uint8_t  type;                        // Type of current frame
+  uint8_t  idx;                         // Body bytes received so far
+  uint8_t  esc;                         // TRUE after UART_FRAME_ESC
+  uint16_t crc;                         // Running CRC
+  uint8_t  body[UART_FRAME_MAX_BODY];   // Frame body
+} uartFrameDec_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Reset a frame decoder to wait for the next start of frame.
+ */
+extern void UARTFrame_init(uartFrameDec_t *pDec);
+
+/*
+ * Returns TRUE while the decoder is inside a frame or resynchronizing
+ * after a bad one, i.e. while it owns the incoming byte stream.
+ */
+extern uint8_t UARTFrame_isActive(uartFrameDec_t *pDec);
+
+/*
+ * Feed one received byte to the decoder.
+ */
+extern uint8_t UARTFrame_input(uartFrameDec_t *pDec, uint8_t byte);
+
+/*
+ * Walk the report records of a UART_FRAME_TYPE_REPORT body.
+ */
+extern uint8_t UARTFrame_nextRecord(const uint8_t *pBody, uint8_t len,
+                                    uint8_t *pOffset, uint8_t *pId,
+                                    uint8_t *pLen, const uint8_t **ppData);
+
+/*
+ * Encode a frame into pBuf, which holds UART_FRAME_ENC_MAX(len) bytes,
+ * returns the number of bytes written.
+ */
+extern uint16_t UARTFrame_encode(uint8_t type, const uint8_t *pBody,
+                                 uint8_t len, uint8_t *pBuf);
+
+/*
+ * CRC-16/CCITT (poly 0x1021) update over a buffer.
+ */
+extern uint16_t UARTFrame_crc16(uint16_t crc, const uint8_t *pData,
+                                uint16_t len);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_FRAME_H */
@@ -370,6 +370,10 @@ bStatus_t Batt_GetParameter(uint8_t param, void *value)
         pRpt->handle = battAttrTbl[BATT_LEVEL_VALUE_IDX].handle;
         pRpt->pCccdAttr = &battAttrTbl[BATT_LEVEL_VALUE_CCCD_IDX];
         pRpt->mode = HID_PROTOCOL_MODE_REPORT;
+        pRpt->coalesce = HID_RPT_COALESCE_REPLACE;
+        pRpt->prio = HID_RPT_PRIO_STREAM;
+        pRpt->depth = 1;
+        pRpt->share = 1;
       }
       break;
 
@@ -75,7 +75,7 @@ extern "C"
 #define BATT_LEVEL_NOTI_DISABLED        2
 
 // HID Report IDs for the service
-#define HID_RPT_ID_BATT_LEVEL_IN        4  // Battery Level input report ID
+#define HID_RPT_ID_BATT_LEVEL_IN        5  // Battery Level input report ID
 
 /*********************************************************************
  * TYPEDEFS
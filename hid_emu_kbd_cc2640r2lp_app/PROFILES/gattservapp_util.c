@@ -52,6 +52,8 @@
 /* This Header file contains all BLE API and icall structure definition */
 #include "icall_ble_api.h"
 
+#include "gattservapp_util.h"
+
 /*********************************************************************
  * MACROS
  */
@@ -80,12 +82,25 @@
  * LOCAL VARIABLES
  */
 
+// Client characteristic configuration table slot + 1 by connection
+// handle, 0 if none
+static uint8 gattServAppConnSlot[GATT_SERV_APP_MAX_CONN_HANDLES];
+
+// Slots held by connections, one bit per slot
+static uint32 gattServAppSlotsUsed = 0;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
 
 static gattCharCfg_t *gattServApp_FindCharCfgItem( uint16 connHandle,
                                                    gattCharCfg_t *charCfgTbl );
+static gattCharCfg_t *gattServApp_FreeCharCfgItem( uint16 connHandle,
+                                                   gattCharCfg_t *charCfgTbl );
+static bStatus_t gattServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl,
+                                             gattAttribute_t *pAttr,
+                                             uint8 authenticated, uint8 taskId,
+                                             pfnGATTReadAttrCB_t pfnReadAttrCB );
 static bStatus_t gattServApp_SendNotiInd( uint16 connHandle, uint8 cccValue,
                                           uint8 authenticated, gattAttribute_t *pAttr,
                                           uint8 taskId, pfnGATTReadAttrCB_t pfnReadAttrCB );
@@ -152,9 +167,6 @@ bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *pValue,
                                       uint16 numAttrs, uint8 taskId,
                                       pfnGATTReadAttrCB_t pfnReadAttrCB )
 {
-  uint8 i;
-  bStatus_t status = SUCCESS;
-
   // Verify input parameters
   if ( ( charCfgTbl == NULL ) || ( pValue == NULL ) ||
        ( attrTbl == NULL )    || ( pfnReadAttrCB == NULL ) )
@@ -162,35 +174,11 @@ bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *pValue,
     return ( INVALIDPARAMETER );
   }
 
-  for ( i = 0; i < linkDBNumConns; i++ )
-  {
-    gattCharCfg_t *pItem = &(charCfgTbl[i]);
-
-    if ( ( pItem->connHandle != INVALID_CONNHANDLE ) &&
-         ( pItem->value != GATT_CFG_NO_OPERATION ) )
-    {
-      gattAttribute_t *pAttr;
-
-      // Find the characteristic value attribute
-      pAttr = GATTServApp_FindAttr( attrTbl, numAttrs, pValue );
-      if ( pAttr != NULL )
-      {
-        if ( pItem->value & GATT_CLIENT_CFG_NOTIFY )
-        {
-           status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_NOTIFY,
-                                              authenticated, pAttr, taskId, pfnReadAttrCB );
-        }
-
-        if ( pItem->value & GATT_CLIENT_CFG_INDICATE )
-        {
-           status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_INDICATE,
-                                              authenticated, pAttr, taskId, pfnReadAttrCB );
-        }
-      }
-    }
-  } // for
-
-  return ( status );
+  // Find the characteristic value attribute
+  return ( gattServApp_ProcessCharCfg( charCfgTbl,
+                                       GATTServApp_FindAttr( attrTbl, numAttrs,
+                                                             pValue ),
+                                       authenticated, taskId, pfnReadAttrCB ) );
 }
 
 /*********************************************************************
@@ -221,6 +209,65 @@ gattAttribute_t *GATTServApp_FindAttr( gattAttribute_t *pAttrTbl,
   return ( (gattAttribute_t *)NULL );
 }
 
+/*********************************************************************
+ * @fn      GATTServApp_LinkUp
+ *
+ * @brief   Give a new connection the lowest free slot in the client
+ *          characteristic configuration tables, so its entries are
+ *          found without a scan.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  none
+ */
+void GATTServApp_LinkUp( uint16 connHandle )
+{
+  uint8 i;
+
+  if ( ( connHandle >= GATT_SERV_APP_MAX_CONN_HANDLES ) ||
+       ( gattServAppConnSlot[connHandle] != 0 ) )
+  {
+    return;
+  }
+
+  for ( i = 0; ( i < linkDBNumConns ) && ( i < 32 ); i++ )
+  {
+    if ( ( gattServAppSlotsUsed & ( 1UL << i ) ) == 0 )
+    {
+      gattServAppSlotsUsed |= ( 1UL << i );
+      gattServAppConnSlot[connHandle] = i + 1;
+      break;
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_LinkDown
+ *
+ * @brief   Free the client characteristic configuration slot of a
+ *          connection.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  none
+ */
+void GATTServApp_LinkDown( uint16 connHandle )
+{
+  uint8 slot;
+
+  if ( connHandle >= GATT_SERV_APP_MAX_CONN_HANDLES )
+  {
+    return;
+  }
+
+  slot = gattServAppConnSlot[connHandle];
+  if ( slot != 0 )
+  {
+    gattServAppSlotsUsed &= ~( 1UL << ( slot - 1 ) );
+    gattServAppConnSlot[connHandle] = 0;
+  }
+}
+
 /*********************************************************************
  * @fn      GATTServApp_ProcessCCCWriteReq
  *
@@ -333,7 +380,7 @@ uint8 GATTServApp_WriteCharCfg( uint16 connHandle, gattCharCfg_t *charCfgTbl,
   pItem = gattServApp_FindCharCfgItem( connHandle, charCfgTbl );
   if ( pItem == NULL )
   {
-    pItem = gattServApp_FindCharCfgItem( INVALID_CONNHANDLE, charCfgTbl );
+    pItem = gattServApp_FreeCharCfgItem( connHandle, charCfgTbl );
     if ( pItem == NULL )
     {
       return ( ATT_ERR_INSUFFICIENT_RESOURCES );
@@ -352,8 +399,9 @@ uint8 GATTServApp_WriteCharCfg( uint16 connHandle, gattCharCfg_t *charCfgTbl,
  * @fn      gattServApp_FindCharCfgItem
  *
  * @brief   Find the characteristic configuration for a given client.
- *          Uses the connection handle to search the characteristic
- *          configuration table of a client.
+ *          Looks in the slot of the connection first; entries written
+ *          elsewhere (before link up, or by the stack restoring a bond)
+ *          are found by searching the table.
  *
  * @param   connHandle - connection handle (0xFFFF for empty entry)
  * @param   charCfgTbl - characteristic configuration table.
@@ -364,6 +412,16 @@ static gattCharCfg_t *gattServApp_FindCharCfgItem( uint16 connHandle,
                                                    gattCharCfg_t *charCfgTbl )
 {
   uint8 i;
+
+  if ( connHandle < GATT_SERV_APP_MAX_CONN_HANDLES )
+  {
+    i = gattServAppConnSlot[connHandle];
+    if ( ( i != 0 ) && ( charCfgTbl[i - 1].connHandle == connHandle ) )
+    {
+      return ( &(charCfgTbl[i - 1]) );
+    }
+  }
+
   for ( i = 0; i < linkDBNumConns; i++ )
   {
     if ( charCfgTbl[i].connHandle == connHandle )
@@ -376,6 +434,86 @@ static gattCharCfg_t *gattServApp_FindCharCfgItem( uint16 connHandle,
   return ( (gattCharCfg_t *)NULL );
 }
 
+/*********************************************************************
+ * @fn      gattServApp_FreeCharCfgItem
+ *
+ * @brief   Find an empty characteristic configuration entry for a new
+ *          client, the slot of the connection if it is empty.
+ *
+ * @param   connHandle - connection handle.
+ * @param   charCfgTbl - characteristic configuration table.
+ *
+ * @return  pointer to the empty item. NULL, if the table is full.
+ */
+static gattCharCfg_t *gattServApp_FreeCharCfgItem( uint16 connHandle,
+                                                   gattCharCfg_t *charCfgTbl )
+{
+  uint8 i;
+
+  if ( connHandle < GATT_SERV_APP_MAX_CONN_HANDLES )
+  {
+    i = gattServAppConnSlot[connHandle];
+    if ( ( i != 0 ) &&
+         ( charCfgTbl[i - 1].connHandle == INVALID_CONNHANDLE ) )
+    {
+      return ( &(charCfgTbl[i - 1]) );
+    }
+  }
+
+  return ( gattServApp_FindCharCfgItem( INVALID_CONNHANDLE, charCfgTbl ) );
+}
+
+/*********************************************************************
+ * @fn      gattServApp_ProcessCharCfg
+ *
+ * @brief   Send the characteristic value to every client that enabled
+ *          notifications or indications.
+ *
+ * @param   charCfgTbl - characteristic configuration table.
+ * @param   pAttr - characteristic value attribute, NULL if not found.
+ * @param   authenticated - whether an authenticated link is required.
+ * @param   taskId - task to be notified of confirmation.
+ * @param   pfnReadAttrCB - read callback function pointer.
+ *
+ * @return  Success or Failure
+ */
+static bStatus_t gattServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl,
+                                             gattAttribute_t *pAttr,
+                                             uint8 authenticated, uint8 taskId,
+                                             pfnGATTReadAttrCB_t pfnReadAttrCB )
+{
+  uint8 i;
+  bStatus_t status = SUCCESS;
+
+  if ( pAttr == NULL )
+  {
+    return ( SUCCESS );
+  }
+
+  for ( i = 0; i < linkDBNumConns; i++ )
+  {
+    gattCharCfg_t *pItem = &(charCfgTbl[i]);
+
+    if ( ( pItem->connHandle != INVALID_CONNHANDLE ) &&
+         ( pItem->value != GATT_CFG_NO_OPERATION ) )
+    {
+      if ( pItem->value & GATT_CLIENT_CFG_NOTIFY )
+      {
+         status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_NOTIFY,
+                                            authenticated, pAttr, taskId, pfnReadAttrCB );
+      }
+
+      if ( pItem->value & GATT_CLIENT_CFG_INDICATE )
+      {
+         status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_INDICATE,
+                                            authenticated, pAttr, taskId, pfnReadAttrCB );
+      }
+    }
+  } // for
+
+  return ( status );
+}
+
  /*********************************************************************
  * @fn      gattServApp_SendNotiInd
  *
@@ -0,0 +1,63 @@
+/******************************************************************************
+
+ @file       gattservapp_util.h
+
+ @brief This file contains what was added to the GATT Server Application
+        utility functions: a connection handle to client characteristic
+        configuration slot map kept on link up and link down.
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef GATTSERVAPP_UTIL_H
+#define GATTSERVAPP_UTIL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall_ble_api.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Connection handles below this get a fixed slot in every client
+// characteristic configuration table; others are found by a scan.
+#ifndef GATT_SERV_APP_MAX_CONN_HANDLES
+  #define GATT_SERV_APP_MAX_CONN_HANDLES      8
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Give a new connection its slot in the client characteristic
+ * configuration tables. Called by the GAP role on link up.
+ */
+extern void GATTServApp_LinkUp( uint16 connHandle );
+
+/*
+ * Free the slot of a connection. Called by the GAP role on link down.
+ */
+extern void GATTServApp_LinkDown( uint16 connHandle );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GATTSERVAPP_UTIL_H */
@@ -0,0 +1,366 @@
+/******************************************************************************
+
+ @file       hid_desc.h
+
+ @brief Composite HID report map, hidRptMap_t skeleton and report pack
+        functions. Generated by tools/hid_desc_gen, do not edit; change the
+        sources and run make -C tools hid-desc.
+
+        Sources: ../keyboard.h:keyboard
+                 ../Desc1_customer.hid:consumer:2
+                 ../Desc1.hid:gamepad
+                 ../system.hid:system:4
+
+ Group: CMCU, SCS
+ Target Device: CC2640R2
+
+ *****************************************************************************/
+
+#ifndef HID_DESC_H
+#define HID_DESC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Report IDs
+#define HID_DESC_KEYBOARD_ID                        1
+#define HID_DESC_CONSUMER_ID                        2
+#define HID_DESC_GAMEPAD_ID                         3
+#define HID_DESC_SYSTEM_ID                          4
+
+// keyboard input report: bit offset, size and logical range of each field
+#define HID_DESC_KEYBOARD_IN_LEN                    8
+#define HID_DESC_KEYBOARD_IN_MODIFIERS_BIT          0
+#define HID_DESC_KEYBOARD_IN_MODIFIERS_SIZE         8
+#define HID_DESC_KEYBOARD_IN_KEYS_BIT               16
+#define HID_DESC_KEYBOARD_IN_KEYS_SIZE              8
+#define HID_DESC_KEYBOARD_IN_KEYS_COUNT             6
+#define HID_DESC_KEYBOARD_IN_KEYS_MIN               0
+#define HID_DESC_KEYBOARD_IN_KEYS_MAX               101
+
+// keyboard output report: bit offset, size and logical range of each field
+#define HID_DESC_KEYBOARD_OUT_LEN                   1
+#define HID_DESC_KEYBOARD_OUT_LEDS_BIT              0
+#define HID_DESC_KEYBOARD_OUT_LEDS_SIZE             5
+
+// keyboard feature report: bit offset, size and logical range of each field
+#define HID_DESC_KEYBOARD_FEATURE_LEN               1
+#define HID_DESC_KEYBOARD_FEATURE_UFF00_0001_BIT    0
+#define HID_DESC_KEYBOARD_FEATURE_UFF00_0001_SIZE   8
+#define HID_DESC_KEYBOARD_FEATURE_UFF00_0001_MIN    0
+#define HID_DESC_KEYBOARD_FEATURE_UFF00_0001_MAX    255
+
+// consumer input report: bit offset, size and logical range of each field
+#define HID_DESC_CONSUMER_IN_LEN                    1
+#define HID_DESC_CONSUMER_IN_USAGE_BIT              0
+#define HID_DESC_CONSUMER_IN_USAGE_SIZE             8
+#define HID_DESC_CONSUMER_IN_USAGE_MIN              1
+#define HID_DESC_CONSUMER_IN_USAGE_MAX              23
+#define HID_DESC_CONSUMER_IN_USAGE_USAGES \
+  { 0x80, 0x81, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, \
+    0x46, 0x47, 0x48, 0x60, 0x61, 0x62, 0xB0, 0xB1, \
+    0xB4, 0xB3, 0xB5, 0xB6, 0xB7, 0xE9, 0xEA }
+
+// gamepad input report: bit offset, size and logical range of each field
+#define HID_DESC_GAMEPAD_IN_LEN                     10
+#define HID_DESC_GAMEPAD_IN_HAT_BIT                 8
+#define HID_DESC_GAMEPAD_IN_HAT_SIZE                8
+#define HID_DESC_GAMEPAD_IN_HAT_MIN                 0
+#define HID_DESC_GAMEPAD_IN_HAT_MAX                 7
+#define HID_DESC_GAMEPAD_IN_BUTTONS_BIT             16
+#define HID_DESC_GAMEPAD_IN_BUTTONS_SIZE            15
+#define HID_DESC_GAMEPAD_IN_X_BIT                   32
+#define HID_DESC_GAMEPAD_IN_X_SIZE                  8
+#define HID_DESC_GAMEPAD_IN_X_MIN                   0
+#define HID_DESC_GAMEPAD_IN_X_MAX                   255
+#define HID_DESC_GAMEPAD_IN_Y_BIT                   40
+#define HID_DESC_GAMEPAD_IN_Y_SIZE                  8
+#define HID_DESC_GAMEPAD_IN_Y_MIN                   0
+#define HID_DESC_GAMEPAD_IN_Y_MAX                   255
+#define HID_DESC_GAMEPAD_IN_Z_BIT                   48
+#define HID_DESC_GAMEPAD_IN_Z_SIZE                  8
+#define HID_DESC_GAMEPAD_IN_Z_MIN                   0
+#define HID_DESC_GAMEPAD_IN_Z_MAX                   255
+#define HID_DESC_GAMEPAD_IN_RZ_BIT                  56
+#define HID_DESC_GAMEPAD_IN_RZ_SIZE                 8
+#define HID_DESC_GAMEPAD_IN_RZ_MIN                  0
+#define HID_DESC_GAMEPAD_IN_RZ_MAX                  255
+#define HID_DESC_GAMEPAD_IN_BRAKE_BIT               64
+#define HID_DESC_GAMEPAD_IN_BRAKE_SIZE              8
+#define HID_DESC_GAMEPAD_IN_BRAKE_MIN               0
+#define HID_DESC_GAMEPAD_IN_BRAKE_MAX               255
+#define HID_DESC_GAMEPAD_IN_ACCELERATOR_BIT         72
+#define HID_DESC_GAMEPAD_IN_ACCELERATOR_SIZE        8
+#define HID_DESC_GAMEPAD_IN_ACCELERATOR_MIN         0
+#define HID_DESC_GAMEPAD_IN_ACCELERATOR_MAX         255
+
+// system input report: bit offset, size and logical range of each field
+#define HID_DESC_SYSTEM_IN_LEN                      1
+#define HID_DESC_SYSTEM_IN_USAGE_BIT                0
+#define HID_DESC_SYSTEM_IN_USAGE_SIZE               8
+#define HID_DESC_SYSTEM_IN_USAGE_MIN                1
+#define HID_DESC_SYSTEM_IN_USAGE_MAX                8
+#define HID_DESC_SYSTEM_IN_USAGE_USAGES \
+  { 0x80, 0x85, 0x86, 0x89, 0x8A, 0x8B, 0x8C, 0x8D }
+
+// Report map, the collections one after the other
+#define HID_DESC_REPORT_MAP \
+  /* keyboard, ../keyboard.h */ \
+  0x05, 0x01,         /* Usage Page (Generic Desktop)                 */ \
+  0x09, 0x06,         /* Usage (Keyboard)                             */ \
+  0xA1, 0x01,         /* Collection (Application)                     */ \
+  0x85, 0x01,         /*   Report ID (1)                              */ \
+  0x05, 0x07,         /*   Usage Page (Key Codes)                     */ \
+  0x19, 0xE0,         /*   Usage Min (0xE0)                           */ \
+  0x29, 0xE7,         /*   Usage Max (0xE7)                           */ \
+  0x15, 0x00,         /*   Logical Min (0)                            */ \
+  0x25, 0x01,         /*   Logical Max (1)                            */ \
+  0x75, 0x01,         /*   Report Size (1)                            */ \
+  0x95, 0x08,         /*   Report Count (8)                           */ \
+  0x81, 0x02,         /*   Input: (Data, Variable, Absolute)          */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x81, 0x01,         /*   Input: (Constant)                          */ \
+  0x95, 0x05,         /*   Report Count (5)                           */ \
+  0x75, 0x01,         /*   Report Size (1)                            */ \
+  0x05, 0x08,         /*   Usage Page (LEDs)                          */ \
+  0x19, 0x01,         /*   Usage Min (0x01)                           */ \
+  0x29, 0x05,         /*   Usage Max (0x05)                           */ \
+  0x91, 0x02,         /*   Output: (Data, Variable, Absolute)         */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x75, 0x03,         /*   Report Size (3)                            */ \
+  0x91, 0x01,         /*   Output: (Constant)                         */ \
+  0x95, 0x06,         /*   Report Count (6)                           */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x15, 0x00,         /*   Logical Min (0)                            */ \
+  0x25, 0x65,         /*   Logical Max (101)                          */ \
+  0x05, 0x07,         /*   Usage Page (Key Codes)                     */ \
+  0x19, 0x00,         /*   Usage Min (0x00)                           */ \
+  0x29, 0x65,         /*   Usage Max (0x65)                           */ \
+  0x81, 0x00,         /*   Input: (Data, Array, Absolute)             */ \
+  0x06, 0x00, 0xFF,   /*   Usage Page (Vendor Defined)                */ \
+  0x09, 0x01,         /*   Usage (0x01)                               */ \
+  0x26, 0xFF, 0x00,   /*   Logical Max (255)                          */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0xB1, 0x02,         /*   Feature: (Data, Variable, Absolute)        */ \
+  0xC0,               /* End Collection                               */ \
+  /* consumer, ../Desc1_customer.hid */ \
+  0x05, 0x0C,         /* Usage Page (Consumer Devices)                */ \
+  0x09, 0x01,         /* Usage (Consumer Control)                     */ \
+  0xA1, 0x01,         /* Collection (Application)                     */ \
+  0x85, 0x02,         /*   Report ID (2)                              */ \
+  0x09, 0x80,         /*   Usage (Selection)                          */ \
+  0x09, 0x81,         /*   Usage (Assign Selection)                   */ \
+  0x09, 0x40,         /*   Usage (Menu)                               */ \
+  0x09, 0x41,         /*   Usage (Menu Pick)                          */ \
+  0x09, 0x42,         /*   Usage (Menu Up)                            */ \
+  0x09, 0x43,         /*   Usage (Menu Down)                          */ \
+  0x09, 0x44,         /*   Usage (Menu Left)                          */ \
+  0x09, 0x45,         /*   Usage (Menu Right)                         */ \
+  0x09, 0x46,         /*   Usage (Menu Escape)                        */ \
+  0x09, 0x47,         /*   Usage (Menu Value Increase)                */ \
+  0x09, 0x48,         /*   Usage (Menu Value Decrease)                */ \
+  0x09, 0x60,         /*   Usage (Data On Screen)                     */ \
+  0x09, 0x61,         /*   Usage (Closed Caption)                     */ \
+  0x09, 0x62,         /*   Usage (Closed Caption Select)              */ \
+  0x09, 0xB0,         /*   Usage (Play)                               */ \
+  0x09, 0xB1,         /*   Usage (Pause)                              */ \
+  0x09, 0xB4,         /*   Usage (Rewind)                             */ \
+  0x09, 0xB3,         /*   Usage (Fast Forward)                       */ \
+  0x09, 0xB5,         /*   Usage (Scan Next Track)                    */ \
+  0x09, 0xB6,         /*   Usage (Scan Previous Track)                */ \
+  0x09, 0xB7,         /*   Usage (Stop)                               */ \
+  0x09, 0xE9,         /*   Usage (Volume Increment)                   */ \
+  0x09, 0xEA,         /*   Usage (Volume Decrement)                   */ \
+  0x15, 0x01,         /*   Logical Min (1)                            */ \
+  0x25, 0x17,         /*   Logical Max (23)                           */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x81, 0x00,         /*   Input: (Data, Array, Absolute)             */ \
+  0xC0,               /* End Collection                               */ \
+  /* gamepad, ../Desc1.hid */ \
+  0x05, 0x01,         /* Usage Page (Generic Desktop)                 */ \
+  0x09, 0x05,         /* Usage (Game Pad)                             */ \
+  0xA1, 0x01,         /* Collection (Application)                     */ \
+  0x85, 0x03,         /*   Report ID (3)                              */ \
+  0x75, 0x01,         /*   Report Size (1)                            */ \
+  0x95, 0x08,         /*   Report Count (8)                           */ \
+  0x81, 0x01,         /*   Input: (Constant)                          */ \
+  0x05, 0x01,         /*   Usage Page (Generic Desktop)               */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x15, 0x00,         /*   Logical Min (0)                            */ \
+  0x25, 0x07,         /*   Logical Max (7)                            */ \
+  0x46, 0x3B, 0x01,   /*   Physical Max (315)                         */ \
+  0x65, 0x14,         /*   Unit (Eng Rot: Degrees)                    */ \
+  0x09, 0x39,         /*   Usage (Hat Switch)                         */ \
+  0x81, 0x42,         /*   Input: (Data, Variable, Absolute, Null)    */ \
+  0x65, 0x00,         /*   Unit (None)                                */ \
+  0x05, 0x09,         /*   Usage Page (Button)                        */ \
+  0x25, 0x01,         /*   Logical Max (1)                            */ \
+  0x19, 0x01,         /*   Usage Min (0x01)                           */ \
+  0x29, 0x0F,         /*   Usage Max (0x0F)                           */ \
+  0x75, 0x01,         /*   Report Size (1)                            */ \
+  0x95, 0x0F,         /*   Report Count (15)                          */ \
+  0x81, 0x02,         /*   Input: (Data, Variable, Absolute)          */ \
+  0x75, 0x01,         /*   Report Size (1)                            */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x81, 0x01,         /*   Input: (Constant)                          */ \
+  0x05, 0x01,         /*   Usage Page (Generic Desktop)               */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x95, 0x02,         /*   Report Count (2)                           */ \
+  0x15, 0x00,         /*   Logical Min (0)                            */ \
+  0x26, 0xFF, 0x00,   /*   Logical Max (255)                          */ \
+  0x35, 0x00,         /*   Physical Min (0)                           */ \
+  0x46, 0xFF, 0x00,   /*   Physical Max (255)                         */ \
+  0xA1, 0x00,         /*   Collection (Physical)                      */ \
+  0x09, 0x30,         /*     Usage (X)                                */ \
+  0x09, 0x31,         /*     Usage (Y)                                */ \
+  0x81, 0x02,         /*     Input: (Data, Variable, Absolute)        */ \
+  0xC0,               /*   End Collection                             */ \
+  0xA1, 0x00,         /*   Collection (Physical)                      */ \
+  0x09, 0x32,         /*     Usage (Z)                                */ \
+  0x09, 0x35,         /*     Usage (Rz)                               */ \
+  0x81, 0x02,         /*     Input: (Data, Variable, Absolute)        */ \
+  0xC0,               /*   End Collection                             */ \
+  0x05, 0x02,         /*   Usage Page (Simulation Controls)           */ \
+  0x09, 0xC5,         /*   Usage (Brake)                              */ \
+  0x09, 0xC4,         /*   Usage (Accelerator)                        */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x95, 0x02,         /*   Report Count (2)                           */ \
+  0x15, 0x00,         /*   Logical Min (0)                            */ \
+  0x26, 0xFF, 0x00,   /*   Logical Max (255)                          */ \
+  0x35, 0x00,         /*   Physical Min (0)                           */ \
+  0x46, 0xFF, 0x00,   /*   Physical Max (255)                         */ \
+  0x81, 0x02,         /*   Input: (Data, Variable, Absolute)          */ \
+  0xC0,               /* End Collection                               */ \
+  /* system, ../system.hid */ \
+  0x05, 0x01,         /* Usage Page (Generic Desktop)                 */ \
+  0x09, 0x80,         /* Usage (System Control)                       */ \
+  0xA1, 0x01,         /* Collection (Application)                     */ \
+  0x85, 0x04,         /*   Report ID (4)                              */ \
+  0x09, 0x80,         /*   Usage (System Control)                     */ \
+  0x09, 0x85,         /*   Usage (System Main Menu)                   */ \
+  0x09, 0x86,         /*   Usage (System App Menu)                    */ \
+  0x09, 0x89,         /*   Usage (System Menu Select)                 */ \
+  0x09, 0x8A,         /*   Usage (System Menu Right)                  */ \
+  0x09, 0x8B,         /*   Usage (System Menu Left)                   */ \
+  0x09, 0x8C,         /*   Usage (System Menu Up)                     */ \
+  0x09, 0x8D,         /*   Usage (System Menu Down)                   */ \
+  0x15, 0x01,         /*   Logical Min (1)                            */ \
+  0x25, 0x08,         /*   Logical Max (8)                            */ \
+  0x95, 0x01,         /*   Report Count (1)                           */ \
+  0x75, 0x08,         /*   Report Size (8)                            */ \
+  0x81, 0x00,         /*   Input: (Data, Array, Absolute)             */ \
+  0xC0                /* End Collection                               */
+
+// hidRptMap_t skeleton: report ID, type and protocol mode of each report
+// in the map, input reports first; handles, CCCDs and queueing are
+// filled in when the service registers
+#define HID_DESC_KEYBOARD_IN_IDX                    0
+#define HID_DESC_CONSUMER_IN_IDX                    1
+#define HID_DESC_GAMEPAD_IN_IDX                     2
+#define HID_DESC_SYSTEM_IN_IDX                      3
+#define HID_DESC_NUM_INPUT_REPORTS                  4
+
+#define HID_DESC_KEYBOARD_OUT_IDX                   0
+#define HID_DESC_KEYBOARD_FEATURE_IDX               1
+#define HID_DESC_NUM_OTHER_REPORTS                  2
+
+#define HID_DESC_RPT_MAP_INPUT \
+  { 0, NULL, HID_DESC_KEYBOARD_ID, HID_REPORT_TYPE_INPUT, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }, \
+  { 0, NULL, HID_DESC_CONSUMER_ID, HID_REPORT_TYPE_INPUT, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }, \
+  { 0, NULL, HID_DESC_GAMEPAD_ID, HID_REPORT_TYPE_INPUT, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }, \
+  { 0, NULL, HID_DESC_SYSTEM_ID, HID_REPORT_TYPE_INPUT, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+#define HID_DESC_RPT_MAP_OTHER \
+  { 0, NULL, HID_DESC_KEYBOARD_ID, HID_REPORT_TYPE_OUTPUT, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }, \
+  { 0, NULL, HID_DESC_KEYBOARD_ID, HID_REPORT_TYPE_FEATURE, \
+    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \
+    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Pack the keyboard input report (report ID 1), HID_DESC_KEYBOARD_IN_LEN bytes.
+ */
+static inline void HidDesc_packKeyboardIn(uint8_t *buf, uint8_t modifiers,
+                                          const uint8_t *keys)
+{
+  buf[0] = modifiers;
+  buf[1] = 0;
+  buf[2] = keys[0];
+  buf[3] = keys[1];
+  buf[4] = keys[2];
+  buf[5] = keys[3];
+  buf[6] = keys[4];
+  buf[7] = keys[5];
+}
+
+/*
+ * Pack the consumer input report (report ID 2), HID_DESC_CONSUMER_IN_LEN bytes.
+ */
+static inline void HidDesc_packConsumerIn(uint8_t *buf, uint8_t usage)
+{
+  buf[0] = usage;
+}
+
+/*
+ * Pack the gamepad input report (report ID 3), HID_DESC_GAMEPAD_IN_LEN bytes.
+ */
+static inline void HidDesc_packGamepadIn(uint8_t *buf, uint8_t hat,
+                                         uint16_t buttons, uint8_t x,
+                                         uint8_t y, uint8_t z, uint8_t rz,
+                                         uint8_t brake, uint8_t accelerator)
+{
+  buf[0] = 0;
+  buf[1] = hat;
+  buf[2] = (uint8_t)buttons;
+  buf[3] = (uint8_t)((buttons >> 8) & 0x7F);
+  buf[4] = x;
+  buf[5] = y;
+  buf[6] = z;
+  buf[7] = rz;
+  buf[8] = brake;
+  buf[9] = accelerator;
+}
+
+/*
+ * Pack the system input report (report ID 4), HID_DESC_SYSTEM_IN_LEN bytes.
+ */
+static inline void HidDesc_packSystemIn(uint8_t *buf, uint8_t usage)
+{
+  buf[0] = usage;
+}
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_DESC_H */
@@ -104,6 +104,59 @@
  */
 #define HID_REPORT_READY_TIME                 1000
 
+// Maximum number of queued reports sent per HID_SEND_REPORT_EVT. Whatever
+// is left is sent on a re-posted event so other task events get a turn.
+#ifndef HID_DEV_SEND_BUDGET
+#define HID_DEV_SEND_BUDGET                   8
+#endif
+
+// Time in ms to wait before retrying when the controller is out of
+// notification buffers and no connection event notice has arrived yet to
+// bring the retry; about one connection event at the preferred connection
+// interval.
+#define HID_SEND_RETRY_TIME                   10
+
+// Hand reports to the controller just before each connection event anchor
+// point instead of as soon as they are produced. Can be changed at run time
+// with HIDDEV_CONN_EVT_ALIGN.
+#ifndef HID_DEV_CONN_EVT_ALIGN
+#define HID_DEV_CONN_EVT_ALIGN                FALSE
+#endif
+
+// Time in ms before the next anchor point at which pending reports are
+// submitted; covers the length of the previous connection event and the
+// time to send the queue down to the controller.
+#ifndef HID_CONN_EVT_GUARD_TIME
+#define HID_CONN_EVT_GUARD_TIME               3
+#endif
+
+// Connection event notice, as flagged in a BLE stack event
+#define HID_CONN_EVT_END_EVT                  0x0001
+
+// Connection parameter profile in use unless the host pins another
+#ifndef HID_DEV_CONN_PROFILE_DEFAULT
+#define HID_DEV_CONN_PROFILE_DEFAULT          HID_DEV_CONN_PROFILE_AUTO
+#endif
+
+// Time in ms without input after which the AUTO profile relaxes to idle
+#ifndef HID_DEV_CONN_QUIET_TIME
+#define HID_DEV_CONN_QUIET_TIME               5000
+#endif
+
+// Gaming profile: 7.5 ms interval, no slave latency, 2 s supervision timeout
+#define HID_GAMING_CONN_INTERVAL              6
+#define HID_GAMING_SLAVE_LATENCY              0
+#define HID_GAMING_CONN_TIMEOUT               200
+
+// Idle profile: 90-110 ms interval, slave latency 10, 6 s supervision timeout
+#define HID_IDLE_MIN_CONN_INTERVAL            72
+#define HID_IDLE_MAX_CONN_INTERVAL            88
+#define HID_IDLE_SLAVE_LATENCY                10
+#define HID_IDLE_CONN_TIMEOUT                 600
+
+// No connection parameter profile requested
+#define HID_DEV_CONN_PROFILE_NONE             0xFF
+
 #define HID_STATE_CHANGE_EVT                  0x0001
 #define HID_BATT_SERVICE_EVT                  0x0002
 #define HID_PASSCODE_EVT                      0x0004
@@ -115,14 +168,38 @@
 #define HID_BATT_PERIODIC_EVT                 Event_Id_00
 #define HID_IDLE_EVT                          Event_Id_01
 #define HID_SEND_REPORT_EVT                   Event_Id_02
+#define HID_CONN_QUIET_EVT                    Event_Id_03
 
 #define HID_ALL_EVENTS                        (HID_ICALL_EVT         | \
                                                HID_QUEUE_EVT         | \
                                                HID_BATT_PERIODIC_EVT | \
                                                HID_IDLE_EVT          | \
-                                               HID_SEND_REPORT_EVT)
+                                               HID_SEND_REPORT_EVT   | \
+                                               HID_CONN_QUIET_EVT)
+
+#define reportQEmpty()                        (hidDevReportQLen == 0)
+#define reportQFull()                         (hidDevReportQLen == HID_DEV_REPORT_Q_SIZE)
+
+// TRUE if a report of len bytes fits in the queue and its data pool.
+#define reportQFits(len)                      (!reportQFull() && \
+                                               ((hidDevReportDataLen + (len)) <= \
+                                                HID_DEV_REPORT_DATA_SIZE))
 
-#define reportQEmpty()                        (firstQIdx == lastQIdx)
+// TRUE if a notification failed only for lack of buffers and may be retried.
+#define sendRetryable(status)                 (((status) == MSG_BUFFER_NOT_AVAIL) || \
+                                               ((status) == bleMemAllocError)     || \
+                                               ((status) == bleNoResources))
+
+// The report queue is changed by the application task (enqueue, evict,
+// flush) and by the HidDev task (remove once sent). Each change runs with
+// the other task held off; stack calls block in ICall and must stay out.
+#define reportQLock()                         ICall_enterCriticalSection()
+#define reportQUnlock(key)                    ICall_leaveCriticalSection(key)
+
+// TRUE if reports wait for the connection event clock rather than go out
+// as soon as they are produced.
+#define reportDeferred()                      (hidDevConnEvtAlign && \
+                                               Util_isActive(&connEvtClock))
 
 #define HIDDEVICE_TASK_PRIORITY               2
 
@@ -134,14 +211,89 @@
  * CONSTANTS
  */
 
-#define HID_DEV_DATA_LEN                      9
+// Longest report. A notification carries at most ATT_MTU - 3 bytes, so
+// reports past 20 bytes need a larger ATT MTU.
+#ifndef HID_DEV_DATA_LEN
+  #define HID_DEV_DATA_LEN                    64
+#endif
+
+// ATT MTU asked for when connected: room for the longest report, and a
+// report map read in few Read Blob requests. The stack's MAX_PDU_SIZE
+// (251, set in the project options) caps what is agreed.
+#ifndef HID_DEV_MTU_SIZE
+  #define HID_DEV_MTU_SIZE                    247
+#endif
+
+// ATT notification header
+#define HID_DEV_NOTI_HDR_LEN                  3
+
+// Saturation limit of a summed relative report field
+#define HID_DEV_REL_MAX                       127
 
 #ifdef HID_DEV_RPT_QUEUE_LEN
-  #define HID_DEV_REPORT_Q_SIZE               (HID_DEV_RPT_QUEUE_LEN+1)
+  #define HID_DEV_REPORT_Q_SIZE               HID_DEV_RPT_QUEUE_LEN
 #else
-  #define HID_DEV_REPORT_Q_SIZE               (10+1)
+  #define HID_DEV_REPORT_Q_SIZE               10
+#endif
+
+// Data of all queued reports, packed; enough for reports of 16 bytes on
+// average.
+#ifndef HID_DEV_REPORT_DATA_SIZE
+  #define HID_DEV_REPORT_DATA_SIZE            (HID_DEV_REPORT_Q_SIZE * 16)
+#endif
+
+#if (HID_DEV_REPORT_DATA_SIZE < HID_DEV_DATA_LEN)
+  #error "HID_DEV_REPORT_DATA_SIZE must hold the longest report."
+#endif
+
+// Reports in the report table that get a bandwidth share and a last sent
+// cache; any beyond are neither limited nor deduplicated.
+#ifndef HID_DEV_MAX_REPORTS
+  #define HID_DEV_MAX_REPORTS                 8
+#endif
+
+// No report queue index
+#define HID_DEV_NO_REPORT                     0xFF
+
+// Reports in the report table whose notification state is mirrored in a
+// bitmap; the CCCD table is read for any beyond.
+#define HID_DEV_NOTIFY_MAX_REPORTS            32
+
+// Highest report ID found through the ID index; higher IDs are looked up
+// by scanning the report table.
+#ifndef HID_DEV_MAX_RPT_ID
+  #define HID_DEV_MAX_RPT_ID                  15
+#endif
+
+// Attribute handles covered by the handle index, counted from the lowest
+// report or CCCD handle; reports beyond are found by scanning the table.
+#ifndef HID_DEV_RPT_HANDLE_SPAN
+  #define HID_DEV_RPT_HANDLE_SPAN             64
+#endif
+
+// Handle index entries: report table index + 1, 0 for none, with
+// HID_DEV_RPT_IDX_CCCD set for a CCCD handle.
+#define HID_DEV_RPT_IDX_CCCD                  0x80
+#define HID_DEV_RPT_IDX_MASK                  0x7F
+
+// Attributes of the HID service covered by the attribute dispatch table;
+// any beyond are classified by UUID on each access.
+#ifndef HID_DEV_MAX_ATTRS
+  #define HID_DEV_MAX_ATTRS                   48
 #endif
 
+// Attribute kinds, indexing hidDevAttrOps
+#define HID_DEV_ATTR_NONE                     0
+#define HID_DEV_ATTR_REPORT                   1  // Report, boot keyboard output
+#define HID_DEV_ATTR_REPORT_IN                2  // Boot keyboard or mouse input
+#define HID_DEV_ATTR_REPORT_MAP               3
+#define HID_DEV_ATTR_INFO                     4
+#define HID_DEV_ATTR_REPORT_REF               5
+#define HID_DEV_ATTR_EXT_REPORT_REF           6
+#define HID_DEV_ATTR_PROTOCOL_MODE            7
+#define HID_DEV_ATTR_CTRL_PT                  8
+#define HID_DEV_ATTR_CCCD                     9
+
 // HID Auto Sync White List configuration parameter. This parameter should be
 // set to FALSE if the HID Host (i.e., the Master device) uses a Resolvable
 // Private Address (RPA). It should be set to TRUE, otherwise.
@@ -168,14 +320,60 @@ typedef struct
   uint8_t  uiOutputs;
 } hidDevPasscodeEvt_t;
 
+// Queued report
 typedef struct
 {
  uint8_t id;
  uint8_t type;
  uint8_t len;
- uint8_t data[HID_DEV_DATA_LEN];
+ uint8_t release;   // TRUE if queued as a release; never dropped
+ uint8_t sending;   // TRUE while the HidDev task sends it
+ uint8_t *pData;    // Data in the report data pool, in queue order
 } hidDevReport_t;
 
+// Report sent out
+typedef struct
+{
+ uint8_t id;
+ uint8_t type;
+ uint8_t len;
+ uint8_t data[HID_DEV_DATA_LEN];
+} hidDevLastReport_t;
+
+// Last report sent, for deduplication
+typedef struct
+{
+  uint32_t time;      // Clock ticks when sent
+  uint8_t  len;       // Length, 0 if none sent on this connection
+  uint8_t  data[HID_DEV_DATA_LEN];
+} hidDevSent_t;
+
+// Report reserved by HidDev_ReserveReport
+typedef struct
+{
+  uint8_t id;
+  uint8_t type;
+  uint8_t len;        // Reserved length
+  uint8_t inPlace;    // TRUE if pData is a stack notification buffer
+  uint8_t *pData;     // Buffer the application fills, NULL if none reserved
+} hidDevRsv_t;
+
+// Attribute read and write handlers, called once blob offsets are checked
+typedef bStatus_t (*hidDevAttrRead_t)(gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t *pLen, uint16_t offset,
+                                      uint16_t maxLen);
+typedef bStatus_t (*hidDevAttrWrite_t)(uint16_t connHandle,
+                                       gattAttribute_t *pAttr,
+                                       uint8_t *pValue, uint16_t len,
+                                       uint16_t offset);
+
+// Handlers of an attribute kind
+typedef struct
+{
+  hidDevAttrRead_t  pfnRead;
+  hidDevAttrWrite_t pfnWrite;
+} hidDevAttrOps_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -233,6 +431,18 @@ static hidRptMap_t *pHidDevRptTbl;
 
 static uint8_t hidDevRptTblLen;
 
+// Report table index + 1 by protocol mode, report type and ID, 0 if none
+static uint8_t hidDevRptIdIdx[2][HID_REPORT_TYPE_FEATURE][HID_DEV_MAX_RPT_ID + 1];
+
+// Report table entry by attribute handle offset, see HID_DEV_RPT_IDX_CCCD
+static uint16_t hidDevRptBaseHandle;
+static uint8_t hidDevRptHandleIdx[HID_DEV_RPT_HANDLE_SPAN];
+
+// Attribute kind by handle offset from the HID service declaration
+static uint16_t hidDevAttrBaseHandle;
+static uint16_t hidDevAttrCount = 0;
+static uint8_t hidDevAttrKind[HID_DEV_MAX_ATTRS];
+
 static hidDevCB_t *pHidDevCB;
 
 static hidDevCfg_t *pHidDevCfg;
@@ -240,13 +450,44 @@ static hidDevCfg_t *pHidDevCfg;
 // Whether to change to the preferred connection parameters
 static uint8_t updateConnParams = TRUE;
 
-// Pending reports
-static uint8_t firstQIdx = 0;
-static uint8_t lastQIdx = 0;
+// Pending reports, oldest first
+static uint8_t hidDevReportQLen = 0;
 static hidDevReport_t hidDevReportQ[HID_DEV_REPORT_Q_SIZE];
 
+// Data of the pending reports, packed in queue order, plus room past it
+// for a reserved report to be filled in
+static uint16_t hidDevReportDataLen = 0;
+static uint8_t hidDevReportData[HID_DEV_REPORT_DATA_SIZE + HID_DEV_DATA_LEN];
+
+// Report being filled in by the application
+static hidDevRsv_t hidDevRsv = { 0 };
+
+// Bandwidth credit left in this round, per report table entry
+static uint8_t hidDevRptCredit[HID_DEV_MAX_REPORTS];
+
+// Last report sent, per report table entry
+static hidDevSent_t hidDevRptSent[HID_DEV_MAX_REPORTS];
+
+// Reports not sent as identical to the last one
+static uint32_t hidDevDedupSkipped = 0;
+
+// Reports not sent as longer than the ATT MTU allows
+static uint32_t hidDevMtuDropped = 0;
+
+// Notifications enabled on this connection, bit per report table entry
+static uint32_t hidDevRptNotify = 0;
+
+// TRUE if HidDev_QueueReport refused a report because the queue was full
+static uint8_t hidDevReportQWaiting = FALSE;
+
 // Last report sent out
-static hidDevReport_t lastReport = { 0 };
+static hidDevLastReport_t lastReport = { 0 };
+
+// Report being sent out, noted before its buffer goes to the stack
+static hidDevLastReport_t hidDevSending;
+
+// Copy of the queued report the HidDev task is sending
+static hidDevLastReport_t hidDevQSend;
 
 // State when HID reports are ready to be sent out
 static volatile uint8_t hidDevReportReadyState = TRUE;
@@ -254,6 +495,33 @@ static volatile uint8_t hidDevReportReadyState = TRUE;
 // Report ready delay clock
 static Clock_Struct reportReadyClock;
 
+// Retry clock for reports the controller had no buffers for
+static Clock_Struct sendRetryClock;
+
+// Whether reports are aligned to connection events
+static uint8_t hidDevConnEvtAlign = HID_DEV_CONN_EVT_ALIGN;
+
+// TRUE once connection event notices arrive on this connection
+static uint8_t hidDevConnEvtNotice = FALSE;
+
+// TRUE while connection event notices are asked for
+static uint8_t hidDevConnEvtNoticeOn = FALSE;
+
+// Fires just before the next connection event anchor point
+static Clock_Struct connEvtClock;
+
+// Connection parameter profile, HID_DEV_CONN_PROFILE_AUTO unless pinned
+static uint8_t hidDevConnProfile = HID_DEV_CONN_PROFILE_DEFAULT;
+
+// Profile last requested on this connection
+static uint8_t hidDevConnProfileReq = HID_DEV_CONN_PROFILE_NONE;
+
+// Time in ms without input before the AUTO profile relaxes
+static uint16_t hidDevConnQuietTime = HID_DEV_CONN_QUIET_TIME;
+
+// Fires when input has been quiet for hidDevConnQuietTime
+static Clock_Struct connQuietClock;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -265,6 +533,10 @@ static void HidDev_processStackMsg(ICall_Hdr *pMsg);
 static void HidDev_processAppMsg(hidDevEvt_t *pMsg);
 static void HidDev_processGattMsg(gattMsgEvent_t *pMsg);
 static void HidDev_disconnected(void);
+static void HidDev_connEvtNotice(void);
+static void HidDev_connEvtNoticeEnable(uint8_t enable);
+static void HidDev_connActivity(void);
+static void HidDev_requestConnProfile(uint8_t profile);
 static void HidDev_highAdvertising(void);
 static void HidDev_lowAdvertising(void);
 static void HidDev_initialAdvertising(void);
@@ -277,11 +549,68 @@ static uint8_t HidDev_enqueueMsg(uint16_t event, uint8_t state,
 static hidRptMap_t *HidDev_reportByHandle(uint16_t handle);
 static hidRptMap_t *HidDev_reportById(uint8_t id, uint8_t type);
 static hidRptMap_t *HidDev_reportByCccdHandle(uint16_t handle);
+static uint8_t HidDev_classifyAttr(gattAttribute_t *pAttr);
+static bStatus_t HidDev_readNone(gattAttribute_t *pAttr, uint8_t *pValue,
+                                 uint16_t *pLen, uint16_t offset,
+                                 uint16_t maxLen);
+static bStatus_t HidDev_readReport(gattAttribute_t *pAttr, uint8_t *pValue,
+                                   uint16_t *pLen, uint16_t offset,
+                                   uint16_t maxLen);
+static bStatus_t HidDev_readReportMap(gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t *pLen, uint16_t offset,
+                                      uint16_t maxLen);
+static bStatus_t HidDev_readInfo(gattAttribute_t *pAttr, uint8_t *pValue,
+                                 uint16_t *pLen, uint16_t offset,
+                                 uint16_t maxLen);
+static bStatus_t HidDev_readReportRef(gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t *pLen, uint16_t offset,
+                                      uint16_t maxLen);
+static bStatus_t HidDev_readExtReportRef(gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t *pLen,
+                                         uint16_t offset, uint16_t maxLen);
+static bStatus_t HidDev_readProtocolMode(gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t *pLen,
+                                         uint16_t offset, uint16_t maxLen);
+static bStatus_t HidDev_writeNone(uint16_t connHandle, gattAttribute_t *pAttr,
+                                  uint8_t *pValue, uint16_t len,
+                                  uint16_t offset);
+static bStatus_t HidDev_writeReport(uint16_t connHandle,
+                                    gattAttribute_t *pAttr, uint8_t *pValue,
+                                    uint16_t len, uint16_t offset);
+static bStatus_t HidDev_writeCtrlPt(uint16_t connHandle,
+                                    gattAttribute_t *pAttr, uint8_t *pValue,
+                                    uint16_t len, uint16_t offset);
+static bStatus_t HidDev_writeCccd(uint16_t connHandle, gattAttribute_t *pAttr,
+                                  uint8_t *pValue, uint16_t len,
+                                  uint16_t offset);
+static bStatus_t HidDev_writeProtocolMode(uint16_t connHandle,
+                                          gattAttribute_t *pAttr,
+                                          uint8_t *pValue, uint16_t len,
+                                          uint16_t offset);
 static void HidDev_enqueueReport(uint8_t id, uint8_t type, uint8_t len,
                                  uint8_t *pData);
-static hidDevReport_t *HidDev_dequeueReport(void);
-static void HidDev_sendReport(uint8_t id, uint8_t type, uint8_t len,
-                              uint8_t *pData);
+static uint8_t HidDev_coalesceReport(uint8_t id, uint8_t type, uint8_t len,
+                                     uint8_t *pData);
+static uint8_t HidDev_isRelease(uint8_t id, uint8_t type, uint8_t len,
+                                uint8_t *pData);
+static uint8_t HidDev_makeRoom(uint8_t id, uint8_t type, uint8_t len,
+                               uint8_t release);
+static uint8_t HidDev_evictReport(uint8_t id, uint8_t type, uint8_t sameId,
+                                  uint8_t maxPrio);
+static uint8_t HidDev_countReports(uint8_t id, uint8_t type);
+static uint8_t HidDev_nextReport(void);
+static uint8_t HidDev_takeReport(hidDevLastReport_t *pOut);
+static void HidDev_finishReport(uint8_t sent);
+static uint8_t *HidDev_reportCredit(hidRptMap_t *pRpt);
+static hidDevSent_t *HidDev_reportSent(hidRptMap_t *pRpt);
+static uint8_t HidDev_notifyEnabled(hidRptMap_t *pRpt);
+static void HidDev_setNotify(hidRptMap_t *pRpt, uint8_t enable);
+static void HidDev_refreshNotify(void);
+static uint8_t HidDev_isDuplicate(hidRptMap_t *pRpt, uint8_t len,
+                                  uint8_t *pData);
+static void HidDev_removeReport(uint8_t idx);
+static uint8_t HidDev_sendReport(uint8_t id, uint8_t type, uint8_t len,
+                                 uint8_t *pData);
 static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData);
 static uint8_t HidDev_isbufset(uint8_t *buf, uint8_t val, uint8_t len);
 
@@ -329,6 +658,21 @@ static const gapBondCBs_t hidDevBondCB =
   HidDev_pairStateCB
 };
 
+// Attribute handlers by attribute kind
+static const hidDevAttrOps_t hidDevAttrOps[] =
+{
+  { HidDev_readNone,         HidDev_writeNone },         // NONE
+  { HidDev_readReport,       HidDev_writeReport },       // REPORT
+  { HidDev_readReport,       HidDev_writeNone },         // REPORT_IN
+  { HidDev_readReportMap,    HidDev_writeNone },         // REPORT_MAP
+  { HidDev_readInfo,         HidDev_writeNone },         // INFO
+  { HidDev_readReportRef,    HidDev_writeNone },         // REPORT_REF
+  { HidDev_readExtReportRef, HidDev_writeNone },         // EXT_REPORT_REF
+  { HidDev_readProtocolMode, HidDev_writeProtocolMode }, // PROTOCOL_MODE
+  { HidDev_readNone,         HidDev_writeCtrlPt },       // CTRL_PT
+  { HidDev_readNone,         HidDev_writeCccd }          // CCCD
+};
+
 /*********************************************************************
  * PUBLIC FUNCTIONS
  */
@@ -397,6 +741,9 @@ static void HidDev_init(void)
   GGS_AddService(GATT_ALL_SERVICES);         // GAP
   GATTServApp_AddService(GATT_ALL_SERVICES); // GATT attributes
 
+  // Initialize GATT Client, to exchange the ATT MTU.
+  GATT_InitClient();
+
   DevInfo_AddService();
   Batt_AddService();
   ScanParam_AddService();
@@ -410,6 +757,18 @@ static void HidDev_init(void)
   // Initialize report ready clock timer
   Util_constructClock(&reportReadyClock, HidDev_reportReadyClockCB,
                       HID_REPORT_READY_TIME, 0, false, NULL);
+
+  // Initialize send retry clock timer
+  Util_constructClock(&sendRetryClock, HidDev_clockHandler,
+                      HID_SEND_RETRY_TIME, 0, false, HID_SEND_REPORT_EVT);
+
+  // Initialize connection event clock timer
+  Util_constructClock(&connEvtClock, HidDev_clockHandler,
+                      HID_SEND_RETRY_TIME, 0, false, HID_SEND_REPORT_EVT);
+
+  // Initialize input quiet clock timer
+  Util_constructClock(&connQuietClock, HidDev_clockHandler,
+                      HID_DEV_CONN_QUIET_TIME, 0, false, HID_CONN_QUIET_EVT);
 }
 
 /*********************************************************************
@@ -447,8 +806,21 @@ static void HidDev_taskFxn(UArg a0, UArg a1)
       {
         if ((src == ICALL_SERVICE_CLASS_BLE) && (dest == selfEntity))
         {
-          // Process inter-task message.
-          HidDev_processStackMsg((ICall_Hdr *)pMsg);
+          ICall_Stack_Event *pEvt = (ICall_Stack_Event *)pMsg;
+
+          // Check for BLE stack events first
+          if (pEvt->signature == 0xffff)
+          {
+            if (pEvt->event_flag & HID_CONN_EVT_END_EVT)
+            {
+              HidDev_connEvtNotice();
+            }
+          }
+          else
+          {
+            // Process inter-task message.
+            HidDev_processStackMsg((ICall_Hdr *)pMsg);
+          }
         }
 
         if (pMsg)
@@ -499,28 +871,81 @@ static void HidDev_taskFxn(UArg a0, UArg a1)
         HidDev_battPeriodicTask();
       }
 
+      // Input quiet, relax the connection parameters.
+      if (events & HID_CONN_QUIET_EVT)
+      {
+        if ((hidDevGapState == GAPROLE_CONNECTED) &&
+            (hidDevConnProfile == HID_DEV_CONN_PROFILE_AUTO))
+        {
+          HidDev_requestConnProfile(HID_DEV_CONN_PROFILE_IDLE);
+        }
+      }
+
       // Send HID report event.
       if (events & HID_SEND_REPORT_EVT)
       {
         // If connection is secure
         if (hidDevConnSecure && hidDevReportReadyState)
         {
-          hidDevReport_t *pReport = HidDev_dequeueReport();
+          uint8_t budget = HID_DEV_SEND_BUDGET;
 
-          if (pReport != NULL)
+          // Send as many reports as the controller accepts, up to the budget.
+          // The report is sent from a copy: the stack calls block, and the
+          // application may change the queue meanwhile.
+          while ((budget > 0) && HidDev_takeReport(&hidDevQSend))
           {
-            // Send report.
-            HidDev_sendReport(pReport->id, pReport->type, pReport->len,
-                              pReport->data);
+            uint8_t *pCredit;
+            uint8_t status = HidDev_sendReport(hidDevQSend.id, hidDevQSend.type,
+                                               hidDevQSend.len,
+                                               hidDevQSend.data);
+
+            // Done once sent or if it never can be; else kept for a retry.
+            HidDev_finishReport(!sendRetryable(status));
+
+            if (sendRetryable(status))
+            {
+              // Out of buffers; keep the report at the head of the queue
+              // and retry once the controller has sent some out. The end
+              // of the next connection event brings the retry; the clock
+              // only covers links that have not had a notice yet.
+              if (!hidDevConnEvtNotice)
+              {
+                Util_restartClock(&sendRetryClock, HID_SEND_RETRY_TIME);
+              }
+              break;
+            }
+
+            pCredit = HidDev_reportCredit(HidDev_reportById(hidDevQSend.id,
+                                                            hidDevQSend.type));
+            if ((pCredit != NULL) && (*pCredit > 0))
+            {
+              (*pCredit)--;
+            }
+
+            budget--;
           }
 
-          // If there is another report in the queue
-          if (!reportQEmpty())
+          // Let a blocked producer refill the queue.
+          if ((budget < HID_DEV_SEND_BUDGET) && hidDevReportQWaiting)
+          {
+            hidDevReportQWaiting = FALSE;
+            (*pHidDevCB->evtCB)(HID_DEV_REPORT_Q_SPACE_EVT);
+          }
+
+          // If the budget ran out with reports still in the queue
+          if ((budget == 0) && !reportQEmpty())
           {
             // Set another event.
             Event_post(syncEvent, HID_SEND_REPORT_EVT);
           }
         }
+
+        // Wake on connection events only while they have work: reports
+        // left to retry, or reports to align.
+        if (hidDevGapState == GAPROLE_CONNECTED)
+        {
+          HidDev_connEvtNoticeEnable(hidDevConnEvtAlign || !reportQEmpty());
+        }
       }
     }
   }
@@ -572,7 +997,9 @@ void HidDev_Register(hidDevCfg_t *pCfg, hidDevCB_t *pCBs)
 /*********************************************************************
  * @fn      HidDev_RegisterReports
  *
- * @brief   Register the report table with HID Dev.
+ * @brief   Register the report table with HID Dev and index it by report
+ *          ID and by attribute handle, so reports are found without a
+ *          scan. Handles and IDs must not change once registered.
  *
  * @param   numReports - Length of report table.
  * @param   pRpt       - Report table.
@@ -581,8 +1008,96 @@ void HidDev_Register(hidDevCfg_t *pCfg, hidDevCB_t *pCBs)
  */
 void HidDev_RegisterReports(uint8_t numReports, hidRptMap_t *pRpt)
 {
+  uint8_t i;
+  uint16_t handle;
+  hidRptMap_t *p;
+
   pHidDevRptTbl = pRpt;
   hidDevRptTblLen = numReports;
+
+  memset(hidDevRptIdIdx, 0, sizeof(hidDevRptIdIdx));
+  memset(hidDevRptHandleIdx, 0, sizeof(hidDevRptHandleIdx));
+
+  // Index from the lowest handle in the table
+  hidDevRptBaseHandle = 0xFFFF;
+  for (i = 0, p = pRpt; i < numReports; i++, p++)
+  {
+    if (p->handle < hidDevRptBaseHandle)
+    {
+      hidDevRptBaseHandle = p->handle;
+    }
+    if ((p->pCccdAttr != NULL) &&
+        (p->pCccdAttr->handle < hidDevRptBaseHandle))
+    {
+      hidDevRptBaseHandle = p->pCccdAttr->handle;
+    }
+  }
+
+  // The first entry wins, as with a scan of the table
+  for (i = 0, p = pRpt; (i < numReports) && (i < HID_DEV_RPT_IDX_MASK);
+       i++, p++)
+  {
+    if ((p->id <= HID_DEV_MAX_RPT_ID) &&
+        (p->mode <= HID_PROTOCOL_MODE_REPORT) &&
+        (p->type >= HID_REPORT_TYPE_INPUT) &&
+        (p->type <= HID_REPORT_TYPE_FEATURE) &&
+        (hidDevRptIdIdx[p->mode][p->type - 1][p->id] == 0))
+    {
+      hidDevRptIdIdx[p->mode][p->type - 1][p->id] = i + 1;
+    }
+
+    handle = p->handle - hidDevRptBaseHandle;
+    if ((handle < HID_DEV_RPT_HANDLE_SPAN) &&
+        (hidDevRptHandleIdx[handle] == 0))
+    {
+      hidDevRptHandleIdx[handle] = i + 1;
+    }
+
+    if (p->pCccdAttr != NULL)
+    {
+      handle = p->pCccdAttr->handle - hidDevRptBaseHandle;
+      if ((handle < HID_DEV_RPT_HANDLE_SPAN) &&
+          (hidDevRptHandleIdx[handle] == 0))
+      {
+        hidDevRptHandleIdx[handle] = (i + 1) | HID_DEV_RPT_IDX_CCCD;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidDev_RegisterAttrs
+ *
+ * @brief   Register the HID service attribute table with HID Dev, after
+ *          GATTServApp_RegisterService has assigned its handles. Each
+ *          attribute is classified once, so the attribute callbacks
+ *          dispatch on the handle without comparing UUIDs.
+ *
+ * @param   pAttrs   - HID service attribute table.
+ * @param   numAttrs - Number of attributes.
+ *
+ * @return  None.
+ */
+void HidDev_RegisterAttrs(gattAttribute_t *pAttrs, uint16_t numAttrs)
+{
+  uint16_t i;
+
+  // Attributes beyond the table are classified on each access
+  hidDevAttrCount = 0;
+  hidDevAttrBaseHandle = pAttrs[0].handle;
+
+  for (i = 0; (i < numAttrs) && (i < HID_DEV_MAX_ATTRS); i++)
+  {
+    // Handles are assigned in table order without gaps
+    if (pAttrs[i].handle != hidDevAttrBaseHandle + i)
+    {
+      break;
+    }
+
+    hidDevAttrKind[i] = HidDev_classifyAttr(&pAttrs[i]);
+  }
+
+  hidDevAttrCount = i;
 }
 
 /*********************************************************************
@@ -611,13 +1126,17 @@ void HidDev_Report(uint8_t id, uint8_t type, uint8_t len, uint8_t *pData)
     // If connection is secure
     if (hidDevConnSecure)
     {
-      // Make sure there're no pending reports.
-      if (reportQEmpty())
+      // Make sure there're no pending reports and none are held for
+      // the next connection event.
+      if (reportQEmpty() && !reportDeferred())
       {
-        // Send report.
-        HidDev_sendReport(id, type, len, pData);
+        // Send report; queue it if the controller is out of buffers.
+        uint8_t status = HidDev_sendReport(id, type, len, pData);
 
-        return;
+        if (!sendRetryable(status))
+        {
+          return;
+        }
       }
     }
   }
@@ -631,6 +1150,209 @@ void HidDev_Report(uint8_t id, uint8_t type, uint8_t len, uint8_t *pData)
   HidDev_enqueueReport(id, type, len, pData);
 }
 
+/*********************************************************************
+ * @fn      HidDev_QueueReport
+ *
+ * @brief   Queue a HID report without ever discarding a queued one.
+ *          The HidDev task sends it in order behind any pending reports
+ *          of the same ID.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  SUCCESS, bleNoResources if the queue or the report's depth
+ *          in it is full, bleIncorrectMode if not bonded, bleInvalidRange
+ *          if the report is too long.
+ */
+bStatus_t HidDev_QueueReport(uint8_t id, uint8_t type, uint8_t len,
+                             uint8_t *pData)
+{
+  hidRptMap_t *pRpt;
+  ICall_CSState key;
+  uint8_t folded;
+
+  // Validate length of report
+  if (len > HID_DEV_DATA_LEN)
+  {
+    return bleInvalidRange;
+  }
+
+  // Reports are only queued for a bonded host.
+  if (HidDev_bondCount() == 0)
+  {
+    return bleIncorrectMode;
+  }
+
+  pRpt = HidDev_reportById(id, type);
+
+  key = reportQLock();
+
+  if (!reportQFits(len) ||
+      ((pRpt != NULL) && (pRpt->depth > 0) &&
+       (HidDev_countReports(id, type) >= pRpt->depth)))
+  {
+    // A report folded into a queued one needs no room of its own.
+    folded = HidDev_coalesceReport(id, type, len, pData);
+    if (!folded)
+    {
+      hidDevReportQWaiting = TRUE;
+    }
+
+    reportQUnlock(key);
+
+    return folded ? SUCCESS : bleNoResources;
+  }
+
+  // The HidDev task only ever frees room, so the report still fits below.
+  reportQUnlock(key);
+
+  // If not connected and not already advertising
+  if (hidDevGapState != GAPROLE_CONNECTED &&
+      hidDevGapState != GAPROLE_ADVERTISING)
+  {
+    HidDev_StartAdvertising();
+  }
+
+  HidDev_enqueueReport(id, type, len, pData);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      HidDev_ReserveReport
+ *
+ * @brief   Reserve a buffer for a HID report so the application can build
+ *          the report in place, then send it with HidDev_CommitReport.
+ *          When the report can go out at once the buffer is the stack's
+ *          notification buffer; otherwise it is free report queue space.
+ *          Only one report can be reserved at a time, and no other report
+ *          may be sent until it is committed.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Largest length of the report.
+ *
+ * @return  Buffer of len bytes, or NULL if the report is too long or
+ *          another one is reserved.
+ */
+uint8_t *HidDev_ReserveReport(uint8_t id, uint8_t type, uint8_t len)
+{
+  if ((len > HID_DEV_DATA_LEN) || (hidDevRsv.pData != NULL))
+  {
+    return NULL;
+  }
+
+  hidDevRsv.id = id;
+  hidDevRsv.type = type;
+  hidDevRsv.len = len;
+  hidDevRsv.inPlace = FALSE;
+
+  // If connected, secure, no reports pending or held and the report fits
+  // in one notification, build it in the notification buffer.
+  if ((hidDevGapState == GAPROLE_CONNECTED) && hidDevConnSecure &&
+      reportQEmpty() && !reportDeferred() &&
+      (len <= (GATT_GetMTU(gapConnHandle) - HID_DEV_NOTI_HDR_LEN)))
+  {
+    hidDevRsv.pData = GATT_bm_alloc(gapConnHandle, ATT_HANDLE_VALUE_NOTI,
+                                    len, NULL);
+    hidDevRsv.inPlace = (hidDevRsv.pData != NULL);
+  }
+
+  // Otherwise past the data of the queued reports. The HidDev task only
+  // removes reports, which moves queued data down and never into this
+  // space, so it can be filled without holding the queue lock.
+  if (hidDevRsv.pData == NULL)
+  {
+    hidDevRsv.pData = &hidDevReportData[hidDevReportDataLen];
+  }
+
+  return hidDevRsv.pData;
+}
+
+/*********************************************************************
+ * @fn      HidDev_CommitReport
+ *
+ * @brief   Send the HID report reserved with HidDev_ReserveReport, as
+ *          HidDev_Report would.
+ *
+ * @param   len - Length of report, up to the reserved length; 0 to
+ *                release the reservation without sending.
+ *
+ * @return  None.
+ */
+void HidDev_CommitReport(uint8_t len)
+{
+  uint8_t *pData = hidDevRsv.pData;
+  uint8_t status;
+
+  if (pData == NULL)
+  {
+    return;
+  }
+
+  if (len > hidDevRsv.len)
+  {
+    len = 0;
+  }
+
+  if (hidDevRsv.inPlace)
+  {
+    status = (len > 0) ? HidDev_sendReport(hidDevRsv.id, hidDevRsv.type,
+                                           len, pData) : bleInvalidRange;
+
+    // Queue it if the controller is out of buffers or the link dropped.
+    if ((status != SUCCESS) && (len > 0) &&
+        (sendRetryable(status) || (hidDevGapState != GAPROLE_CONNECTED)))
+    {
+      HidDev_enqueueReport(hidDevRsv.id, hidDevRsv.type, len, pData);
+    }
+
+    // Unless the stack took it, the buffer is still ours: the report was
+    // skipped as a duplicate, not sent or failed.
+    if (hidDevRsv.inPlace)
+    {
+      attHandleValueNoti_t noti;
+
+      noti.pValue = pData;
+      GATT_bm_free((gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI);
+    }
+  }
+  else if (len > 0)
+  {
+    // If not connected and not already advertising
+    if (hidDevGapState != GAPROLE_CONNECTED &&
+        hidDevGapState != GAPROLE_ADVERTISING)
+    {
+      HidDev_StartAdvertising();
+    }
+
+    HidDev_enqueueReport(hidDevRsv.id, hidDevRsv.type, len, pData);
+  }
+
+  hidDevRsv.pData = NULL;
+  hidDevRsv.inPlace = FALSE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_IsNotifyEnabled
+ *
+ * @brief   Tell whether the host has enabled notifications for a report
+ *          in the current protocol mode.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ *
+ * @return  TRUE if enabled, FALSE if not or the report is unknown.
+ */
+uint8_t HidDev_IsNotifyEnabled(uint8_t id, uint8_t type)
+{
+  hidRptMap_t *pRpt = HidDev_reportById(id, type);
+
+  return (pRpt != NULL) ? HidDev_notifyEnabled(pRpt) : FALSE;
+}
+
 /*********************************************************************
  * @fn      HidDev_Close
  *
@@ -697,7 +1419,7 @@ bStatus_t HidDev_SetParameter(uint8_t param, uint8_t len, void *pValue)
           }
 
           // Clear out last report
-          memset(&lastReport, 0, sizeof(hidDevReport_t));
+          memset(&lastReport, 0, sizeof(hidDevLastReport_t));
         }
 
         // Drop connection.
@@ -707,7 +1429,14 @@ bStatus_t HidDev_SetParameter(uint8_t param, uint8_t len, void *pValue)
         }
 
         // Flush report queue.
-        firstQIdx = lastQIdx = 0;
+        {
+          ICall_CSState key = reportQLock();
+
+          hidDevReportQLen = 0;
+          hidDevReportDataLen = 0;
+          hidDevReportQWaiting = FALSE;
+          reportQUnlock(key);
+        }
 
         // Erase bonding info.
         GAPBondMgr_SetParameter(GAPBOND_ERASE_ALLBONDS, 0, NULL);
@@ -718,9 +1447,66 @@ bStatus_t HidDev_SetParameter(uint8_t param, uint8_t len, void *pValue)
       }
       break;
 
-    default:
-      ret = INVALIDPARAMETER;
-      break;
+    case HIDDEV_CONN_EVT_ALIGN:
+      if (len == sizeof(uint8_t))
+      {
+        hidDevConnEvtAlign = *((uint8_t*)pValue);
+
+        if (!hidDevConnEvtAlign)
+        {
+          // Release any reports held for the next connection event.
+          Util_stopClock(&connEvtClock);
+        }
+
+        // The HidDev task turns connection event notices on or off.
+        Event_post(syncEvent, HID_SEND_REPORT_EVT);
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+
+    case HIDDEV_CONN_PROFILE:
+      if ((len == sizeof(uint8_t)) &&
+          (*((uint8_t*)pValue) <= HID_DEV_CONN_PROFILE_IDLE))
+      {
+        hidDevConnProfile = *((uint8_t*)pValue);
+
+        if (hidDevConnSecure)
+        {
+          if (hidDevConnProfile == HID_DEV_CONN_PROFILE_AUTO)
+          {
+            // Relax once input has been quiet for a while.
+            Util_restartClock(&connQuietClock, hidDevConnQuietTime);
+          }
+          else
+          {
+            Util_stopClock(&connQuietClock);
+            HidDev_requestConnProfile(hidDevConnProfile);
+          }
+        }
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+
+    case HIDDEV_CONN_QUIET_TIME:
+      if ((len == sizeof(uint16_t)) && (*((uint16_t*)pValue) > 0))
+      {
+        hidDevConnQuietTime = *((uint16_t*)pValue);
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+
+    default:
+      ret = INVALIDPARAMETER;
+      break;
   }
 
   return (ret);
@@ -753,6 +1539,26 @@ bStatus_t HidDev_GetParameter(uint8_t param, void *pValue)
       *((uint8_t*)pValue) = hidDevGapBondPairingState;
       break;
 
+    case HIDDEV_DEDUP_SKIPPED:
+      *((uint32_t*)pValue) = hidDevDedupSkipped;
+      break;
+
+    case HIDDEV_MTU_DROPPED:
+      *((uint32_t*)pValue) = hidDevMtuDropped;
+      break;
+
+    case HIDDEV_CONN_EVT_ALIGN:
+      *((uint8_t*)pValue) = hidDevConnEvtAlign;
+      break;
+
+    case HIDDEV_CONN_PROFILE:
+      *((uint8_t*)pValue) = hidDevConnProfile;
+      break;
+
+    case HIDDEV_CONN_QUIET_TIME:
+      *((uint16_t*)pValue) = hidDevConnQuietTime;
+      break;
+
     default:
       ret = INVALIDPARAMETER;
       break;
@@ -797,72 +1603,19 @@ bStatus_t HidDev_ReadAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
                             uint8_t *pValue, uint16_t *pLen, uint16_t offset,
                             uint16_t maxLen, uint8_t method)
 {
-  bStatus_t   status = SUCCESS;
-  hidRptMap_t *pRpt;
-
-  uint16_t uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+  bStatus_t status;
+  uint16_t  idx = pAttr->handle - hidDevAttrBaseHandle;
+  uint8_t   kind = (idx < hidDevAttrCount) ? hidDevAttrKind[idx] :
+                                             HidDev_classifyAttr(pAttr);
 
   // Only report map is long.
-  if (offset > 0 && uuid != REPORT_MAP_UUID)
+  if (offset > 0 && kind != HID_DEV_ATTR_REPORT_MAP)
   {
     return (ATT_ERR_ATTR_NOT_LONG);
   }
 
-  if (uuid == REPORT_UUID ||
-      uuid == BOOT_KEY_INPUT_UUID ||
-      uuid == BOOT_KEY_OUTPUT_UUID ||
-      uuid == BOOT_MOUSE_INPUT_UUID)
-  {
-    // Find report ID in table.
-    if ((pRpt = HidDev_reportByHandle(pAttr->handle)) != NULL)
-    {
-      // Execute report callback.
-      status  = (*pHidDevCB->reportCB)(pRpt->id, pRpt->type, uuid,
-                                        HID_DEV_OPER_READ, pLen, pValue);
-    }
-    else
-    {
-      *pLen = 0;
-    }
-  }
-  else if (uuid == REPORT_MAP_UUID)
-  {
-    // If the value offset of the Read Blob Request is greater than the
-    // length of the attribute value, an Error Response shall be sent with
-    // the error code Invalid Offset.
-    if (offset > hidReportMapLen)
-    {
-      status = ATT_ERR_INVALID_OFFSET;
-    }
-    else
-    {
-      // Determine read length.
-      *pLen = MIN(maxLen, (hidReportMapLen - offset));
-
-      // Copy data.
-      memcpy(pValue, pAttr->pValue + offset, *pLen);
-    }
-  }
-  else if (uuid == HID_INFORMATION_UUID)
-  {
-    *pLen = HID_INFORMATION_LEN;
-    memcpy(pValue, pAttr->pValue, HID_INFORMATION_LEN);
-  }
-  else if (uuid == GATT_REPORT_REF_UUID)
-  {
-    *pLen = HID_REPORT_REF_LEN;
-    memcpy(pValue, pAttr->pValue, HID_REPORT_REF_LEN);
-  }
-  else if (uuid == PROTOCOL_MODE_UUID)
-  {
-    *pLen = HID_PROTOCOL_MODE_LEN;
-    pValue[0] = pAttr->pValue[0];
-  }
-  else if (uuid == GATT_EXT_REPORT_REF_UUID)
-  {
-    *pLen = HID_EXT_REPORT_REF_LEN;
-    memcpy(pValue, pAttr->pValue, HID_EXT_REPORT_REF_LEN);
-  }
+  status = (*hidDevAttrOps[kind].pfnRead)(pAttr, pValue, pLen, offset,
+                                          maxLen);
 
   // Restart idle timer.
   if (status == SUCCESS)
@@ -891,8 +1644,10 @@ bStatus_t HidDev_WriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
                              uint8_t *pValue, uint16_t len, uint16_t offset,
                              uint8_t method)
 {
-  bStatus_t   status = SUCCESS;
-  hidRptMap_t *pRpt;
+  bStatus_t status;
+  uint16_t  idx = pAttr->handle - hidDevAttrBaseHandle;
+  uint8_t   kind = (idx < hidDevAttrCount) ? hidDevAttrKind[idx] :
+                                             HidDev_classifyAttr(pAttr);
 
   // Make sure it's not a blob operation (no attributes in the profile are long).
   if (offset > 0)
@@ -900,81 +1655,8 @@ bStatus_t HidDev_WriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
     return (ATT_ERR_ATTR_NOT_LONG);
   }
 
-  uint16_t uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
-
-  if (uuid == REPORT_UUID || uuid == BOOT_KEY_OUTPUT_UUID)
-  {
-    // Find report ID in table.
-    if ((pRpt = HidDev_reportByHandle(pAttr->handle)) != NULL)
-    {
-      // Execute report callback.
-      status  = (*pHidDevCB->reportCB)(pRpt->id, pRpt->type, uuid,
-                                        HID_DEV_OPER_WRITE, &len, pValue);
-    }
-  }
-  else if (uuid == HID_CTRL_PT_UUID)
-  {
-    // Validate length and value range.
-    if (len == 1)
-    {
-      if (pValue[0] == HID_CMD_SUSPEND ||  pValue[0] == HID_CMD_EXIT_SUSPEND)
-      {
-        // Execute HID app event callback.
-        (*pHidDevCB->evtCB)((pValue[0] == HID_CMD_SUSPEND) ?
-                             HID_DEV_SUSPEND_EVT : HID_DEV_EXIT_SUSPEND_EVT);
-      }
-      else
-      {
-        status = ATT_ERR_INVALID_VALUE;
-      }
-    }
-    else
-    {
-      status = ATT_ERR_INVALID_VALUE_SIZE;
-    }
-  }
-  else if (uuid == GATT_CLIENT_CHAR_CFG_UUID)
-  {
-    status = GATTServApp_ProcessCCCWriteReq(connHandle, pAttr, pValue, len,
-                                            offset, GATT_CLIENT_CFG_NOTIFY);
-    if (status == SUCCESS)
-    {
-      uint16_t charCfg = BUILD_UINT16(pValue[0], pValue[1]);
-
-      // Find report ID in table.
-      if ((pRpt = HidDev_reportByCccdHandle(pAttr->handle)) != NULL)
-      {
-        // Execute report callback.
-        (*pHidDevCB->reportCB)(pRpt->id, pRpt->type, uuid,
-                               (charCfg == GATT_CLIENT_CFG_NOTIFY) ?
-                               HID_DEV_OPER_ENABLE : HID_DEV_OPER_DISABLE,
-                               &len, pValue);
-      }
-    }
-  }
-  else if (uuid == PROTOCOL_MODE_UUID)
-  {
-    if (len == HID_PROTOCOL_MODE_LEN)
-    {
-      if (pValue[0] == HID_PROTOCOL_MODE_BOOT ||
-          pValue[0] == HID_PROTOCOL_MODE_REPORT)
-      {
-        pAttr->pValue[0] = pValue[0];
-
-        // Execute HID app event callback.
-        (*pHidDevCB->evtCB)((pValue[0] == HID_PROTOCOL_MODE_BOOT) ?
-                            HID_DEV_SET_BOOT_EVT : HID_DEV_SET_REPORT_EVT);
-      }
-      else
-      {
-        status = ATT_ERR_INVALID_VALUE;
-      }
-    }
-    else
-    {
-      status = ATT_ERR_INVALID_VALUE_SIZE;
-    }
-  }
+  status = (*hidDevAttrOps[kind].pfnWrite)(connHandle, pAttr, pValue, len,
+                                           offset);
 
   // Restart idle timer.
   if (status == SUCCESS)
@@ -1164,6 +1846,18 @@ static void HidDev_processStateChangeEvt(gaprole_States_t newState)
     // Start idle timer.
     HidDev_StartIdleTimer();
 
+    // Ask for an ATT MTU that fits long reports in one notification.
+    {
+      attExchangeMTUReq_t req;
+
+      req.clientRxMTU = HID_DEV_MTU_SIZE;
+      VOID GATT_ExchangeMTU(gapConnHandle, &req, selfEntity);
+    }
+
+    // Aligned reports need a notice at the end of each connection event;
+    // otherwise notices are asked for once reports wait in the queue.
+    HidDev_connEvtNoticeEnable(hidDevConnEvtAlign);
+
     // If there are reports in the queue
     if (!reportQEmpty())
     {
@@ -1222,6 +1916,16 @@ static void HidDev_disconnected(void)
   // Stop idle timer.
   HidDev_StopIdleTimer();
 
+  // Queued reports wait for the next secure connection.
+  Util_stopClock(&sendRetryClock);
+  Util_stopClock(&connEvtClock);
+  hidDevConnEvtNotice = FALSE;
+  HidDev_connEvtNoticeEnable(FALSE);
+
+  // Parameters are requested afresh on the next connection.
+  Util_stopClock(&connQuietClock);
+  hidDevConnProfileReq = HID_DEV_CONN_PROFILE_NONE;
+
   // Reset state variables.
   hidDevConnSecure = FALSE;
   hidProtocolMode = HID_PROTOCOL_MODE_REPORT;
@@ -1229,7 +1933,9 @@ static void HidDev_disconnected(void)
   hidDevGapBondPairingState = HID_GAPBOND_PAIRING_STATE_NONE;
 
   // Reset last report sent out
-  memset(&lastReport, 0, sizeof(hidDevReport_t));
+  memset(&lastReport, 0, sizeof(hidDevLastReport_t));
+  memset(hidDevRptSent, 0, sizeof(hidDevRptSent));
+  hidDevRptNotify = 0;
 
   // If bonded and normally connectable start advertising.
   if ((HidDev_bondCount() > 0) &&
@@ -1243,6 +1949,178 @@ static void HidDev_disconnected(void)
   (*pHidDevCB->evtCB)(HID_DEV_GAPBOND_STATE_CHANGE_EVT);
 }
 
+/*********************************************************************
+ * @fn      HidDev_connEvtNotice
+ *
+ * @brief   Handle the end of a connection event. The controller has
+ *          sent what it could and freed those notification buffers, so
+ *          reports held back for lack of them are retried now.
+ *
+ *          When aligned, arm the clock that submits pending reports just
+ *          before the next anchor point instead; until it fires, new
+ *          reports are queued so they land together in that event and
+ *          coalesce in between. If an event passes without a notice, as
+ *          with slave latency, the clock expires and reports go out at
+ *          once again.
+ *
+ *          Unaligned, notices stop once the queue is empty.
+ *
+ * @return  none
+ */
+static void HidDev_connEvtNotice(void)
+{
+  uint16_t interval;
+  uint32_t timeout;
+
+  if (hidDevGapState != GAPROLE_CONNECTED)
+  {
+    return;
+  }
+
+  hidDevConnEvtNotice = TRUE;
+
+  if (!hidDevConnEvtAlign)
+  {
+    if (reportQEmpty())
+    {
+      HidDev_connEvtNoticeEnable(FALSE);
+    }
+    else if (hidDevConnSecure)
+    {
+      Util_stopClock(&sendRetryClock);
+      Event_post(syncEvent, HID_SEND_REPORT_EVT);
+    }
+    return;
+  }
+
+  // Connection interval in 1.25 ms units, to ms
+  GAPRole_GetParameter(GAPROLE_CONN_INTERVAL, &interval);
+  timeout = ((uint32_t)interval * 5) / 4;
+
+  if (timeout > HID_CONN_EVT_GUARD_TIME)
+  {
+    timeout -= HID_CONN_EVT_GUARD_TIME;
+  }
+  else
+  {
+    timeout = 1;
+  }
+
+  Util_restartClock(&connEvtClock, timeout);
+}
+
+/*********************************************************************
+ * @fn      HidDev_connEvtNoticeEnable
+ *
+ * @brief   Ask the controller for a notice at the end of each connection
+ *          event, or stop it. Each notice wakes the HidDev task, so they
+ *          are only on while reports are queued or aligned. Called by the
+ *          HidDev task.
+ *
+ * @param   enable - TRUE to turn notices on, FALSE to turn them off.
+ *
+ * @return  none
+ */
+static void HidDev_connEvtNoticeEnable(uint8_t enable)
+{
+  if (enable != hidDevConnEvtNoticeOn)
+  {
+    hidDevConnEvtNoticeOn = enable;
+    HCI_EXT_ConnEventNoticeCmd(selfEntity,
+                               enable ? HID_CONN_EVT_END_EVT : 0);
+  }
+}
+
+/*********************************************************************
+ * @fn      HidDev_connActivity
+ *
+ * @brief   Note input going out to the host. The AUTO profile asks for
+ *          the gaming parameters and relaxes to idle once input has been
+ *          quiet for the quiet time; a pinned profile is asked for once
+ *          per connection.
+ *
+ * @return  none
+ */
+static void HidDev_connActivity(void)
+{
+  if (hidDevConnProfile == HID_DEV_CONN_PROFILE_AUTO)
+  {
+    Util_restartClock(&connQuietClock, hidDevConnQuietTime);
+    HidDev_requestConnProfile(HID_DEV_CONN_PROFILE_GAMING);
+  }
+  else if (updateConnParams)
+  {
+    HidDev_requestConnProfile(hidDevConnProfile);
+  }
+
+  updateConnParams = FALSE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_requestConnProfile
+ *
+ * @brief   Ask the host for the connection parameters of a profile,
+ *          unless they were the last asked for. The typing profile uses
+ *          the desired parameters set in the GAPRole. While an earlier
+ *          request is outstanding the profile is asked for again on the
+ *          next input, or after another quiet time when relaxing.
+ *
+ * @param   profile - HID_DEV_CONN_PROFILE_GAMING, _TYPING or _IDLE.
+ *
+ * @return  none
+ */
+static void HidDev_requestConnProfile(uint8_t profile)
+{
+  uint16_t minInterval;
+  uint16_t maxInterval;
+  uint16_t latency;
+  uint16_t timeout;
+
+  if (profile == hidDevConnProfileReq)
+  {
+    return;
+  }
+
+  switch (profile)
+  {
+    case HID_DEV_CONN_PROFILE_GAMING:
+      minInterval = HID_GAMING_CONN_INTERVAL;
+      maxInterval = HID_GAMING_CONN_INTERVAL;
+      latency = HID_GAMING_SLAVE_LATENCY;
+      timeout = HID_GAMING_CONN_TIMEOUT;
+      break;
+
+    case HID_DEV_CONN_PROFILE_IDLE:
+      minInterval = HID_IDLE_MIN_CONN_INTERVAL;
+      maxInterval = HID_IDLE_MAX_CONN_INTERVAL;
+      latency = HID_IDLE_SLAVE_LATENCY;
+      timeout = HID_IDLE_CONN_TIMEOUT;
+      break;
+
+    default:
+      GAPRole_GetParameter(GAPROLE_MIN_CONN_INTERVAL, &minInterval);
+      GAPRole_GetParameter(GAPROLE_MAX_CONN_INTERVAL, &maxInterval);
+      GAPRole_GetParameter(GAPROLE_SLAVE_LATENCY, &latency);
+      GAPRole_GetParameter(GAPROLE_TIMEOUT_MULTIPLIER, &timeout);
+      break;
+  }
+
+  if (GAPRole_SendUpdateParam(minInterval, maxInterval, latency, timeout,
+                              GAPROLE_NO_ACTION) == blePending)
+  {
+    if (profile == HID_DEV_CONN_PROFILE_IDLE)
+    {
+      Util_restartClock(&connQuietClock, hidDevConnQuietTime);
+    }
+  }
+  else
+  {
+    // Asked for, or never will be; parameters already in use are not
+    // asked for again either.
+    hidDevConnProfileReq = profile;
+  }
+}
+
 /*********************************************************************
  * @fn      HidDev_pairStateCB
  *
@@ -1295,6 +2173,7 @@ static void HidDev_processPairStateEvt(uint8_t state, uint8_t status)
     {
       hidDevConnSecure = TRUE;
       Util_restartClock(&reportReadyClock, HID_REPORT_READY_TIME);
+      HidDev_refreshNotify();
     }
   }
   else if (state == GAPBOND_PAIRING_STATE_BONDED)
@@ -1303,6 +2182,7 @@ static void HidDev_processPairStateEvt(uint8_t state, uint8_t status)
     {
       hidDevConnSecure = TRUE;
       Util_restartClock(&reportReadyClock, HID_REPORT_READY_TIME);
+      HidDev_refreshNotify();
 
 #if DEFAULT_SCAN_PARAM_NOTIFY_TEST == TRUE
       ScanParam_RefreshNotify(gapConnHandle);
@@ -1415,6 +2295,10 @@ static void HidDev_batteryCB(uint8_t event)
  */
 static void HidDev_processBatteryEvt(uint8_t event)
 {
+  // The battery level report's CCCD is written through the battery
+  // service, not HidDev_WriteAttrCB.
+  HidDev_refreshNotify();
+
   if (event == BATT_LEVEL_NOTI_ENABLED)
   {
     // If connected start periodic measurement.
@@ -1478,6 +2362,21 @@ static hidRptMap_t *HidDev_reportByHandle(uint16_t handle)
 {
   uint8_t i;
   hidRptMap_t *p = pHidDevRptTbl;
+  uint16_t offset = handle - hidDevRptBaseHandle;
+
+  if ((offset < HID_DEV_RPT_HANDLE_SPAN) &&
+      (hidDevRptTblLen <= HID_DEV_RPT_IDX_MASK))
+  {
+    i = hidDevRptHandleIdx[offset];
+    if ((i == 0) || (i & HID_DEV_RPT_IDX_CCCD))
+    {
+      return NULL;
+    }
+
+    // A handle belongs to one report, in one protocol mode
+    p = &pHidDevRptTbl[i - 1];
+    return (p->mode == hidProtocolMode) ? p : NULL;
+  }
 
   for (i = hidDevRptTblLen; i > 0; i--, p++)
   {
@@ -1503,6 +2402,15 @@ static hidRptMap_t *HidDev_reportByCccdHandle(uint16_t handle)
 {
   uint8_t i;
   hidRptMap_t *p = pHidDevRptTbl;
+  uint16_t offset = handle - hidDevRptBaseHandle;
+
+  if ((offset < HID_DEV_RPT_HANDLE_SPAN) &&
+      (hidDevRptTblLen <= HID_DEV_RPT_IDX_MASK))
+  {
+    i = hidDevRptHandleIdx[offset];
+    return (i & HID_DEV_RPT_IDX_CCCD) ?
+           &pHidDevRptTbl[(i & HID_DEV_RPT_IDX_MASK) - 1] : NULL;
+  }
 
   for (i = hidDevRptTblLen; i > 0; i--, p++)
   {
@@ -1516,109 +2424,485 @@ static hidRptMap_t *HidDev_reportByCccdHandle(uint16_t handle)
 }
 
 /*********************************************************************
- * @fn      HidDev_reportById
+ * @fn      HidDev_classifyAttr
  *
- * @brief   Find the HID report structure for the Report ID and type.
+ * @brief   Find the kind of an attribute of the HID service.
  *
- * @param   id   - HID report ID
- * @param   type - HID report type
+ * @param   pAttr - Attribute.
  *
- * @return  Pointer to HID report structure
+ * @return  HID_DEV_ATTR_NONE or another attribute kind.
  */
-static hidRptMap_t *HidDev_reportById(uint8_t id, uint8_t type)
+static uint8_t HidDev_classifyAttr(gattAttribute_t *pAttr)
 {
-  uint8_t i;
-  hidRptMap_t *p = pHidDevRptTbl;
+  uint16_t uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
 
-  for (i = hidDevRptTblLen; i > 0; i--, p++)
+  switch (uuid)
   {
-    if (p->id == id && p->type == type && p->mode == hidProtocolMode)
-    {
-      return p;
-    }
-  }
+    case REPORT_UUID:
+    case BOOT_KEY_OUTPUT_UUID:
+      return HID_DEV_ATTR_REPORT;
 
-  return NULL;
+    case BOOT_KEY_INPUT_UUID:
+    case BOOT_MOUSE_INPUT_UUID:
+      return HID_DEV_ATTR_REPORT_IN;
+
+    case REPORT_MAP_UUID:
+      return HID_DEV_ATTR_REPORT_MAP;
+
+    case HID_INFORMATION_UUID:
+      return HID_DEV_ATTR_INFO;
+
+    case GATT_REPORT_REF_UUID:
+      return HID_DEV_ATTR_REPORT_REF;
+
+    case GATT_EXT_REPORT_REF_UUID:
+      return HID_DEV_ATTR_EXT_REPORT_REF;
+
+    case PROTOCOL_MODE_UUID:
+      return HID_DEV_ATTR_PROTOCOL_MODE;
+
+    case HID_CTRL_PT_UUID:
+      return HID_DEV_ATTR_CTRL_PT;
+
+    case GATT_CLIENT_CHAR_CFG_UUID:
+      return HID_DEV_ATTR_CCCD;
+
+    default:
+      return HID_DEV_ATTR_NONE;
+  }
 }
 
 /*********************************************************************
- * @fn      HidDev_sendReport
- *
- * @brief   Send a HID report.
+ * @fn      HidDev_readNone
  *
- * @param   id    - HID report ID.
- * @param   type  - HID report type.
- * @param   len   - Length of report.
- * @param   pData - Report data.
+ * @brief   Read of an attribute HID Dev does not serve.
  *
- * @return  None.
+ * @return  SUCCESS
  */
-static void HidDev_sendReport(uint8_t id, uint8_t type, uint8_t len, uint8_t *pData)
+static bStatus_t HidDev_readNone(gattAttribute_t *pAttr, uint8_t *pValue,
+                                 uint16_t *pLen, uint16_t offset,
+                                 uint16_t maxLen)
 {
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readReport
+ *
+ * @brief   Read a report through the application report callback.
+ *
+ * @return  SUCCESS or status from the report callback
+ */
+static bStatus_t HidDev_readReport(gattAttribute_t *pAttr, uint8_t *pValue,
+                                   uint16_t *pLen, uint16_t offset,
+                                   uint16_t maxLen)
+{
+  hidRptMap_t *pRpt;
+
+  // Find report ID in table.
+  if ((pRpt = HidDev_reportByHandle(pAttr->handle)) != NULL)
+  {
+    // Execute report callback.
+    return (*pHidDevCB->reportCB)(pRpt->id, pRpt->type,
+                                  BUILD_UINT16(pAttr->type.uuid[0],
+                                               pAttr->type.uuid[1]),
+                                  HID_DEV_OPER_READ, pLen, pValue);
+  }
+
+  *pLen = 0;
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readReportMap
+ *
+ * @brief   Read the report map, the one long attribute.
+ *
+ * @return  SUCCESS or ATT_ERR_INVALID_OFFSET
+ */
+static bStatus_t HidDev_readReportMap(gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t *pLen, uint16_t offset,
+                                      uint16_t maxLen)
+{
+  // If the value offset of the Read Blob Request is greater than the
+  // length of the attribute value, an Error Response shall be sent with
+  // the error code Invalid Offset.
+  if (offset > hidReportMapLen)
+  {
+    return (ATT_ERR_INVALID_OFFSET);
+  }
+
+  // Determine read length.
+  *pLen = MIN(maxLen, (hidReportMapLen - offset));
+
+  // Copy data.
+  memcpy(pValue, pAttr->pValue + offset, *pLen);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readInfo
+ *
+ * @brief   Read the HID information characteristic.
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t HidDev_readInfo(gattAttribute_t *pAttr, uint8_t *pValue,
+                                 uint16_t *pLen, uint16_t offset,
+                                 uint16_t maxLen)
+{
+  *pLen = HID_INFORMATION_LEN;
+  memcpy(pValue, pAttr->pValue, HID_INFORMATION_LEN);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readReportRef
+ *
+ * @brief   Read a report reference descriptor.
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t HidDev_readReportRef(gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t *pLen, uint16_t offset,
+                                      uint16_t maxLen)
+{
+  *pLen = HID_REPORT_REF_LEN;
+  memcpy(pValue, pAttr->pValue, HID_REPORT_REF_LEN);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readExtReportRef
+ *
+ * @brief   Read an external report reference descriptor.
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t HidDev_readExtReportRef(gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t *pLen,
+                                         uint16_t offset, uint16_t maxLen)
+{
+  *pLen = HID_EXT_REPORT_REF_LEN;
+  memcpy(pValue, pAttr->pValue, HID_EXT_REPORT_REF_LEN);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_readProtocolMode
+ *
+ * @brief   Read the protocol mode characteristic.
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t HidDev_readProtocolMode(gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t *pLen,
+                                         uint16_t offset, uint16_t maxLen)
+{
+  *pLen = HID_PROTOCOL_MODE_LEN;
+  pValue[0] = pAttr->pValue[0];
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_writeNone
+ *
+ * @brief   Write to an attribute HID Dev does not serve.
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t HidDev_writeNone(uint16_t connHandle, gattAttribute_t *pAttr,
+                                  uint8_t *pValue, uint16_t len,
+                                  uint16_t offset)
+{
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_writeReport
+ *
+ * @brief   Write a report through the application report callback.
+ *
+ * @return  SUCCESS or status from the report callback
+ */
+static bStatus_t HidDev_writeReport(uint16_t connHandle,
+                                    gattAttribute_t *pAttr, uint8_t *pValue,
+                                    uint16_t len, uint16_t offset)
+{
+  hidRptMap_t *pRpt;
+
+  // Find report ID in table.
+  if ((pRpt = HidDev_reportByHandle(pAttr->handle)) != NULL)
+  {
+    // Execute report callback.
+    return (*pHidDevCB->reportCB)(pRpt->id, pRpt->type,
+                                  BUILD_UINT16(pAttr->type.uuid[0],
+                                               pAttr->type.uuid[1]),
+                                  HID_DEV_OPER_WRITE, &len, pValue);
+  }
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_writeCtrlPt
+ *
+ * @brief   Write the HID control point: suspend or exit suspend.
+ *
+ * @return  SUCCESS, ATT_ERR_INVALID_VALUE or ATT_ERR_INVALID_VALUE_SIZE
+ */
+static bStatus_t HidDev_writeCtrlPt(uint16_t connHandle,
+                                    gattAttribute_t *pAttr, uint8_t *pValue,
+                                    uint16_t len, uint16_t offset)
+{
+  // Validate length and value range.
+  if (len != 1)
+  {
+    return (ATT_ERR_INVALID_VALUE_SIZE);
+  }
+
+  if (pValue[0] != HID_CMD_SUSPEND && pValue[0] != HID_CMD_EXIT_SUSPEND)
+  {
+    return (ATT_ERR_INVALID_VALUE);
+  }
+
+  // Execute HID app event callback.
+  (*pHidDevCB->evtCB)((pValue[0] == HID_CMD_SUSPEND) ?
+                       HID_DEV_SUSPEND_EVT : HID_DEV_EXIT_SUSPEND_EVT);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_writeCccd
+ *
+ * @brief   Write a report CCCD and track its notification state.
+ *
+ * @return  SUCCESS or status from GATTServApp_ProcessCCCWriteReq
+ */
+static bStatus_t HidDev_writeCccd(uint16_t connHandle, gattAttribute_t *pAttr,
+                                  uint8_t *pValue, uint16_t len,
+                                  uint16_t offset)
+{
+  bStatus_t status;
+  hidRptMap_t *pRpt;
+
+  status = GATTServApp_ProcessCCCWriteReq(connHandle, pAttr, pValue, len,
+                                          offset, GATT_CLIENT_CFG_NOTIFY);
+  if (status == SUCCESS)
+  {
+    uint16_t charCfg = BUILD_UINT16(pValue[0], pValue[1]);
+
+    // Find report ID in table.
+    if ((pRpt = HidDev_reportByCccdHandle(pAttr->handle)) != NULL)
+    {
+      HidDev_setNotify(pRpt, (charCfg & GATT_CLIENT_CFG_NOTIFY) != 0);
+
+      // Execute report callback.
+      (*pHidDevCB->reportCB)(pRpt->id, pRpt->type, GATT_CLIENT_CHAR_CFG_UUID,
+                             (charCfg == GATT_CLIENT_CFG_NOTIFY) ?
+                             HID_DEV_OPER_ENABLE : HID_DEV_OPER_DISABLE,
+                             &len, pValue);
+    }
+  }
+
+  return (status);
+}
+
+/*********************************************************************
+ * @fn      HidDev_writeProtocolMode
+ *
+ * @brief   Write the protocol mode characteristic.
+ *
+ * @return  SUCCESS, ATT_ERR_INVALID_VALUE or ATT_ERR_INVALID_VALUE_SIZE
+ */
+static bStatus_t HidDev_writeProtocolMode(uint16_t connHandle,
+                                          gattAttribute_t *pAttr,
+                                          uint8_t *pValue, uint16_t len,
+                                          uint16_t offset)
+{
+  if (len != HID_PROTOCOL_MODE_LEN)
+  {
+    return (ATT_ERR_INVALID_VALUE_SIZE);
+  }
+
+  if (pValue[0] != HID_PROTOCOL_MODE_BOOT &&
+      pValue[0] != HID_PROTOCOL_MODE_REPORT)
+  {
+    return (ATT_ERR_INVALID_VALUE);
+  }
+
+  pAttr->pValue[0] = pValue[0];
+
+  // Execute HID app event callback.
+  (*pHidDevCB->evtCB)((pValue[0] == HID_PROTOCOL_MODE_BOOT) ?
+                      HID_DEV_SET_BOOT_EVT : HID_DEV_SET_REPORT_EVT);
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      HidDev_reportById
+ *
+ * @brief   Find the HID report structure for the Report ID and type.
+ *
+ * @param   id   - HID report ID
+ * @param   type - HID report type
+ *
+ * @return  Pointer to HID report structure
+ */
+static hidRptMap_t *HidDev_reportById(uint8_t id, uint8_t type)
+{
+  uint8_t i;
+  hidRptMap_t *p = pHidDevRptTbl;
+
+  if ((id <= HID_DEV_MAX_RPT_ID) && (type >= HID_REPORT_TYPE_INPUT) &&
+      (type <= HID_REPORT_TYPE_FEATURE) &&
+      (hidDevRptTblLen <= HID_DEV_RPT_IDX_MASK))
+  {
+    i = hidDevRptIdIdx[hidProtocolMode][type - 1][id];
+    return (i != 0) ? &pHidDevRptTbl[i - 1] : NULL;
+  }
+
+  for (i = hidDevRptTblLen; i > 0; i--, p++)
+  {
+    if (p->id == id && p->type == type && p->mode == hidProtocolMode)
+    {
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      HidDev_sendReport
+ *
+ * @brief   Send a HID report.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  SUCCESS, the notification failure status, or bleIncorrectMode
+ *          if the report is unknown or its notifications are disabled.
+ */
+static uint8_t HidDev_sendReport(uint8_t id, uint8_t type, uint8_t len,
+                                 uint8_t *pData)
+{
+  uint8_t status = bleIncorrectMode;
   hidRptMap_t *pRpt;
 
   // Get ATT handle for report.
   if ((pRpt = HidDev_reportById(id, type)) != NULL)
   {
-    uint8_t value = GATTServApp_ReadCharCfg(gapConnHandle,
-                                            GATT_CCC_TBL(pRpt->pCccdAttr->pValue));
-
     // If notifications are enabled
-    if (value & GATT_CLIENT_CFG_NOTIFY)
+    if (HidDev_notifyEnabled(pRpt))
     {
       // After service discovery and encryption, the HID Device should
       // request to change to the preferred connection parameters that best
-      // suit its use case.
-      if (updateConnParams)
-      {
-        GAPRole_SetParameter(GAPROLE_PARAM_UPDATE_REQ, sizeof(uint8_t),
-                             &updateConnParams);
+      // suit its use case; with the AUTO profile they follow the input.
+      HidDev_connActivity();
 
-        updateConnParams = FALSE;
+      // The host already has this state
+      if (HidDev_isDuplicate(pRpt, len, pData))
+      {
+        hidDevDedupSkipped++;
+        status = SUCCESS;
       }
-
-      // Send report notification
-      if (HidDev_sendNoti(pRpt->handle, len, pData) == SUCCESS)
+      else
       {
-        // Save the report just sent out
-        lastReport.id = id;
-        lastReport.type = type;
-        lastReport.len = len;
-        memcpy(lastReport.data, pData, len);
+        hidDevSent_t *pSent = pRpt->dedup ? HidDev_reportSent(pRpt) : NULL;
+
+        // Note the report first; a buffer filled in place belongs to the
+        // stack once it is sent.
+        hidDevSending.id = id;
+        hidDevSending.type = type;
+        hidDevSending.len = len;
+        memcpy(hidDevSending.data, pData, len);
+
+        // Send report notification
+        status = HidDev_sendNoti(pRpt->handle, len, pData);
+        if (status == SUCCESS)
+        {
+          // Save the report just sent out
+          lastReport = hidDevSending;
+
+          if (pSent != NULL)
+          {
+            pSent->time = Clock_getTicks();
+            pSent->len = len;
+            memcpy(pSent->data, hidDevSending.data, len);
+          }
+        }
       }
 
       // Start idle timer.
       HidDev_StartIdleTimer();
     }
   }
+
+  return status;
 }
 
 /*********************************************************************
  * @fn      hidDevSendNoti
  *
- * @brief   Send a HID notification.
+ * @brief   Send a HID notification. A report filled in place in a
+ *          reserved notification buffer is sent as is; once the stack
+ *          takes that buffer hidDevRsv.inPlace is cleared, otherwise the
+ *          buffer stays with the caller. A report longer than the ATT
+ *          MTU allows is dropped and counted rather than cut short.
  *
  * @param   handle - Attribute handle.
  * @param   len - Length of report.
  * @param   pData - Report data.
  *
- * @return  Success or failure.
+ * @return  Success, bleInvalidMtuSize if the report does not fit, or
+ *          the failure status.
  */
 static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData)
 {
   uint8_t status;
+  uint8_t inPlace = (hidDevRsv.inPlace && (pData == hidDevRsv.pData));
   attHandleValueNoti_t noti;
 
-  noti.pValue = GATT_bm_alloc(gapConnHandle, ATT_HANDLE_VALUE_NOTI, len, NULL);
+  // A partial report would be read by the host as a different one. Not
+  // retryable, so the report is not queued again.
+  if (len > (GATT_GetMTU(gapConnHandle) - HID_DEV_NOTI_HDR_LEN))
+  {
+    hidDevMtuDropped++;
+    return bleInvalidMtuSize;
+  }
+
+  noti.pValue = inPlace ? pData :
+                GATT_bm_alloc(gapConnHandle, ATT_HANDLE_VALUE_NOTI, len, NULL);
   if (noti.pValue != NULL)
   {
     noti.handle = handle;
     noti.len = len;
-    memcpy(noti.pValue, pData, len);
+    if (!inPlace)
+    {
+      memcpy(noti.pValue, pData, len);
+    }
 
     // Send notification
     status = GATT_Notification(gapConnHandle, &noti, FALSE);
-    if (status != SUCCESS)
+    if (status == SUCCESS)
+    {
+      if (inPlace)
+      {
+        hidDevRsv.inPlace = FALSE;
+      }
+    }
+    else if (!inPlace)
     {
       GATT_bm_free((gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI);
     }
@@ -1634,7 +2918,8 @@ static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData)
 /*********************************************************************
  * @fn      HidDev_enqueueReport
  *
- * @brief   Enqueue a HID report to be sent later.
+ * @brief   Enqueue a HID report to be sent later. Called by the
+ *          application task; the queue is changed under its lock.
  *
  * @param   id    - HID report ID.
  * @param   type  - HID report type.
@@ -1646,25 +2931,48 @@ static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData)
 static void HidDev_enqueueReport(uint8_t id, uint8_t type, uint8_t len,
                                  uint8_t *pData)
 {
+  hidDevReport_t *pReport;
+  ICall_CSState key;
+  uint8_t release;
+
   // Enqueue only if bonded.
   if (HidDev_bondCount() > 0)
   {
-    // Update last index.
-    lastQIdx = (lastQIdx + 1) % HID_DEV_REPORT_Q_SIZE;
+    key = reportQLock();
 
-    if (lastQIdx == firstQIdx)
+    // Fold into a queued report of the same ID if its policy allows.
+    if (!HidDev_coalesceReport(id, type, len, pData))
     {
-      // Queue overflow; discard oldest report.
-      firstQIdx = (firstQIdx + 1) % HID_DEV_REPORT_Q_SIZE;
+      release = HidDev_isRelease(id, type, len, pData);
+
+      if (!HidDev_makeRoom(id, type, len, release))
+      {
+        reportQUnlock(key);
+
+        // Queue overflow; the new report is the one discarded.
+        return;
+      }
+
+      // Save report at the end of the data pool. A reserved report is
+      // already there, or just past it if a report was discarded.
+      pReport = &hidDevReportQ[hidDevReportQLen++];
+      pReport->id = id;
+      pReport->type = type;
+      pReport->len = len;
+      pReport->pData = &hidDevReportData[hidDevReportDataLen];
+      if (pReport->pData != pData)
+      {
+        memmove(pReport->pData, pData, len);
+      }
+      pReport->release = release;
+      pReport->sending = FALSE;
+      hidDevReportDataLen += len;
     }
 
-    // Save report.
-    hidDevReportQ[lastQIdx].id = id;
-    hidDevReportQ[lastQIdx].type = type;
-    hidDevReportQ[lastQIdx].len = len;
-    memcpy(hidDevReportQ[lastQIdx].data, pData, len);
+    reportQUnlock(key);
 
-    if (hidDevConnSecure)
+    // Unless held for the next connection event
+    if (hidDevConnSecure && !reportDeferred())
     {
       // Notify our task to send out pending reports.
       Event_post(syncEvent, HID_SEND_REPORT_EVT);
@@ -1673,28 +2981,678 @@ static void HidDev_enqueueReport(uint8_t id, uint8_t type, uint8_t len,
 }
 
 /*********************************************************************
- * @fn      HidDev_dequeueReport
+ * @fn      HidDev_coalesceReport
  *
- * @brief   Dequeue a HID report to be sent out.
+ * @brief   Fold a HID report into the newest queued report with the same
+ *          ID and type, following the coalescing policy of the report.
+ *          A replaced report keeps its place in the queue, so it has to
+ *          keep its length too. Relative reports are only summed when
+ *          their state bytes are unchanged, so button transitions still
+ *          reach the host. A queued release, or the report being sent,
+ *          is never overwritten.
  *
  * @param   id    - HID report ID.
  * @param   type  - HID report type.
  * @param   len   - Length of report.
  * @param   pData - Report data.
  *
- * @return  None.
+ * @return  TRUE if the report was folded into the queue, FALSE if it
+ *          has to be queued on its own.
  */
-static hidDevReport_t *HidDev_dequeueReport(void)
+static uint8_t HidDev_coalesceReport(uint8_t id, uint8_t type, uint8_t len,
+                                     uint8_t *pData)
 {
-  if (reportQEmpty())
+  hidRptMap_t *pRpt = HidDev_reportById(id, type);
+  hidDevReport_t *pQueued;
+  uint8_t idx;
+  uint8_t i;
+
+  // Find the newest queued report with the same ID and type.
+  for (idx = hidDevReportQLen; idx > 0; idx--)
   {
-    return NULL;
+    pQueued = &hidDevReportQ[idx - 1];
+
+    if ((pQueued->id != id) || (pQueued->type != type))
+    {
+      continue;
+    }
+
+    // A report being sent was copied out already.
+    if (pQueued->release || pQueued->sending || (pRpt == NULL) ||
+        (pRpt->coalesce == HID_RPT_COALESCE_NONE))
+    {
+      return FALSE;
+    }
+
+    if (pQueued->len != len)
+    {
+      return FALSE;
+    }
+
+    if (pRpt->coalesce == HID_RPT_COALESCE_REPLACE)
+    {
+      memcpy(pQueued->pData, pData, len);
+
+      return TRUE;
+    }
+
+    // Sum relative fields only if the state before them is the same.
+    if ((pRpt->relOffset > len) ||
+        (memcmp(pQueued->pData, pData, pRpt->relOffset) != 0))
+    {
+      return FALSE;
+    }
+
+    for (i = pRpt->relOffset; i < len; i++)
+    {
+      int16_t sum = (int8_t)pQueued->pData[i] + (int8_t)pData[i];
+
+      if (sum > HID_DEV_REL_MAX)
+      {
+        sum = HID_DEV_REL_MAX;
+      }
+      else if (sum < -HID_DEV_REL_MAX)
+      {
+        sum = -HID_DEV_REL_MAX;
+      }
+
+      pQueued->pData[i] = (uint8_t)sum;
+    }
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_isRelease
+ *
+ * @brief   Tell whether a HID report is a release: all zero, or taking
+ *          something up against the previous report of its ID, which is
+ *          the newest queued one or else the last one sent. Something
+ *          goes up when a bit of the on/off state (modifiers, buttons) is
+ *          cleared or a usage leaves the usage array (keys). A report
+ *          that also presses something still counts, so the release in
+ *          it is not lost. Values such as axes are not looked at, and a
+ *          report without a layout is a release only when all zero.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  TRUE if the report is a release.
+ */
+static uint8_t HidDev_isRelease(uint8_t id, uint8_t type, uint8_t len,
+                                uint8_t *pData)
+{
+  hidRptMap_t *pRpt;
+  uint8_t *pPrev = NULL;
+  uint8_t prevLen = 0;
+  uint8_t i;
+  uint8_t j;
+
+  if (HidDev_isbufset(pData, 0x00, len))
+  {
+    return TRUE;
+  }
+
+  pRpt = HidDev_reportById(id, type);
+  if (pRpt == NULL)
+  {
+    return FALSE;
+  }
+
+  for (i = hidDevReportQLen; i > 0; i--)
+  {
+    if ((hidDevReportQ[i - 1].id == id) && (hidDevReportQ[i - 1].type == type))
+    {
+      pPrev = hidDevReportQ[i - 1].pData;
+      prevLen = hidDevReportQ[i - 1].len;
+      break;
+    }
+  }
+
+  if ((pPrev == NULL) && (lastReport.id == id) && (lastReport.type == type))
+  {
+    pPrev = lastReport.data;
+    prevLen = lastReport.len;
+  }
+
+  if ((pPrev == NULL) || (prevLen != len) ||
+      (pRpt->bitsOffset + pRpt->bitsLen > len) ||
+      (pRpt->arrayOffset + pRpt->arrayLen > len))
+  {
+    return FALSE;
+  }
+
+  // A bit of on/off state cleared
+  for (i = pRpt->bitsOffset; i < pRpt->bitsOffset + pRpt->bitsLen; i++)
+  {
+    if (pPrev[i] & ~pData[i])
+    {
+      return TRUE;
+    }
+  }
+
+  // A usage gone from the array, wherever the others moved to
+  for (i = pRpt->arrayOffset; i < pRpt->arrayOffset + pRpt->arrayLen; i++)
+  {
+    if (pPrev[i] == 0)
+    {
+      continue;
+    }
+
+    for (j = pRpt->arrayOffset; j < pRpt->arrayOffset + pRpt->arrayLen; j++)
+    {
+      if (pData[j] == pPrev[i])
+      {
+        break;
+      }
+    }
+
+    if (j == pRpt->arrayOffset + pRpt->arrayLen)
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_makeRoom
+ *
+ * @brief   Make room in the queue for a new HID report. A report past the
+ *          queue depth of its ID pushes out the oldest droppable report of
+ *          that ID. On queue overflow the oldest droppable report of the
+ *          lowest priority class goes, as long as that class is not above
+ *          the new report's, until the new report's data fits too.
+ *          Releases are never discarded, and may push out any droppable
+ *          report.
+ *
+ * @param   id      - HID report ID.
+ * @param   type    - HID report type.
+ * @param   len     - Length of the new report.
+ * @param   release - TRUE if the new report is a release.
+ *
+ * @return  TRUE if the report can be queued, FALSE if it is discarded.
+ */
+static uint8_t HidDev_makeRoom(uint8_t id, uint8_t type, uint8_t len,
+                               uint8_t release)
+{
+  hidRptMap_t *pRpt = HidDev_reportById(id, type);
+  uint8_t prio = (pRpt != NULL) ? pRpt->prio : HID_RPT_PRIO_STREAM;
+
+  if (release)
+  {
+    prio = 0xFF;
+  }
+  else if ((pRpt != NULL) && (pRpt->depth > 0) &&
+           (HidDev_countReports(id, type) >= pRpt->depth) &&
+           !HidDev_evictReport(id, type, TRUE, prio))
+  {
+    return FALSE;
+  }
+
+  while (!reportQFits(len))
+  {
+    if (!HidDev_evictReport(id, type, FALSE, prio))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_evictReport
+ *
+ * @brief   Discard the oldest droppable queued HID report of the lowest
+ *          priority class. Releases and the report being sent are never
+ *          discarded. A report of the
+ *          same ID left right behind an identical one goes with it, as it
+ *          no longer changes anything.
+ *
+ * @param   id      - HID report ID.
+ * @param   type    - HID report type.
+ * @param   sameId  - TRUE to only consider reports with this ID and type.
+ * @param   maxPrio - Highest priority class that may be discarded.
+ *
+ * @return  TRUE if a report was discarded.
+ */
+static uint8_t HidDev_evictReport(uint8_t id, uint8_t type, uint8_t sameId,
+                                  uint8_t maxPrio)
+{
+  hidDevReport_t *pReport;
+  hidRptMap_t *pRpt;
+  uint8_t victim = HID_DEV_NO_REPORT;
+  uint8_t victimPrio = 0;
+  uint8_t prev = HID_DEV_NO_REPORT;
+  uint8_t prio;
+  uint8_t i;
+
+  for (i = 0; i < hidDevReportQLen; i++)
+  {
+    pReport = &hidDevReportQ[i];
+
+    if ((sameId && ((pReport->id != id) || (pReport->type != type))) ||
+        pReport->release || pReport->sending)
+    {
+      continue;
+    }
+
+    pRpt = HidDev_reportById(pReport->id, pReport->type);
+    prio = (pRpt != NULL) ? pRpt->prio : HID_RPT_PRIO_STREAM;
+
+    if ((prio <= maxPrio) &&
+        ((victim == HID_DEV_NO_REPORT) || (prio < victimPrio)))
+    {
+      victim = i;
+      victimPrio = prio;
+    }
+  }
+
+  if (victim == HID_DEV_NO_REPORT)
+  {
+    return FALSE;
+  }
+
+  id = hidDevReportQ[victim].id;
+  type = hidDevReportQ[victim].type;
+  HidDev_removeReport(victim);
+
+  // Neighbours of the same ID on either side of the discarded report
+  for (i = victim; i > 0; i--)
+  {
+    if ((hidDevReportQ[i - 1].id == id) && (hidDevReportQ[i - 1].type == type))
+    {
+      prev = i - 1;
+      break;
+    }
+  }
+
+  for (i = victim; i < hidDevReportQLen; i++)
+  {
+    if ((hidDevReportQ[i].id == id) && (hidDevReportQ[i].type == type))
+    {
+      if ((prev != HID_DEV_NO_REPORT) && !hidDevReportQ[i].sending &&
+          (hidDevReportQ[prev].len == hidDevReportQ[i].len) &&
+          (memcmp(hidDevReportQ[prev].pData, hidDevReportQ[i].pData,
+                  hidDevReportQ[i].len) == 0))
+      {
+        HidDev_removeReport(i);
+      }
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      HidDev_countReports
+ *
+ * @brief   Count the queued HID reports with an ID and type, leaving
+ *          out the one being sent.
+ *
+ * @param   id   - HID report ID.
+ * @param   type - HID report type.
+ *
+ * @return  Number of queued reports.
+ */
+static uint8_t HidDev_countReports(uint8_t id, uint8_t type)
+{
+  uint8_t count = 0;
+  uint8_t i;
+
+  for (i = 0; i < hidDevReportQLen; i++)
+  {
+    if ((hidDevReportQ[i].id == id) && (hidDevReportQ[i].type == type) &&
+        !hidDevReportQ[i].sending)
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/*********************************************************************
+ * @fn      HidDev_nextReport
+ *
+ * @brief   Pick the next HID report to send. Only the oldest queued report
+ *          of each ID is a candidate, so reports of one ID keep their
+ *          order. The highest priority class wins among the IDs with
+ *          credit left in this round; each ID gets as many credits per
+ *          round as its bandwidth share.
+ *
+ * @param   None.
+ *
+ * @return  Queue index of the report, or HID_DEV_NO_REPORT if the queue
+ *          is empty.
+ */
+static uint8_t HidDev_nextReport(void)
+{
+  hidDevReport_t *pReport;
+  hidRptMap_t *pRpt;
+  uint8_t next = HID_DEV_NO_REPORT;
+  uint8_t nextPrio = 0;
+  uint8_t prio;
+  uint8_t round;
+  uint8_t i, j;
+
+  for (round = 0; (round < 2) && (next == HID_DEV_NO_REPORT); round++)
+  {
+    for (i = 0; i < hidDevReportQLen; i++)
+    {
+      pReport = &hidDevReportQ[i];
+
+      // Skip reports queued behind an older one of the same ID.
+      for (j = 0; j < i; j++)
+      {
+        if ((hidDevReportQ[j].id == pReport->id) &&
+            (hidDevReportQ[j].type == pReport->type))
+        {
+          break;
+        }
+      }
+
+      if (j < i)
+      {
+        continue;
+      }
+
+      pRpt = HidDev_reportById(pReport->id, pReport->type);
+      prio = (pRpt != NULL) ? pRpt->prio : HID_RPT_PRIO_STREAM;
+
+      if ((HidDev_reportCredit(pRpt) != NULL) &&
+          (*HidDev_reportCredit(pRpt) == 0))
+      {
+        continue;
+      }
+
+      if ((next == HID_DEV_NO_REPORT) || (prio > nextPrio))
+      {
+        next = i;
+        nextPrio = prio;
+      }
+    }
+
+    // Every candidate used up its share; start a new round.
+    if ((next == HID_DEV_NO_REPORT) && !reportQEmpty())
+    {
+      for (i = 0; (i < hidDevRptTblLen) && (i < HID_DEV_MAX_REPORTS); i++)
+      {
+        hidDevRptCredit[i] = (pHidDevRptTbl[i].share > 0) ?
+                             pHidDevRptTbl[i].share : 1;
+      }
+    }
+  }
+
+  return next;
+}
+
+/*********************************************************************
+ * @fn      HidDev_takeReport
+ *
+ * @brief   Pick the next HID report to send, mark it as being sent and
+ *          copy it out, so it can be sent without holding the queue lock
+ *          while the application changes the queue. Called by the HidDev
+ *          task, with no report being sent.
+ *
+ * @param   pOut - Copy of the report.
+ *
+ * @return  TRUE if a report was taken, FALSE if the queue is empty.
+ */
+static uint8_t HidDev_takeReport(hidDevLastReport_t *pOut)
+{
+  hidDevReport_t *pReport;
+  ICall_CSState key = reportQLock();
+  uint8_t idx = HidDev_nextReport();
+
+  if (idx != HID_DEV_NO_REPORT)
+  {
+    pReport = &hidDevReportQ[idx];
+    pReport->sending = TRUE;
+    pOut->id = pReport->id;
+    pOut->type = pReport->type;
+    pOut->len = pReport->len;
+    memcpy(pOut->data, pReport->pData, pReport->len);
+  }
+
+  reportQUnlock(key);
+
+  return (idx != HID_DEV_NO_REPORT);
+}
+
+/*********************************************************************
+ * @fn      HidDev_finishReport
+ *
+ * @brief   Remove the report taken with HidDev_takeReport from the
+ *          queue, or put it back to be retried. Reports ahead of it may
+ *          have been evicted meanwhile, so it is found by its mark; a
+ *          flushed queue no longer has it.
+ *
+ * @param   sent - TRUE to remove it, FALSE to keep it.
+ *
+ * @return  None.
+ */
+static void HidDev_finishReport(uint8_t sent)
+{
+  ICall_CSState key = reportQLock();
+  uint8_t i;
+
+  for (i = 0; i < hidDevReportQLen; i++)
+  {
+    if (hidDevReportQ[i].sending)
+    {
+      if (sent)
+      {
+        HidDev_removeReport(i);
+      }
+      else
+      {
+        hidDevReportQ[i].sending = FALSE;
+      }
+      break;
+    }
+  }
+
+  reportQUnlock(key);
+}
+
+/*********************************************************************
+ * @fn      HidDev_reportCredit
+ *
+ * @brief   Get the bandwidth credit left in this round for a report.
+ *
+ * @param   pRpt - HID report structure, may be NULL.
+ *
+ * @return  Pointer to the credit, or NULL if the report has no share.
+ */
+static uint8_t *HidDev_reportCredit(hidRptMap_t *pRpt)
+{
+  uint8_t idx;
+
+  if (pRpt == NULL)
+  {
+    return NULL;
+  }
+
+  idx = (uint8_t)(pRpt - pHidDevRptTbl);
+
+  return (idx < HID_DEV_MAX_REPORTS) ? &hidDevRptCredit[idx] : NULL;
+}
+
+/*********************************************************************
+ * @fn      HidDev_reportSent
+ *
+ * @brief   Get the last report sent on this connection for a report.
+ *
+ * @param   pRpt - HID report structure, may be NULL.
+ *
+ * @return  Pointer to the last sent report, or NULL if the report has
+ *          no cache.
+ */
+static hidDevSent_t *HidDev_reportSent(hidRptMap_t *pRpt)
+{
+  uint8_t idx;
+
+  if (pRpt == NULL)
+  {
+    return NULL;
+  }
+
+  idx = (uint8_t)(pRpt - pHidDevRptTbl);
+
+  return (idx < HID_DEV_MAX_REPORTS) ? &hidDevRptSent[idx] : NULL;
+}
+
+/*********************************************************************
+ * @fn      HidDev_notifyEnabled
+ *
+ * @brief   Tell whether notifications are enabled for a report on this
+ *          connection.
+ *
+ * @param   pRpt - HID report structure.
+ *
+ * @return  TRUE if enabled
+ */
+static uint8_t HidDev_notifyEnabled(hidRptMap_t *pRpt)
+{
+  uint8_t idx = (uint8_t)(pRpt - pHidDevRptTbl);
+
+  if (pRpt->pCccdAttr == NULL)
+  {
+    return FALSE;
+  }
+
+  if (idx < HID_DEV_NOTIFY_MAX_REPORTS)
+  {
+    return (hidDevRptNotify & ((uint32_t)1 << idx)) != 0;
+  }
+
+  return (GATTServApp_ReadCharCfg(gapConnHandle,
+                                  GATT_CCC_TBL(pRpt->pCccdAttr->pValue)) &
+          GATT_CLIENT_CFG_NOTIFY) != 0;
+}
+
+/*********************************************************************
+ * @fn      HidDev_setNotify
+ *
+ * @brief   Note a report's notifications being enabled or disabled.
+ *
+ * @param   pRpt   - HID report structure.
+ * @param   enable - TRUE if enabled.
+ *
+ * @return  none
+ */
+static void HidDev_setNotify(hidRptMap_t *pRpt, uint8_t enable)
+{
+  uint8_t idx = (uint8_t)(pRpt - pHidDevRptTbl);
+
+  if (idx < HID_DEV_NOTIFY_MAX_REPORTS)
+  {
+    if (enable)
+    {
+      hidDevRptNotify |= ((uint32_t)1 << idx);
+    }
+    else
+    {
+      hidDevRptNotify &= ~((uint32_t)1 << idx);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidDev_refreshNotify
+ *
+ * @brief   Reload the notification bitmap from the CCCDs. The bond
+ *          manager restores a bonded host's CCCDs, and the battery
+ *          service takes writes to its own, without HidDev_WriteAttrCB.
+ *
+ * @return  none
+ */
+static void HidDev_refreshNotify(void)
+{
+  uint8_t i;
+  hidRptMap_t *p = pHidDevRptTbl;
+
+  for (i = 0; (i < hidDevRptTblLen) && (i < HID_DEV_NOTIFY_MAX_REPORTS);
+       i++, p++)
+  {
+    if (p->pCccdAttr != NULL)
+    {
+      uint16_t value = GATTServApp_ReadCharCfg(gapConnHandle,
+                                               GATT_CCC_TBL(p->pCccdAttr->pValue));
+
+      HidDev_setNotify(p, (value & GATT_CLIENT_CFG_NOTIFY) != 0);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      HidDev_isDuplicate
+ *
+ * @brief   Tell whether a report of a deduplicated ID is identical to the
+ *          last one sent and its keep-alive interval has not run out.
+ *
+ * @param   pRpt  - HID report structure.
+ * @param   len   - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  TRUE if the report need not be sent.
+ */
+static uint8_t HidDev_isDuplicate(hidRptMap_t *pRpt, uint8_t len,
+                                  uint8_t *pData)
+{
+  hidDevSent_t *pSent;
+
+  if (!pRpt->dedup || ((pSent = HidDev_reportSent(pRpt)) == NULL) ||
+      (pSent->len == 0) || (pSent->len != len) ||
+      (memcmp(pSent->data, pData, len) != 0))
+  {
+    return FALSE;
+  }
+
+  return ((pRpt->keepAlive == 0) ||
+          ((Clock_getTicks() - pSent->time) <
+           (uint32_t)pRpt->keepAlive * (1000 / Clock_tickPeriod)));
+}
+
+/*********************************************************************
+ * @fn      HidDev_removeReport
+ *
+ * @brief   Remove a HID report from the queue once it has been sent.
+ *          The data of the reports behind it moves down to close the gap.
+ *          Called with the queue lock held.
+ *
+ * @param   idx - Queue index of the report.
+ *
+ * @return  None.
+ */
+static void HidDev_removeReport(uint8_t idx)
+{
+  uint8_t *pData = hidDevReportQ[idx].pData;
+  uint8_t len = hidDevReportQ[idx].len;
+  uint8_t i;
+
+  memmove(pData, pData + len,
+          &hidDevReportData[hidDevReportDataLen] - (pData + len));
+  hidDevReportDataLen -= len;
+
+  for (i = idx + 1; i < hidDevReportQLen; i++)
+  {
+    hidDevReportQ[i].pData -= len;
   }
 
-  // Update first index.
-  firstQIdx = (firstQIdx + 1) % HID_DEV_REPORT_Q_SIZE;
+  hidDevReportQLen--;
 
-  return (&(hidDevReportQ[firstQIdx]));
+  memmove(&hidDevReportQ[idx], &hidDevReportQ[idx + 1],
+          (hidDevReportQLen - idx) * sizeof(hidDevReport_t));
 }
 
 /*********************************************************************
@@ -80,6 +80,31 @@ extern "C"
                                           // the HID Dev GAP Bond Manager
                                           // Pairing State. Read Only.
                                           // Size is uint8_t.
+#define HIDDEV_DEDUP_SKIPPED        0x03  // Reading this parameter will return
+                                          // the number of input reports not
+                                          // sent as identical to the last
+                                          // one. Read Only. Size is uint32_t.
+#define HIDDEV_CONN_EVT_ALIGN       0x04  // TRUE to hold reports and submit
+                                          // them just before each connection
+                                          // event. Read/Write. Size is
+                                          // uint8_t.
+#define HIDDEV_CONN_PROFILE         0x05  // Connection parameter profile,
+                                          // HID_DEV_CONN_PROFILE_AUTO or one
+                                          // pinned by the host. Read/Write.
+                                          // Size is uint8_t.
+#define HIDDEV_CONN_QUIET_TIME      0x06  // Time in ms without input before
+                                          // the AUTO profile relaxes to IDLE.
+                                          // Read/Write. Size is uint16_t.
+#define HIDDEV_MTU_DROPPED          0x07  // Reading this parameter will return
+                                          // the number of input reports not
+                                          // sent as longer than ATT_MTU - 3.
+                                          // Read Only. Size is uint32_t.
+
+// Connection parameter profiles
+#define HID_DEV_CONN_PROFILE_AUTO   0  // GAMING on input, IDLE when quiet
+#define HID_DEV_CONN_PROFILE_GAMING 1  // Shortest interval, no slave latency
+#define HID_DEV_CONN_PROFILE_TYPING 2  // The GAPRole desired parameters
+#define HID_DEV_CONN_PROFILE_IDLE   3  // Long interval, high slave latency
 
 // HID read/write operation
 #define HID_DEV_OPER_WRITE          0  // Write operation
@@ -94,12 +119,24 @@ extern "C"
 #define HID_DEV_SET_REPORT_EVT            3  // HID set report mode
 #define HID_DEV_GAPROLE_STATE_CHANGE_EVT  4  // HID GAP Role state change
 #define HID_DEV_GAPBOND_STATE_CHANGE_EVT  5  // HID GAP Bond state change
+#define HID_DEV_REPORT_Q_SPACE_EVT        6  // HID report queue has room again
+                                             // after HidDev_QueueReport
+                                             // returned bleNoResources
 
 /* HID Report type */
 #define HID_REPORT_TYPE_INPUT       1
 #define HID_REPORT_TYPE_OUTPUT      2
 #define HID_REPORT_TYPE_FEATURE     3
 
+/* HID report queue priority class */
+#define HID_RPT_PRIO_STREAM         0    // Continuous state, e.g. mouse, gamepad
+#define HID_RPT_PRIO_EVENT          1    // Discrete events, e.g. keyboard, consumer
+
+/* HID report queue coalescing policy */
+#define HID_RPT_COALESCE_NONE       0    // Queue every report
+#define HID_RPT_COALESCE_REPLACE    1    // Absolute state, newest replaces queued
+#define HID_RPT_COALESCE_SUM        2    // Relative, sum into queued report
+
 /* HID information flags */
 #define HID_FLAGS_REMOTE_WAKE           0x01 // RemoteWake
 #define HID_FLAGS_NORMALLY_CONNECTABLE  0x02 // NormallyConnectable
@@ -283,6 +320,18 @@ typedef struct
   uint8_t         id;           // Report ID
   uint8_t         type;         // Report type
   uint8_t         mode;         // Protocol mode (report or boot)
+  uint8_t         coalesce;     // Queue coalescing policy (HID_RPT_COALESCE_*)
+  uint8_t         relOffset;    // First relative byte for HID_RPT_COALESCE_SUM
+  uint8_t         prio;         // Queue priority class (HID_RPT_PRIO_*)
+  uint8_t         depth;        // Max reports queued, 0 for the whole queue
+  uint8_t         share;        // Reports sent per scheduling round, 0 for 1
+  uint8_t         dedup;        // TRUE to skip a report identical to the last sent
+  uint16_t        keepAlive;    // Send an identical report anyway after this
+                                // many ms since the last one, 0 for never
+  uint8_t         bitsOffset;   // First byte of on/off state (modifiers, buttons)
+  uint8_t         bitsLen;      // Bytes of on/off state, 0 for none
+  uint8_t         arrayOffset;  // First byte of a usage array (keys)
+  uint8_t         arrayLen;     // Bytes of the usage array, 0 for none
 } hidRptMap_t;
 
 // HID dev configuration structure
@@ -300,7 +349,7 @@ typedef struct
 // These variables are defined in the service source file that uses HID Dev
 
 // HID report map length
-extern uint8_t hidReportMapLen;
+extern uint16_t hidReportMapLen;
 
 // HID protocol mode
 extern uint8_t hidProtocolMode;
@@ -368,7 +417,8 @@ extern void HidDev_Register(hidDevCfg_t *pCfg, hidDevCB_t *pCBs);
 /*********************************************************************
  * @fn      HidDev_RegisterReports
  *
- * @brief   Register the report table with HID Dev.
+ * @brief   Register the report table with HID Dev. The table is indexed
+ *          here, so its IDs and handles must not change afterwards.
  *
  * @param   numReports - Length of report table.
  * @param   pRpt       - Report table.
@@ -377,6 +427,20 @@ extern void HidDev_Register(hidDevCfg_t *pCfg, hidDevCB_t *pCBs);
  */
 extern void HidDev_RegisterReports(uint8_t numReports, hidRptMap_t *pRpt);
 
+/*********************************************************************
+ * @fn      HidDev_RegisterAttrs
+ *
+ * @brief   Register the HID service attribute table with HID Dev once
+ *          GATTServApp_RegisterService has assigned its handles. The
+ *          attribute callbacks then dispatch on the attribute handle.
+ *
+ * @param   pAttrs   - HID service attribute table.
+ * @param   numAttrs - Number of attributes.
+ *
+ * @return  None.
+ */
+extern void HidDev_RegisterAttrs(gattAttribute_t *pAttrs, uint16_t numAttrs);
+
 /*********************************************************************
  * @fn      HidDev_Report
  *
@@ -392,6 +456,69 @@ extern void HidDev_RegisterReports(uint8_t numReports, hidRptMap_t *pRpt);
 extern void HidDev_Report(uint8_t id, uint8_t type, uint8_t len,
                           uint8_t *pData);
 
+/*********************************************************************
+ * @fn      HidDev_QueueReport
+ *
+ * @brief   Queue a HID report without ever discarding a queued one.
+ *          If the queue, or the report's depth in it, is full the
+ *          report is refused and HID_DEV_REPORT_Q_SPACE_EVT is sent
+ *          once a slot frees up.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Length of report.
+ * @param   pData - Report data.
+ *
+ * @return  SUCCESS, bleNoResources if the queue or the report's depth
+ *          in it is full, bleIncorrectMode if not bonded, bleInvalidRange
+ *          if the report is too long.
+ */
+extern bStatus_t HidDev_QueueReport(uint8_t id, uint8_t type, uint8_t len,
+                                    uint8_t *pData);
+
+/*********************************************************************
+ * @fn      HidDev_ReserveReport
+ *
+ * @brief   Reserve a buffer for a HID report so the application can build
+ *          the report in place, then send it with HidDev_CommitReport.
+ *          Only one report can be reserved at a time, and no other report
+ *          may be sent until it is committed.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ * @param   len   - Largest length of the report.
+ *
+ * @return  Buffer of len bytes, or NULL if the report is too long or
+ *          another one is reserved.
+ */
+extern uint8_t *HidDev_ReserveReport(uint8_t id, uint8_t type, uint8_t len);
+
+/*********************************************************************
+ * @fn      HidDev_CommitReport
+ *
+ * @brief   Send the HID report reserved with HidDev_ReserveReport, as
+ *          HidDev_Report would.
+ *
+ * @param   len - Length of report, up to the reserved length; 0 to
+ *                release the reservation without sending.
+ *
+ * @return  None.
+ */
+extern void HidDev_CommitReport(uint8_t len);
+
+/*********************************************************************
+ * @fn      HidDev_IsNotifyEnabled
+ *
+ * @brief   Tell whether the host has enabled notifications for a report
+ *          in the current protocol mode.
+ *
+ * @param   id    - HID report ID.
+ * @param   type  - HID report type.
+ *
+ * @return  TRUE if enabled, FALSE if not or the report is unknown.
+ */
+extern uint8_t HidDev_IsNotifyEnabled(uint8_t id, uint8_t type);
+
 /*********************************************************************
  * @fn      HidDev_Close
  *
@@ -64,6 +64,21 @@
  * CONSTANTS
  */
 
+// HID report mapping table indexes: the report map's input reports, the
+// boot and battery input reports, then the report map's output and feature
+// reports and the boot keyboard output report
+#define HID_RPT_IDX_KEY_IN            HID_DESC_KEYBOARD_IN_IDX
+#define HID_RPT_IDX_CC_IN             HID_DESC_CONSUMER_IN_IDX
+#define HID_RPT_IDX_GAMEPAD_IN        HID_DESC_GAMEPAD_IN_IDX
+#define HID_RPT_IDX_SYS_IN            HID_DESC_SYSTEM_IN_IDX
+#define HID_RPT_IDX_BOOT_KEY_IN       (HID_DESC_NUM_INPUT_REPORTS)
+#define HID_RPT_IDX_BOOT_MOUSE_IN     (HID_DESC_NUM_INPUT_REPORTS + 1)
+#define HID_RPT_IDX_BATT_LEVEL_IN     (HID_DESC_NUM_INPUT_REPORTS + 2)
+#define HID_RPT_IDX_OTHER             (HID_DESC_NUM_INPUT_REPORTS + 3)
+#define HID_RPT_IDX_LED_OUT           (HID_RPT_IDX_OTHER + HID_DESC_KEYBOARD_OUT_IDX)
+#define HID_RPT_IDX_FEATURE           (HID_RPT_IDX_OTHER + HID_DESC_KEYBOARD_FEATURE_IDX)
+#define HID_RPT_IDX_BOOT_KEY_OUT      (HID_RPT_IDX_OTHER + HID_DESC_NUM_OTHER_REPORTS)
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -145,312 +160,32 @@ static CONST uint8 hidInfo[HID_INFORMATION_LEN] =
   HID_KBD_FLAGS                                   // Flags
 };
 
-// HID Report Map characteristic value
-// Keyboard report descriptor (using format for Boot interface descriptor)
-#if  defined(GENERNAL)
+// HID Report Map characteristic value: one composite device, each
+// collection with its own report ID (hid_desc.h)
 static CONST uint8 hidReportMap[] =
 {
-  0x05, 0x01,     // Usage Pg (Generic Desktop)
-  0x09, 0x06,     // Usage (Keyboard)
-  0xA1, 0x01,     // Collection: (Application)
-                  //
-  0x05, 0x07,     // Usage Pg (Key Codes)
-  0x19, 0xE0,     // Usage Min (224)
-  0x29, 0xE7,     // Usage Max (231)
-  0x15, 0x00,     // Log Min (0)
-  0x25, 0x01,     // Log Max (1)
-                  //
-                  // Modifier byte
-  0x75, 0x01,     // Report Size (1)
-  0x95, 0x08,     // Report Count (8)
-  0x81, 0x02,     // Input: (Data, Variable, Absolute)
-                  //
-                  // Reserved byte
-  0x95, 0x01,     // Report Count (1)
-  0x75, 0x08,     // Report Size (8)
-  0x81, 0x01,     // Input: (Constant)
-                  //
-                  // LED report
-  0x95, 0x05,     // Report Count (5)
-  0x75, 0x01,     // Report Size (1)
-  0x05, 0x08,     // Usage Pg (LEDs)
-  0x19, 0x01,     // Usage Min (1)
-  0x29, 0x05,     // Usage Max (5)
-  0x91, 0x02,     // Output: (Data, Variable, Absolute)
-                  //
-                  // LED report padding
-  0x95, 0x01,     // Report Count (1)
-  0x75, 0x03,     // Report Size (3)
-  0x91, 0x01,     // Output: (Constant)
-                  //
-                  // Key arrays (6 bytes)
-  0x95, 0x06,     // Report Count (6)
-  0x75, 0x08,     // Report Size (8)
-  0x15, 0x00,     // Log Min (0)
-  0x25, 0x65,     // Log Max (101)
-  0x05, 0x07,     // Usage Pg (Key Codes)
-  0x19, 0x00,     // Usage Min (0)
-  0x29, 0x65,     // Usage Max (101)
-  0x81, 0x00,     // Input: (Data, Array)
-                  //
-  0xC0            // End Collection
-};
-#elif defined(CUSTOMER)
-static CONST uint8 hidReportMap[] =
-{
-   0x05, 0x0c,                    // USAGE_PAGE (Consumer Devices)
-   0x09, 0x01,                    // USAGE (Consumer Control)
-   0xa1, 0x01,                    // COLLECTION (Application)
-   0x85, 0x01,                    //   REPORT_ID (1)
-   0x09, 0xCD,                    //   USAGE (Play/Pause)
-   0x09, 0xB5,                    //   USAGE (Scan next track)
-   0x09, 0xB6,                    //   USAGE (Scan previous track)
-   0x09, 0xE9,                    //   USAGE (Volume up)
-   0x09, 0xEA,                    //   USAGE (Volume down)
-   0x09, 0xE2,                    //   USAGE (Volume mute)
-   0x09, 0x40,                    //   USAGE (Menu)
-   0x09, 0x41,                    //   USAGE (Menu Pick)
-   0x09, 0x42,                    //   USAGE (Menu up)
-   0x09, 0x43,                    //   USAGE (Menu down)
-   0x09, 0x44,                    //   USAGE (Menu left)
-   0x09, 0x45,                    //   USAGE (Menu right)
-   0x09, 0x46,                    //   USAGE (Menu escape)
-   0x09, 0x82,                    //   USAGE (Assign Selection)
-   0x09, 0x83,                    //   USAGE (Mode Step)
-   0x09, 0x94,                    //   USAGE (Quit)
-   0x09, 0x9C,                    //   USAGE (Channel Increment)
-   0x09, 0x9D,                    //   USAGE (Channel Decrement)
-   0x0A, 0x25, 0x02,              //   USAGE (AL FORWARD)
-   0x0A, 0x24, 0x02,              //   USAGE (AL BACK)
-   0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-   0x25, 0x14,                    //   LOGICAL_MAXIMUM (14)
-   0x95, 0x01,                    //   REPORT_COUNT (1)
-   0x75, 0x08,                    //   REPORT_SIZE (8)
-   0x81, 0x00,                    //   INPUT (Data,Ary,Abs)
-   0xc0                           // END_COLLECTION
-};
-#elif defined(JOYSTICK)
-//  JOYSTICK report descriptor (using format for Boot interface descriptor)
-static const uint8 hidReportMap = {
-    USAGE_PAGE(1),      0x01,         // Generic Desktop
-    USAGE(1),           0x04,         // Joystick
-    COLLECTION(1),      0x01,         // Application
-    COLLECTION(1),      0x00,         //  Physical
-    USAGE_PAGE(1),      0x09,         //   Buttons
-    USAGE_MINIMUM(1),   0x01,
-    USAGE_MAXIMUM(1),   0x03,
-    LOGICAL_MINIMUM(1), 0x00,
-    LOGICAL_MAXIMUM(1), 0x01,
-    REPORT_COUNT(1),    0x03,         //   2 bits (Buttons)
-    REPORT_SIZE(1),     0x01,
-    INPUT(1),           0x02,         //   Data, Variable, Absolute
-    REPORT_COUNT(1),    0x01,         //   6 bits (Padding)
-    REPORT_SIZE(1),     0x05,
-    INPUT(1),           0x01,         //   Constant
-    USAGE_PAGE(1),      0x01,         //   Generic Desktop
-    USAGE(1),           0x30,         //   X
-    USAGE(1),           0x31,         //   Y
-    USAGE(1),           0x32,         //   Z
-    USAGE(1),           0x33,         //   Rx
-    LOGICAL_MINIMUM(1), 0x81,         //   -127
-    LOGICAL_MAXIMUM(1), 0x7f,         //   127
-    REPORT_SIZE(1),     0x08,         //   Three bytes
-    REPORT_COUNT(1),    0x04,
-    INPUT(1),           0x02,         //   Data, Variable, Absolute (unlike mouse)
-    END_COLLECTION(0),
-    END_COLLECTION(0),
+  HID_DESC_REPORT_MAP
 };
-#elif defined(KEYBOARD)
-static const uint8 KEYBOARD_REPORT_MAP = {
-    USAGE_PAGE(1),      0x01,       // Generic Desktop Ctrls
-    USAGE(1),           0x06,       // Keyboard
-    COLLECTION(1),      0x01,       // Application
-    USAGE_PAGE(1),      0x07,       // Kbrd/Keypad
-    USAGE_MINIMUM(1),   0xE0,
-    USAGE_MAXIMUM(1),   0xE7,
-    LOGICAL_MINIMUM(1), 0x00,
-    LOGICAL_MAXIMUM(1), 0x01,
-    REPORT_SIZE(1),     0x01,       //   1 byte (Modifier)
-    REPORT_COUNT(1),    0x08,
-    INPUT(1),           0x02,       //   Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position
-    REPORT_COUNT(1),    0x01,       //   1 byte (Reserved)
-    REPORT_SIZE(1),     0x08,
-    INPUT(1),           0x01,       //   Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position
-    REPORT_COUNT(1),    0x05,       //   5 bits (Num lock, Caps lock, Scroll lock, Compose, Kana)
-    REPORT_SIZE(1),     0x01,
-    USAGE_PAGE(1),      0x08,       //   LEDs
-    USAGE_MINIMUM(1),   0x01,       //   Num Lock
-    USAGE_MAXIMUM(1),   0x05,       //   Kana
-    OUTPUT(1),          0x02,       //   Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile
-    REPORT_COUNT(1),    0x01,       //   3 bits (Padding)
-    REPORT_SIZE(1),     0x03,
-    OUTPUT(1),          0x01,       //   Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile
-    REPORT_COUNT(1),    0x06,       //   6 bytes (Keys)
-    REPORT_SIZE(1),     0x08,
-    LOGICAL_MINIMUM(1), 0x00,
-    LOGICAL_MAXIMUM(1), 0x65,       //   101 keys
-    USAGE_PAGE(1),      0x07,       //   Kbrd/Keypad
-    USAGE_MINIMUM(1),   0x00,
-    USAGE_MAXIMUM(1),   0x65,
-    INPUT(1),           0x00,       //   Data,Array,Abs,No Wrap,Linear,Preferred State,No Null Position
-    END_COLLECTION(0),
-};
-#elif defined(MOUSE)
-static const MOUSE_REPORT_MAP = {
-    USAGE_PAGE(1),      0x01,         // Generic Desktop
-    USAGE(1),           0x02,         // Mouse
-    COLLECTION(1),      0x01,         // Application
-    USAGE(1),           0x01,         // Pointer
-    COLLECTION(1),      0x00,         // Physical
-    USAGE_PAGE(1),      0x09,         // Buttons
-    USAGE_MINIMUM(1),   0x01,
-    USAGE_MAXIMUM(1),   0x03,
-    LOGICAL_MINIMUM(1), 0x00,
-    LOGICAL_MAXIMUM(1), 0x01,
-    REPORT_COUNT(1),    0x03,         //   3 bits (Buttons)
-    REPORT_SIZE(1),     0x01,
-    INPUT(1),           0x02,         //   Data, Variable, Absolute
-    REPORT_COUNT(1),    0x01,         //   5 bits (Padding)
-    REPORT_SIZE(1),     0x05,
-    INPUT(1),           0x01,         //   Constant
-    USAGE_PAGE(1),      0x01,         //   Generic Desktop
-    USAGE(1),           0x30,         //   X
-    USAGE(1),           0x31,         //   Y
-    USAGE(1),           0x38,         //   Wheel
-    LOGICAL_MINIMUM(1), 0x81,         //   -127
-    LOGICAL_MAXIMUM(1), 0x7f,         //   127
-    REPORT_SIZE(1),     0x08,         //   Three bytes
-    REPORT_COUNT(1),    0x03,
-    INPUT(1),           0x06,         //   Data, Variable, Relative
-    END_COLLECTION(0),
-    END_COLLECTION(0),
-};
-#elif defined(GAME_PAD)
-//  GAME_PAD report descriptor (using format for Boot interface descriptor)
-//char hidReportMap[118] = {
-//    0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
-//    0x09, 0x05,                    // USAGE (Game Pad)
-//    0xa1, 0x01,                    // COLLECTION (Application)
-//    0x85, 0x03,                    //   REPORT_ID (3)
-//    0x75, 0x01,                    //   REPORT_SIZE (1)
-//    0x95, 0x08,                    //   REPORT_COUNT (8)
-//    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-//    0x25, 0x08,                    //   LOGICAL_MAXIMUM (8)
-//    0x81, 0x01,                    //   INPUT (Cnst,Ary,Abs)
-//    0x05, 0x01,                    //   USAGE_PAGE (Generic Desktop)
-//    0x75, 0x08,                    //   REPORT_SIZE (8)
-//    0x95, 0x01,                    //   REPORT_COUNT (1)
-//    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-//    0x25, 0x07,                    //   LOGICAL_MAXIMUM (7)
-//    0x46, 0x3b, 0x01,              //   PHYSICAL_MAXIMUM (315)
-//    0x65, 0x14,                    //   UNIT (Eng Rot:Angular Pos)
-//    0x09, 0x39,                    //   USAGE (Hat switch)
-//    0x81, 0x42,                    //   INPUT (Data,Var,Abs,Null)
-//    0x65, 0x00,                    //   UNIT (None)
-//    0x05, 0x09,                    //   USAGE_PAGE (Button)
-//    0x15, 0x01,                    //   LOGICAL_MINIMUM (1)
-//    0x25, 0x01,                    //   LOGICAL_MAXIMUM (1)
-//    0x19, 0x01,                    //   USAGE_MINIMUM (Button 1)
-//    0x29, 0x0f,                    //   USAGE_MAXIMUM (Button 15)
-//    0x75, 0x01,                    //   REPORT_SIZE (1)
-//    0x95, 0x0f,                    //   REPORT_COUNT (15)
-//    0x81, 0x02,                    //   INPUT (Data,Var,Abs)
-//    0x75, 0x01,                    //   REPORT_SIZE (1)
-//    0x95, 0x01,                    //   REPORT_COUNT (1)
-//    0x81, 0x01,                    //   INPUT (Cnst,Ary,Abs)
-//    0x05, 0x01,                    //   USAGE_PAGE (Generic Desktop)
-//    0x75, 0x08,                    //   REPORT_SIZE (8)
-//    0x95, 0x02,                    //   REPORT_COUNT (2)
-//    0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
-//    0x26, 0xff, 0x00,              //   LOGICAL_MAXIMUM (255)
-//    0x35, 0x00,                    //   PHYSICAL_MINIMUM (0)
-//    0x46, 0xff, 0x00,              //   PHYSICAL_MAXIMUM (255)
-//    0xa1, 0x00,                    //   COLLECTION (Physical)
-//    0x09, 0x30,                    //     USAGE (X)
-//    0x09, 0x31,                    //     USAGE (Y)
-//    0x81, 0x02,                    //     INPUT (Data,Var,Abs)
-//    0xc0,                          //     END_COLLECTION
-//    0xa1, 0x00,                    //   COLLECTION (Physical)
-//    0x09, 0x32,                    //   USAGE (Z)
-//    0x09, 0x35,                    //   USAGE (Rz)
-//    0x81, 0x02,                    //   INPUT (Data,Var,Abs)
-//    0xc0,                          // END_COLLECTION
-//    0x05, 0x02,                    // USAGE_PAGE (Simulation Controls)
-//    0x09, 0xc5,                    // USAGE (Brake)
-//    0x09, 0xc4,                    // USAGE (Accelerator)
-//    0x75, 0x08,                    // REPORT_SIZE (8)
-//    0x95, 0x02,                    // REPORT_COUNT (2)
-//    0x15, 0x00,                    // LOGICAL_MINIMUM (0)
-//    0x26, 0xff, 0x00,              // LOGICAL_MAXIMUM (255)
-//    0x35, 0x00,                    // PHYSICAL_MINIMUM (0)
-//    0x46, 0xff, 0x00,              // PHYSICAL_MAXIMUM (255)
-//    0x81, 0x02,                    // INPUT (Data,Var,Abs)
-//    0xc0                           // END_COLLECTION
-//};
-static const uint8 hidReportMap[] = {
-0x05,0x01,
-0x09,0x05,
-0xa1,0x01,
-0x85,0x03,
-0x75,0x01,
-0x95,0x08,
-0x81,0x01,
-0x05,0x01,
-0x75,0x08,
-0x95,0x01,
-0x25,0x07,
-0x46,0x3b,0x01,
-0x65,0x14,
-0x09,0x39,
-0x81,0x42,
-0x65,0x00,
-0x05,0x09,
-0x25,0x01,
-0x19,0x01,
-0x29,0x0f,
-0x75,0x01,
-0x95,0x0f,
-0x81,0x02,
-0x75,0x01,
-0x95,0x01,
-0x81,0x01,
-0x05,0x01,
-0x75,0x08,
-0x95,0x02,
-0x15,0x00,
-0x26,0xff,
-0x00,0x35,
-0x00,0x46,
-0xff,0x00,
-0xa1,0x00,
-0x09,0x30,
-0x09,0x31,
-0x81,0x02,
-0xc0,
-0xa1,0x00,
-0x09,0x32,
-0x09,0x35,
-0x81,0x02,
-0xc0,
-0x05,0x02,
-0x09,0xc5,
-0x09,0xc4,
-0x75,0x08,
-0x95,0x02,
-0x15,0x00,
-0x25,0xff,
-0x35,0x00,
-0x45,0xff,
-0x81,0x02,
-0xc0
-};
-#endif
 
 // HID report map length
-uint8 hidReportMapLen = sizeof(hidReportMap);
+uint16 hidReportMapLen = sizeof(hidReportMap);
 
-// HID report mapping table
-static hidRptMap_t  hidRptMap[HID_NUM_REPORTS];
+// Report mapping entry filled in at registration
+#define HID_RPT_MAP_UNSET \
+  { 0, NULL, 0, 0, 0, HID_RPT_COALESCE_NONE, 0, HID_RPT_PRIO_EVENT, 0, 0, 0, 0, \
+    0, 0, 0, 0 }
+
+// HID report mapping table. ID, type and mode of the report map's reports
+// come from hid_desc.h; the rest is filled in at registration.
+static hidRptMap_t  hidRptMap[HID_NUM_REPORTS] =
+{
+  HID_DESC_RPT_MAP_INPUT,
+  HID_RPT_MAP_UNSET,                      // Boot keyboard input
+  HID_RPT_MAP_UNSET,                      // Boot mouse input
+  HID_RPT_MAP_UNSET,                      // Battery level input
+  HID_DESC_RPT_MAP_OTHER,
+  HID_RPT_MAP_UNSET                       // Boot keyboard output
+};
 
 /*********************************************************************
  * Profile Attributes - variables
@@ -523,6 +258,44 @@ static uint8 hidReportFeature;
 static uint8 hidReportRefFeature[HID_REPORT_REF_LEN] =
              { HID_RPT_ID_FEATURE, HID_REPORT_TYPE_FEATURE };
 
+// HID Report characteristic, consumer control input
+static uint8 hidReportCcInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8 hidReportCcIn;
+static gattCharCfg_t *hidReportCcInClientCharCfg;
+
+// HID Report Reference characteristic descriptor, consumer control input
+static uint8 hidReportRefCcIn[HID_REPORT_REF_LEN] =
+             { HID_RPT_ID_CC_IN, HID_REPORT_TYPE_INPUT };
+
+// HID Report characteristic, gamepad input
+static uint8 hidReportGamepadInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8 hidReportGamepadIn;
+static gattCharCfg_t *hidReportGamepadInClientCharCfg;
+
+// HID Report Reference characteristic descriptor, gamepad input
+static uint8 hidReportRefGamepadIn[HID_REPORT_REF_LEN] =
+             { HID_RPT_ID_GAMEPAD_IN, HID_REPORT_TYPE_INPUT };
+
+// HID Report characteristic, system control input
+static uint8 hidReportSysInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8 hidReportSysIn;
+static gattCharCfg_t *hidReportSysInClientCharCfg;
+
+// HID Report Reference characteristic descriptor, system control input
+static uint8 hidReportRefSysIn[HID_REPORT_REF_LEN] =
+             { HID_RPT_ID_SYS_IN, HID_REPORT_TYPE_INPUT };
+
+// Client Characteristic Configuration tables allocated at registration
+static gattCharCfg_t ** const hidClientCharCfgTbls[] =
+{
+  &hidReportKeyInClientCharCfg,
+  &hidReportBootKeyInClientCharCfg,
+  &hidReportBootMouseInClientCharCfg,
+  &hidReportCcInClientCharCfg,
+  &hidReportGamepadInClientCharCfg,
+  &hidReportSysInClientCharCfg
+};
+
 /*********************************************************************
  * Profile Attributes - Table
  */
@@ -761,6 +534,102 @@ static gattAttribute_t hidAttrTbl[] =
         0,
         hidReportRefFeature
       },
+
+    // HID Report characteristic, consumer control input declaration
+    {
+      { ATT_BT_UUID_SIZE, characterUUID },
+      GATT_PERMIT_READ,
+      0,
+      &hidReportCcInProps
+    },
+
+      // HID Report characteristic, consumer control input
+      {
+        { ATT_BT_UUID_SIZE, hidReportUUID },
+        GATT_PERMIT_ENCRYPT_READ,
+        0,
+        &hidReportCcIn
+      },
+
+      // HID Report characteristic client characteristic configuration
+      {
+        { ATT_BT_UUID_SIZE, clientCharCfgUUID },
+        GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE,
+        0,
+        (uint8 *) &hidReportCcInClientCharCfg
+      },
+
+      // HID Report Reference characteristic descriptor, consumer control input
+      {
+        { ATT_BT_UUID_SIZE, reportRefUUID },
+        GATT_PERMIT_READ,
+        0,
+        hidReportRefCcIn
+      },
+
+    // HID Report characteristic, gamepad input declaration
+    {
+      { ATT_BT_UUID_SIZE, characterUUID },
+      GATT_PERMIT_READ,
+      0,
+      &hidReportGamepadInProps
+    },
+
+      // HID Report characteristic, gamepad input
+      {
+        { ATT_BT_UUID_SIZE, hidReportUUID },
+        GATT_PERMIT_ENCRYPT_READ,
+        0,
+        &hidReportGamepadIn
+      },
+
+      // HID Report characteristic client characteristic configuration
+      {
+        { ATT_BT_UUID_SIZE, clientCharCfgUUID },
+        GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE,
+        0,
+        (uint8 *) &hidReportGamepadInClientCharCfg
+      },
+
+      // HID Report Reference characteristic descriptor, gamepad input
+      {
+        { ATT_BT_UUID_SIZE, reportRefUUID },
+        GATT_PERMIT_READ,
+        0,
+        hidReportRefGamepadIn
+      },
+
+    // HID Report characteristic, system control input declaration
+    {
+      { ATT_BT_UUID_SIZE, characterUUID },
+      GATT_PERMIT_READ,
+      0,
+      &hidReportSysInProps
+    },
+
+      // HID Report characteristic, system control input
+      {
+        { ATT_BT_UUID_SIZE, hidReportUUID },
+        GATT_PERMIT_ENCRYPT_READ,
+        0,
+        &hidReportSysIn
+      },
+
+      // HID Report characteristic client characteristic configuration
+      {
+        { ATT_BT_UUID_SIZE, clientCharCfgUUID },
+        GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE,
+        0,
+        (uint8 *) &hidReportSysInClientCharCfg
+      },
+
+      // HID Report Reference characteristic descriptor, system control input
+      {
+        { ATT_BT_UUID_SIZE, reportRefUUID },
+        GATT_PERMIT_READ,
+        0,
+        hidReportRefSysIn
+      },
 };
 
 // Attribute index enumeration-- these indexes match array elements above
@@ -794,7 +663,19 @@ enum
   HID_BOOT_MOUSE_IN_CCCD_IDX,     // HID Boot Mouse Input Report characteristic client characteristic configuration
   HID_FEATURE_DECL_IDX,           // Feature Report declaration
   HID_FEATURE_IDX,                // Feature Report
-  HID_REPORT_REF_FEATURE_IDX      // HID Report Reference characteristic descriptor, feature
+  HID_REPORT_REF_FEATURE_IDX,     // HID Report Reference characteristic descriptor, feature
+  HID_REPORT_CC_IN_DECL_IDX,      // HID Report characteristic, consumer control input declaration
+  HID_REPORT_CC_IN_IDX,           // HID Report characteristic, consumer control input
+  HID_REPORT_CC_IN_CCCD_IDX,      // HID Report characteristic client characteristic configuration
+  HID_REPORT_REF_CC_IN_IDX,       // HID Report Reference characteristic descriptor, consumer control input
+  HID_REPORT_GAMEPAD_IN_DECL_IDX, // HID Report characteristic, gamepad input declaration
+  HID_REPORT_GAMEPAD_IN_IDX,      // HID Report characteristic, gamepad input
+  HID_REPORT_GAMEPAD_IN_CCCD_IDX, // HID Report characteristic client characteristic configuration
+  HID_REPORT_REF_GAMEPAD_IN_IDX,  // HID Report Reference characteristic descriptor, gamepad input
+  HID_REPORT_SYS_IN_DECL_IDX,     // HID Report characteristic, system control input declaration
+  HID_REPORT_SYS_IN_IDX,          // HID Report characteristic, system control input
+  HID_REPORT_SYS_IN_CCCD_IDX,     // HID Report characteristic client characteristic configuration
+  HID_REPORT_REF_SYS_IN_IDX       // HID Report Reference characteristic descriptor, system control input
 };
 
 /*********************************************************************
@@ -838,99 +719,151 @@ bStatus_t HidKbd_AddService(void)
 {
   uint8 status = SUCCESS;
 
-  // Allocate Client Charateristic Configuration tables.
-  hidReportKeyInClientCharCfg = (gattCharCfg_t *)ICall_malloc(sizeof(gattCharCfg_t) *
-                                                              linkDBNumConns);
-
-  if (hidReportKeyInClientCharCfg == NULL)
-  {
-    return ( bleMemAllocError );
-  }
+  uint8 i;
 
-  hidReportBootKeyInClientCharCfg = (gattCharCfg_t *)ICall_malloc(sizeof(gattCharCfg_t) *
-                                                                  linkDBNumConns);
-
-  if (hidReportBootKeyInClientCharCfg == NULL)
-  {
-    ICall_free(hidReportKeyInClientCharCfg);
-
-    return ( bleMemAllocError );
-  }
-
-  hidReportBootMouseInClientCharCfg = (gattCharCfg_t *)ICall_malloc(sizeof(gattCharCfg_t) *
-                                                                    linkDBNumConns);
-  if (hidReportBootMouseInClientCharCfg == NULL)
+  // Allocate Client Charateristic Configuration tables.
+  for (i = 0; i < sizeof(hidClientCharCfgTbls) / sizeof(hidClientCharCfgTbls[0]);
+       i++)
   {
-    ICall_free(hidReportKeyInClientCharCfg);
+    *hidClientCharCfgTbls[i] = (gattCharCfg_t *)ICall_malloc(sizeof(gattCharCfg_t) *
+                                                             linkDBNumConns);
+    if (*hidClientCharCfgTbls[i] == NULL)
+    {
+      while (i-- > 0)
+      {
+        ICall_free(*hidClientCharCfgTbls[i]);
+      }
 
-    ICall_free(hidReportBootKeyInClientCharCfg);
+      return ( bleMemAllocError );
+    }
 
-    return ( bleMemAllocError );
+    // Initialize Client Characteristic Configuration attributes
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, *hidClientCharCfgTbls[i]);
   }
 
-  // Initialize Client Characteristic Configuration attributes
-  GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportKeyInClientCharCfg);
-  GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportBootKeyInClientCharCfg);
-  GATTServApp_InitCharCfg(INVALID_CONNHANDLE,
-                          hidReportBootMouseInClientCharCfg);
-
   // Register GATT attribute list and CBs with GATT Server App
   status = GATTServApp_RegisterService(hidAttrTbl, GATT_NUM_ATTRS(hidAttrTbl),
                                        GATT_MAX_ENCRYPT_KEY_SIZE, &hidKbdCBs);
 
+  // Dispatch attribute reads and writes by handle
+  HidDev_RegisterAttrs(hidAttrTbl, GATT_NUM_ATTRS(hidAttrTbl));
+
   // Set up included service
   Batt_GetParameter(BATT_PARAM_SERVICE_HANDLE,
                     &GATT_INCLUDED_HANDLE(hidAttrTbl, HID_INCLUDED_SERVICE_IDX));
 
   // Construct map of reports to characteristic handles
-  // Each report is uniquely identified via its ID and type
+  // Each report is uniquely identified via its ID and type, those of the
+  // report map set where hidRptMap is defined. Input reports come first,
+  // within the HidDev_RegisterReports bandwidth share and deduplication
+  // limit (HID_DEV_MAX_REPORTS).
 
   // Key input report
-  hidRptMap[0].id = hidReportRefKeyIn[0];
-  hidRptMap[0].type = hidReportRefKeyIn[1];
-  hidRptMap[0].handle = hidAttrTbl[HID_REPORT_KEY_IN_IDX].handle;
-  hidRptMap[0].pCccdAttr = &hidAttrTbl[HID_REPORT_KEY_IN_CCCD_IDX];
-  hidRptMap[0].mode = HID_PROTOCOL_MODE_REPORT;
-
-  // LED output report
-  hidRptMap[1].id = hidReportRefLedOut[0];
-  hidRptMap[1].type = hidReportRefLedOut[1];
-  hidRptMap[1].handle = hidAttrTbl[HID_REPORT_LED_OUT_IDX].handle;
-  hidRptMap[1].pCccdAttr = NULL;
-  hidRptMap[1].mode = HID_PROTOCOL_MODE_REPORT;
+  hidRptMap[HID_RPT_IDX_KEY_IN].handle = hidAttrTbl[HID_REPORT_KEY_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_KEY_IN].pCccdAttr = &hidAttrTbl[HID_REPORT_KEY_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_KEY_IN].coalesce = HID_RPT_COALESCE_NONE;
+  hidRptMap[HID_RPT_IDX_KEY_IN].prio = HID_RPT_PRIO_EVENT;
+  hidRptMap[HID_RPT_IDX_KEY_IN].depth = 0;
+  hidRptMap[HID_RPT_IDX_KEY_IN].share = 4;
+  hidRptMap[HID_RPT_IDX_KEY_IN].dedup = TRUE;
+  hidRptMap[HID_RPT_IDX_KEY_IN].keepAlive = 0;
+  hidRptMap[HID_RPT_IDX_KEY_IN].bitsOffset = HID_DESC_KEYBOARD_IN_MODIFIERS_BIT / 8;
+  hidRptMap[HID_RPT_IDX_KEY_IN].bitsLen = HID_DESC_KEYBOARD_IN_MODIFIERS_SIZE / 8;
+  hidRptMap[HID_RPT_IDX_KEY_IN].arrayOffset = HID_DESC_KEYBOARD_IN_KEYS_BIT / 8;
+  hidRptMap[HID_RPT_IDX_KEY_IN].arrayLen = HID_DESC_KEYBOARD_IN_KEYS_COUNT;
+
+  // Consumer control input report, a press and a release per usage
+  hidRptMap[HID_RPT_IDX_CC_IN].handle = hidAttrTbl[HID_REPORT_CC_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_CC_IN].pCccdAttr = &hidAttrTbl[HID_REPORT_CC_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_CC_IN].coalesce = HID_RPT_COALESCE_NONE;
+  hidRptMap[HID_RPT_IDX_CC_IN].prio = HID_RPT_PRIO_EVENT;
+  hidRptMap[HID_RPT_IDX_CC_IN].depth = 0;
+  hidRptMap[HID_RPT_IDX_CC_IN].share = 1;
+  hidRptMap[HID_RPT_IDX_CC_IN].dedup = TRUE;
+  hidRptMap[HID_RPT_IDX_CC_IN].keepAlive = 0;
+  hidRptMap[HID_RPT_IDX_CC_IN].arrayOffset = HID_DESC_CONSUMER_IN_USAGE_BIT / 8;
+  hidRptMap[HID_RPT_IDX_CC_IN].arrayLen = 1;
+
+  // Gamepad input report, absolute state
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].handle = hidAttrTbl[HID_REPORT_GAMEPAD_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].pCccdAttr = &hidAttrTbl[HID_REPORT_GAMEPAD_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].coalesce = HID_RPT_COALESCE_REPLACE;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].prio = HID_RPT_PRIO_STREAM;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].depth = 1;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].share = 2;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].dedup = TRUE;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].keepAlive = 0;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].bitsOffset = HID_DESC_GAMEPAD_IN_BUTTONS_BIT / 8;
+  hidRptMap[HID_RPT_IDX_GAMEPAD_IN].bitsLen = (HID_DESC_GAMEPAD_IN_BUTTONS_SIZE + 7) / 8;
+
+  // System control input report, a press and a release per usage
+  hidRptMap[HID_RPT_IDX_SYS_IN].handle = hidAttrTbl[HID_REPORT_SYS_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_SYS_IN].pCccdAttr = &hidAttrTbl[HID_REPORT_SYS_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_SYS_IN].coalesce = HID_RPT_COALESCE_NONE;
+  hidRptMap[HID_RPT_IDX_SYS_IN].prio = HID_RPT_PRIO_EVENT;
+  hidRptMap[HID_RPT_IDX_SYS_IN].depth = 0;
+  hidRptMap[HID_RPT_IDX_SYS_IN].share = 1;
+  hidRptMap[HID_RPT_IDX_SYS_IN].dedup = TRUE;
+  hidRptMap[HID_RPT_IDX_SYS_IN].keepAlive = 0;
+  hidRptMap[HID_RPT_IDX_SYS_IN].arrayOffset = HID_DESC_SYSTEM_IN_USAGE_BIT / 8;
+  hidRptMap[HID_RPT_IDX_SYS_IN].arrayLen = 1;
 
   // Boot keyboard input report
   // Use same ID and type as key input report
-  hidRptMap[2].id = hidReportRefKeyIn[0];
-  hidRptMap[2].type = hidReportRefKeyIn[1];
-  hidRptMap[2].handle = hidAttrTbl[HID_BOOT_KEY_IN_IDX].handle;
-  hidRptMap[2].pCccdAttr = &hidAttrTbl[HID_BOOT_KEY_IN_CCCD_IDX];
-  hidRptMap[2].mode = HID_PROTOCOL_MODE_BOOT;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].id = hidReportRefKeyIn[0];
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].type = hidReportRefKeyIn[1];
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].handle = hidAttrTbl[HID_BOOT_KEY_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].pCccdAttr = &hidAttrTbl[HID_BOOT_KEY_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].mode = HID_PROTOCOL_MODE_BOOT;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].coalesce = HID_RPT_COALESCE_NONE;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].prio = HID_RPT_PRIO_EVENT;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].depth = 0;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].share = 4;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].dedup = TRUE;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].keepAlive = 0;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].bitsOffset = 0;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].bitsLen = 1;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].arrayOffset = 2;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_IN].arrayLen = 6;
+
+  // Boot mouse input report
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].id = HID_RPT_ID_MOUSE_IN;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].type = HID_REPORT_TYPE_INPUT;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].handle = hidAttrTbl[HID_BOOT_MOUSE_IN_IDX].handle;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].pCccdAttr = &hidAttrTbl[HID_BOOT_MOUSE_IN_CCCD_IDX];
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].mode = HID_PROTOCOL_MODE_BOOT;
+  // Buttons are state, X, Y and wheel are deltas
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].coalesce = HID_RPT_COALESCE_SUM;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].relOffset = 1;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].prio = HID_RPT_PRIO_STREAM;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].depth = 4;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].share = 1;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].dedup = FALSE;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].bitsOffset = 0;
+  hidRptMap[HID_RPT_IDX_BOOT_MOUSE_IN].bitsLen = 1;
+
+  // Battery level input report
+  VOID Batt_GetParameter(BATT_PARAM_BATT_LEVEL_IN_REPORT,
+                         &(hidRptMap[HID_RPT_IDX_BATT_LEVEL_IN]));
+
+  // LED output report
+  hidRptMap[HID_RPT_IDX_LED_OUT].handle = hidAttrTbl[HID_REPORT_LED_OUT_IDX].handle;
+  hidRptMap[HID_RPT_IDX_LED_OUT].pCccdAttr = NULL;
+  hidRptMap[HID_RPT_IDX_LED_OUT].coalesce = HID_RPT_COALESCE_NONE;
 
   // Boot keyboard output report
   // Use same ID and type as LED output report
-  hidRptMap[3].id = hidReportRefLedOut[0];
-  hidRptMap[3].type = hidReportRefLedOut[1];
-  hidRptMap[3].handle = hidAttrTbl[HID_BOOT_KEY_OUT_IDX].handle;
-  hidRptMap[3].pCccdAttr = NULL;
-  hidRptMap[3].mode = HID_PROTOCOL_MODE_BOOT;
-
-  // Boot mouse input report
-  hidRptMap[4].id = HID_RPT_ID_MOUSE_IN;
-  hidRptMap[4].type = HID_REPORT_TYPE_INPUT;
-  hidRptMap[4].handle = hidAttrTbl[HID_BOOT_MOUSE_IN_IDX].handle;
-  hidRptMap[4].pCccdAttr = &hidAttrTbl[HID_BOOT_MOUSE_IN_CCCD_IDX];
-  hidRptMap[4].mode = HID_PROTOCOL_MODE_BOOT;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].id = hidReportRefLedOut[0];
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].type = hidReportRefLedOut[1];
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].handle = hidAttrTbl[HID_BOOT_KEY_OUT_IDX].handle;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].pCccdAttr = NULL;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].mode = HID_PROTOCOL_MODE_BOOT;
+  hidRptMap[HID_RPT_IDX_BOOT_KEY_OUT].coalesce = HID_RPT_COALESCE_NONE;
 
   // Feature report
-  hidRptMap[5].id = hidReportRefFeature[0];
-  hidRptMap[5].type = hidReportRefFeature[1];
-  hidRptMap[5].handle = hidAttrTbl[HID_FEATURE_IDX].handle;
-  hidRptMap[5].pCccdAttr = NULL;
-  hidRptMap[5].mode = HID_PROTOCOL_MODE_REPORT;
-
-  // Battery level input report
-  VOID Batt_GetParameter(BATT_PARAM_BATT_LEVEL_IN_REPORT, &(hidRptMap[6]));
+  hidRptMap[HID_RPT_IDX_FEATURE].handle = hidAttrTbl[HID_FEATURE_IDX].handle;
+  hidRptMap[HID_RPT_IDX_FEATURE].pCccdAttr = NULL;
+  hidRptMap[HID_RPT_IDX_FEATURE].coalesce = HID_RPT_COALESCE_NONE;
 
   // Setup report ID map
   HidDev_RegisterReports(HID_NUM_REPORTS, hidRptMap);
@@ -1060,6 +993,22 @@ uint8 HidKbd_GetParameter(uint8 id, uint8 type, uint16 uuid, uint8 *pLen,
   return (SUCCESS);
 }
 
+/*********************************************************************
+ * @fn      HidKbd_GetReportMap
+ *
+ * @brief   Get the report map of the service.
+ *
+ * @param   pLen - output, report map length.
+ *
+ * @return  pointer to the report map
+ */
+const uint8 *HidKbd_GetReportMap(uint16 *pLen)
+{
+  *pLen = hidReportMapLen;
+
+  return (hidReportMap);
+}
+
 
 /*********************************************************************
 *********************************************************************/
@@ -52,30 +52,30 @@ extern "C"
 {
 #endif
 
-// HID Report Map characteristic value
-//#define  GENERNAL
-#define    CUSTOMER
-//#define  JOYSTICK
-//#define  KEYBOARD
-//#define  MOUSE
-//#define GAME_PAD
-
 /*********************************************************************
  * INCLUDES
  */
+#include "hid_desc.h"
 
 /*********************************************************************
  * CONSTANTS
  */
 
-// Number of HID reports defined in the service
-#define HID_NUM_REPORTS          7
-
-// HID Report IDs for the service
-#define HID_RPT_ID_KEY_IN        0  // Keyboard input report ID
-#define HID_RPT_ID_MOUSE_IN      1  // Mouse input report ID
-#define HID_RPT_ID_LED_OUT       0  // LED output report ID
-#define HID_RPT_ID_FEATURE       0  // Feature report ID
+// Number of HID reports defined in the service: those of the report map
+// (hid_desc.h), then boot keyboard in and out, boot mouse and battery level
+#define HID_NUM_REPORTS          (HID_DESC_NUM_INPUT_REPORTS + \
+                                  HID_DESC_NUM_OTHER_REPORTS + 4)
+
+// HID Report IDs for the service. The report map is one composite device
+// generated by tools/hid_desc_gen, each top level collection under its own
+// ID; 5 is the battery level (HID_RPT_ID_BATT_LEVEL_IN).
+#define HID_RPT_ID_KEY_IN        HID_DESC_KEYBOARD_ID  // Keyboard input report ID
+#define HID_RPT_ID_CC_IN         HID_DESC_CONSUMER_ID  // Consumer control input report ID
+#define HID_RPT_ID_GAMEPAD_IN    HID_DESC_GAMEPAD_ID   // Gamepad input report ID
+#define HID_RPT_ID_SYS_IN        HID_DESC_SYSTEM_ID    // System control input report ID
+#define HID_RPT_ID_MOUSE_IN      6                     // Boot mouse input report ID
+#define HID_RPT_ID_LED_OUT       HID_DESC_KEYBOARD_ID  // LED output report ID
+#define HID_RPT_ID_FEATURE       HID_DESC_KEYBOARD_ID  // Feature report ID
 
 // HID feature flags
 #define HID_KBD_FLAGS             HID_FLAGS_REMOTE_WAKE
@@ -147,6 +147,17 @@ extern uint8 HidKbd_SetParameter(uint8 id, uint8 type, uint16 uuid, uint8 len,
 extern uint8 HidKbd_GetParameter(uint8 id, uint8 type, uint16 uuid, uint8 *pLen,
                                  void *pValue);
 
+/*********************************************************************
+ * @fn      HidKbd_GetReportMap
+ *
+ * @brief   Get the report map of the service.
+ *
+ * @param   pLen - output, report map length.
+ *
+ * @return  pointer to the report map
+ */
+extern const uint8 *HidKbd_GetReportMap(uint16 *pLen);
+
 
 /*********************************************************************
 *********************************************************************/
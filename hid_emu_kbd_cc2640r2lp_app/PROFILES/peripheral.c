@@ -67,6 +67,7 @@
 #include "icall_ble_api.h"
 
 #include "peripheral.h"
+#include "gattservapp_util.h"
 
 /*********************************************************************
  * MACROS
@@ -1221,6 +1222,9 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
             Util_restartClock(&startUpdateClock, timeout*1000);
           }
 
+          // Give the link its slot in the CCC tables
+          GATTServApp_LinkUp(pPkt->connectionHandle);
+
           // Notify the Bond Manager to the connection
           VOID GAPBondMgr_LinkEst(pPkt->devAddrType, pPkt->devAddr,
                                   pPkt->connectionHandle, GAP_PROFILE_PERIPHERAL);
@@ -1248,6 +1252,8 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
 
         GAPBondMgr_LinkTerm(pPkt->connectionHandle);
 
+        GATTServApp_LinkDown(pPkt->connectionHandle);
+
         memset(gapRole_ConnectedDevAddr, 0, B_ADDR_LEN);
 
         // Erase connection information
@@ -1568,6 +1574,7 @@ static bStatus_t gapRole_startConnUpdate(uint8_t handleFailure,
  *              bleInvalidRange:
  *              bleIncorrectMode: invalid profile role.
  *              bleAlreadyInRequestedMode: already updating link parameters.
+ *              blePending: an earlier update is still outstanding.
  *              bleNotConnected: Connection is down
  *              bleMemAllocError: Memory allocation error occurred.
  *              bleNoResources: No available resource
@@ -1582,6 +1589,11 @@ bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
   {
     return (bleNotConnected);
   }
+  // Let the outstanding update finish, or time out, first.
+  else if (Util_isActive(&updateTimeoutClock))
+  {
+    return (blePending);
+  }
   else
   {
     gapRole_updateConnParams_t paramUpdate;
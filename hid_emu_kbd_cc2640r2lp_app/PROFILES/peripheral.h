@@ -577,6 +577,7 @@ extern bStatus_t GAPRole_TerminateConnection(void);
  * @return      @ref bleInvalidRange : connection parameters violate spec
  * @return      @ref bleIncorrectMode : invalid profile role.
  * @return      @ref bleAlreadyInRequestedMode : already updating link parameters.
+ * @return      @ref blePending : an earlier update is still outstanding.
  * @return      @ref bleNotConnected : Connection is down
  * @return      @ref bleMemAllocError
  * @return      @ref bleNoResources
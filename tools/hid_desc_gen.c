@@ -0,0 +1,1748 @@
+/******************************************************************************
+
+ @file       hid_desc_gen.c
+
+ @brief Report descriptor compiler. Reads HID Descriptor Tool sources,
+        either the binary .hid files or the C arrays the tool exports
+        (.h), joins them into one composite report map and writes a
+        header holding:
+
+          - HID_DESC_REPORT_MAP, the report map bytes
+          - HID_DESC_RPT_MAP_INPUT / HID_DESC_RPT_MAP_OTHER, hidRptMap_t
+            skeleton entries (id, type, mode) of every report in the map
+          - HidDesc_pack<Name>In(), one per input report, storing each
+            field with offsets and sizes worked out here
+
+        Usage: hid_desc_gen [-o header] source[:name[:id]]...
+               hid_desc_gen -x [-o header] source
+          source    .hid or .h file, one top level collection
+          name      lower case collection name (default: file name)
+          id        report ID to give the collection, replacing the one
+                    in the source or adding one when it has none
+          -x        write the source's items as a C array instead, as the
+                    tool exports them, to keep .h copies of the .hid files
+
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SOURCES         8
+#define MAX_ITEMS           512
+#define MAX_USAGES          64
+#define MAX_FIELDS          64
+#define MAX_REPORTS         16
+#define MAX_PARAMS          16
+#define MAX_ELEMS           64
+#define NAME_LEN            32
+
+// Longest Report Map characteristic value HOGP allows
+#define MAX_MAP_LEN         512
+
+// HID Descriptor Tool .hid file layout
+#define HID_FILE_MAGIC      0xCAFE
+#define HID_FILE_HDR_MIN    10
+
+// Item tags (prefix with the size bits cleared)
+#define TAG_INPUT           0x80
+#define TAG_OUTPUT          0x90
+#define TAG_FEATURE         0xB0
+#define TAG_COLLECTION      0xA0
+#define TAG_END_COLLECTION  0xC0
+#define TAG_USAGE_PAGE      0x04
+#define TAG_LOGICAL_MIN     0x14
+#define TAG_LOGICAL_MAX     0x24
+#define TAG_PHYSICAL_MIN    0x34
+#define TAG_PHYSICAL_MAX    0x44
+#define TAG_UNIT_EXP        0x54
+#define TAG_UNIT            0x64
+#define TAG_REPORT_SIZE     0x74
+#define TAG_REPORT_ID       0x84
+#define TAG_REPORT_COUNT    0x94
+#define TAG_PUSH            0xA4
+#define TAG_POP             0xB4
+#define TAG_USAGE           0x08
+#define TAG_USAGE_MIN       0x18
+#define TAG_USAGE_MAX       0x28
+
+// Main item flags
+#define FLAG_CONSTANT       0x01
+#define FLAG_VARIABLE       0x02
+
+// Report types, in skeleton order
+#define TYPE_INPUT          0
+#define TYPE_OUTPUT         1
+#define TYPE_FEATURE        2
+
+/*********************************************************************
+ * Types
+ */
+
+typedef struct
+{
+  uint8_t prefix;
+  uint8_t size;                 // Data bytes, 0, 1, 2 or 4
+  uint32_t data;
+  int src;                      // Source the item came from
+} item_t;
+
+typedef struct
+{
+  const char *pPath;
+  char name[NAME_LEN];
+  int id;                       // Report ID override, -1 for none
+  item_t items[MAX_ITEMS];
+  int numItems;
+} source_t;
+
+typedef struct
+{
+  int type;
+  uint16_t bitOff;
+  uint16_t size;
+  uint16_t count;
+  uint8_t flags;
+  int32_t logMin;
+  int32_t logMax;
+  uint32_t usages[MAX_USAGES];  // Page << 16 | usage
+  int numUsages;
+  uint32_t usageMin;
+  uint32_t usageMax;
+  int hasRange;
+} field_t;
+
+typedef struct
+{
+  int src;
+  uint8_t id;
+  int type;
+  uint16_t bits;
+  field_t fields[MAX_FIELDS];
+  int numFields;
+} report_t;
+
+// Pack function parameter
+typedef struct
+{
+  char name[NAME_LEN];
+  int width;                    // C type width, 8, 16 or 32
+  int isSigned;
+  int count;                    // Elements behind a pointer, 0 for a scalar
+  const field_t *pField;
+  uint16_t bitOff;              // First element
+  uint16_t size;                // Bits per element
+} param_t;
+
+// One stored value: a parameter, or one element of a pointer parameter
+typedef struct
+{
+  int param;
+  int index;                    // -1 for a scalar
+  uint16_t bitOff;
+  uint16_t size;
+} elem_t;
+
+/*********************************************************************
+ * State
+ */
+
+static source_t sources[MAX_SOURCES];
+static int numSources;
+
+static item_t mapItems[MAX_SOURCES * MAX_ITEMS];
+static int numMapItems;
+
+static report_t reports[MAX_REPORTS];
+static int numReports;
+
+static FILE *pOut;
+
+static const char * const typeSuffix[] = { "IN", "OUT", "FEATURE" };
+static const char * const typeCamel[] = { "In", "Out", "Feature" };
+static const char * const typeName[] = { "input", "output", "feature" };
+static const char * const typeConst[] =
+  { "HID_REPORT_TYPE_INPUT", "HID_REPORT_TYPE_OUTPUT",
+    "HID_REPORT_TYPE_FEATURE" };
+
+/*********************************************************************
+ * Errors
+ */
+
+static void fail(const char *pWhere, const char *pWhat)
+{
+  fprintf(stderr, "hid_desc_gen: %s: %s\n", pWhere, pWhat);
+  exit(1);
+}
+
+/*********************************************************************
+ * Source readers
+ */
+
+static uint8_t *readFile(const char *pPath, long *pLen)
+{
+  FILE *f = fopen(pPath, "rb");
+  uint8_t *pBuf;
+
+  if (f == NULL)
+  {
+    perror(pPath);
+    exit(1);
+  }
+
+  fseek(f, 0, SEEK_END);
+  *pLen = ftell(f);
+  fseek(f, 0, SEEK_SET);
+
+  pBuf = malloc(*pLen + 1);
+  if ((pBuf == NULL) || (fread(pBuf, 1, *pLen, f) != (size_t)*pLen))
+  {
+    fail(pPath, "read failed");
+  }
+  pBuf[*pLen] = '\0';
+  fclose(f);
+
+  return pBuf;
+}
+
+static void addItem(source_t *pSrc, uint8_t prefix, uint32_t data)
+{
+  static const uint8_t sizeTbl[4] = { 0, 1, 2, 4 };
+  item_t *pItem;
+
+  if (pSrc->numItems == MAX_ITEMS)
+  {
+    fail(pSrc->pPath, "too many items");
+  }
+
+  if (prefix == 0xFE)
+  {
+    fail(pSrc->pPath, "long items are not supported");
+  }
+
+  pItem = &pSrc->items[pSrc->numItems++];
+  pItem->prefix = prefix;
+  pItem->size = sizeTbl[prefix & 0x03];
+  pItem->data = data;
+  if (pItem->size < 4)
+  {
+    pItem->data &= (1UL << (8 * pItem->size)) - 1;
+  }
+  pItem->src = (int)(pSrc - sources);
+}
+
+// Binary HID Descriptor Tool file: a header giving its own length, the
+// magic 0xCAFE, the item count and the record length, then one record
+// per item starting with the prefix and four little endian data bytes.
+static void readHidFile(source_t *pSrc, const uint8_t *pBuf, long len)
+{
+  uint16_t hdrLen, magic, count, recLen;
+  const uint8_t *pRec;
+  uint16_t i;
+
+  if (len < HID_FILE_HDR_MIN)
+  {
+    fail(pSrc->pPath, "truncated header");
+  }
+
+  hdrLen = pBuf[0] | (pBuf[1] << 8);
+  magic = pBuf[4] | (pBuf[5] << 8);
+  count = pBuf[6] | (pBuf[7] << 8);
+  recLen = pBuf[8] | (pBuf[9] << 8);
+
+  if ((magic != HID_FILE_MAGIC) || (recLen < 5) ||
+      (hdrLen + (long)count * recLen > len))
+  {
+    fail(pSrc->pPath, "not a HID Descriptor Tool file");
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    pRec = &pBuf[hdrLen + i * recLen];
+    addItem(pSrc, pRec[0], (uint32_t)pRec[1] | ((uint32_t)pRec[2] << 8) |
+                           ((uint32_t)pRec[3] << 16) |
+                           ((uint32_t)pRec[4] << 24));
+  }
+}
+
+// Exported C array: the bytes between the first { and the next }, with
+// comments skipped.
+static void readHeaderFile(source_t *pSrc, char *pText)
+{
+  uint8_t bytes[MAX_ITEMS * 5];
+  int numBytes = 0;
+  char *p = pText;
+  char *q;
+  int pos;
+  uint8_t prefix;
+  uint32_t data;
+  int i, n;
+
+  // Blank out comments
+  while ((p = strchr(p, '/')) != NULL)
+  {
+    if (p[1] == '/')
+    {
+      for (q = p; (*q != '\0') && (*q != '\n'); q++)
+      {
+        *q = ' ';
+      }
+    }
+    else if (p[1] == '*')
+    {
+      q = strstr(p + 2, "*/");
+      if (q == NULL)
+      {
+        fail(pSrc->pPath, "unterminated comment");
+      }
+      memset(p, ' ', q + 2 - p);
+    }
+    p++;
+  }
+
+  p = strchr(pText, '{');
+  q = (p != NULL) ? strchr(p, '}') : NULL;
+  if (q == NULL)
+  {
+    fail(pSrc->pPath, "no { ... } array");
+  }
+  *q = '\0';
+  p++;
+
+  while (*p != '\0')
+  {
+    while (isspace((unsigned char)*p) || (*p == ','))
+    {
+      p++;
+    }
+    if (*p == '\0')
+    {
+      break;
+    }
+    if (numBytes == (int)sizeof(bytes))
+    {
+      fail(pSrc->pPath, "too many bytes");
+    }
+    bytes[numBytes++] = (uint8_t)strtoul(p, &q, 0);
+    if (q == p)
+    {
+      fail(pSrc->pPath, "bad byte");
+    }
+    p = q;
+  }
+
+  for (pos = 0; pos < numBytes; pos += 1 + n)
+  {
+    prefix = bytes[pos];
+    n = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+    if (pos + n >= numBytes)
+    {
+      fail(pSrc->pPath, "item runs past the end");
+    }
+    data = 0;
+    for (i = 0; i < n; i++)
+    {
+      data |= (uint32_t)bytes[pos + 1 + i] << (8 * i);
+    }
+    addItem(pSrc, prefix, data);
+  }
+}
+
+static void readSource(source_t *pSrc)
+{
+  const char *pExt = strrchr(pSrc->pPath, '.');
+  uint8_t *pBuf;
+  long len;
+
+  pBuf = readFile(pSrc->pPath, &len);
+  if ((pExt != NULL) && (strcmp(pExt, ".hid") == 0))
+  {
+    readHidFile(pSrc, pBuf, len);
+  }
+  else
+  {
+    readHeaderFile(pSrc, (char *)pBuf);
+  }
+  free(pBuf);
+}
+
+/*********************************************************************
+ * Report ID override
+ */
+
+static void setReportId(source_t *pSrc)
+{
+  int i;
+  int found = -1;
+
+  if (pSrc->id < 0)
+  {
+    return;
+  }
+
+  for (i = 0; i < pSrc->numItems; i++)
+  {
+    if ((pSrc->items[i].prefix & 0xFC) == TAG_REPORT_ID)
+    {
+      if ((found >= 0) && (pSrc->items[i].data != (uint32_t)found))
+      {
+        fail(pSrc->pPath, "more than one report ID, cannot renumber");
+      }
+      found = (int)pSrc->items[i].data;
+      pSrc->items[i].prefix = TAG_REPORT_ID | 1;
+      pSrc->items[i].size = 1;
+      pSrc->items[i].data = pSrc->id;
+    }
+  }
+
+  if (found >= 0)
+  {
+    return;
+  }
+
+  // None: add one right after the top level collection opens
+  for (i = 0; i < pSrc->numItems; i++)
+  {
+    if ((pSrc->items[i].prefix & 0xFC) == TAG_COLLECTION)
+    {
+      break;
+    }
+  }
+  if ((i == pSrc->numItems) || (pSrc->numItems == MAX_ITEMS))
+  {
+    fail(pSrc->pPath, "no collection to add a report ID to");
+  }
+
+  memmove(&pSrc->items[i + 2], &pSrc->items[i + 1],
+          (pSrc->numItems - i - 1) * sizeof(item_t));
+  pSrc->numItems++;
+  pSrc->items[i + 1].prefix = TAG_REPORT_ID | 1;
+  pSrc->items[i + 1].size = 1;
+  pSrc->items[i + 1].data = pSrc->id;
+  pSrc->items[i + 1].src = pSrc->items[i].src;
+}
+
+/*********************************************************************
+ * Joining sources
+ */
+
+// Globals a source may rely on being 0 at its start
+static const uint8_t resetTags[] =
+{
+  TAG_USAGE_PAGE, TAG_LOGICAL_MIN, TAG_LOGICAL_MAX, TAG_PHYSICAL_MIN,
+  TAG_PHYSICAL_MAX, TAG_UNIT_EXP, TAG_UNIT, TAG_REPORT_SIZE, TAG_REPORT_COUNT
+};
+
+// Items that read the globals
+static int isDataItem(uint8_t tag)
+{
+  return (tag == TAG_INPUT) || (tag == TAG_OUTPUT) || (tag == TAG_FEATURE);
+}
+
+// Whether pItem depends on the value of resetTags[t]. Constant data items
+// are padding and only read the size and count; array items report
+// indices, which have no physical range or unit.
+static int readsGlobal(const item_t *pItem, int t)
+{
+  uint8_t tag = pItem->prefix & 0xFC;
+
+  if (resetTags[t] == TAG_USAGE_PAGE)
+  {
+    return (tag == TAG_USAGE) || (tag == TAG_USAGE_MIN) ||
+           (tag == TAG_USAGE_MAX);
+  }
+
+  if (!isDataItem(tag))
+  {
+    return 0;
+  }
+
+  switch (resetTags[t])
+  {
+    case TAG_REPORT_SIZE:
+    case TAG_REPORT_COUNT:
+      return 1;
+
+    case TAG_LOGICAL_MIN:
+    case TAG_LOGICAL_MAX:
+      return !(pItem->data & 0x01);
+
+    default:
+      return !(pItem->data & 0x01) && (pItem->data & 0x02);
+  }
+}
+
+static void appendItem(const item_t *pItem, int *pLen)
+{
+  if (numMapItems == (int)(sizeof(mapItems) / sizeof(mapItems[0])))
+  {
+    fail("report map", "too many items");
+  }
+  mapItems[numMapItems++] = *pItem;
+  *pLen += 1 + pItem->size;
+}
+
+// Global items carry over from one collection to the next, so a source
+// that reads a global at its default would inherit the value the
+// previous source set. Add an explicit 0 for each such global.
+static void appendSource(const source_t *pSrc, uint32_t *pGlobals, int *pLen)
+{
+  item_t reset;
+  uint8_t tag;
+  int t, i;
+
+  for (t = 0; t < (int)sizeof(resetTags); t++)
+  {
+    if (pGlobals[t] == 0)
+    {
+      continue;
+    }
+
+    for (i = 0; i < pSrc->numItems; i++)
+    {
+      tag = pSrc->items[i].prefix & 0xFC;
+      if ((tag == resetTags[t]) || readsGlobal(&pSrc->items[i], t))
+      {
+        break;
+      }
+    }
+
+    if ((i == pSrc->numItems) || ((pSrc->items[i].prefix & 0xFC) ==
+                                  resetTags[t]))
+    {
+      // Never read, or set before it is
+      continue;
+    }
+
+    reset.prefix = resetTags[t] | 1;
+    reset.size = 1;
+    reset.data = 0;
+    reset.src = (int)(pSrc - sources);
+    appendItem(&reset, pLen);
+    pGlobals[t] = 0;
+  }
+
+  for (i = 0; i < pSrc->numItems; i++)
+  {
+    appendItem(&pSrc->items[i], pLen);
+    for (t = 0; t < (int)sizeof(resetTags); t++)
+    {
+      if ((pSrc->items[i].prefix & 0xFC) == resetTags[t])
+      {
+        pGlobals[t] = pSrc->items[i].data;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * Parser
+ */
+
+typedef struct
+{
+  uint16_t page;
+  int32_t logMin;
+  int32_t logMax;
+  uint16_t size;
+  uint16_t count;
+  uint8_t id;
+} globals_t;
+
+static int32_t signedData(const item_t *pItem)
+{
+  switch (pItem->size)
+  {
+    case 1: return (int8_t)pItem->data;
+    case 2: return (int16_t)pItem->data;
+    default: return (int32_t)pItem->data;
+  }
+}
+
+static uint32_t fullUsage(const item_t *pItem, uint16_t page)
+{
+  return (pItem->size == 4) ? pItem->data : (((uint32_t)page << 16) |
+                                             pItem->data);
+}
+
+static report_t *findReport(int src, uint8_t id, int type)
+{
+  int i;
+
+  for (i = 0; i < numReports; i++)
+  {
+    if ((reports[i].id == id) && (reports[i].type == type))
+    {
+      if (reports[i].src != src)
+      {
+        fail(sources[src].pPath, "report ID used by another collection");
+      }
+      return &reports[i];
+    }
+  }
+
+  if (numReports == MAX_REPORTS)
+  {
+    fail(sources[src].pPath, "too many reports");
+  }
+
+  reports[numReports].src = src;
+  reports[numReports].id = id;
+  reports[numReports].type = type;
+  return &reports[numReports++];
+}
+
+static void parseMap(void)
+{
+  globals_t g = { 0 };
+  globals_t stack[4];
+  int sp = 0;
+  uint32_t usages[MAX_USAGES];
+  int numUsages = 0;
+  uint32_t usageMin = 0, usageMax = 0;
+  int hasMin = 0, hasMax = 0;
+  int depth = 0;
+  int anyId = 0, noId = 0;
+  const item_t *pItem;
+  const char *pWhere;
+  report_t *pRpt;
+  field_t *pField;
+  int i, type;
+
+  for (i = 0; i < numMapItems; i++)
+  {
+    pItem = &mapItems[i];
+    pWhere = sources[pItem->src].pPath;
+
+    switch (pItem->prefix & 0xFC)
+    {
+      case TAG_USAGE_PAGE:   g.page = (uint16_t)pItem->data; break;
+      case TAG_LOGICAL_MIN:  g.logMin = signedData(pItem); break;
+      case TAG_LOGICAL_MAX:  g.logMax = signedData(pItem); break;
+      case TAG_REPORT_SIZE:  g.size = (uint16_t)pItem->data; break;
+      case TAG_REPORT_COUNT: g.count = (uint16_t)pItem->data; break;
+      case TAG_REPORT_ID:    g.id = (uint8_t)pItem->data; anyId = 1; break;
+
+      case TAG_PHYSICAL_MIN:
+      case TAG_PHYSICAL_MAX:
+      case TAG_UNIT_EXP:
+      case TAG_UNIT:
+        break;
+
+      case TAG_PUSH:
+        if (sp == 4)
+        {
+          fail(pWhere, "push too deep");
+        }
+        stack[sp++] = g;
+        break;
+
+      case TAG_POP:
+        if (sp == 0)
+        {
+          fail(pWhere, "pop without push");
+        }
+        g = stack[--sp];
+        break;
+
+      case TAG_USAGE:
+        if (numUsages == MAX_USAGES)
+        {
+          fail(pWhere, "too many usages");
+        }
+        usages[numUsages++] = fullUsage(pItem, g.page);
+        break;
+
+      case TAG_USAGE_MIN:
+        usageMin = fullUsage(pItem, g.page);
+        hasMin = 1;
+        break;
+
+      case TAG_USAGE_MAX:
+        usageMax = fullUsage(pItem, g.page);
+        hasMax = 1;
+        break;
+
+      case TAG_COLLECTION:
+        if ((depth == 0) && (numUsages == 0))
+        {
+          fail(pWhere, "top level collection without a usage");
+        }
+        depth++;
+        numUsages = 0;
+        hasMin = hasMax = 0;
+        break;
+
+      case TAG_END_COLLECTION:
+        if (depth-- == 0)
+        {
+          fail(pWhere, "end collection without collection");
+        }
+        numUsages = 0;
+        hasMin = hasMax = 0;
+        break;
+
+      case TAG_INPUT:
+      case TAG_OUTPUT:
+      case TAG_FEATURE:
+        type = ((pItem->prefix & 0xFC) == TAG_INPUT) ? TYPE_INPUT :
+               ((pItem->prefix & 0xFC) == TAG_OUTPUT) ? TYPE_OUTPUT :
+                                                        TYPE_FEATURE;
+        if (g.id == 0)
+        {
+          noId = 1;
+        }
+        if ((g.size == 0) || (g.size > 32) || (g.count == 0))
+        {
+          fail(pWhere, "main item without a report size or count");
+        }
+        if (hasMin != hasMax)
+        {
+          fail(pWhere, "usage minimum without maximum");
+        }
+
+        pRpt = findReport(pItem->src, g.id, type);
+        if (pRpt->numFields == MAX_FIELDS)
+        {
+          fail(pWhere, "too many fields");
+        }
+        pField = &pRpt->fields[pRpt->numFields++];
+        pField->type = type;
+        pField->bitOff = pRpt->bits;
+        pField->size = g.size;
+        pField->count = g.count;
+        pField->flags = (uint8_t)pItem->data;
+        pField->logMin = g.logMin;
+        pField->logMax = g.logMax;
+        memcpy(pField->usages, usages, numUsages * sizeof(uint32_t));
+        pField->numUsages = numUsages;
+        pField->usageMin = usageMin;
+        pField->usageMax = usageMax;
+        pField->hasRange = hasMin;
+        pRpt->bits += g.size * g.count;
+
+        numUsages = 0;
+        hasMin = hasMax = 0;
+        break;
+
+      default:
+        fail(pWhere, "unknown item");
+    }
+  }
+
+  if (depth != 0)
+  {
+    fail("report map", "unbalanced collections");
+  }
+  if (anyId && noId)
+  {
+    fail("report map", "fields before the first report ID");
+  }
+
+  for (i = 0; i < numReports; i++)
+  {
+    if (reports[i].bits % 8)
+    {
+      fail(sources[reports[i].src].pPath, "report is not a whole byte");
+    }
+  }
+}
+
+/*********************************************************************
+ * Names
+ */
+
+static const char *usageName(uint32_t usage)
+{
+  switch (usage)
+  {
+    case 0x00010030: return "x";
+    case 0x00010031: return "y";
+    case 0x00010032: return "z";
+    case 0x00010033: return "rx";
+    case 0x00010034: return "ry";
+    case 0x00010035: return "rz";
+    case 0x00010036: return "slider";
+    case 0x00010037: return "dial";
+    case 0x00010038: return "wheel";
+    case 0x00010039: return "hat";
+    case 0x000200BA: return "rudder";
+    case 0x000200BB: return "throttle";
+    case 0x000200C4: return "accelerator";
+    case 0x000200C5: return "brake";
+    default:         return NULL;
+  }
+}
+
+// Name of a bitmap of one bit fields, or of an array field
+static const char *pageName(uint16_t page, int array, int plural)
+{
+  switch (page)
+  {
+    case 0x07: return !array ? "modifiers" : plural ? "keys" : "key";
+    case 0x08: return "leds";
+    case 0x09: return !array ? "buttons" : plural ? "buttons" : "button";
+    default:   return !array ? "bits" : plural ? "usages" : "usage";
+  }
+}
+
+static uint32_t elementUsage(const field_t *pField, int i)
+{
+  if (pField->hasRange)
+  {
+    return pField->usageMin + i;
+  }
+  if (pField->numUsages == 0)
+  {
+    return 0;
+  }
+  return pField->usages[(i < pField->numUsages) ? i : pField->numUsages - 1];
+}
+
+static uint16_t fieldPage(const field_t *pField)
+{
+  return (uint16_t)(elementUsage(pField, 0) >> 16);
+}
+
+static void upper(char *pDst, const char *pSrc)
+{
+  while (*pSrc)
+  {
+    *pDst++ = (char)toupper((unsigned char)*pSrc++);
+  }
+  *pDst = '\0';
+}
+
+static void camel(char *pDst, const char *pSrc)
+{
+  int up = 1;
+
+  for (; *pSrc; pSrc++)
+  {
+    if (*pSrc == '_')
+    {
+      up = 1;
+      continue;
+    }
+    *pDst++ = up ? (char)toupper((unsigned char)*pSrc) : *pSrc;
+    up = 0;
+  }
+  *pDst = '\0';
+}
+
+/*********************************************************************
+ * Parameters
+ */
+
+static int typeWidth(int bits)
+{
+  return (bits <= 8) ? 8 : (bits <= 16) ? 16 : 32;
+}
+
+static int addParam(param_t *pParams, int *pNum, const char *pName,
+                    const field_t *pField, uint16_t bitOff, uint16_t size,
+                    int count)
+{
+  param_t *p;
+  int i, n = 1;
+  char name[NAME_LEN];
+
+  snprintf(name, sizeof(name), "%s", pName);
+  for (i = 0; i < *pNum; i++)
+  {
+    if (strcmp(pParams[i].name, name) == 0)
+    {
+      snprintf(name, sizeof(name), "%s%d", pName, ++n);
+      i = -1;
+    }
+  }
+
+  if (*pNum == MAX_PARAMS)
+  {
+    fail(name, "too many parameters");
+  }
+  p = &pParams[(*pNum)++];
+  snprintf(p->name, sizeof(p->name), "%s", name);
+  p->width = typeWidth(size);
+  p->isSigned = (pField->logMin < 0);
+  p->count = count;
+  p->pField = pField;
+  p->bitOff = bitOff;
+  p->size = size;
+
+  return *pNum - 1;
+}
+
+// Split the data fields of a report into pack function parameters and
+// the values each byte is made of
+static void buildParams(const report_t *pRpt, param_t *pParams, int *pNumParams,
+                        elem_t *pElems, int *pNumElems)
+{
+  const field_t *pField;
+  const char *pName;
+  char fallback[NAME_LEN];
+  uint32_t usage;
+  int i, k, param;
+
+  *pNumParams = *pNumElems = 0;
+
+  for (i = 0; i < pRpt->numFields; i++)
+  {
+    pField = &pRpt->fields[i];
+    if (pField->flags & FLAG_CONSTANT)
+    {
+      continue;
+    }
+
+    if (*pNumElems + pField->count > MAX_ELEMS)
+    {
+      fail("report", "too many values");
+    }
+
+    if ((pField->flags & FLAG_VARIABLE) && (pField->size == 1) &&
+        (pField->count > 1))
+    {
+      // Bitmap, one parameter
+      if (pField->count > 32)
+      {
+        fail("report", "bitmap wider than 32 bits");
+      }
+      param = addParam(pParams, pNumParams,
+                       pageName(fieldPage(pField), 0, 1), pField,
+                       pField->bitOff, pField->count, 0);
+      pElems[*pNumElems].param = param;
+      pElems[*pNumElems].index = -1;
+      pElems[*pNumElems].bitOff = pField->bitOff;
+      pElems[(*pNumElems)++].size = pField->count;
+    }
+    else if (pField->flags & FLAG_VARIABLE)
+    {
+      // One parameter per value, named after its usage
+      for (k = 0; k < pField->count; k++)
+      {
+        usage = elementUsage(pField, k);
+        pName = usageName(usage);
+        if (pName == NULL)
+        {
+          snprintf(fallback, sizeof(fallback), "u%04x_%04x",
+                   (unsigned)(usage >> 16), (unsigned)(usage & 0xFFFF));
+          pName = fallback;
+        }
+        param = addParam(pParams, pNumParams, pName, pField,
+                         pField->bitOff + k * pField->size, pField->size, 0);
+        pElems[*pNumElems].param = param;
+        pElems[*pNumElems].index = -1;
+        pElems[*pNumElems].bitOff = pField->bitOff + k * pField->size;
+        pElems[(*pNumElems)++].size = pField->size;
+      }
+    }
+    else
+    {
+      // Array, a scalar or a pointer to count values
+      param = addParam(pParams, pNumParams,
+                       pageName(fieldPage(pField), 1, pField->count > 1),
+                       pField, pField->bitOff, pField->size,
+                       (pField->count > 1) ? pField->count : 0);
+      for (k = 0; k < pField->count; k++)
+      {
+        pElems[*pNumElems].param = param;
+        pElems[*pNumElems].index = (pField->count > 1) ? k : -1;
+        pElems[*pNumElems].bitOff = pField->bitOff + k * pField->size;
+        pElems[(*pNumElems)++].size = pField->size;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * Output
+ */
+
+static const char *itemName(uint8_t tag)
+{
+  switch (tag)
+  {
+    case TAG_INPUT:          return "Input";
+    case TAG_OUTPUT:         return "Output";
+    case TAG_FEATURE:        return "Feature";
+    case TAG_COLLECTION:     return "Collection";
+    case TAG_END_COLLECTION: return "End Collection";
+    case TAG_USAGE_PAGE:     return "Usage Page";
+    case TAG_LOGICAL_MIN:    return "Logical Min";
+    case TAG_LOGICAL_MAX:    return "Logical Max";
+    case TAG_PHYSICAL_MIN:   return "Physical Min";
+    case TAG_PHYSICAL_MAX:   return "Physical Max";
+    case TAG_UNIT_EXP:       return "Unit Exponent";
+    case TAG_UNIT:           return "Unit";
+    case TAG_REPORT_SIZE:    return "Report Size";
+    case TAG_REPORT_ID:      return "Report ID";
+    case TAG_REPORT_COUNT:   return "Report Count";
+    case TAG_PUSH:           return "Push";
+    case TAG_POP:            return "Pop";
+    case TAG_USAGE:          return "Usage";
+    case TAG_USAGE_MIN:      return "Usage Min";
+    case TAG_USAGE_MAX:      return "Usage Max";
+    default:                 return "?";
+  }
+}
+
+static void define(const char *pName, const char *pSuffix, long value)
+{
+  char name[3 * NAME_LEN];
+
+  snprintf(name, sizeof(name), "%.*s%s", 2 * NAME_LEN, pName, pSuffix);
+  fprintf(pOut, "#define %-43s %ld\n", name, value);
+}
+
+static const char *pageLabel(uint16_t page)
+{
+  switch (page)
+  {
+    case 0x01: return "Generic Desktop";
+    case 0x02: return "Simulation Controls";
+    case 0x05: return "Game Controls";
+    case 0x07: return "Key Codes";
+    case 0x08: return "LEDs";
+    case 0x09: return "Button";
+    case 0x0C: return "Consumer Devices";
+    default:   return (page >= 0xFF00) ? "Vendor Defined" : NULL;
+  }
+}
+
+static const char *usageLabel(uint32_t usage)
+{
+  switch (usage)
+  {
+    case 0x00010002: return "Mouse";
+    case 0x00010004: return "Joystick";
+    case 0x00010005: return "Game Pad";
+    case 0x00010006: return "Keyboard";
+    case 0x00010030: return "X";
+    case 0x00010031: return "Y";
+    case 0x00010032: return "Z";
+    case 0x00010033: return "Rx";
+    case 0x00010034: return "Ry";
+    case 0x00010035: return "Rz";
+    case 0x00010038: return "Wheel";
+    case 0x00010039: return "Hat Switch";
+    case 0x00010080: return "System Control";
+    case 0x00010081: return "System Power Down";
+    case 0x00010082: return "System Sleep";
+    case 0x00010083: return "System Wake Up";
+    case 0x00010084: return "System Context Menu";
+    case 0x00010085: return "System Main Menu";
+    case 0x00010086: return "System App Menu";
+    case 0x00010087: return "System Menu Help";
+    case 0x00010088: return "System Menu Exit";
+    case 0x00010089: return "System Menu Select";
+    case 0x0001008A: return "System Menu Right";
+    case 0x0001008B: return "System Menu Left";
+    case 0x0001008C: return "System Menu Up";
+    case 0x0001008D: return "System Menu Down";
+    case 0x000200C4: return "Accelerator";
+    case 0x000200C5: return "Brake";
+    case 0x000C0001: return "Consumer Control";
+    case 0x000C0040: return "Menu";
+    case 0x000C0041: return "Menu Pick";
+    case 0x000C0042: return "Menu Up";
+    case 0x000C0043: return "Menu Down";
+    case 0x000C0044: return "Menu Left";
+    case 0x000C0045: return "Menu Right";
+    case 0x000C0046: return "Menu Escape";
+    case 0x000C0047: return "Menu Value Increase";
+    case 0x000C0048: return "Menu Value Decrease";
+    case 0x000C0060: return "Data On Screen";
+    case 0x000C0061: return "Closed Caption";
+    case 0x000C0062: return "Closed Caption Select";
+    case 0x000C0080: return "Selection";
+    case 0x000C0081: return "Assign Selection";
+    case 0x000C00B0: return "Play";
+    case 0x000C00B1: return "Pause";
+    case 0x000C00B3: return "Fast Forward";
+    case 0x000C00B4: return "Rewind";
+    case 0x000C00B5: return "Scan Next Track";
+    case 0x000C00B6: return "Scan Previous Track";
+    case 0x000C00B7: return "Stop";
+    case 0x000C00CD: return "Play/Pause";
+    case 0x000C00E2: return "Mute";
+    case 0x000C00E9: return "Volume Increment";
+    case 0x000C00EA: return "Volume Decrement";
+    default:         return NULL;
+  }
+}
+
+static void mainLabel(char *pBuf, size_t len, const char *pName, uint32_t data)
+{
+  snprintf(pBuf, len, "%s: (%s%s%s%s)", pName,
+           (data & FLAG_CONSTANT) ? "Constant" : "Data",
+           (data & FLAG_CONSTANT) ? "" :
+           (data & FLAG_VARIABLE) ? ", Variable" : ", Array",
+           (data & FLAG_CONSTANT) ? "" :
+           (data & 0x04) ? ", Relative" : ", Absolute",
+           (data & 0x40) ? ", Null" : "");
+}
+
+// Item bytes as C literals, with a trailing comma unless last
+static void itemBytes(char *pBuf, size_t bufLen, const item_t *pItem,
+                      int last)
+{
+  int len, k;
+
+  len = snprintf(pBuf, bufLen, "0x%02X", pItem->prefix);
+  for (k = 0; k < pItem->size; k++)
+  {
+    len += snprintf(&pBuf[len], bufLen - len, ", 0x%02X",
+                    (unsigned)((pItem->data >> (8 * k)) & 0xFF));
+  }
+  if (!last)
+  {
+    snprintf(&pBuf[len], bufLen - len, ",");
+  }
+}
+
+// Item name and value, page being the usage page in effect
+static void itemComment(char *pBuf, size_t bufLen, const item_t *pItem,
+                        uint16_t page)
+{
+  static const char * const collLabel[] = { "Physical", "Application",
+                                            "Logical" };
+  const char *pLabel = NULL;
+  uint8_t tag = pItem->prefix & 0xFC;
+
+  if (tag == TAG_USAGE_PAGE)
+  {
+    pLabel = pageLabel(page);
+  }
+  else if (tag == TAG_USAGE)
+  {
+    pLabel = usageLabel(fullUsage(pItem, page));
+  }
+  else if ((tag == TAG_COLLECTION) && (pItem->data < 3))
+  {
+    pLabel = collLabel[pItem->data];
+  }
+  else if ((tag == TAG_UNIT) && (pItem->data == 0))
+  {
+    pLabel = "None";
+  }
+  else if ((tag == TAG_UNIT) && (pItem->data == 0x14))
+  {
+    pLabel = "Eng Rot: Degrees";
+  }
+
+  if ((tag == TAG_INPUT) || (tag == TAG_OUTPUT) || (tag == TAG_FEATURE))
+  {
+    mainLabel(pBuf, bufLen, itemName(tag), pItem->data);
+  }
+  else if (pLabel != NULL)
+  {
+    snprintf(pBuf, bufLen, "%s (%s)", itemName(tag), pLabel);
+  }
+  else if ((tag == TAG_END_COLLECTION) || (tag == TAG_PUSH) ||
+           (tag == TAG_POP))
+  {
+    snprintf(pBuf, bufLen, "%s", itemName(tag));
+  }
+  else if ((tag == TAG_LOGICAL_MIN) || (tag == TAG_LOGICAL_MAX) ||
+           (tag == TAG_PHYSICAL_MIN) || (tag == TAG_PHYSICAL_MAX))
+  {
+    snprintf(pBuf, bufLen, "%s (%ld)", itemName(tag),
+             (long)signedData(pItem));
+  }
+  else if ((tag == TAG_REPORT_SIZE) || (tag == TAG_REPORT_COUNT) ||
+           (tag == TAG_REPORT_ID))
+  {
+    snprintf(pBuf, bufLen, "%s (%lu)", itemName(tag),
+             (unsigned long)pItem->data);
+  }
+  else
+  {
+    snprintf(pBuf, bufLen, "%s (0x%02lX)", itemName(tag),
+             (unsigned long)pItem->data);
+  }
+}
+
+static void emitMap(void)
+{
+  const item_t *pItem;
+  char bytes[40];
+  char comment[64];
+  int i, depth = 0;
+  int src = -1;
+  uint16_t page = 0;
+  uint8_t tag;
+
+  fprintf(pOut, "// Report map, the collections one after the other\n");
+  fprintf(pOut, "#define HID_DESC_REPORT_MAP \\\n");
+
+  for (i = 0; i < numMapItems; i++)
+  {
+    pItem = &mapItems[i];
+    tag = pItem->prefix & 0xFC;
+
+    if (pItem->src != src)
+    {
+      src = pItem->src;
+      fprintf(pOut, "  /* %s, %s */ \\\n", sources[src].name,
+              sources[src].pPath);
+    }
+
+    itemBytes(bytes, sizeof(bytes), pItem, i + 1 == numMapItems);
+
+    if (tag == TAG_END_COLLECTION)
+    {
+      depth--;
+    }
+
+    if (tag == TAG_USAGE_PAGE)
+    {
+      page = (uint16_t)pItem->data;
+    }
+
+    itemComment(comment, sizeof(comment), pItem, page);
+
+    fprintf(pOut, "  %-20s/* %*s%-*s */%s\n", bytes, 2 * depth, "",
+            44 - 2 * depth, comment, (i + 1 < numMapItems) ? " \\" : "");
+
+    if (tag == TAG_COLLECTION)
+    {
+      depth++;
+    }
+  }
+
+  fprintf(pOut, "\n");
+}
+
+static void emitSkeleton(void)
+{
+  static const char * const macroName[] = { "INPUT", "OTHER" };
+  char name[NAME_LEN], prefix[2 * NAME_LEN];
+  int pass, type, i, n, total;
+
+  fprintf(pOut, "// hidRptMap_t skeleton: report ID, type and protocol mode "
+          "of each report\n// in the map, input reports first; handles, "
+          "CCCDs and queueing are\n// filled in when the service "
+          "registers\n");
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    n = 0;
+    for (type = (pass == 0) ? TYPE_INPUT : TYPE_OUTPUT;
+         type <= ((pass == 0) ? TYPE_INPUT : TYPE_FEATURE); type++)
+    {
+      for (i = 0; i < numReports; i++)
+      {
+        if (reports[i].type == type)
+        {
+          upper(name, sources[reports[i].src].name);
+          snprintf(prefix, sizeof(prefix), "HID_DESC_%s_%s", name,
+                   typeSuffix[type]);
+          define(prefix, "_IDX", n++);
+        }
+      }
+    }
+    snprintf(prefix, sizeof(prefix), "HID_DESC_NUM_%s", macroName[pass]);
+    define(prefix, "_REPORTS", n);
+    fprintf(pOut, "\n");
+  }
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    total = 0;
+    for (type = TYPE_INPUT; type <= TYPE_FEATURE; type++)
+    {
+      for (i = 0; i < numReports; i++)
+      {
+        if ((reports[i].type == type) && ((type == TYPE_INPUT) == (pass == 0)))
+        {
+          total++;
+        }
+      }
+    }
+
+    fprintf(pOut, "#define HID_DESC_RPT_MAP_%s%s\n", macroName[pass],
+            total ? " \\" : "");
+    n = 0;
+    for (type = TYPE_INPUT; type <= TYPE_FEATURE; type++)
+    {
+      for (i = 0; i < numReports; i++)
+      {
+        if ((reports[i].type != type) || ((type == TYPE_INPUT) != (pass == 0)))
+        {
+          continue;
+        }
+        upper(name, sources[reports[i].src].name);
+        // Complete initializers; the queue policy is set at registration
+        fprintf(pOut, "  { 0, NULL, HID_DESC_%s_ID, %s, \\\n"
+                "    HID_PROTOCOL_MODE_REPORT, HID_RPT_COALESCE_NONE, 0, \\\n"
+                "    HID_RPT_PRIO_EVENT, 0, 0, 0, 0, 0, 0, 0, 0 }%s\n", name,
+                typeConst[type], (++n < total) ? ", \\" : "");
+      }
+    }
+    fprintf(pOut, "\n");
+  }
+}
+
+static void emitDefines(void)
+{
+  const report_t *pRpt;
+  param_t params[MAX_PARAMS];
+  elem_t elems[MAX_ELEMS];
+  int numParams, numElems;
+  char name[NAME_LEN], field[NAME_LEN + 1], prefix[2 * NAME_LEN];
+  char fieldPrefix[3 * NAME_LEN + 1];
+  int i, k, u;
+
+  fprintf(pOut, "// Report IDs\n");
+  for (i = 0; i < numSources; i++)
+  {
+    upper(name, sources[i].name);
+    for (k = 0; k < numReports; k++)
+    {
+      if (reports[k].src == i)
+      {
+        snprintf(prefix, sizeof(prefix), "HID_DESC_%s", name);
+        define(prefix, "_ID", reports[k].id);
+        break;
+      }
+    }
+  }
+  fprintf(pOut, "\n");
+
+  for (i = 0; i < numReports; i++)
+  {
+    pRpt = &reports[i];
+    upper(name, sources[pRpt->src].name);
+    snprintf(prefix, sizeof(prefix), "HID_DESC_%s_%s", name,
+             typeSuffix[pRpt->type]);
+
+    fprintf(pOut, "// %s %s report: bit offset, size and logical range of "
+            "each field\n", sources[pRpt->src].name, typeName[pRpt->type]);
+    define(prefix, "_LEN", pRpt->bits / 8);
+
+    buildParams(pRpt, params, &numParams, elems, &numElems);
+    for (k = 0; k < numParams; k++)
+    {
+      upper(field + 1, params[k].name);
+      field[0] = '_';
+      snprintf(fieldPrefix, sizeof(fieldPrefix), "%s%s", prefix, field);
+      define(fieldPrefix, "_BIT", params[k].bitOff);
+      define(fieldPrefix, "_SIZE", params[k].size);
+      if (params[k].count)
+      {
+        define(fieldPrefix, "_COUNT", params[k].count);
+      }
+      if ((params[k].pField->flags & FLAG_VARIABLE) &&
+          (params[k].pField->size == 1))
+      {
+        // Bitmap
+        continue;
+      }
+      define(fieldPrefix, "_MIN", params[k].pField->logMin);
+      define(fieldPrefix, "_MAX", params[k].pField->logMax);
+
+      // Usage of each array index from _MIN up
+      if (!(params[k].pField->flags & FLAG_VARIABLE) &&
+          !params[k].pField->hasRange && params[k].pField->numUsages)
+      {
+        fprintf(pOut, "#define %s_USAGES \\\n  {", fieldPrefix);
+        for (u = 0; u < params[k].pField->numUsages; u++)
+        {
+          fprintf(pOut, " 0x%02lX%s",
+                  (unsigned long)(params[k].pField->usages[u] & 0xFFFF),
+                  (u + 1 == params[k].pField->numUsages) ? " }\n" :
+                  (u % 8 == 7) ? ", \\\n   " : ",");
+        }
+      }
+    }
+    fprintf(pOut, "\n");
+  }
+}
+
+// Returns TRUE when the term is the value as it is
+static int emitTerm(char *pBuf, size_t bufLen, const param_t *pParam,
+                    const elem_t *pElem, int byte)
+{
+  char value[2 * NAME_LEN];
+  int lo, hi, from, bits, shift, mask, plain;
+
+  lo = (pElem->bitOff > 8 * byte) ? pElem->bitOff : 8 * byte;
+  hi = (pElem->bitOff + pElem->size < 8 * byte + 8) ?
+       pElem->bitOff + pElem->size : 8 * byte + 8;
+  from = lo - pElem->bitOff;
+  bits = hi - lo;
+  shift = lo - 8 * byte;
+
+  // Signed values are stored two's complement
+  plain = !pParam->isSigned;
+  if (pElem->index >= 0)
+  {
+    snprintf(value, sizeof(value), "%s[%d]", pParam->name, pElem->index);
+  }
+  else if (pParam->isSigned)
+  {
+    snprintf(value, sizeof(value), "(uint%d_t)%s", pParam->width,
+             pParam->name);
+  }
+  else
+  {
+    snprintf(value, sizeof(value), "%s", pParam->name);
+  }
+
+  if (from)
+  {
+    snprintf(value + strlen(value), sizeof(value) - strlen(value), " >> %d",
+             from);
+  }
+
+  // Bits above the field that would land inside this byte
+  mask = (shift + bits < 8) ? ((1 << bits) - 1) : 0;
+
+  if (mask && shift)
+  {
+    snprintf(pBuf, bufLen, "((%s) & 0x%02X) << %d", value, mask, shift);
+  }
+  else if (mask)
+  {
+    snprintf(pBuf, bufLen, "(%s) & 0x%02X", value, mask);
+  }
+  else if (shift)
+  {
+    snprintf(pBuf, bufLen, "(%s) << %d", value, shift);
+  }
+  else
+  {
+    snprintf(pBuf, bufLen, "%s", value);
+    return plain && (from == 0);
+  }
+
+  return 0;
+}
+
+static void emitPack(const report_t *pRpt)
+{
+  param_t params[MAX_PARAMS];
+  elem_t elems[MAX_ELEMS];
+  int numParams, numElems;
+  char name[NAME_LEN], fn[NAME_LEN], term[4 * NAME_LEN];
+  char decl[2 * NAME_LEN];
+  char line[512];
+  int byte, k, n, col, plain = 0, width = 8;
+
+  buildParams(pRpt, params, &numParams, elems, &numElems);
+
+  upper(name, sources[pRpt->src].name);
+  camel(fn, sources[pRpt->src].name);
+
+  fprintf(pOut, "/*\n * Pack the %s input report (report ID %u), "
+          "HID_DESC_%s_IN_LEN bytes.\n */\n", sources[pRpt->src].name,
+          pRpt->id, name);
+  col = fprintf(pOut, "static inline void HidDesc_pack%s%s(", fn,
+                typeCamel[pRpt->type]);
+  fprintf(pOut, "uint8_t *buf");
+  n = col + 12;
+  for (k = 0; k < numParams; k++)
+  {
+    if (params[k].count)
+    {
+      snprintf(decl, sizeof(decl), "const %sint%d_t *%.*s",
+               params[k].isSigned ? "" : "u", params[k].width, NAME_LEN,
+               params[k].name);
+    }
+    else
+    {
+      snprintf(decl, sizeof(decl), "%sint%d_t %.*s",
+               params[k].isSigned ? "" : "u", params[k].width, NAME_LEN,
+               params[k].name);
+    }
+
+    if (n + 2 + (int)strlen(decl) + 1 > 78)
+    {
+      fprintf(pOut, ",\n%*s%s", col, "", decl);
+      n = col + (int)strlen(decl);
+    }
+    else
+    {
+      fprintf(pOut, ", %s", decl);
+      n += 2 + (int)strlen(decl);
+    }
+  }
+  fprintf(pOut, ")\n{\n");
+
+  for (byte = 0; byte < pRpt->bits / 8; byte++)
+  {
+    line[0] = '\0';
+    n = 0;
+    for (k = 0; k < numElems; k++)
+    {
+      if ((elems[k].bitOff < 8 * byte + 8) &&
+          (elems[k].bitOff + elems[k].size > 8 * byte))
+      {
+        plain = emitTerm(term, sizeof(term), &params[elems[k].param],
+                         &elems[k], byte);
+        width = params[elems[k].param].width;
+        snprintf(line + strlen(line), sizeof(line) - strlen(line), "%s%s",
+                 n ? " | " : "", term);
+        n++;
+      }
+    }
+
+    if (n == 0)
+    {
+      fprintf(pOut, "  buf[%d] = 0;\n", byte);
+    }
+    else if ((n == 1) && plain && (width == 8))
+    {
+      fprintf(pOut, "  buf[%d] = %s;\n", byte, line);
+    }
+    else if ((n == 1) && plain)
+    {
+      fprintf(pOut, "  buf[%d] = (uint8_t)%s;\n", byte, line);
+    }
+    else
+    {
+      fprintf(pOut, "  buf[%d] = (uint8_t)(%s);\n", byte, line);
+    }
+  }
+
+  fprintf(pOut, "}\n\n");
+}
+
+static void emitHeader(int argc, char *argv[], const char *pOutPath)
+{
+  const char *pFile = strrchr(pOutPath, '/');
+  char guard[NAME_LEN];
+  int i;
+
+  pFile = (pFile != NULL) ? pFile + 1 : pOutPath;
+  for (i = 0; pFile[i] && (i < NAME_LEN - 1); i++)
+  {
+    guard[i] = isalnum((unsigned char)pFile[i]) ?
+               (char)toupper((unsigned char)pFile[i]) : '_';
+  }
+  guard[i] = '\0';
+
+  fprintf(pOut, "/****************************************************"
+          "**************************\n\n");
+  fprintf(pOut, " @file       %s\n\n", pFile);
+  fprintf(pOut, " @brief Composite HID report map, hidRptMap_t skeleton "
+          "and report pack\n        functions. Generated by "
+          "tools/hid_desc_gen, do not edit; change the\n        sources "
+          "and run make -C tools hid-desc.\n\n        Sources:");
+  for (i = 0; i < argc; i++)
+  {
+    fprintf(pOut, "%s%s", (i == 0) ? " " : "\n                 ", argv[i]);
+  }
+  fprintf(pOut, "\n\n Group: CMCU, SCS\n Target Device: CC2640R2\n\n");
+  fprintf(pOut, " *****************************************************"
+          "************************/\n\n");
+  fprintf(pOut, "#ifndef %s\n#define %s\n\n", guard, guard);
+  fprintf(pOut, "#ifdef __cplusplus\nextern \"C\"\n{\n#endif\n\n");
+  fprintf(pOut, "/*************************************************"
+          "********************\n * INCLUDES\n */\n");
+  fprintf(pOut, "#include <stdint.h>\n\n");
+  fprintf(pOut, "/*************************************************"
+          "********************\n * CONSTANTS\n */\n\n");
+
+  emitDefines();
+  emitMap();
+  emitSkeleton();
+
+  fprintf(pOut, "/*************************************************"
+          "********************\n * FUNCTIONS\n */\n\n");
+  for (i = 0; i < numReports; i++)
+  {
+    if (reports[i].type == TYPE_INPUT)
+    {
+      emitPack(&reports[i]);
+    }
+  }
+
+  fprintf(pOut, "/*************************************************"
+          "********************\n*************************************"
+          "********************************/\n\n");
+  fprintf(pOut, "#ifdef __cplusplus\n}\n#endif\n\n#endif /* %s */\n", guard);
+}
+
+// The source's own items, unchanged, as the tool's C export
+static void emitExport(const source_t *pSrc)
+{
+  const char *pSrcFile = strrchr(pSrc->pPath, '/');
+  const item_t *pItem;
+  char bytes[40];
+  char comment[64];
+  int i, len = 0, depth = 0;
+  uint16_t page = 0;
+  uint8_t tag;
+
+  for (i = 0; i < pSrc->numItems; i++)
+  {
+    len += 1 + pSrc->items[i].size;
+  }
+
+  pSrcFile = (pSrcFile != NULL) ? pSrcFile + 1 : pSrc->pPath;
+  fprintf(pOut, "// C export of %s by tools/hid_desc_gen -x, do not edit;"
+          "\n// change %s and run make -C tools hid-desc-export."
+          "\n\n\n", pSrcFile, pSrcFile);
+  fprintf(pOut, "char ReportDescriptor[%d] = {\n", len);
+
+  for (i = 0; i < pSrc->numItems; i++)
+  {
+    pItem = &pSrc->items[i];
+    tag = pItem->prefix & 0xFC;
+
+    itemBytes(bytes, sizeof(bytes), pItem, i + 1 == pSrc->numItems);
+
+    if (tag == TAG_END_COLLECTION)
+    {
+      depth--;
+    }
+
+    if (tag == TAG_USAGE_PAGE)
+    {
+      page = (uint16_t)pItem->data;
+    }
+
+    itemComment(comment, sizeof(comment), pItem, page);
+
+    fprintf(pOut, "    %-31s// %*s%s\n", bytes, 2 * depth, "", comment);
+
+    if (tag == TAG_COLLECTION)
+    {
+      depth++;
+    }
+  }
+
+  fprintf(pOut, "};\n\n");
+}
+
+/*********************************************************************
+ * Main
+ */
+
+static void usage(void)
+{
+  fprintf(stderr, "usage: hid_desc_gen [-o header] "
+          "source[:name[:id]]...\n"
+          "       hid_desc_gen -x [-o header] source\n");
+  exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *pOutPath = NULL;
+  source_t *pSrc;
+  char *pArg, *pColon, *pBase;
+  uint32_t globals[sizeof(resetTags)] = { 0 };
+  int argi = 1;
+  int mapLen = 0;
+  int export = 0;
+  int i, k;
+
+  if ((argc > 1) && (strcmp(argv[1], "-x") == 0))
+  {
+    export = 1;
+    argi = 2;
+  }
+  if ((argc > argi + 1) && (strcmp(argv[argi], "-o") == 0))
+  {
+    pOutPath = argv[argi + 1];
+    argi += 2;
+  }
+  if ((argi == argc) || (argc - argi > (export ? 1 : MAX_SOURCES)))
+  {
+    usage();
+  }
+
+  for (i = argi; i < argc; i++)
+  {
+    pSrc = &sources[numSources++];
+    pArg = strdup(argv[i]);
+    pSrc->id = -1;
+
+    pColon = strchr(pArg, ':');
+    if (pColon != NULL)
+    {
+      *pColon++ = '\0';
+      pBase = strchr(pColon, ':');
+      if (pBase != NULL)
+      {
+        *pBase++ = '\0';
+        pSrc->id = atoi(pBase);
+        if ((pSrc->id < 1) || (pSrc->id > 255))
+        {
+          fail(argv[i], "report ID must be 1..255");
+        }
+      }
+      snprintf(pSrc->name, sizeof(pSrc->name), "%s", pColon);
+    }
+    else
+    {
+      pBase = strrchr(pArg, '/');
+      snprintf(pSrc->name, sizeof(pSrc->name), "%s",
+               (pBase != NULL) ? pBase + 1 : pArg);
+      pBase = strchr(pSrc->name, '.');
+      if (pBase != NULL)
+      {
+        *pBase = '\0';
+      }
+      for (k = 0; pSrc->name[k]; k++)
+      {
+        pSrc->name[k] = isalnum((unsigned char)pSrc->name[k]) ?
+                        (char)tolower((unsigned char)pSrc->name[k]) : '_';
+      }
+    }
+    pSrc->pPath = pArg;
+
+    readSource(pSrc);
+    if (export)
+    {
+      break;
+    }
+    setReportId(pSrc);
+
+    appendSource(pSrc, globals, &mapLen);
+  }
+
+  if (mapLen > MAX_MAP_LEN)
+  {
+    fail("report map", "longer than 512 bytes");
+  }
+
+  if (!export)
+  {
+    parseMap();
+  }
+
+  pOut = stdout;
+  if (pOutPath != NULL)
+  {
+    pOut = fopen(pOutPath, "w");
+    if (pOut == NULL)
+    {
+      perror(pOutPath);
+      return 1;
+    }
+  }
+
+  if (export)
+  {
+    emitExport(&sources[0]);
+  }
+  else
+  {
+    emitHeader(argc - argi, &argv[argi], (pOutPath != NULL) ? pOutPath :
+                                                             "hid_desc.h");
+  }
+
+  if (pOut != stdout)
+  {
+    fclose(pOut);
+  }
+
+  return 0;
+}
@@ -0,0 +1,326 @@
+/******************************************************************************
+
+ @file       hid_fields_bench.c
+
+ @brief Host benchmark of the descriptor driven field packer
+        (hid_fields.c) against report code that knows the layout: the
+        hand-written buf[] stores hidemukbd.c used before hid_desc.h, and
+        the generated HidDesc_pack* functions. Packs the gamepad report of
+        the composite report map and checks that every path produces the
+        same bytes.
+
+        full     all controls: hat, 15 buttons, 6 axes
+        one      one axis of an existing report, as AT#GA or AT#SFx=...
+        parse    HidFields_parse of the whole report map
+
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hid_fields.h"
+#include "hid_desc.h"
+
+#define ROUNDS              2000000
+#define PARSE_ROUNDS        20000
+#define GP_LEN              HID_DESC_GAMEPAD_IN_LEN
+#define GP_BUTTONS          HID_DESC_GAMEPAD_IN_BUTTONS_SIZE
+#define GP_AXES             6
+
+static const uint8_t reportMap[] = { HID_DESC_REPORT_MAP };
+
+// Generic Desktop X, Y, Z, Rz and Simulation brake, accelerator
+static const uint16_t axisPage[GP_AXES]  = { 0x01, 0x01, 0x01, 0x01, 0x02, 0x02 };
+static const uint16_t axisUsage[GP_AXES] = { 0x30, 0x31, 0x32, 0x35, 0xC5, 0xC4 };
+
+static hidFieldTbl_t tbl;
+static uint32_t checksum;
+
+/*********************************************************************
+ * Gamepad state, a new one every round
+ */
+
+typedef struct
+{
+  uint16_t buttons;
+  uint8_t  hat;
+  uint8_t  axes[GP_AXES];
+} gamepad_t;
+
+static void nextState(gamepad_t *pState, uint32_t n)
+{
+  uint8_t i;
+
+  pState->buttons = (uint16_t)((n * 0x9E37u) & 0x7FFF);
+  pState->hat = (uint8_t)(n % 9);
+  for (i = 0; i < GP_AXES; i++)
+  {
+    pState->axes[i] = (uint8_t)(n * (i + 3));
+  }
+}
+
+static void sum(const uint8_t *pBuf)
+{
+  uint8_t i;
+
+  for (i = 0; i < GP_LEN; i++)
+  {
+    checksum = (checksum << 1) ^ pBuf[i];
+  }
+}
+
+/*********************************************************************
+ * Full report
+ */
+
+// Byte stores in the style of hidemukbd.c before hid_desc.h
+static void fullHand(const gamepad_t *pState, uint8_t *buf)
+{
+  uint8_t i;
+
+  buf[0] = 0;
+  buf[1] = pState->hat;
+  buf[2] = (uint8_t)pState->buttons;
+  buf[3] = (uint8_t)((pState->buttons >> 8) & 0x7F);
+  for (i = 0; i < GP_AXES; i++)
+  {
+    buf[4 + i] = pState->axes[i];
+  }
+}
+
+static void fullGen(const gamepad_t *pState, uint8_t *buf)
+{
+  HidDesc_packGamepadIn(buf, pState->hat, pState->buttons,
+                        pState->axes[0], pState->axes[1], pState->axes[2],
+                        pState->axes[3], pState->axes[4], pState->axes[5]);
+}
+
+// Fields looked up once, as a caller holding hidField_t pointers would
+static const hidField_t *pHat, *pButtons, *pAxes[GP_AXES];
+static uint16_t hatIdx, axisIdx[GP_AXES];
+
+// The 15 one bit buttons set as one run
+static void fullFields(const gamepad_t *pState, uint8_t *buf)
+{
+  uint8_t i;
+
+  buf[0] = 0;
+  HidFields_set(pHat, hatIdx, pState->hat, buf);
+  HidFields_setBits(pButtons, 0, GP_BUTTONS, pState->buttons, buf);
+  for (i = 0; i < GP_AXES; i++)
+  {
+    HidFields_set(pAxes[i], axisIdx[i], pState->axes[i], buf);
+  }
+}
+
+// As above, each button set on its own
+static void fullPerBit(const gamepad_t *pState, uint8_t *buf)
+{
+  uint8_t i;
+
+  buf[0] = 0;
+  HidFields_set(pHat, hatIdx, pState->hat, buf);
+  for (i = 0; i < GP_BUTTONS; i++)
+  {
+    HidFields_set(pButtons, i, (pState->buttons >> i) & 1, buf);
+  }
+  for (i = 0; i < GP_AXES; i++)
+  {
+    HidFields_set(pAxes[i], axisIdx[i], pState->axes[i], buf);
+  }
+}
+
+// Every control found by usage, the buttons by their first usage
+static void fullFind(const gamepad_t *pState, uint8_t *buf)
+{
+  const hidField_t *pField;
+  uint16_t idx;
+  uint8_t i;
+
+  buf[0] = 0;
+  pField = HidFields_find(&tbl, HID_FIELDS_INPUT, 0x01, 0x39, &idx);
+  HidFields_set(pField, idx, pState->hat, buf);
+  pField = HidFields_find(&tbl, HID_FIELDS_INPUT, 0x09, 1, &idx);
+  HidFields_setBits(pField, idx, GP_BUTTONS, pState->buttons, buf);
+  for (i = 0; i < GP_AXES; i++)
+  {
+    pField = HidFields_find(&tbl, HID_FIELDS_INPUT, axisPage[i],
+                            axisUsage[i], &idx);
+    HidFields_set(pField, idx, pState->axes[i], buf);
+  }
+}
+
+/*********************************************************************
+ * One axis
+ */
+
+static void oneHand(const gamepad_t *pState, uint8_t *buf)
+{
+  buf[4] = pState->axes[0];
+}
+
+static void oneGen(const gamepad_t *pState, uint8_t *buf)
+{
+  // The generated code only packs whole reports
+  fullGen(pState, buf);
+}
+
+static void oneFields(const gamepad_t *pState, uint8_t *buf)
+{
+  HidFields_set(pAxes[0], axisIdx[0], pState->axes[0], buf);
+}
+
+static void oneFind(const gamepad_t *pState, uint8_t *buf)
+{
+  const hidField_t *pField;
+  uint16_t idx;
+
+  pField = HidFields_find(&tbl, HID_FIELDS_INPUT, 0x01, 0x30, &idx);
+  HidFields_set(pField, idx, pState->axes[0], buf);
+}
+
+static void oneName(const gamepad_t *pState, uint8_t *buf)
+{
+  const hidField_t *pField;
+  uint16_t page, usage, idx;
+
+  HidFields_usageByName("x", 1, &page, &usage);
+  pField = HidFields_find(&tbl, HID_FIELDS_INPUT, page, usage, &idx);
+  HidFields_set(pField, idx, pState->axes[0], buf);
+}
+
+/*********************************************************************
+ * Benchmark
+ */
+
+static double nowNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Time one packer; every round is also packed by ref into a second
+// buffer and compared
+static double run(const char *name,
+                  void (*pack)(const gamepad_t *, uint8_t *),
+                  void (*ref)(const gamepad_t *, uint8_t *),
+                  double base)
+{
+  gamepad_t state;
+  uint8_t buf[GP_LEN];
+  uint8_t refBuf[GP_LEN];
+  double t0, t1, ns;
+  uint32_t n;
+
+  // Same bytes as the reference
+  memset(buf, 0, sizeof(buf));
+  memset(refBuf, 0, sizeof(refBuf));
+  for (n = 0; n < 1000; n++)
+  {
+    nextState(&state, n);
+    pack(&state, buf);
+    ref(&state, refBuf);
+    if (memcmp(buf, refBuf, GP_LEN) != 0)
+    {
+      fprintf(stderr, "%s: report differs at round %u\n", name, n);
+      exit(1);
+    }
+  }
+
+  t0 = nowNs();
+  for (n = 0; n < ROUNDS; n++)
+  {
+    nextState(&state, n);
+    pack(&state, buf);
+    sum(buf);
+  }
+  t1 = nowNs();
+
+  ns = (t1 - t0) / ROUNDS;
+  printf("%-15s %9.1f %9.2f\n", name, ns, (base > 0) ? ns / base : 1.0);
+
+  return ns;
+}
+
+// New state and checksum only, the floor under every row
+static void statesOnly(const gamepad_t *pState, uint8_t *buf)
+{
+  (void)pState;
+  (void)buf;
+}
+
+int main(void)
+{
+  const hidField_t *pField;
+  uint16_t idx;
+  double t0, t1, base;
+  uint32_t n;
+  uint8_t i;
+
+  if (HidFields_parse(&tbl, reportMap, sizeof(reportMap)) !=
+      HID_FIELDS_SUCCESS)
+  {
+    fprintf(stderr, "report map does not parse\n");
+    return 1;
+  }
+
+  pHat = HidFields_find(&tbl, HID_FIELDS_INPUT, 0x01, 0x39, &hatIdx);
+  pButtons = HidFields_find(&tbl, HID_FIELDS_INPUT, 0x09, 1, &idx);
+  for (i = 0; i < GP_AXES; i++)
+  {
+    pAxes[i] = HidFields_find(&tbl, HID_FIELDS_INPUT, axisPage[i],
+                              axisUsage[i], &axisIdx[i]);
+  }
+  if ((pHat == NULL) || (pButtons == NULL) || (pButtons->count != GP_BUTTONS))
+  {
+    fprintf(stderr, "gamepad fields not found\n");
+    return 1;
+  }
+  for (i = 0; i < GP_AXES; i++)
+  {
+    if (pAxes[i] == NULL)
+    {
+      fprintf(stderr, "gamepad axis %u not found\n", i);
+      return 1;
+    }
+  }
+
+  printf("%-15s %9s %9s\n", "full report", "ns/rpt", "x buf[]");
+  run("(state only)", statesOnly, statesOnly, 0);
+  base = run("buf[]", fullHand, fullHand, 0);
+  run("HidDesc_pack", fullGen, fullHand, base);
+  run("fields", fullFields, fullHand, base);
+  run("fields, per bit", fullPerBit, fullHand, base);
+  run("find+fields", fullFind, fullHand, base);
+
+  printf("\n%-14s %9s %9s\n", "one axis", "ns/rpt", "x buf[]");
+  base = run("buf[]", oneHand, oneHand, 0);
+  run("HidDesc_pack", oneGen, fullHand, base);
+  run("fields", oneFields, oneHand, base);
+  run("find+fields", oneFind, oneHand, base);
+  run("name+find", oneName, oneHand, base);
+
+  pField = NULL;
+  t0 = nowNs();
+  for (n = 0; n < PARSE_ROUNDS; n++)
+  {
+    HidFields_parse(&tbl, reportMap, sizeof(reportMap));
+    pField = &tbl.fields[n % tbl.numFields];
+    checksum += pField->bitOffset;
+  }
+  t1 = nowNs();
+
+  printf("\nparse %u byte map: %.0f ns, %u fields, %u reports, %u usages\n",
+         (unsigned)sizeof(reportMap), (t1 - t0) / PARSE_ROUNDS,
+         tbl.numFields, tbl.numRpts, tbl.numUsages);
+  printf("(checksum %08x)\n", checksum);
+
+  return 0;
+}
@@ -0,0 +1,241 @@
+/******************************************************************************
+
+ @file       gattservapp_test.c
+
+ @brief Host test of the client characteristic configuration slots in
+        gattservapp_util.c. Random link up, link down and CCCD reads,
+        writes and resets over several connections are checked against
+        a plain scan of the table, the lookup the stock utilities do:
+        reads must return the same value and writes succeed or fail the
+        same, wherever the slots put the entries. Covers entries written
+        before link up and handles without a slot.
+
+        Usage: gattservapp_test [rounds]   exits 0 on success
+
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "icall_ble_api.h"
+#include "gattservapp_util.h"
+
+#define NUM_CONNS           4
+#define NUM_TBLS            3
+#define ROUNDS              200000
+
+// Link handles in use: with a slot, and past GATT_SERV_APP_MAX_CONN_HANDLES
+static const uint16 connHandles[] =
+{
+  0, 1, 2, 3, 5, GATT_SERV_APP_MAX_CONN_HANDLES, 0x0040
+};
+
+#define NUM_HANDLES         (sizeof(connHandles) / sizeof(connHandles[0]))
+
+/*********************************************************************
+ * Stack stand-ins, the notification path is not under test
+ */
+
+uint8 linkDBNumConns = NUM_CONNS;
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  (void)connHandle;
+  (void)opcode;
+  (void)size;
+  (void)pSizeAlloc;
+  return NULL;
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+  (void)pMsg;
+  (void)opcode;
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  (void)connHandle;
+  (void)pNoti;
+  (void)authenticated;
+  return FAILURE;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  (void)connHandle;
+  (void)pInd;
+  (void)authenticated;
+  (void)taskId;
+  return FAILURE;
+}
+
+/*********************************************************************
+ * Reference: the table scan of the stock utilities
+ */
+
+static gattCharCfg_t refTbl[NUM_TBLS][NUM_CONNS];
+
+static gattCharCfg_t *refFind(gattCharCfg_t *pTbl, uint16 connHandle)
+{
+  uint8 i;
+
+  for (i = 0; i < NUM_CONNS; i++)
+  {
+    if (pTbl[i].connHandle == connHandle)
+    {
+      return &pTbl[i];
+    }
+  }
+
+  return NULL;
+}
+
+static uint16 refRead(gattCharCfg_t *pTbl, uint16 connHandle)
+{
+  gattCharCfg_t *pItem = refFind(pTbl, connHandle);
+
+  return (pItem != NULL) ? pItem->value : GATT_CFG_NO_OPERATION;
+}
+
+static uint8 refWrite(gattCharCfg_t *pTbl, uint16 connHandle, uint16 value)
+{
+  gattCharCfg_t *pItem = refFind(pTbl, connHandle);
+
+  if (pItem == NULL)
+  {
+    pItem = refFind(pTbl, INVALID_CONNHANDLE);
+    if (pItem == NULL)
+    {
+      return ATT_ERR_INSUFFICIENT_RESOURCES;
+    }
+
+    pItem->connHandle = connHandle;
+  }
+
+  pItem->value = value;
+
+  return SUCCESS;
+}
+
+static void refReset(gattCharCfg_t *pTbl, uint16 connHandle)
+{
+  gattCharCfg_t *pItem = refFind(pTbl, connHandle);
+
+  if (pItem != NULL)
+  {
+    pItem->connHandle = INVALID_CONNHANDLE;
+    pItem->value = GATT_CFG_NO_OPERATION;
+  }
+}
+
+/*********************************************************************
+ * Test
+ */
+
+static gattCharCfg_t tbl[NUM_TBLS][NUM_CONNS];
+static uint8 linked[NUM_HANDLES];
+
+static int fail(unsigned long round, const char *what, uint16 connHandle,
+                unsigned got, unsigned want)
+{
+  fprintf(stderr, "round %lu: %s of handle 0x%04x gave %u, expected %u\n",
+          round, what, connHandle, got, want);
+
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long rounds = (argc > 1) ? strtoul(argv[1], NULL, 0) : ROUNDS;
+  unsigned long round;
+  unsigned long writes = 0, full = 0;
+  uint8 t;
+
+  srand(1);
+
+  for (t = 0; t < NUM_TBLS; t++)
+  {
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, tbl[t]);
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, refTbl[t]);
+  }
+
+  for (round = 0; round < rounds; round++)
+  {
+    uint8 h = (uint8)(rand() % NUM_HANDLES);
+    uint16 connHandle = connHandles[h];
+    uint16 value = (uint16)(rand() % 4);
+    uint8 got, want;
+
+    t = (uint8)(rand() % NUM_TBLS);
+
+    switch (rand() % 8)
+    {
+      case 0:
+        // Link up; the stack may have restored entries before this
+        if (!linked[h])
+        {
+          GATTServApp_LinkUp(connHandle);
+          linked[h] = TRUE;
+        }
+        break;
+
+      case 1:
+        // Link down clears the entries of the link, as GAPRole does
+        if (linked[h])
+        {
+          GATTServApp_LinkDown(connHandle);
+          linked[h] = FALSE;
+          for (t = 0; t < NUM_TBLS; t++)
+          {
+            GATTServApp_InitCharCfg(connHandle, tbl[t]);
+            refReset(refTbl[t], connHandle);
+          }
+        }
+        break;
+
+      case 2:
+        GATTServApp_InitCharCfg(connHandle, tbl[t]);
+        refReset(refTbl[t], connHandle);
+        break;
+
+      case 3:
+      case 4:
+        got = GATTServApp_WriteCharCfg(connHandle, tbl[t], value);
+        want = refWrite(refTbl[t], connHandle, value);
+        if (got != want)
+        {
+          return fail(round, "write", connHandle, got, want);
+        }
+        writes++;
+        full += (got != SUCCESS);
+        break;
+
+      default:
+        break;
+    }
+
+    // Every handle reads the same from every table
+    for (h = 0; h < NUM_HANDLES; h++)
+    {
+      for (t = 0; t < NUM_TBLS; t++)
+      {
+        uint16 v = GATTServApp_ReadCharCfg(connHandles[h], tbl[t]);
+        uint16 r = refRead(refTbl[t], connHandles[h]);
+
+        if (v != r)
+        {
+          return fail(round, "read", connHandles[h], v, r);
+        }
+      }
+    }
+  }
+
+  printf("gattservapp_test: %lu rounds, %lu writes (%lu to a full table), "
+         "ok\n", rounds, writes, full);
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+/******************************************************************************
+
+ @file       hostsim.c
+
+ @brief Host simulator for the HID emulated keyboard. Runs the unmodified
+        application, HID device and service code against the stand-ins in
+        this directory, with UART0 on a pseudo terminal and the over the
+        air traffic on a line oriented sink.
+
+        Usage: hostsim [options]
+          -o file   sink (default stdout)
+          -l path   symlink to the UART pseudo terminal
+          -c ms     advertising to connection delay (default 100)
+          -i n      connection interval at connect, 1.25 ms units (default 24)
+          -I n      fixed connection interval, ignore update requests
+          -p n      notifications per connection event (default 4)
+          -b n      controller notification buffers (default 5)
+          -m n      largest ATT MTU the central accepts (default 247)
+          -f        do not pace the UART at its baud rate
+          -t s      exit after s seconds
+          -a n      once bonded, time n rounds of the attribute callbacks
+                    of every service and exit
+
+        Sink lines, times are CLOCK_MONOTONIC microseconds:
+          P <path>                          UART pseudo terminal
+          H <handle> <uuid>                 attribute registered
+          S <t> <state>                     GAPRole state change
+          C <t> <interval> <latency> <to>   connection parameters
+          M <t> <mtu>                       ATT MTU exchanged
+          D <t> <reason>                    disconnected
+          N <t> <tQueued> <handle> <hex>    notification sent over the air
+          I <t> <tQueued> <handle> <hex>    indication sent over the air
+          B <t> <handle>                    notification refused, no buffer
+          O <t> <bytes>                     UART receive overrun
+          L <t> <n>                         notification buffers the
+                                            application holds, at a
+                                            connection event when changed
+          A <handle> <uuid> <reads> <ns> <writes> <ns>
+                                            attribute callback cost, -a
+
+ *****************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <icall.h>
+#include <ti/sysbios/BIOS.h>
+
+#include "bcomdef.h"
+#include "peripheral.h"
+#include "hiddev.h"
+#include "hidemukbd.h"
+
+#include "hostsim.h"
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+simCfg_t simCfg =
+{
+  .connectDelayMs = 100,
+  .initInterval   = 24,
+  .fixedInterval  = 0,
+  .pktsPerEvt     = 4,
+  .txBufs         = 5,
+  .mtu            = 247,
+  .uartPaced      = 1,
+};
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static pthread_mutex_t sinkLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *pSink = NULL;
+
+/*********************************************************************
+ * SINK
+ */
+
+void Sim_sinkOpen(const char *pPath)
+{
+  pSink = (pPath != NULL) ? fopen(pPath, "w") : stdout;
+  if (pSink == NULL)
+  {
+    perror(pPath);
+    exit(1);
+  }
+}
+
+void Sim_sink(const char *pFmt, ...)
+{
+  va_list ap;
+
+  pthread_mutex_lock(&sinkLock);
+  va_start(ap, pFmt);
+  vfprintf(pSink, pFmt, ap);
+  va_end(ap);
+  fputc('\n', pSink);
+  fflush(pSink);
+  pthread_mutex_unlock(&sinkLock);
+}
+
+void Sim_sinkHex(char tag, uint64_t t1, uint64_t t2, uint16_t handle,
+                 const uint8_t *pData, uint16_t len)
+{
+  uint16_t i;
+
+  pthread_mutex_lock(&sinkLock);
+  fprintf(pSink, "%c %llu %llu %u ", tag, (unsigned long long)t1,
+          (unsigned long long)t2, handle);
+  for (i = 0; i < len; i++)
+  {
+    fprintf(pSink, "%02x", pData[i]);
+  }
+  fputc('\n', pSink);
+  fflush(pSink);
+  pthread_mutex_unlock(&sinkLock);
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+static void usage(const char *pName)
+{
+  fprintf(stderr, "usage: %s [-o sink] [-l link] [-c ms] [-i interval] "
+          "[-I interval] [-p pkts] [-b bufs] [-m mtu] [-f] [-t seconds] "
+          "[-a rounds]\n",
+          pName);
+  exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *pSinkPath = NULL;
+  const char *pLink = NULL;
+  const char *pPty;
+  unsigned runTime = 0;
+  unsigned attrRounds = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "o:l:c:i:I:p:b:m:ft:a:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'o': pSinkPath = optarg; break;
+      case 'l': pLink = optarg; break;
+      case 'c': simCfg.connectDelayMs = atoi(optarg); break;
+      case 'i': simCfg.initInterval = atoi(optarg); break;
+      case 'I': simCfg.fixedInterval = atoi(optarg); break;
+      case 'p': simCfg.pktsPerEvt = atoi(optarg); break;
+      case 'b': simCfg.txBufs = atoi(optarg); break;
+      case 'm': simCfg.mtu = atoi(optarg); break;
+      case 'f': simCfg.uartPaced = 0; break;
+      case 't': runTime = atoi(optarg); break;
+      case 'a': attrRounds = atoi(optarg); break;
+      default:  usage(argv[0]);
+    }
+  }
+
+  if ((simCfg.initInterval < 6) || (simCfg.pktsPerEvt == 0) ||
+      (simCfg.txBufs == 0) || (simCfg.mtu < 23) ||
+      (simCfg.fixedInterval && (simCfg.fixedInterval < 6)))
+  {
+    usage(argv[0]);
+  }
+
+  Sim_sinkOpen(pSinkPath);
+
+  pPty = Sim_uartOpenPty(pLink);
+  if (pPty == NULL)
+  {
+    perror("pty");
+    return 1;
+  }
+  Sim_sink("P %s", pPty);
+
+  // Same bring-up as Startup/main.c
+  ICall_init();
+  ICall_createRemoteTasks();
+  GAPRole_createTask();
+  HidDev_createTask();
+  HidEmuKbd_createTask();
+  BIOS_start();
+
+  if (attrRounds > 0)
+  {
+    Sim_bleAttrBench(attrRounds);
+    return 0;
+  }
+
+  if (runTime > 0)
+  {
+    sleep(runTime);
+    return 0;
+  }
+
+  for (;;)
+  {
+    pause();
+  }
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+
+ @file       hostsim.h
+
+ @brief Internal interface of the Linux host simulator. The firmware sources
+        are compiled unmodified against the stand-in SDK headers in
+        include/; this header ties the stand-ins together.
+
+        Execution model: every TI-RTOS task and every simulated interrupt
+        source is a POSIX thread, but only one of them holds the CPU at a
+        time. The CPU goes to the highest priority ready context. Tasks are
+        preempted only at kernel calls (Event_post, Event_pend, leaving a
+        critical section, Task_restore), which is where a real preemption
+        would change what the firmware observes.
+
+ *****************************************************************************/
+
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Priority of interrupt contexts, above every task
+#define SIM_ISR_PRIO              100
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Execution context: a task or an interrupt source
+typedef struct simCtx
+{
+  const char     *pName;
+  int             prio;       // Task priority, SIM_ISR_PRIO for interrupts
+  int             ready;      // Wants the CPU
+  uint64_t        seq;        // FIFO order among equal priorities
+  int             csDepth;    // Critical section nesting
+  pthread_cond_t  cv;         // Signalled when given the CPU
+  pthread_t       thread;
+  Task_FuncPtr    fxn;
+  UArg            arg0;
+  UArg            arg1;
+  struct simCtx  *pNext;
+} simCtx_t;
+
+// Simulator configuration, set from the command line
+typedef struct
+{
+  uint32_t connectDelayMs;    // Advertising to connection
+  uint16_t initInterval;      // Connection interval at connect, 1.25 ms
+  uint16_t fixedInterval;     // Ignore parameter updates if non-zero
+  uint8_t  pktsPerEvt;        // Notifications sent per connection event
+  uint8_t  txBufs;            // Controller notification buffers
+  uint16_t mtu;               // Largest ATT MTU the central accepts
+  uint8_t  uartPaced;         // Pace the UART at the configured baud rate
+} simCfg_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+extern simCfg_t simCfg;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+// Kernel (sim_kernel.c)
+extern simCtx_t *Sim_isrCreate(const char *pName);
+extern void Sim_isrBegin(simCtx_t *pIsr);
+extern void Sim_isrEnd(simCtx_t *pIsr);
+extern simCtx_t *Sim_self(void);
+extern uint64_t Sim_nowUs(void);
+extern void Sim_sleepUs(uint64_t us);
+
+// ICall (sim_icall.c)
+extern void Sim_icallSend(uint8_t entity, void *pMsg);
+extern uint8_t Sim_icallEntity(void);
+
+// BLE stack (sim_ble.c)
+extern void Sim_bleInit(void);
+extern void Sim_bleAttrBench(unsigned rounds);
+
+// UART (sim_uart.c)
+extern const char *Sim_uartOpenPty(const char *pLink);
+
+// Observable sink (hostsim.c)
+extern void Sim_sinkOpen(const char *pPath);
+extern void Sim_sink(const char *pFmt, ...)
+  __attribute__((format(printf, 1, 2)));
+extern void Sim_sinkHex(char tag, uint64_t t1, uint64_t t2, uint16_t handle,
+                        const uint8_t *pData, uint16_t len);
+
+#endif /* HOSTSIM_H */
@@ -0,0 +1,211 @@
+/******************************************************************************
+
+ @file       hostsim_bench.c
+
+ @brief End to end benchmark on the host simulator. Starts hostsim, types
+        through its UART pseudo terminal with KEYS frames and times the
+        notifications on its sink.
+
+          latency     UART write of a one key frame to the first
+                      notification on the air
+          throughput  a burst of full KEYS frames: reports per second on
+                      the air and reports lost on the way
+
+        Usage: hostsim_bench [-n samples] [-f frames] [-F] hostsim [args...]
+          -F        turn on RTS/CTS first (AT#FC1), so a burst larger than
+                    the receive ring is held off instead of overrunning
+
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "uart_frame.h"
+#include "hostsim_drive.h"
+
+#define LAT_SAMPLES         200
+#define TPUT_FRAMES         32
+#define KEYS_PER_FRAME      (UART_FRAME_MAX_BODY / 2)
+
+static int cmpU64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*********************************************************************
+ * Benchmarks
+ */
+
+static void latency(unsigned samples)
+{
+  uint64_t *pLat = calloc(samples, sizeof(uint64_t));
+  char line[512];
+  unsigned i, got = 0;
+
+  for (i = 0; i < samples; i++)
+  {
+    benchNoti_t noti;
+    uint64_t t0;
+    int seen = 0;
+
+    // Land anywhere in the connection interval
+    usleep(2000 + (unsigned)(rand() % 20000));
+
+    t0 = nowUs();
+    sendKeys(1);
+
+    // Press and release
+    while ((seen < 2) && simLine(line, sizeof(line), 1000))
+    {
+      if (parseNoti(line, &noti) && (noti.handle == kbdHandle))
+      {
+        if (seen++ == 0)
+        {
+          pLat[got++] = noti.t - t0;
+        }
+      }
+    }
+  }
+
+  qsort(pLat, got, sizeof(uint64_t), cmpU64);
+
+  printf("latency    %u/%u samples, us: min %llu  p50 %llu  p99 %llu  "
+         "max %llu\n", got, samples,
+         got ? (unsigned long long)pLat[0] : 0ULL,
+         got ? (unsigned long long)pLat[got / 2] : 0ULL,
+         got ? (unsigned long long)pLat[(got * 99) / 100] : 0ULL,
+         got ? (unsigned long long)pLat[got - 1] : 0ULL);
+
+  free(pLat);
+}
+
+static unsigned received, refused, overruns;
+static uint64_t tFirst, tLast;
+
+static void throughputLine(const char *pLine)
+{
+  benchNoti_t noti;
+
+  if (parseNoti(pLine, &noti) && (noti.handle == kbdHandle))
+  {
+    if (received++ == 0)
+    {
+      tFirst = noti.t;
+    }
+    tLast = noti.t;
+  }
+  else if (pLine[0] == 'B')
+  {
+    refused++;
+  }
+  else if (pLine[0] == 'O')
+  {
+    overruns++;
+  }
+}
+
+static void throughput(unsigned frames)
+{
+  char line[512];
+  unsigned expected = frames * KEYS_PER_FRAME * 2;
+  uint64_t t0;
+  unsigned i;
+
+  settle(SETTLE_MS);
+
+  received = refused = overruns = 0;
+  tFirst = tLast = 0;
+
+  // With RTS/CTS the writes block once the device holds reception
+  pLineHook = throughputLine;
+  t0 = nowUs();
+  for (i = 0; i < frames; i++)
+  {
+    sendKeys(KEYS_PER_FRAME);
+  }
+  pLineHook = NULL;
+
+  while (simLine(line, sizeof(line), SETTLE_MS))
+  {
+    throughputLine(line);
+  }
+
+  printf("throughput %u reports in %.1f ms (%.0f reports/s), "
+         "first after %.1f ms\n", received,
+         (tLast - tFirst) / 1000.0,
+         (tLast > tFirst) ? received * 1e6 / (double)(tLast - tFirst) : 0.0,
+         received ? (tFirst - t0) / 1000.0 : 0.0);
+  printf("           expected %u, lost %u, no buffer %u, uart overruns %u\n",
+         expected, (expected > received) ? expected - received : 0,
+         refused, overruns);
+}
+
+/*
+ * AT#FC1, then AT#BC at the new setting to keep it.
+ */
+static void flowCtrlOn(void)
+{
+  static const char fc[] = "AT#FC1\r\n";
+  static const char bc[] = "AT#BC\r\n";
+
+  ptyWrite((const uint8_t *)fc, sizeof(fc) - 1);
+  settle(100);
+  ptyWrite((const uint8_t *)bc, sizeof(bc) - 1);
+  settle(100);
+}
+
+static void usage(const char *pName)
+{
+  fprintf(stderr, "usage: %s [-n samples] [-f frames] [-F] hostsim "
+          "[args...]\n", pName);
+  exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned samples = LAT_SAMPLES;
+  unsigned frames = TPUT_FRAMES;
+  int flowCtrl = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "+n:f:F")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': samples = atoi(optarg); break;
+      case 'f': frames = atoi(optarg); break;
+      case 'F': flowCtrl = 1; break;
+      default:  usage(argv[0]);
+    }
+  }
+
+  if (optind >= argc)
+  {
+    usage(argv[0]);
+  }
+
+  if (!simOpen(&argv[optind]))
+  {
+    return 1;
+  }
+
+  if (flowCtrl)
+  {
+    flowCtrlOn();
+  }
+
+  warmUp();
+  latency(samples);
+  throughput(frames);
+
+  simStop();
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+
+ @file       hostsim_check.c
+
+ @brief End to end checks on the host simulator, through its UART pseudo
+        terminal and its sink.
+
+          dedup       repeated identical keyboard reports built in place
+                      (AT#HP01000, an empty key press and release) are
+                      skipped without holding on to their notification
+                      buffers
+          escape      report frames whose LEN, body and CRC hold escaped
+                      bytes (11, 13, 7D), written a byte or a part at a
+                      time, are notified before the frame timeout
+
+        Usage: hostsim_check hostsim [args...]   exits 0 on success
+
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uart_frame.h"
+#include "hostsim_drive.h"
+
+#define DEDUP_ROUNDS        50
+
+// HIDEMUKBD_UART_FRAME_TIMEOUT; a frame the receive scanner misses is
+// only parsed once it expires
+#define FRAME_TIMEOUT_MS    20
+
+#define KBD_RPT_ID          1
+
+/*********************************************************************
+ * Sink
+ */
+
+// Notification buffers the application holds, from the last L line
+static int bufsHeld;
+static unsigned kbdNotis;
+
+// Last keyboard notification: time queued and data in hex
+static uint64_t kbdQueued;
+static char kbdHex[2 * UART_FRAME_MAX_BODY + 1];
+
+static void checkLine(const char *pLine)
+{
+  unsigned long long t, tq;
+  unsigned handle;
+  benchNoti_t noti;
+  int held;
+
+  if (parseNoti(pLine, &noti) && (noti.handle == kbdHandle))
+  {
+    kbdNotis++;
+    if (sscanf(pLine, "N %llu %llu %u %128s", &t, &tq, &handle, kbdHex) == 4)
+    {
+      kbdQueued = tq;
+    }
+  }
+  else if ((pLine[0] == 'L') && (sscanf(pLine, "L %llu %d", &t, &held) == 2))
+  {
+    bufsHeld = held;
+  }
+}
+
+static void drain(int quietMs)
+{
+  char line[512];
+
+  while (simLine(line, sizeof(line), quietMs))
+  {
+    checkLine(line);
+  }
+}
+
+static void sendLine(const char *pLine)
+{
+  ptyWrite((const uint8_t *)pLine, strlen(pLine));
+}
+
+/*********************************************************************
+ * Checks
+ */
+
+static int checkDedup(void)
+{
+  unsigned i;
+
+  drain(SETTLE_MS);
+  kbdNotis = 0;
+
+  for (i = 0; i < DEDUP_ROUNDS; i++)
+  {
+    sendLine("AT#HP01000\r\n");
+    drain(20);
+  }
+  drain(SETTLE_MS);
+
+  printf("dedup      %u x AT#HP01000: %u notifications, %d buffers held\n",
+         DEDUP_ROUNDS, kbdNotis, bufsHeld);
+
+  return (bufsHeld == 0) && (kbdNotis == 0);
+}
+
+static int escaped(uint8_t b)
+{
+  return (b == 0x11) || (b == 0x13) || (b == UART_FRAME_ESC);
+}
+
+// Report frame for the keyboard with dataLen bytes holding 11, 13 and 7D,
+// its last byte picked so that the CRC holds one as well; returns the
+// encoded length and the report in hex.
+static uint16_t escapeFrame(uint8_t dataLen, uint8_t seed, uint8_t *pFrame,
+                            char *pHex)
+{
+  uint8_t raw[2 + UART_FRAME_MAX_BODY];
+  uint8_t *pBody = &raw[2];
+  uint16_t crc;
+  uint8_t i;
+
+  raw[0] = UART_FRAME_RECORD_HDR_LEN + dataLen;
+  raw[1] = UART_FRAME_TYPE_REPORT;
+  pBody[0] = KBD_RPT_ID;
+  pBody[1] = dataLen;
+  for (i = 0; i < dataLen; i++)
+  {
+    static const uint8_t fill[] = { 0x11, UART_FRAME_ESC, 0x13 };
+
+    pBody[2 + i] = (i < sizeof(fill)) ? fill[i] : (uint8_t)(seed + i);
+  }
+
+  do
+  {
+    pBody[1 + dataLen]++;
+    crc = UARTFrame_crc16(0xFFFF, raw, 2 + raw[0]);
+  } while (!escaped(crc & 0xFF) && !escaped(crc >> 8));
+
+  for (i = 0; i < dataLen; i++)
+  {
+    sprintf(&pHex[2 * i], "%02x", pBody[2 + i]);
+  }
+
+  return UARTFrame_encode(UART_FRAME_TYPE_REPORT, pBody, raw[0], pFrame);
+}
+
+// Write the frame in pieces of step bytes, each its own UART read
+static void sendSplit(const uint8_t *pFrame, uint16_t len, uint16_t step)
+{
+  uint16_t n;
+
+  while (len > 0)
+  {
+    n = (len < step) ? len : step;
+    ptyWrite(pFrame, n);
+    pFrame += n;
+    len -= n;
+    if (len > 0)
+    {
+      usleep(2000);
+    }
+  }
+}
+
+static int checkEscape(void)
+{
+  static const struct
+  {
+    uint8_t dataLen;    // LEN 11, 13 and 10, not escaped
+    uint16_t step;
+  } cases[] = { { 15, 1 }, { 17, 2 }, { 15, 3 }, { 17, 5 }, { 14, 4 } };
+  uint8_t frame[UART_FRAME_ENC_MAX(UART_FRAME_MAX_BODY)];
+  char hex[2 * UART_FRAME_MAX_BODY + 1];
+  unsigned i;
+  int ok = 1;
+
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    uint16_t len = escapeFrame(cases[i].dataLen, (uint8_t)(0x20 * i), frame,
+                               hex);
+    uint64_t tSent;
+    long waitUs;
+
+    kbdHex[0] = '\0';
+    sendSplit(frame, len, cases[i].step);
+    tSent = nowUs();
+    drain(200);
+
+    waitUs = (long)(kbdQueued - tSent);
+    printf("escape     LEN %02x in %u byte reads: %s after %ld us\n",
+           UART_FRAME_RECORD_HDR_LEN + cases[i].dataLen, cases[i].step,
+           (strcmp(kbdHex, hex) == 0) ? "notified" : "NOT notified",
+           waitUs);
+
+    if ((strcmp(kbdHex, hex) != 0) || (waitUs >= FRAME_TIMEOUT_MS * 1000))
+    {
+      ok = 0;
+    }
+  }
+
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  int ok;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s hostsim [args...]\n", argv[0]);
+    return 2;
+  }
+
+  if (!simOpen(&argv[1]))
+  {
+    return 1;
+  }
+
+  warmUp();
+
+  ok = checkDedup();
+  ok &= checkEscape();
+
+  simStop();
+
+  printf("hostsim_check: %s\n", ok ? "ok" : "FAILED");
+
+  return ok ? 0 : 1;
+}
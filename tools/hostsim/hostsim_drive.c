@@ -0,0 +1,347 @@
+/******************************************************************************
+
+ @file       hostsim_drive.c
+
+ @brief Host side of the simulator, shared by hostsim_bench and
+        hostsim_check: starts hostsim, writes its UART pseudo terminal
+        and reads its sink.
+
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "uart_frame.h"
+#include "hostsim_drive.h"
+
+/*********************************************************************
+ * Simulator process
+ */
+
+static pid_t simPid;
+static int simOutFd = -1;
+static char simBuf[4096];
+static size_t simBufLen = 0;
+static int ptyFd = -1;
+
+void (*pLineHook)(const char *pLine) = NULL;
+
+uint64_t nowUs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void simStart(char *argv[])
+{
+  int fds[2];
+
+  if (pipe(fds) != 0)
+  {
+    perror("pipe");
+    exit(1);
+  }
+
+  simPid = fork();
+  if (simPid == 0)
+  {
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[0]);
+    close(fds[1]);
+    execv(argv[0], argv);
+    perror(argv[0]);
+    _exit(1);
+  }
+
+  close(fds[1]);
+  simOutFd = fds[0];
+}
+
+void simStop(void)
+{
+  kill(simPid, SIGTERM);
+  waitpid(simPid, NULL, 0);
+}
+
+/*
+ * Take a complete line out of the sink buffer.
+ */
+static int simTakeLine(char *pLine, size_t size)
+{
+  char *pEol = memchr(simBuf, '\n', simBufLen);
+  size_t len;
+
+  if (pEol == NULL)
+  {
+    return 0;
+  }
+
+  len = (size_t)(pEol - simBuf) + 1;
+  if (len < size)
+  {
+    memcpy(pLine, simBuf, len);
+    pLine[len] = '\0';
+  }
+  else
+  {
+    pLine[0] = '\0';
+  }
+  simBufLen -= len;
+  memmove(simBuf, &simBuf[len], simBufLen);
+
+  return 1;
+}
+
+/*
+ * Next sink line, discarding whatever the firmware writes to the UART.
+ * Returns 0 on timeout.
+ */
+int simLine(char *pLine, size_t size, int timeoutMs)
+{
+  uint64_t deadline = nowUs() + (uint64_t)timeoutMs * 1000u;
+
+  while (!simTakeLine(pLine, size))
+  {
+    struct pollfd pfd[2];
+    int64_t left = (int64_t)(deadline - nowUs());
+    nfds_t n = 1;
+    uint8_t junk[256];
+    ssize_t got;
+
+    if (left <= 0)
+    {
+      return 0;
+    }
+
+    pfd[0].fd = simOutFd;
+    pfd[0].events = POLLIN;
+    if (ptyFd >= 0)
+    {
+      pfd[1].fd = ptyFd;
+      pfd[1].events = POLLIN;
+      n = 2;
+    }
+
+    if (poll(pfd, n, (int)((left + 999) / 1000)) <= 0)
+    {
+      continue;
+    }
+
+    if ((n == 2) && (pfd[1].revents & POLLIN))
+    {
+      while (read(ptyFd, junk, sizeof(junk)) > 0)
+      {
+      }
+    }
+
+    if (pfd[0].revents & (POLLIN | POLLHUP))
+    {
+      got = read(simOutFd, &simBuf[simBufLen], sizeof(simBuf) - simBufLen);
+      if (got <= 0)
+      {
+        fprintf(stderr, "hostsim exited\n");
+        exit(1);
+      }
+      simBufLen += (size_t)got;
+    }
+  }
+
+  return 1;
+}
+
+static void ptyOpen(const char *pPath)
+{
+  struct termios tio;
+
+  ptyFd = open(pPath, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (ptyFd < 0)
+  {
+    perror(pPath);
+    exit(1);
+  }
+
+  tcgetattr(ptyFd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(ptyFd, TCSANOW, &tio);
+}
+
+int simOpen(char *argv[])
+{
+  char line[512];
+
+  simStart(argv);
+
+  // The first line names the terminal
+  if (!simLine(line, sizeof(line), 2000) || (line[0] != 'P'))
+  {
+    fprintf(stderr, "hostsim did not start\n");
+    simStop();
+    return 0;
+  }
+  line[strcspn(line, "\n")] = '\0';
+  ptyOpen(&line[2]);
+
+  return 1;
+}
+
+/*
+ * Wait until the pty takes more bytes. The sink is read meanwhile, so
+ * hostsim does not block on it while it holds the writer off.
+ */
+static void ptyWait(void)
+{
+  struct pollfd pfd[2];
+  char line[512];
+  ssize_t got;
+
+  pfd[0].fd = ptyFd;
+  pfd[0].events = POLLOUT;
+  pfd[1].fd = simOutFd;
+  pfd[1].events = ((pLineHook != NULL) || (simBufLen < sizeof(simBuf))) ?
+                  POLLIN : 0;
+
+  if ((poll(pfd, 2, 10) <= 0) || !(pfd[1].revents & (POLLIN | POLLHUP)))
+  {
+    return;
+  }
+
+  got = read(simOutFd, &simBuf[simBufLen], sizeof(simBuf) - simBufLen);
+  if (got <= 0)
+  {
+    fprintf(stderr, "hostsim exited\n");
+    exit(1);
+  }
+  simBufLen += (size_t)got;
+
+  while ((pLineHook != NULL) && simTakeLine(line, sizeof(line)))
+  {
+    pLineHook(line);
+  }
+}
+
+void ptyWrite(const uint8_t *pData, size_t len)
+{
+  while (len > 0)
+  {
+    ssize_t n = write(ptyFd, pData, len);
+
+    if (n > 0)
+    {
+      pData += n;
+      len -= (size_t)n;
+    }
+    else if ((n < 0) && (errno != EAGAIN) && (errno != EINTR))
+    {
+      perror("pty");
+      exit(1);
+    }
+    else
+    {
+      ptyWait();
+    }
+  }
+}
+
+void sendKeys(uint8_t n)
+{
+  uint8_t body[UART_FRAME_MAX_BODY];
+  uint8_t frame[UART_FRAME_ENC_MAX(UART_FRAME_MAX_BODY)];
+  uint8_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    body[2 * i] = 0;
+    body[2 * i + 1] = KEY_A;
+  }
+
+  ptyWrite(frame, UARTFrame_encode(UART_FRAME_TYPE_KEYS, body, 2 * n, frame));
+}
+
+/*********************************************************************
+ * Sink parsing
+ */
+
+int parseNoti(const char *pLine, benchNoti_t *pNoti)
+{
+  unsigned long long t, tq;
+
+  return (pLine[0] == 'N') &&
+         (sscanf(pLine, "N %llu %llu %u", &t, &tq, &pNoti->handle) == 3) &&
+         ((pNoti->t = t), 1);
+}
+
+void settle(int quietMs)
+{
+  char line[512];
+
+  while (simLine(line, sizeof(line), quietMs))
+  {
+  }
+}
+
+/*********************************************************************
+ * Warm up
+ */
+
+unsigned kbdHandle;
+
+/*
+ * Type until the host is bonded and reports flow. The keyboard input
+ * report is the first handle notified twice, press and release; other
+ * services notify once when the link comes up.
+ */
+void warmUp(void)
+{
+  char line[512];
+  uint64_t deadline = nowUs() + WARMUP_MS * 1000u;
+  unsigned handles[8] = { 0 };
+  unsigned counts[8] = { 0 };
+  benchNoti_t noti;
+  unsigned i;
+
+  while (nowUs() < deadline)
+  {
+    sendKeys(1);
+    while (simLine(line, sizeof(line), 200))
+    {
+      if (!parseNoti(line, &noti))
+      {
+        continue;
+      }
+
+      for (i = 0; i < 8; i++)
+      {
+        if ((handles[i] == noti.handle) || (handles[i] == 0))
+        {
+          handles[i] = noti.handle;
+          break;
+        }
+      }
+
+      if ((i < 8) && (++counts[i] == 2))
+      {
+        kbdHandle = noti.handle;
+        settle(SETTLE_MS);
+        return;
+      }
+    }
+  }
+
+  fprintf(stderr, "no keyboard report within %u ms\n", WARMUP_MS);
+  simStop();
+  exit(1);
+}
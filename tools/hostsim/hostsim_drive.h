@@ -0,0 +1,72 @@
+/******************************************************************************
+
+ @file       hostsim_drive.h
+
+ @brief Host side of the simulator, shared by hostsim_bench and
+        hostsim_check: starts hostsim, writes its UART pseudo terminal
+        and reads its sink.
+
+ *****************************************************************************/
+
+#ifndef HOSTSIM_DRIVE_H
+#define HOSTSIM_DRIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define WARMUP_MS           10000
+#define SETTLE_MS           1000
+#define KEY_A               0x04
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// N line of the sink
+typedef struct
+{
+  uint64_t t;
+  unsigned handle;
+} benchNoti_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Takes sink lines that arrive while a pty write is held off
+extern void (*pLineHook)(const char *pLine);
+
+// Keyboard input report handle, found by warmUp
+extern unsigned kbdHandle;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+extern uint64_t nowUs(void);
+
+// Start hostsim with argv and open the terminal it names; 0 on failure
+extern int simOpen(char *argv[]);
+extern void simStop(void);
+
+// Next sink line, 0 on timeout
+extern int simLine(char *pLine, size_t size, int timeoutMs);
+
+// Drain sink lines until nothing arrives for quietMs
+extern void settle(int quietMs);
+
+extern void ptyWrite(const uint8_t *pData, size_t len);
+
+// KEYS frame with n press/release pairs of the same key
+extern void sendKeys(uint8_t n);
+
+extern int parseNoti(const char *pLine, benchNoti_t *pNoti);
+
+// Type until the host is bonded and keyboard reports flow
+extern void warmUp(void);
+
+#endif /* HOSTSIM_DRIVE_H */
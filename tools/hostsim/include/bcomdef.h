@@ -0,0 +1,41 @@
+/******************************************************************************
+
+ @file       bcomdef.h
+
+ @brief Host simulator stand-in for the BLE common definitions.
+
+ *****************************************************************************/
+
+#ifndef BCOMDEF_H
+#define BCOMDEF_H
+
+#include "comdef.h"
+#include "osal.h"
+
+// BLE status codes
+#define bleNotReady               0x10
+#define bleAlreadyInRequestedMode 0x11
+#define bleIncorrectMode          0x12
+#define bleMemAllocError          0x13
+#define bleNotConnected           0x14
+#define bleNoResources            0x15
+#define blePending                0x16
+#define bleTimeout                0x17
+#define bleInvalidRange           0x18
+#define bleLinkEncrypted          0x19
+#define bleProcedureComplete      0x1A
+#define bleInvalidMtuSize         0x1B
+
+typedef Status_t bStatus_t;
+
+#define B_ADDR_LEN                6
+#define KEYLEN                    16
+#define ECC_KEYLEN                32
+#define B_MAX_ADV_LEN             31
+
+#define B_APP_DEFAULT_PASSCODE    123456
+
+#define INVALID_CONNHANDLE        0xFFFF
+#define LOOPBACK_CONNHANDLE       0xFFFE
+
+#endif /* BCOMDEF_H */
@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file       board.h
+
+ @brief Host simulator stand-in for the LaunchPad board file.
+
+ *****************************************************************************/
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#define Board_UART0                         0
+#define Board_BUTTON0                       0
+#define Board_BUTTON1                       1
+#define Board_SPI1                          1
+
+extern void Board_initUART(void);
+
+#endif /* BOARD_H */
@@ -0,0 +1,53 @@
+/******************************************************************************
+
+ @file       comdef.h
+
+ @brief Host simulator stand-in for the common type definitions.
+
+ *****************************************************************************/
+
+#ifndef COMDEF_H
+#define COMDEF_H
+
+#include "hal_types.h"
+
+// Generic status codes
+#define SUCCESS                   0x00
+#define FAILURE                   0x01
+#define INVALIDPARAMETER          0x02
+#define INVALID_TASK              0x03
+#define MSG_BUFFER_NOT_AVAIL      0x04
+#define INVALID_MSG_POINTER       0x05
+#define INVALID_EVENT_ID          0x06
+#define INVALID_INTERRUPT_ID      0x07
+#define NO_TIMER_AVAIL            0x08
+#define NV_ITEM_UNINIT            0x09
+#define NV_OPER_FAILED            0x0A
+#define INVALID_MEM_SIZE          0x0B
+#define NV_BAD_ITEM_LEN           0x0C
+
+typedef uint8 Status_t;
+
+#define BUILD_UINT16(loByte, hiByte) \
+          ((uint16)(((loByte) & 0x00FF) + (((hiByte) & 0x00FF) << 8)))
+
+#define BUILD_UINT32(Byte0, Byte1, Byte2, Byte3) \
+          ((uint32)((uint32)((Byte0) & 0x00FF) \
+          + ((uint32)((Byte1) & 0x00FF) << 8) \
+          + ((uint32)((Byte2) & 0x00FF) << 16) \
+          + ((uint32)((Byte3) & 0x00FF) << 24)))
+
+#define HI_UINT16(a)              (((a) >> 8) & 0xFF)
+#define LO_UINT16(a)              ((a) & 0xFF)
+
+#ifndef MIN
+#define MIN(n, m)                 (((n) < (m)) ? (n) : (m))
+#endif
+#ifndef MAX
+#define MAX(n, m)                 (((n) < (m)) ? (m) : (n))
+#endif
+
+// Pointer sized integer, used to store pointers in attribute values
+#define PTR_TYPE                  uintptr_t *
+
+#endif /* COMDEF_H */
@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file       devinfoservice.h
+
+ @brief Host simulator stand-in for the Device Information service.
+
+ *****************************************************************************/
+
+#ifndef DEVINFOSERVICE_H
+#define DEVINFOSERVICE_H
+
+#include "bcomdef.h"
+
+extern bStatus_t DevInfo_AddService(void);
+extern bStatus_t DevInfo_SetParameter(uint8 param, uint8 len, void *value);
+
+#endif /* DEVINFOSERVICE_H */
@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file       aon_batmon.h
+
+ @brief Host simulator stand-in for the driverlib battery monitor.
+
+ *****************************************************************************/
+
+#ifndef DRIVERLIB_AON_BATMON_H
+#define DRIVERLIB_AON_BATMON_H
+
+#include <stdint.h>
+
+// Battery voltage in 8.8 fixed point volts
+extern uint32_t AONBatMonBatteryVoltageGet(void);
+
+#endif /* DRIVERLIB_AON_BATMON_H */
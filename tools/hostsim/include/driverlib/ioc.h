@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file       ioc.h
+
+ @brief Host simulator stand-in for the driverlib IO controller.
+
+ *****************************************************************************/
+
+#ifndef DRIVERLIB_IOC_H
+#define DRIVERLIB_IOC_H
+
+#define IOC_PORT_MCU_UART0_RX       0x0000000F
+#define IOC_PORT_MCU_UART0_TX       0x00000010
+#define IOC_PORT_MCU_UART0_CTS      0x00000011
+#define IOC_PORT_MCU_UART0_RTS      0x00000012
+
+#endif /* DRIVERLIB_IOC_H */
@@ -0,0 +1,20 @@
+/******************************************************************************
+
+ @file       uart.h
+
+ @brief Host simulator stand-in for the driverlib UART functions used by
+        the NPI transport.
+
+ *****************************************************************************/
+
+#ifndef DRIVERLIB_UART_H
+#define DRIVERLIB_UART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern void UARTHwFlowControlEnable(uint32_t ui32Base);
+extern void UARTHwFlowControlDisable(uint32_t ui32Base);
+extern bool UARTCharsAvail(uint32_t ui32Base);
+
+#endif /* DRIVERLIB_UART_H */
@@ -0,0 +1,71 @@
+/******************************************************************************
+
+ @file       gap.h
+
+ @brief Host simulator stand-in for the GAP definitions.
+
+ *****************************************************************************/
+
+#ifndef GAP_H
+#define GAP_H
+
+#include "bcomdef.h"
+
+#define GAP_MSG_EVENT                       0xD0
+
+#define GAP_PROFILE_PERIPHERAL              0x04
+
+#define GAP_DEVICE_NAME_LEN                 (20 + 1)
+
+// Advertising data types
+#define GAP_ADTYPE_FLAGS                    0x01
+#define GAP_ADTYPE_16BIT_MORE               0x02
+#define GAP_ADTYPE_16BIT_COMPLETE           0x03
+#define GAP_ADTYPE_LOCAL_NAME_SHORT         0x08
+#define GAP_ADTYPE_LOCAL_NAME_COMPLETE      0x09
+#define GAP_ADTYPE_APPEARANCE               0x19
+
+#define GAP_ADTYPE_FLAGS_LIMITED            0x01
+#define GAP_ADTYPE_FLAGS_GENERAL            0x02
+#define GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED 0x04
+
+#define GAP_ADTYPE_ADV_IND                  0x00
+
+#define GAP_ADVCHAN_ALL                     0x07
+
+#define GAP_FILTER_POLICY_ALL               0x00
+#define GAP_FILTER_POLICY_WHITE_SCAN        0x01
+#define GAP_FILTER_POLICY_WHITE_CON         0x02
+#define GAP_FILTER_POLICY_WHITE             0x03
+
+// Appearance values
+#define GAP_APPEARE_HID_KEYBOARD            0x03C1
+#define GAP_APPEARE_HID_MOUSE               0x03C2
+#define GAP_APPEARE_HID_JOYSTIC             0x03C3
+#define GAP_APPEARE_HID_GAMEPAD             0x03C4
+
+// GAP parameters
+#define TGAP_GEN_DISC_ADV_MIN               0
+#define TGAP_LIM_ADV_TIMEOUT                1
+#define TGAP_LIM_DISC_ADV_INT_MIN           6
+#define TGAP_LIM_DISC_ADV_INT_MAX           7
+#define TGAP_GEN_DISC_ADV_INT_MIN           8
+#define TGAP_GEN_DISC_ADV_INT_MAX           9
+#define TGAP_CONN_PAUSE_PERIPHERAL          23
+#define TGAP_SM_MIN_KEY_LEN                 31
+#define TGAP_SM_MAX_KEY_LEN                 32
+
+#define GAP_BONDINGS_MAX                    10
+#define GAP_CHAR_CFG_MAX                    4
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint8            opcode;
+} gapEventHdr_t;
+
+extern bStatus_t GAP_SetParamValue(uint16 paramID, uint16 paramValue);
+extern uint16 GAP_GetParamValue(uint16 paramID);
+extern void GAP_RegisterForMsgs(uint8 taskID);
+
+#endif /* GAP_H */
@@ -0,0 +1,20 @@
+/******************************************************************************
+
+ @file       gapgattserver.h
+
+ @brief Host simulator stand-in for the GAP GATT server.
+
+ *****************************************************************************/
+
+#ifndef GAPGATTSERVER_H
+#define GAPGATTSERVER_H
+
+#include "bcomdef.h"
+
+#define GGS_DEVICE_NAME_ATT                 0
+#define GGS_APPEARANCE_ATT                  1
+
+extern bStatus_t GGS_AddService(uint32 services);
+extern bStatus_t GGS_SetParameter(uint8 param, uint8 len, void *value);
+
+#endif /* GAPGATTSERVER_H */
@@ -0,0 +1,117 @@
+/******************************************************************************
+
+ @file       gatt.h
+
+ @brief Host simulator stand-in for the GATT server definitions.
+
+ *****************************************************************************/
+
+#ifndef GATT_H
+#define GATT_H
+
+#include "bcomdef.h"
+#include "att.h"
+
+// Stack message events
+#define GATT_MSG_EVENT                      0xB0
+
+// Attribute permissions
+#define GATT_PERMIT_READ                    0x01
+#define GATT_PERMIT_WRITE                   0x02
+#define GATT_PERMIT_AUTHEN_READ             0x04
+#define GATT_PERMIT_AUTHEN_WRITE            0x08
+#define GATT_PERMIT_AUTHOR_READ             0x10
+#define GATT_PERMIT_AUTHOR_WRITE            0x20
+#define GATT_PERMIT_ENCRYPT_READ            0x40
+#define GATT_PERMIT_ENCRYPT_WRITE           0x80
+
+// Characteristic properties
+#define GATT_PROP_BCAST                     0x01
+#define GATT_PROP_READ                      0x02
+#define GATT_PROP_WRITE_NO_RSP              0x04
+#define GATT_PROP_WRITE                     0x08
+#define GATT_PROP_NOTIFY                    0x10
+#define GATT_PROP_INDICATE                  0x20
+#define GATT_PROP_AUTHEN                    0x40
+#define GATT_PROP_EXTENDED                  0x80
+
+// Characteristic presentation formats and name spaces
+#define GATT_FORMAT_BOOL                    0x01
+#define GATT_FORMAT_UINT8                   0x04
+#define GATT_FORMAT_UINT16                  0x06
+#define GATT_NS_BT_SIG                      0x01
+
+#define GATT_INVALID_HANDLE                 0x0000
+
+#define GATT_MAX_MTU                        0xFFFF
+#define GATT_MAX_ENCRYPT_KEY_SIZE           16
+
+#define GATT_NUM_ATTRS(attrs)               (sizeof(attrs) / sizeof(gattAttribute_t))
+
+#define GATT_SERVICE_HANDLE(attrs)          ((attrs)[0].handle)
+#define GATT_INCLUDED_HANDLE(attrs, attrIdx) \
+          (((gattIncludedService_t *)((attrs)[(attrIdx)].pValue))->handle)
+
+typedef struct
+{
+  uint8        len;
+  const uint8 *uuid;
+} gattAttrType_t;
+
+typedef struct attAttribute_t
+{
+  gattAttrType_t type;
+  uint8          permissions;
+  uint16         handle;
+  uint8         *pValue;
+} gattAttribute_t;
+
+// Characteristic presentation format
+typedef struct
+{
+  uint8  format;
+  int8   exponent;
+  uint16 unit;
+  uint8  nameSpace;
+  uint16 desc;
+} gattCharFormat_t;
+
+typedef struct
+{
+  uint16 handle;
+  uint16 endGrpHandle;
+  uint16 serviceUUID;
+} gattIncludedService_t;
+
+typedef union
+{
+  attExchangeMTUReq_t       exchangeMTUReq;
+  attExchangeMTURsp_t       exchangeMTURsp;
+  attHandleValueNoti_t      handleValueNoti;
+  attHandleValueInd_t       handleValueInd;
+  attFlowCtrlViolatedEvt_t  flowCtrlEvt;
+  attMtuUpdatedEvt_t        mtuEvt;
+} gattMsg_t;
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint16           connHandle;
+  uint8            method;
+  gattMsg_t        msg;
+} gattMsgEvent_t;
+
+extern void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                           uint16 *pSizeAlloc);
+extern void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode);
+extern bStatus_t GATT_Notification(uint16 connHandle,
+                                   attHandleValueNoti_t *pNoti,
+                                   uint8 authenticated);
+extern bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                                 uint8 authenticated, uint8 taskId);
+extern uint16 GATT_GetMTU(uint16 connHandle);
+extern bStatus_t GATT_InitClient(void);
+extern bStatus_t GATT_ExchangeMTU(uint16 connHandle, attExchangeMTUReq_t *pReq,
+                                  uint8 taskId);
+
+#endif /* GATT_H */
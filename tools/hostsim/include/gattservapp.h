@@ -0,0 +1,83 @@
+/******************************************************************************
+
+ @file       gattservapp.h
+
+ @brief Host simulator stand-in for the GATT server application API.
+
+ *****************************************************************************/
+
+#ifndef GATTSERVAPP_H
+#define GATTSERVAPP_H
+
+#include "bcomdef.h"
+#include "gatt.h"
+
+#define GATT_ALL_SERVICES                   0xFFFFFFFF
+
+#define GATT_CLIENT_CFG_NOTIFY              0x0001
+#define GATT_CLIENT_CFG_INDICATE            0x0002
+
+#define GATT_LOCAL_READ                     0xFF
+#define GATT_LOCAL_WRITE                    0xFE
+
+#define GATT_CFG_NO_OPERATION               0x0000
+#define GATT_CFG_NO_DATA                    0xFF
+
+// Client characteristic configuration table, one entry per connection
+#define GATT_CCC_TBL(pValue)                ((gattCharCfg_t *)(*((PTR_TYPE)(pValue))))
+
+typedef struct
+{
+  uint16 connHandle;
+  uint8  value;
+} gattCharCfg_t;
+
+typedef bStatus_t (*pfnGATTReadAttrCB_t)(uint16 connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8 *pValue, uint16 *pLen,
+                                         uint16 offset, uint16 maxLen,
+                                         uint8 method);
+
+typedef bStatus_t (*pfnGATTWriteAttrCB_t)(uint16 connHandle,
+                                          gattAttribute_t *pAttr,
+                                          uint8 *pValue, uint16 len,
+                                          uint16 offset, uint8 method);
+
+typedef bStatus_t (*pfnGATTAuthorizeAttrCB_t)(uint16 connHandle,
+                                              gattAttribute_t *pAttr,
+                                              uint8 opcode);
+
+typedef struct
+{
+  pfnGATTReadAttrCB_t      pfnReadAttrCB;
+  pfnGATTWriteAttrCB_t     pfnWriteAttrCB;
+  pfnGATTAuthorizeAttrCB_t pfnAuthorizeAttrCB;
+} gattServiceCBs_t;
+
+extern bStatus_t GATTServApp_AddService(uint32 services);
+extern bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                             uint16 numAttrs,
+                                             uint8 encKeySize,
+                                             CONST gattServiceCBs_t *pServiceCBs);
+extern void GATTServApp_InitCharCfg(uint16 connHandle,
+                                    gattCharCfg_t *charCfgTbl);
+extern bStatus_t GATTServApp_ProcessCharCfg(gattCharCfg_t *charCfgTbl,
+                                            uint8 *pValue,
+                                            uint8 authenticated,
+                                            gattAttribute_t *attrTbl,
+                                            uint16 numAttrs, uint8 taskId,
+                                            pfnGATTReadAttrCB_t pfnReadAttrCB);
+extern gattAttribute_t *GATTServApp_FindAttr(gattAttribute_t *pAttrTbl,
+                                             uint16 numAttrs, uint8 *pValue);
+extern bStatus_t GATTServApp_ProcessCCCWriteReq(uint16 connHandle,
+                                                gattAttribute_t *pAttr,
+                                                uint8 *pValue, uint16 len,
+                                                uint16 offset,
+                                                uint16 validCfg);
+extern uint16 GATTServApp_ReadCharCfg(uint16 connHandle,
+                                      gattCharCfg_t *charCfgTbl);
+extern uint8 GATTServApp_WriteCharCfg(uint16 connHandle,
+                                      gattCharCfg_t *charCfgTbl,
+                                      uint16 value);
+
+#endif /* GATTSERVAPP_H */
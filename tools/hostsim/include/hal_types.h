@@ -0,0 +1,36 @@
+/******************************************************************************
+
+ @file       hal_types.h
+
+ @brief Host simulator stand-in for the CC26xx HAL base types.
+
+ *****************************************************************************/
+
+#ifndef HAL_TYPES_H
+#define HAL_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int8_t    int8;
+typedef uint8_t   uint8;
+typedef int16_t   int16;
+typedef uint16_t  uint16;
+typedef int32_t   int32;
+typedef uint32_t  uint32;
+typedef uint8_t   halIntState_t;
+
+#ifndef TRUE
+#define TRUE      1
+#endif
+#ifndef FALSE
+#define FALSE     0
+#endif
+#ifndef NULL
+#define NULL      ((void *)0)
+#endif
+
+#define CONST     const
+#define VOID      (void)
+
+#endif /* HAL_TYPES_H */
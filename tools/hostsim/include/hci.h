@@ -0,0 +1,41 @@
+/******************************************************************************
+
+ @file       hci.h
+
+ @brief Host simulator stand-in for the HCI interface.
+
+ *****************************************************************************/
+
+#ifndef HCI_H
+#define HCI_H
+
+#include "bcomdef.h"
+
+#define HCI_GAP_EVENT_EVENT                         0x92
+
+#define HCI_COMMAND_COMPLETE_EVENT_CODE             0x0E
+#define HCI_LE_READ_LOCAL_SUPPORTED_FEATURES        0x2003
+
+#define HCI_ERROR_CODE_PIN_KEY_MISSING              0x06
+#define HCI_ERROR_CODE_UNSUPPORTED_REMOTE_FEATURE   0x1A
+#define HCI_ERROR_CODE_LMP_LL_RESP_TIMEOUT          0x22
+#define HCI_ERROR_CODE_CONTROLLER_BUSY              0x3A
+
+typedef uint8 hciStatus_t;
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint8            numHciCmdPkt;
+  uint16           cmdOpcode;
+  uint8           *pReturnParam;
+} hciEvt_CmdComplete_t;
+
+extern hciStatus_t HCI_LE_ReadLocalSupportedFeaturesCmd(void);
+extern hciStatus_t HCI_EXT_SetLocalSupportedFeaturesCmd(uint8 *localFeatures);
+extern hciStatus_t HCI_EXT_SetMaxDataLenCmd(uint16 txOctets, uint16 txTime,
+                                            uint16 rxOctets, uint16 rxTime);
+extern hciStatus_t HCI_ReadBDADDRCmd(void);
+extern hciStatus_t HCI_EXT_ConnEventNoticeCmd(uint8 taskID, uint16 taskEvent);
+
+#endif /* HCI_H */
@@ -0,0 +1,65 @@
+/******************************************************************************
+
+ @file       icall.h
+
+ @brief Host simulator stand-in for the ICall dispatcher. Applications get
+        a TI-RTOS Event as their sync handle (ICALL_EVENTS builds).
+
+ *****************************************************************************/
+
+#ifndef ICALL_H
+#define ICALL_H
+
+#include <stdint.h>
+#include <ti/sysbios/knl/Event.h>
+
+#define ICALL_MSG_EVENT_ID            Event_Id_31
+#define ICALL_TIMEOUT_FOREVER         0xFFFFFFFFUL
+
+#define ICALL_ERRNO_SUCCESS           0
+#define ICALL_ERRNO_TIMEOUT           -1
+#define ICALL_ERRNO_NOMSG             -2
+
+#define ICALL_SERVICE_CLASS_BLE       0x0018
+
+typedef uint8_t       ICall_EntityID;
+typedef uint16_t      ICall_ServiceEnum;
+typedef Event_Handle  ICall_SyncHandle;
+typedef int_fast16_t  ICall_Errno;
+typedef uint32_t      ICall_CSState;
+
+// Stack message header
+typedef struct
+{
+  uint8_t event;
+  uint8_t status;
+} ICall_Hdr;
+
+// HCI extension event
+typedef struct
+{
+  ICall_Hdr hdr;
+  uint8_t  *pData;
+} ICall_HciExtEvt;
+
+// BLE stack event, signature 0xffff
+typedef struct
+{
+  uint16_t signature;
+  uint32_t event_flag;
+} ICall_Stack_Event;
+
+extern void ICall_init(void);
+extern void ICall_createRemoteTasks(void);
+extern ICall_Errno ICall_registerApp(ICall_EntityID *pEntity,
+                                     ICall_SyncHandle *pMsgSyncHdl);
+extern ICall_Errno ICall_fetchServiceMsg(ICall_ServiceEnum *pSrc,
+                                         ICall_EntityID *pDest, void **ppMsg);
+extern void ICall_freeMsg(void *pMsg);
+extern void *ICall_malloc(uint_least16_t size);
+extern void ICall_free(void *pMsg);
+extern ICall_CSState ICall_enterCriticalSection(void);
+extern void ICall_leaveCriticalSection(ICall_CSState key);
+extern uint_fast32_t ICall_getMaxMSecs(void);
+
+#endif /* ICALL_H */
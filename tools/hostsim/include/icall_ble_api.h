@@ -0,0 +1,24 @@
+/******************************************************************************
+
+ @file       icall_ble_api.h
+
+ @brief Host simulator stand-in for the ICall BLE stack API.
+
+ *****************************************************************************/
+
+#ifndef ICALL_BLE_API_H
+#define ICALL_BLE_API_H
+
+#include "bcomdef.h"
+#include "icall.h"
+#include "hci.h"
+#include "gap.h"
+#include "gatt.h"
+#include "gattservapp.h"
+#include "gapgattserver.h"
+#include "gapbondmgr.h"
+#include "linkdb.h"
+#include "gatt_uuid.h"
+#include "gatt_profile_uuid.h"
+
+#endif /* ICALL_BLE_API_H */
@@ -0,0 +1,14 @@
+/******************************************************************************
+
+ @file       hw_ints.h
+
+ @brief Host simulator stand-in for the CC26xx interrupt numbers.
+
+ *****************************************************************************/
+
+#ifndef HW_INTS_H
+#define HW_INTS_H
+
+#define INT_UART0_COMB                      21
+
+#endif /* HW_INTS_H */
@@ -0,0 +1,14 @@
+/******************************************************************************
+
+ @file       hw_memmap.h
+
+ @brief Host simulator stand-in for the CC26xx memory map.
+
+ *****************************************************************************/
+
+#ifndef HW_MEMMAP_H
+#define HW_MEMMAP_H
+
+#define UART0_BASE                          0x40001000
+
+#endif /* HW_MEMMAP_H */
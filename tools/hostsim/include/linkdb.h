@@ -0,0 +1,23 @@
+/******************************************************************************
+
+ @file       linkdb.h
+
+ @brief Host simulator stand-in for the link database.
+
+ *****************************************************************************/
+
+#ifndef LINKDB_H
+#define LINKDB_H
+
+#include "bcomdef.h"
+
+#define LINKDB_STATUS_UPDATE_NEW            0
+#define LINKDB_STATUS_UPDATE_REMOVED        1
+#define LINKDB_STATUS_UPDATE_STATEFLAGS     2
+
+// Number of simultaneous connections supported
+extern uint8 linkDBNumConns;
+
+extern uint8 linkDB_NumActive(void);
+
+#endif /* LINKDB_H */
@@ -0,0 +1,22 @@
+/******************************************************************************
+
+ @file       ll_common.h
+
+ @brief Host simulator stand-in for the link layer common definitions.
+
+ *****************************************************************************/
+
+#ifndef LL_COMMON_H
+#define LL_COMMON_H
+
+#define LL_FEATURE_CONN_PARAMS_REQ          0x02
+
+#define LL_MIN_LINK_DATA_LEN                27
+#define LL_MAX_LINK_DATA_LEN                251
+#define LL_MIN_LINK_DATA_TIME               328
+#define LL_MAX_LINK_DATA_TIME               2120
+
+#define CLR_FEATURE_FLAG(var, feature)      ((var) &= ~(feature))
+#define SET_FEATURE_FLAG(var, feature)      ((var) |= (feature))
+
+#endif /* LL_COMMON_H */
@@ -0,0 +1,20 @@
+/******************************************************************************
+
+ @file       osal.h
+
+ @brief Host simulator stand-in for the OSAL message header.
+
+ *****************************************************************************/
+
+#ifndef OSAL_H
+#define OSAL_H
+
+#include "comdef.h"
+
+typedef struct
+{
+  uint8 event;
+  uint8 status;
+} osal_event_hdr_t;
+
+#endif /* OSAL_H */
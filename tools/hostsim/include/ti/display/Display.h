@@ -0,0 +1,28 @@
+/******************************************************************************
+
+ @file       Display.h
+
+ @brief Host simulator stand-in for the display driver. The firmware is
+        built with Display_DISABLE_ALL, so every call compiles away.
+
+ *****************************************************************************/
+
+#ifndef TI_DISPLAY_DISPLAY_H
+#define TI_DISPLAY_DISPLAY_H
+
+typedef void *Display_Handle;
+
+#define Display_Type_LCD              0x01
+#define Display_Type_UART             0x02
+
+#define Display_open(type, params)    ((Display_Handle)0)
+#define Display_close(h)
+#define Display_clear(h)
+#define Display_print0(h, l, c, f)
+#define Display_print1(h, l, c, f, a0)
+#define Display_print2(h, l, c, f, a0, a1)
+#define Display_print3(h, l, c, f, a0, a1, a2)
+#define Display_print4(h, l, c, f, a0, a1, a2, a3)
+#define Display_print5(h, l, c, f, a0, a1, a2, a3, a4)
+
+#endif /* TI_DISPLAY_DISPLAY_H */
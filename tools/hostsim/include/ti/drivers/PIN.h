@@ -0,0 +1,43 @@
+/******************************************************************************
+
+ @file       PIN.h
+
+ @brief Host simulator stand-in for the PIN driver.
+
+ *****************************************************************************/
+
+#ifndef TI_DRIVERS_PIN_H
+#define TI_DRIVERS_PIN_H
+
+#include <stdint.h>
+
+typedef uint32_t PIN_Config;
+typedef uint32_t PIN_Id;
+
+typedef struct
+{
+  uint32_t bmPort;
+} PIN_State;
+
+typedef PIN_State *PIN_Handle;
+
+#define PIN_TERMINATE               0xFE
+#define PIN_UNASSIGNED              0xFF
+
+#define PIN_INPUT_EN                (0 << 29)
+#define PIN_INPUT_DIS               (1 << 29)
+#define PIN_NOPULL                  (0 << 13)
+#define PIN_PULLUP                  (1 << 13)
+#define PIN_PULLDOWN                (2 << 13)
+#define PIN_GPIO_OUTPUT_DIS         (0 << 23)
+#define PIN_GPIO_OUTPUT_EN          (1 << 23)
+#define PIN_GPIO_LOW                (0 << 22)
+#define PIN_GPIO_HIGH               (1 << 22)
+#define PIN_PUSHPULL                (0 << 25)
+
+extern int PIN_init(const PIN_Config aPinCfg[]);
+extern PIN_Handle PIN_open(PIN_State *state, const PIN_Config pinList[]);
+extern void PIN_close(PIN_Handle handle);
+extern int PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId, uint32_t val);
+
+#endif /* TI_DRIVERS_PIN_H */
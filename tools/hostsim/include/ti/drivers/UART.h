@@ -0,0 +1,110 @@
+/******************************************************************************
+
+ @file       UART.h
+
+ @brief Host simulator stand-in for the TI-RTOS UART driver. The only
+        instance is backed by a pseudo terminal, see sim_uart.c.
+
+ *****************************************************************************/
+
+#ifndef TI_DRIVERS_UART_H
+#define TI_DRIVERS_UART_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UART_STATUS_SUCCESS         0
+#define UART_STATUS_ERROR           -1
+#define UART_STATUS_UNDEFINEDCMD    -2
+
+#define UART_ERROR                  UART_STATUS_ERROR
+#define UART_WAIT_FOREVER           (~(0U))
+
+typedef struct UART_Config *UART_Handle;
+
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+
+typedef enum
+{
+  UART_MODE_BLOCKING,
+  UART_MODE_CALLBACK
+} UART_Mode;
+
+typedef enum
+{
+  UART_RETURN_FULL,
+  UART_RETURN_NEWLINE
+} UART_ReturnMode;
+
+typedef enum
+{
+  UART_DATA_BINARY = 0,
+  UART_DATA_TEXT = 1
+} UART_DataMode;
+
+typedef enum
+{
+  UART_ECHO_OFF = 0,
+  UART_ECHO_ON = 1
+} UART_Echo;
+
+typedef enum
+{
+  UART_LEN_5 = 0,
+  UART_LEN_6 = 1,
+  UART_LEN_7 = 2,
+  UART_LEN_8 = 3
+} UART_LEN;
+
+typedef enum
+{
+  UART_STOP_ONE = 0,
+  UART_STOP_TWO = 1
+} UART_STOP;
+
+typedef enum
+{
+  UART_PAR_NONE = 0,
+  UART_PAR_EVEN = 1,
+  UART_PAR_ODD = 2,
+  UART_PAR_ZERO = 3,
+  UART_PAR_ONE = 4
+} UART_PAR;
+
+typedef struct
+{
+  UART_Mode       readMode;
+  UART_Mode       writeMode;
+  uint32_t        readTimeout;
+  uint32_t        writeTimeout;
+  UART_Callback   readCallback;
+  UART_Callback   writeCallback;
+  UART_ReturnMode readReturnMode;
+  UART_DataMode   readDataMode;
+  UART_DataMode   writeDataMode;
+  UART_Echo       readEcho;
+  uint32_t        baudRate;
+  UART_LEN        dataLength;
+  UART_STOP       stopBits;
+  UART_PAR        parityType;
+  void           *custom;
+} UART_Params;
+
+typedef struct UART_Config
+{
+  void const *fxnTablePtr;
+  void       *object;
+  void const *hwAttrs;
+} UART_Config;
+
+extern void UART_init(void);
+extern void UART_Params_init(UART_Params *params);
+extern UART_Handle UART_open(unsigned int index, UART_Params *params);
+extern void UART_close(UART_Handle handle);
+extern int UART_control(UART_Handle handle, unsigned int cmd, void *arg);
+extern int UART_read(UART_Handle handle, void *buffer, size_t size);
+extern int UART_write(UART_Handle handle, const void *buffer, size_t size);
+extern void UART_readCancel(UART_Handle handle);
+extern void UART_writeCancel(UART_Handle handle);
+
+#endif /* TI_DRIVERS_UART_H */
@@ -0,0 +1,19 @@
+/******************************************************************************
+
+ @file       PINCC26XX.h
+
+ @brief Host simulator stand-in for the CC26xx PIN driver extensions.
+
+ *****************************************************************************/
+
+#ifndef TI_DRIVERS_PIN_PINCC26XX_H
+#define TI_DRIVERS_PIN_PINCC26XX_H
+
+#include <ti/drivers/PIN.h>
+
+#define IOID_18                     18
+#define IOID_19                     19
+
+extern int PINCC26XX_setMux(PIN_Handle handle, PIN_Id pinId, int32_t nMux);
+
+#endif /* TI_DRIVERS_PIN_PINCC26XX_H */
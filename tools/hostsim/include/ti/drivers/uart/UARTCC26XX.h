@@ -0,0 +1,30 @@
+/******************************************************************************
+
+ @file       UARTCC26XX.h
+
+ @brief Host simulator stand-in for the CC26xx UART driver definitions.
+
+ *****************************************************************************/
+
+#ifndef TI_DRIVERS_UART_UARTCC26XX_H
+#define TI_DRIVERS_UART_UARTCC26XX_H
+
+#include <stdint.h>
+#include <ti/drivers/UART.h>
+
+#define UARTCC26XX_CMD_RETURN_PARTIAL_ENABLE    (UART_CMD_RESERVED + 0)
+#define UARTCC26XX_CMD_RETURN_PARTIAL_DISABLE   (UART_CMD_RESERVED + 1)
+#define UART_CMD_RESERVED                       32
+
+typedef struct
+{
+  uint32_t baseAddr;
+  int      intNum;
+} UARTCC26XX_HWAttrsV2;
+
+typedef struct
+{
+  int unused;
+} UARTCC26XX_Object;
+
+#endif /* TI_DRIVERS_UART_UARTCC26XX_H */
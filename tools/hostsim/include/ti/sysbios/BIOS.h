@@ -0,0 +1,20 @@
+/******************************************************************************
+
+ @file       BIOS.h
+
+ @brief Host simulator stand-in for ti.sysbios.BIOS.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_BIOS_H
+#define TI_SYSBIOS_BIOS_H
+
+#include <xdc/std.h>
+
+#define BIOS_WAIT_FOREVER     (~((UInt32)0))
+#define BIOS_NO_WAIT          ((UInt32)0)
+
+// Start the scheduler; does not return
+extern void BIOS_start(void);
+
+#endif /* TI_SYSBIOS_BIOS_H */
@@ -0,0 +1,9 @@
+/******************************************************************************
+
+ @file       Hwi.h
+
+ @brief Host simulator stand-in for ti.sysbios.family.arm.m3.Hwi.
+
+ *****************************************************************************/
+
+#include <ti/sysbios/hal/Hwi.h>
@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file       Hwi.h
+
+ @brief Host simulator stand-in for ti.sysbios.hal.Hwi.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_HAL_HWI_H
+#define TI_SYSBIOS_HAL_HWI_H
+
+#include <xdc/std.h>
+
+extern UInt Hwi_disable(void);
+extern void Hwi_restore(UInt key);
+
+#endif /* TI_SYSBIOS_HAL_HWI_H */
@@ -0,0 +1,52 @@
+/******************************************************************************
+
+ @file       Clock.h
+
+ @brief Host simulator stand-in for ti.sysbios.knl.Clock. Clock functions
+        run in interrupt context on the simulator's tick thread.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_CLOCK_H
+#define TI_SYSBIOS_KNL_CLOCK_H
+
+#include <xdc/std.h>
+
+// Same tick as the target: 10 us
+#define Clock_tickPeriod      10
+
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+  UArg    arg;
+  UInt32  period;
+  Bool    startFlag;
+} Clock_Params;
+
+typedef struct Clock_Struct
+{
+  Clock_FuncPtr        fxn;
+  UArg                 arg;
+  UInt32               timeout;   // Initial timeout in ticks
+  UInt32               period;    // Reload in ticks, 0 for one shot
+  Bool                 active;
+  UInt64               deadline;  // Absolute expiry in ticks
+  struct Clock_Struct *pNext;     // Active list
+} Clock_Struct;
+
+typedef Clock_Struct *Clock_Handle;
+
+#define Clock_handle(pStruct) ((Clock_Handle)(pStruct))
+
+extern void Clock_Params_init(Clock_Params *pParams);
+extern void Clock_construct(Clock_Struct *pStruct, Clock_FuncPtr fxn,
+                            UInt32 timeout, const Clock_Params *pParams);
+extern void Clock_start(Clock_Handle handle);
+extern void Clock_stop(Clock_Handle handle);
+extern Bool Clock_isActive(Clock_Handle handle);
+extern void Clock_setTimeout(Clock_Handle handle, UInt32 timeout);
+extern void Clock_setPeriod(Clock_Handle handle, UInt32 period);
+extern UInt32 Clock_getTicks(void);
+
+#endif /* TI_SYSBIOS_KNL_CLOCK_H */
@@ -0,0 +1,63 @@
+/******************************************************************************
+
+ @file       Event.h
+
+ @brief Host simulator stand-in for ti.sysbios.knl.Event.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_EVENT_H
+#define TI_SYSBIOS_KNL_EVENT_H
+
+#include <xdc/std.h>
+
+#define Event_Id_NONE         0
+#define Event_Id_00           (1UL << 0)
+#define Event_Id_01           (1UL << 1)
+#define Event_Id_02           (1UL << 2)
+#define Event_Id_03           (1UL << 3)
+#define Event_Id_04           (1UL << 4)
+#define Event_Id_05           (1UL << 5)
+#define Event_Id_06           (1UL << 6)
+#define Event_Id_07           (1UL << 7)
+#define Event_Id_08           (1UL << 8)
+#define Event_Id_09           (1UL << 9)
+#define Event_Id_10           (1UL << 10)
+#define Event_Id_11           (1UL << 11)
+#define Event_Id_12           (1UL << 12)
+#define Event_Id_13           (1UL << 13)
+#define Event_Id_14           (1UL << 14)
+#define Event_Id_15           (1UL << 15)
+#define Event_Id_16           (1UL << 16)
+#define Event_Id_17           (1UL << 17)
+#define Event_Id_18           (1UL << 18)
+#define Event_Id_19           (1UL << 19)
+#define Event_Id_20           (1UL << 20)
+#define Event_Id_21           (1UL << 21)
+#define Event_Id_22           (1UL << 22)
+#define Event_Id_23           (1UL << 23)
+#define Event_Id_24           (1UL << 24)
+#define Event_Id_25           (1UL << 25)
+#define Event_Id_26           (1UL << 26)
+#define Event_Id_27           (1UL << 27)
+#define Event_Id_28           (1UL << 28)
+#define Event_Id_29           (1UL << 29)
+#define Event_Id_30           (1UL << 30)
+#define Event_Id_31           (1UL << 31)
+
+typedef struct Event_Struct
+{
+  UInt32         posted;      // Posted, not yet consumed events
+  UInt32         andMask;     // Wait condition of the pending task
+  UInt32         orMask;
+  struct simCtx *pWaiter;     // Task blocked in Event_pend, NULL if none
+} Event_Struct;
+
+typedef Event_Struct *Event_Handle;
+
+extern Event_Handle Event_create(void *pParams, void *pEb);
+extern void Event_post(Event_Handle handle, UInt eventMask);
+extern UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                       UInt32 timeout);
+
+#endif /* TI_SYSBIOS_KNL_EVENT_H */
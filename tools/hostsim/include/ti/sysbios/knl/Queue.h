@@ -0,0 +1,31 @@
+/******************************************************************************
+
+ @file       Queue.h
+
+ @brief Host simulator stand-in for ti.sysbios.knl.Queue. Same semantics
+        as the target: Queue_get on an empty queue returns the queue.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_QUEUE_H
+#define TI_SYSBIOS_KNL_QUEUE_H
+
+#include <xdc/std.h>
+
+typedef struct Queue_Elem
+{
+  struct Queue_Elem *next;
+  struct Queue_Elem *prev;
+} Queue_Elem;
+
+typedef Queue_Elem   Queue_Struct;
+typedef Queue_Elem  *Queue_Handle;
+
+#define Queue_handle(pStruct)   ((Queue_Handle)(pStruct))
+
+extern void Queue_construct(Queue_Struct *pStruct, void *pParams);
+extern void Queue_put(Queue_Handle handle, Queue_Elem *pElem);
+extern void *Queue_get(Queue_Handle handle);
+extern Bool Queue_empty(Queue_Handle handle);
+
+#endif /* TI_SYSBIOS_KNL_QUEUE_H */
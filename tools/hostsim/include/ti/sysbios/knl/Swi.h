@@ -0,0 +1,17 @@
+/******************************************************************************
+
+ @file       Swi.h
+
+ @brief Host simulator stand-in for ti.sysbios.knl.Swi.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_SWI_H
+#define TI_SYSBIOS_KNL_SWI_H
+
+#include <xdc/std.h>
+
+#define Swi_disable()         ((UInt)0)
+#define Swi_restore(key)      ((void)(key))
+
+#endif /* TI_SYSBIOS_KNL_SWI_H */
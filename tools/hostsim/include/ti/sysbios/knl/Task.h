@@ -0,0 +1,41 @@
+/******************************************************************************
+
+ @file       Task.h
+
+ @brief Host simulator stand-in for ti.sysbios.knl.Task. Each task is a
+        POSIX thread; only the highest priority ready task runs.
+
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_TASK_H
+#define TI_SYSBIOS_KNL_TASK_H
+
+#include <xdc/std.h>
+
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct
+{
+  UArg   arg0;
+  UArg   arg1;
+  Int    priority;
+  Ptr    stack;
+  SizeT  stackSize;
+} Task_Params;
+
+typedef struct Task_Struct
+{
+  struct simCtx *pCtx;
+} Task_Struct;
+
+typedef Task_Struct *Task_Handle;
+
+extern void Task_Params_init(Task_Params *pParams);
+extern Task_Handle Task_construct(Task_Struct *pStruct, Task_FuncPtr fxn,
+                                  const Task_Params *pParams, void *pEb);
+extern UInt Task_disable(void);
+extern void Task_restore(UInt key);
+extern void Task_sleep(UInt32 ticks);
+extern void Task_yield(void);
+
+#endif /* TI_SYSBIOS_KNL_TASK_H */
@@ -0,0 +1,22 @@
+/******************************************************************************
+
+ @file       Error.h
+
+ @brief Host simulator stand-in for xdc.runtime.Error.
+
+ *****************************************************************************/
+
+#ifndef XDC_RUNTIME_ERROR_H
+#define XDC_RUNTIME_ERROR_H
+
+#include <xdc/std.h>
+
+typedef struct
+{
+  int unused;
+} Error_Block;
+
+#define Error_init(eb)        ((void)(eb))
+#define Error_check(eb)       (0)
+
+#endif /* XDC_RUNTIME_ERROR_H */
@@ -0,0 +1,20 @@
+/******************************************************************************
+
+ @file       System.h
+
+ @brief Host simulator stand-in for xdc.runtime.System.
+
+ *****************************************************************************/
+
+#ifndef XDC_RUNTIME_SYSTEM_H
+#define XDC_RUNTIME_SYSTEM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <xdc/std.h>
+
+#define System_abort(str)     do { fprintf(stderr, "%s\n", (str)); abort(); } while (0)
+#define System_printf         printf
+#define System_flush()        fflush(stdout)
+
+#endif /* XDC_RUNTIME_SYSTEM_H */
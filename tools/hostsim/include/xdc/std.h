@@ -0,0 +1,42 @@
+/******************************************************************************
+
+ @file       std.h
+
+ @brief Host simulator stand-in for the XDC standard types.
+
+ *****************************************************************************/
+
+#ifndef XDC_STD_H
+#define XDC_STD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef char          Char;
+typedef unsigned char UChar;
+typedef int           Int;
+typedef unsigned int  UInt;
+typedef long          Long;
+typedef unsigned long ULong;
+typedef int16_t       Int16;
+typedef uint16_t      UInt16;
+typedef int32_t       Int32;
+typedef uint32_t      UInt32;
+typedef uint64_t      UInt64;
+typedef bool          Bool;
+typedef void          Void;
+typedef void         *Ptr;
+typedef uintptr_t     UArg;
+typedef size_t        SizeT;
+typedef const char   *String;
+typedef int32_t       Bits32;
+
+#ifndef TRUE
+#define TRUE          1
+#endif
+#ifndef FALSE
+#define FALSE         0
+#endif
+
+#endif /* XDC_STD_H */
@@ -0,0 +1,1136 @@
+/******************************************************************************
+
+ @file       sim_ble.c
+
+ @brief BLE stack stand-in for the host simulator: GAPRole peripheral,
+        GAPBondMgr, GATT server registration and the notification path.
+
+        A scripted central drives the link. It connects a fixed delay
+        after advertising starts, pairs (or re-encrypts when a bond
+        exists), enables every client characteristic configuration
+        descriptor and accepts parameter update requests. Notifications
+        queue in a small controller buffer pool that a periodic
+        connection event interrupt drains onto the sink, then posts the
+        connection event notice to the task that asked for it.
+
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <icall.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "icall_ble_api.h"
+#include "peripheral.h"
+#include "devinfoservice.h"
+#include "gattservapp_util.h"
+
+#include "hostsim.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// GAPRole task
+#define SIM_GAPROLE_TASK_PRIORITY     3
+
+#define SIM_GAPROLE_START_EVT         Event_Id_00
+#define SIM_GAPROLE_ADV_EVT           Event_Id_01
+#define SIM_GAPROLE_CONN_EVT          Event_Id_02
+#define SIM_GAPROLE_TERM_EVT          Event_Id_03
+#define SIM_GAPROLE_PAIR_EVT          Event_Id_04
+#define SIM_GAPROLE_UPDATE_EVT        Event_Id_05
+
+#define SIM_GAPROLE_ALL_EVENTS        (SIM_GAPROLE_START_EVT  | \
+                                       SIM_GAPROLE_ADV_EVT    | \
+                                       SIM_GAPROLE_CONN_EVT   | \
+                                       SIM_GAPROLE_TERM_EVT   | \
+                                       SIM_GAPROLE_PAIR_EVT   | \
+                                       SIM_GAPROLE_UPDATE_EVT)
+
+// Central pairs this long after the connection is up, in ms
+#define SIM_PAIR_DELAY_MS             50
+
+// Connection events between a parameter update request and the new
+// parameters taking effect
+#define SIM_UPDATE_DELAY_EVTS         6
+
+// Clock ticks per 1.25 ms connection interval unit
+#define SIM_TICKS_PER_INTERVAL        (1250 / Clock_tickPeriod)
+
+#define SIM_MAX_SERVICES              12
+
+// Largest attribute value read by the callback benchmark
+#define SIM_MAX_ATTR_VALUE            512
+#define SIM_TX_Q_SIZE                 256
+
+// Host disconnect reason logged on local termination
+#define SIM_TERM_LOCAL_HOST           0x16
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Registered GATT service
+typedef struct
+{
+  gattAttribute_t        *pAttrs;
+  uint16                  numAttrs;
+  const gattServiceCBs_t *pCBs;
+} simService_t;
+
+// Notification waiting for a connection event
+typedef struct
+{
+  uint16    handle;
+  uint16    len;
+  uint8    *pValue;
+  uint64_t  tQueued;
+  char      tag;
+} simTxPkt_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 linkDBNumConns = 1;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// GAPRole task
+static Task_Struct gapRoleTask;
+static Event_Handle gapRoleEvent;
+
+static Clock_Struct connectClock;
+static Clock_Struct pairClock;
+static Clock_Struct updateClock;
+static Clock_Struct connEvtClock;
+
+static gapRolesCBs_t *pGapRoleCBs = NULL;
+static gapRolesParamUpdateCB_t *pGapRoleUpdateCB = NULL;
+static gaprole_States_t gapRoleState = GAPROLE_INIT;
+static uint8 gapRoleAdvEnabled = FALSE;
+static uint8 gapRoleAdvFilterPolicy = GAP_FILTER_POLICY_ALL;
+static uint16 gapRoleAdvOffTime = 0;
+static uint8 gapRoleParamUpdateEnable = 0;
+static uint16 gapRoleMinInterval = 6;
+static uint16 gapRoleMaxInterval = 3200;
+static uint16 gapRoleSlaveLatency = 0;
+static uint16 gapRoleTimeout = 1000;
+static uint8 gapRoleTermReason = 0;
+
+// Parameters of the update in progress
+static uint16 updInterval = 0;
+static uint16 updLatency = 0;
+static uint16 updTimeout = 0;
+
+// Task and event flag that get a notice after each connection event
+static uint8 connEvtNoticeTask = 0xFF;
+static uint16 connEvtNoticeEvent = 0;
+
+// Link state, shared with the connection event interrupt
+static uint8 linkUp = FALSE;
+static uint16 linkInterval = 0;
+static uint16 linkLatency = 0;
+static uint16 linkTimeout = 0;
+static uint16 linkMtu = ATT_MTU_SIZE;
+
+// Bond manager
+static gapBondCBs_t *pGapBondCBs = NULL;
+static uint8 gapBondCount = 0;
+
+// GATT server
+static simService_t simServices[SIM_MAX_SERVICES];
+static uint8 simNumServices = 0;
+static uint16 simNextHandle = 1;
+
+// Controller notification buffers, drained by the connection event
+static simTxPkt_t simTxQ[SIM_TX_Q_SIZE];
+static uint16 simTxHead = 0;
+static uint16 simTxTail = 0;
+
+// GATT_bm_alloc buffers the application holds, and the count last sunk
+static int simBmHeld = 0;
+static int simBmSunk = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint16 sim_txCount(void)
+{
+  return (uint16)((simTxHead - simTxTail) % SIM_TX_Q_SIZE);
+}
+
+static void sim_txFlush(void)
+{
+  while (simTxTail != simTxHead)
+  {
+    free(simTxQ[simTxTail].pValue);
+    simTxTail = (simTxTail + 1) % SIM_TX_Q_SIZE;
+  }
+}
+
+static bStatus_t sim_txQueue(char tag, uint16 handle, uint16 len,
+                             uint8 *pValue)
+{
+  simTxPkt_t *pPkt;
+
+  if (!linkUp)
+  {
+    return bleNotConnected;
+  }
+
+  if (len > (uint16)(linkMtu - 3))
+  {
+    return bleInvalidMtuSize;
+  }
+
+  if (sim_txCount() >= simCfg.txBufs)
+  {
+    Sim_sink("B %llu %u", (unsigned long long)Sim_nowUs(), handle);
+    return MSG_BUFFER_NOT_AVAIL;
+  }
+
+  pPkt = &simTxQ[simTxHead];
+  pPkt->handle = handle;
+  pPkt->len = len;
+  pPkt->pValue = pValue;
+  pPkt->tQueued = Sim_nowUs();
+  pPkt->tag = tag;
+  simTxHead = (simTxHead + 1) % SIM_TX_Q_SIZE;
+
+  // The buffer is the stack's now
+  simBmHeld--;
+
+  return SUCCESS;
+}
+
+static void sim_setState(gaprole_States_t state)
+{
+  gapRoleState = state;
+
+  Sim_sink("S %llu %u", (unsigned long long)Sim_nowUs(), state);
+
+  if (pGapRoleCBs && pGapRoleCBs->pfnStateChange)
+  {
+    pGapRoleCBs->pfnStateChange(state);
+  }
+}
+
+static void sim_setInterval(uint16 interval)
+{
+  linkInterval = interval;
+
+  Clock_stop(Clock_handle(&connEvtClock));
+  Clock_setTimeout(Clock_handle(&connEvtClock),
+                   interval * SIM_TICKS_PER_INTERVAL);
+  Clock_setPeriod(Clock_handle(&connEvtClock),
+                  interval * SIM_TICKS_PER_INTERVAL);
+  Clock_start(Clock_handle(&connEvtClock));
+
+  Sim_sink("C %llu %u %u %u", (unsigned long long)Sim_nowUs(), linkInterval,
+           linkLatency, linkTimeout);
+}
+
+static void sim_startAdvertising(void)
+{
+  if ((gapRoleState == GAPROLE_STARTED) || (gapRoleState == GAPROLE_WAITING) ||
+      (gapRoleState == GAPROLE_WAITING_AFTER_TIMEOUT))
+  {
+    sim_setState(GAPROLE_ADVERTISING);
+
+    Clock_setTimeout(Clock_handle(&connectClock),
+                     simCfg.connectDelayMs * (1000 / Clock_tickPeriod));
+    Clock_start(Clock_handle(&connectClock));
+  }
+}
+
+/*
+ * The central writes 0x0001 to every CCCD of every registered service,
+ * as a host does after service discovery.
+ */
+static void sim_enableCccds(void)
+{
+  uint8 value[2] = { LO_UINT16(GATT_CLIENT_CFG_NOTIFY),
+                     HI_UINT16(GATT_CLIENT_CFG_NOTIFY) };
+  uint8 i;
+  uint16 j;
+
+  for (i = 0; i < simNumServices; i++)
+  {
+    simService_t *pSvc = &simServices[i];
+
+    for (j = 0; j < pSvc->numAttrs; j++)
+    {
+      gattAttribute_t *pAttr = &pSvc->pAttrs[j];
+
+      if ((pAttr->type.len == ATT_BT_UUID_SIZE) &&
+          (BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]) ==
+           GATT_CLIENT_CHAR_CFG_UUID) &&
+          pSvc->pCBs && pSvc->pCBs->pfnWriteAttrCB)
+      {
+        pSvc->pCBs->pfnWriteAttrCB(0, pAttr, value, sizeof(value), 0,
+                                   ATT_WRITE_REQ);
+      }
+    }
+  }
+}
+
+static void sim_pair(void)
+{
+  if (!linkUp)
+  {
+    return;
+  }
+
+  if (pGapBondCBs && pGapBondCBs->pairStateCB)
+  {
+    if (gapBondCount == 0)
+    {
+      pGapBondCBs->pairStateCB(0, GAPBOND_PAIRING_STATE_STARTED, SUCCESS);
+      pGapBondCBs->pairStateCB(0, GAPBOND_PAIRING_STATE_COMPLETE, SUCCESS);
+      gapBondCount = 1;
+    }
+
+    pGapBondCBs->pairStateCB(0, GAPBOND_PAIRING_STATE_BONDED, SUCCESS);
+  }
+  else if (gapBondCount == 0)
+  {
+    gapBondCount = 1;
+  }
+
+  sim_enableCccds();
+}
+
+static void sim_update(void)
+{
+  uint16 interval;
+
+  if (!linkUp)
+  {
+    return;
+  }
+
+  interval = simCfg.fixedInterval ? simCfg.fixedInterval : updInterval;
+  linkLatency = simCfg.fixedInterval ? 0 : updLatency;
+  linkTimeout = updTimeout;
+
+  sim_setInterval(interval);
+
+  if (pGapRoleUpdateCB && *pGapRoleUpdateCB)
+  {
+    (*pGapRoleUpdateCB)(linkInterval, linkLatency, linkTimeout);
+  }
+}
+
+static void sim_terminate(void)
+{
+  UInt key;
+
+  if (!linkUp)
+  {
+    return;
+  }
+
+  Clock_stop(Clock_handle(&pairClock));
+  Clock_stop(Clock_handle(&updateClock));
+  Clock_stop(Clock_handle(&connEvtClock));
+
+  key = Hwi_disable();
+  linkUp = FALSE;
+  sim_txFlush();
+  Hwi_restore(key);
+
+  GATTServApp_LinkDown(0);
+
+  gapRoleTermReason = SIM_TERM_LOCAL_HOST;
+  Sim_sink("D %llu %u", (unsigned long long)Sim_nowUs(), gapRoleTermReason);
+
+  sim_setState(GAPROLE_WAITING);
+
+  if (gapRoleAdvEnabled)
+  {
+    sim_startAdvertising();
+  }
+}
+
+static void sim_connect(void)
+{
+  if (gapRoleState != GAPROLE_ADVERTISING)
+  {
+    return;
+  }
+
+  linkUp = TRUE;
+  linkLatency = 0;
+  linkMtu = ATT_MTU_SIZE;
+  linkTimeout = gapRoleTimeout;
+  gapRoleAdvEnabled = FALSE;
+  sim_setInterval(simCfg.fixedInterval ? simCfg.fixedInterval :
+                                         simCfg.initInterval);
+
+  // As peripheral.c does on GAP_LINK_ESTABLISHED_EVENT
+  GATTServApp_LinkUp(0);
+
+  sim_setState(GAPROLE_CONNECTED);
+
+  Clock_start(Clock_handle(&pairClock));
+}
+
+static void sim_clockPost(UArg arg)
+{
+  Event_post(gapRoleEvent, arg);
+}
+
+/*
+ * Connection event interrupt: the controller sends up to pktsPerEvt
+ * queued notifications.
+ */
+static void sim_connEvt(UArg arg)
+{
+  uint64_t now = Sim_nowUs();
+  uint8 n;
+
+  (void)arg;
+
+  if (!linkUp)
+  {
+    return;
+  }
+
+  for (n = 0; (n < simCfg.pktsPerEvt) && (simTxTail != simTxHead); n++)
+  {
+    simTxPkt_t *pPkt = &simTxQ[simTxTail];
+
+    Sim_sinkHex(pPkt->tag, now, pPkt->tQueued, pPkt->handle, pPkt->pValue,
+                pPkt->len);
+    free(pPkt->pValue);
+    simTxTail = (simTxTail + 1) % SIM_TX_Q_SIZE;
+  }
+
+  if (simBmHeld != simBmSunk)
+  {
+    Sim_sink("L %llu %d", (unsigned long long)now, simBmHeld);
+    simBmSunk = simBmHeld;
+  }
+
+  if (connEvtNoticeEvent != 0)
+  {
+    ICall_Stack_Event *pEvt = ICall_malloc(sizeof(ICall_Stack_Event));
+
+    pEvt->signature = 0xffff;
+    pEvt->event_flag = connEvtNoticeEvent;
+    Sim_icallSend(connEvtNoticeTask, pEvt);
+  }
+}
+
+static void sim_gapRoleTaskFxn(UArg a0, UArg a1)
+{
+  (void)a0;
+  (void)a1;
+
+  for (;;)
+  {
+    UInt events = Event_pend(gapRoleEvent, Event_Id_NONE,
+                             SIM_GAPROLE_ALL_EVENTS, ICALL_TIMEOUT_FOREVER);
+
+    if (events & SIM_GAPROLE_START_EVT)
+    {
+      sim_setState(GAPROLE_STARTED);
+      if (gapRoleAdvEnabled)
+      {
+        sim_startAdvertising();
+      }
+    }
+
+    if (events & SIM_GAPROLE_TERM_EVT)
+    {
+      sim_terminate();
+    }
+
+    if (events & SIM_GAPROLE_ADV_EVT)
+    {
+      if (gapRoleAdvEnabled)
+      {
+        sim_startAdvertising();
+      }
+      else if (gapRoleState == GAPROLE_ADVERTISING)
+      {
+        Clock_stop(Clock_handle(&connectClock));
+        sim_setState(GAPROLE_WAITING);
+      }
+    }
+
+    if (events & SIM_GAPROLE_CONN_EVT)
+    {
+      sim_connect();
+    }
+
+    if (events & SIM_GAPROLE_PAIR_EVT)
+    {
+      sim_pair();
+    }
+
+    if (events & SIM_GAPROLE_UPDATE_EVT)
+    {
+      sim_update();
+    }
+  }
+}
+
+static uint64_t sim_nowNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/*********************************************************************
+ * SIMULATOR FUNCTIONS
+ */
+
+void Sim_bleInit(void)
+{
+  Clock_Params params;
+
+  gapRoleEvent = Event_create(NULL, NULL);
+
+  Clock_Params_init(&params);
+  params.arg = SIM_GAPROLE_CONN_EVT;
+  Clock_construct(&connectClock, sim_clockPost, 0, &params);
+
+  params.arg = SIM_GAPROLE_PAIR_EVT;
+  Clock_construct(&pairClock, sim_clockPost,
+                  SIM_PAIR_DELAY_MS * (1000 / Clock_tickPeriod), &params);
+
+  params.arg = SIM_GAPROLE_UPDATE_EVT;
+  Clock_construct(&updateClock, sim_clockPost, 0, &params);
+
+  // Connection events run in the clock interrupt like the radio ISR
+  params.arg = 0;
+  Clock_construct(&connEvtClock, sim_connEvt, 0, &params);
+}
+
+/*
+ * Attribute callback microbenchmark: once the central has bonded, read
+ * every attribute and rewrite every CCCD of each registered service
+ * through its callbacks, rounds times, from an interrupt context so no
+ * task runs in between. Prints one line per service:
+ *   A <first handle> <service uuid> <reads> <ns/read> <writes> <ns/write>
+ */
+void Sim_bleAttrBench(unsigned rounds)
+{
+  uint8 value[2] = { LO_UINT16(GATT_CLIENT_CFG_NOTIFY),
+                     HI_UINT16(GATT_CLIENT_CFG_NOTIFY) };
+  static uint8 buf[SIM_MAX_ATTR_VALUE];
+  simCtx_t *pIsr;
+  uint8 i;
+
+  while ((gapRoleState != GAPROLE_CONNECTED) || (gapBondCount == 0))
+  {
+    Sim_sleepUs(10000);
+  }
+
+  // Let the application finish reacting to the CCCD writes
+  Sim_sleepUs(200000);
+
+  pIsr = Sim_isrCreate("attrBench");
+  Sim_isrBegin(pIsr);
+
+  for (i = 0; i < simNumServices; i++)
+  {
+    simService_t *pSvc = &simServices[i];
+    gattAttrType_t *pSvcType = (gattAttrType_t *)pSvc->pAttrs[0].pValue;
+    uint64_t readNs = 0, writeNs = 0, t;
+    uint32_t reads = 0, writes = 0;
+    unsigned r;
+    uint16 j, len;
+
+    if ((pSvc->pCBs == NULL) || (pSvc->pCBs->pfnReadAttrCB == NULL))
+    {
+      continue;
+    }
+
+    for (r = 0; r < rounds; r++)
+    {
+      t = sim_nowNs();
+      for (j = 0; j < pSvc->numAttrs; j++)
+      {
+        pSvc->pCBs->pfnReadAttrCB(0, &pSvc->pAttrs[j], buf, &len, 0,
+                                  linkMtu - 1, ATT_READ_REQ);
+      }
+      readNs += sim_nowNs() - t;
+      reads += pSvc->numAttrs;
+
+      if (pSvc->pCBs->pfnWriteAttrCB == NULL)
+      {
+        continue;
+      }
+
+      for (j = 0; j < pSvc->numAttrs; j++)
+      {
+        gattAttribute_t *pAttr = &pSvc->pAttrs[j];
+
+        if ((pAttr->type.len == ATT_BT_UUID_SIZE) &&
+            (BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]) ==
+             GATT_CLIENT_CHAR_CFG_UUID))
+        {
+          t = sim_nowNs();
+          pSvc->pCBs->pfnWriteAttrCB(0, pAttr, value, sizeof(value), 0,
+                                     ATT_WRITE_REQ);
+          writeNs += sim_nowNs() - t;
+          writes++;
+        }
+      }
+    }
+
+    Sim_sink("A %u %04x %u %.1f %u %.1f", pSvc->pAttrs[0].handle,
+             BUILD_UINT16(pSvcType->uuid[0], pSvcType->uuid[1]),
+             reads, reads ? (double)readNs / reads : 0.0,
+             writes, writes ? (double)writeNs / writes : 0.0);
+  }
+
+  Sim_isrEnd(pIsr);
+}
+
+/*********************************************************************
+ * GAPRole
+ */
+
+void GAPRole_createTask(void)
+{
+  Task_Params taskParams;
+
+  Task_Params_init(&taskParams);
+  taskParams.priority = SIM_GAPROLE_TASK_PRIORITY;
+
+  Task_construct(&gapRoleTask, sim_gapRoleTaskFxn, &taskParams, NULL);
+}
+
+bStatus_t GAPRole_StartDevice(gapRolesCBs_t *pAppCallbacks)
+{
+  if (gapRoleState != GAPROLE_INIT)
+  {
+    return bleAlreadyInRequestedMode;
+  }
+
+  pGapRoleCBs = pAppCallbacks;
+  Event_post(gapRoleEvent, SIM_GAPROLE_START_EVT);
+
+  return SUCCESS;
+}
+
+void GAPRole_RegisterAppCBs(gapRolesParamUpdateCB_t *pParamUpdateCB)
+{
+  pGapRoleUpdateCB = pParamUpdateCB;
+}
+
+bStatus_t GAPRole_TerminateConnection(void)
+{
+  if (!linkUp)
+  {
+    return bleIncorrectMode;
+  }
+
+  Event_post(gapRoleEvent, SIM_GAPROLE_TERM_EVT);
+
+  return SUCCESS;
+}
+
+bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
+                                  uint16_t maxConnInterval,
+                                  uint16_t latency, uint16_t connTimeout,
+                                  uint8_t handleFailure)
+{
+  (void)handleFailure;
+
+  if (!linkUp)
+  {
+    return bleNotConnected;
+  }
+
+  // One update at a time, as the GAPRole
+  if (Clock_isActive(Clock_handle(&updateClock)))
+  {
+    return blePending;
+  }
+
+  // Already in use
+  if ((linkInterval >= minConnInterval) && (linkInterval <= maxConnInterval) &&
+      (linkLatency == latency) && (linkTimeout == connTimeout))
+  {
+    return bleInvalidRange;
+  }
+
+  // The central takes the shortest interval offered
+  updInterval = minConnInterval;
+  updLatency = latency;
+  updTimeout = connTimeout;
+
+  Clock_setTimeout(Clock_handle(&updateClock),
+                   SIM_UPDATE_DELAY_EVTS * linkInterval *
+                   SIM_TICKS_PER_INTERVAL);
+  Clock_start(Clock_handle(&updateClock));
+
+  return SUCCESS;
+}
+
+bStatus_t GAPRole_SetParameter(uint16_t param, uint8_t len, void *pValue)
+{
+  switch (param)
+  {
+    case GAPROLE_ADVERT_ENABLED:
+      gapRoleAdvEnabled = *((uint8 *)pValue);
+      if (gapRoleState != GAPROLE_INIT)
+      {
+        Event_post(gapRoleEvent, SIM_GAPROLE_ADV_EVT);
+      }
+      break;
+
+    case GAPROLE_ADVERT_OFF_TIME:
+      gapRoleAdvOffTime = *((uint16 *)pValue);
+      break;
+
+    case GAPROLE_ADV_FILTER_POLICY:
+      gapRoleAdvFilterPolicy = *((uint8 *)pValue);
+      break;
+
+    case GAPROLE_PARAM_UPDATE_ENABLE:
+      gapRoleParamUpdateEnable = *((uint8 *)pValue);
+      break;
+
+    case GAPROLE_MIN_CONN_INTERVAL:
+      gapRoleMinInterval = *((uint16 *)pValue);
+      break;
+
+    case GAPROLE_MAX_CONN_INTERVAL:
+      gapRoleMaxInterval = *((uint16 *)pValue);
+      break;
+
+    case GAPROLE_SLAVE_LATENCY:
+      gapRoleSlaveLatency = *((uint16 *)pValue);
+      break;
+
+    case GAPROLE_TIMEOUT_MULTIPLIER:
+      gapRoleTimeout = *((uint16 *)pValue);
+      break;
+
+    case GAPROLE_PARAM_UPDATE_REQ:
+      if (*((uint8 *)pValue) && gapRoleParamUpdateEnable)
+      {
+        return GAPRole_SendUpdateParam(gapRoleMinInterval, gapRoleMaxInterval,
+                                       gapRoleSlaveLatency, gapRoleTimeout,
+                                       GAPROLE_NO_ACTION);
+      }
+      break;
+
+    default:
+      // Advertising data and the rest have no effect on the central
+      break;
+  }
+
+  (void)len;
+
+  return SUCCESS;
+}
+
+bStatus_t GAPRole_GetParameter(uint16_t param, void *pValue)
+{
+  switch (param)
+  {
+    case GAPROLE_ADVERT_ENABLED:
+      *((uint8 *)pValue) = gapRoleAdvEnabled;
+      break;
+
+    case GAPROLE_ADVERT_OFF_TIME:
+      *((uint16 *)pValue) = gapRoleAdvOffTime;
+      break;
+
+    case GAPROLE_ADV_FILTER_POLICY:
+      *((uint8 *)pValue) = gapRoleAdvFilterPolicy;
+      break;
+
+    case GAPROLE_CONNHANDLE:
+      *((uint16 *)pValue) = linkUp ? 0 : INVALID_CONNHANDLE;
+      break;
+
+    case GAPROLE_PARAM_UPDATE_ENABLE:
+      *((uint8 *)pValue) = gapRoleParamUpdateEnable;
+      break;
+
+    case GAPROLE_MIN_CONN_INTERVAL:
+      *((uint16 *)pValue) = gapRoleMinInterval;
+      break;
+
+    case GAPROLE_MAX_CONN_INTERVAL:
+      *((uint16 *)pValue) = gapRoleMaxInterval;
+      break;
+
+    case GAPROLE_SLAVE_LATENCY:
+      *((uint16 *)pValue) = gapRoleSlaveLatency;
+      break;
+
+    case GAPROLE_TIMEOUT_MULTIPLIER:
+      *((uint16 *)pValue) = gapRoleTimeout;
+      break;
+
+    case GAPROLE_CONN_INTERVAL:
+      *((uint16 *)pValue) = linkInterval;
+      break;
+
+    case GAPROLE_CONN_LATENCY:
+      *((uint16 *)pValue) = linkLatency;
+      break;
+
+    case GAPROLE_CONN_TIMEOUT:
+      *((uint16 *)pValue) = linkTimeout;
+      break;
+
+    case GAPROLE_STATE:
+      *((uint8 *)pValue) = gapRoleState;
+      break;
+
+    case GAPROLE_CONN_TERM_REASON:
+      *((uint8 *)pValue) = gapRoleTermReason;
+      break;
+
+    default:
+      return INVALIDPARAMETER;
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * GAPBondMgr
+ */
+
+bStatus_t GAPBondMgr_SetParameter(uint16 param, uint8 len, void *pValue)
+{
+  (void)len;
+  (void)pValue;
+
+  if (param == GAPBOND_ERASE_ALLBONDS)
+  {
+    gapBondCount = 0;
+  }
+
+  return SUCCESS;
+}
+
+bStatus_t GAPBondMgr_GetParameter(uint16 param, void *pValue)
+{
+  if (param == GAPBOND_BOND_COUNT)
+  {
+    *((uint8 *)pValue) = gapBondCount;
+    return SUCCESS;
+  }
+
+  return INVALIDPARAMETER;
+}
+
+void GAPBondMgr_Register(gapBondCBs_t *pCB)
+{
+  pGapBondCBs = pCB;
+}
+
+bStatus_t GAPBondMgr_PasscodeRsp(uint16 connectionHandle, uint8 status,
+                                 uint32 passcode)
+{
+  (void)connectionHandle;
+  (void)status;
+  (void)passcode;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * GAP and HCI
+ */
+
+bStatus_t GAP_SetParamValue(uint16 paramID, uint16 paramValue)
+{
+  (void)paramID;
+  (void)paramValue;
+
+  return SUCCESS;
+}
+
+uint16 GAP_GetParamValue(uint16 paramID)
+{
+  (void)paramID;
+
+  return 0;
+}
+
+void GAP_RegisterForMsgs(uint8 taskID)
+{
+  (void)taskID;
+}
+
+bStatus_t GGS_SetParameter(uint8 param, uint8 len, void *value)
+{
+  (void)param;
+  (void)len;
+  (void)value;
+
+  return SUCCESS;
+}
+
+/*
+ * The command complete goes back to the calling application, the return
+ * parameters follow the event in the same allocation.
+ */
+hciStatus_t HCI_LE_ReadLocalSupportedFeaturesCmd(void)
+{
+  hciEvt_CmdComplete_t *pEvt;
+  uint8 *pRet;
+
+  pEvt = ICall_malloc(sizeof(hciEvt_CmdComplete_t) + 9);
+  if (pEvt == NULL)
+  {
+    return bleMemAllocError;
+  }
+
+  pRet = (uint8 *)(pEvt + 1);
+  memset(pRet, 0, 9);
+  pRet[0] = SUCCESS;
+  pRet[1] = 0x3F;
+
+  pEvt->hdr.event = HCI_GAP_EVENT_EVENT;
+  pEvt->hdr.status = HCI_COMMAND_COMPLETE_EVENT_CODE;
+  pEvt->numHciCmdPkt = 1;
+  pEvt->cmdOpcode = HCI_LE_READ_LOCAL_SUPPORTED_FEATURES;
+  pEvt->pReturnParam = pRet;
+
+  Sim_icallSend(Sim_icallEntity(), pEvt);
+
+  return SUCCESS;
+}
+
+hciStatus_t HCI_EXT_SetLocalSupportedFeaturesCmd(uint8 *localFeatures)
+{
+  (void)localFeatures;
+
+  return SUCCESS;
+}
+
+hciStatus_t HCI_EXT_SetMaxDataLenCmd(uint16 txOctets, uint16 txTime,
+                                     uint16 rxOctets, uint16 rxTime)
+{
+  (void)txOctets;
+  (void)txTime;
+  (void)rxOctets;
+  (void)rxTime;
+
+  return SUCCESS;
+}
+
+hciStatus_t HCI_EXT_ConnEventNoticeCmd(uint8 taskID, uint16 taskEvent)
+{
+  connEvtNoticeTask = taskID;
+  connEvtNoticeEvent = taskEvent;
+
+  return SUCCESS;
+}
+
+hciStatus_t HCI_ReadBDADDRCmd(void)
+{
+  return SUCCESS;
+}
+
+uint8 linkDB_NumActive(void)
+{
+  return linkUp ? 1 : 0;
+}
+
+/*********************************************************************
+ * GATT server
+ */
+
+/*
+ * GAP and GATT services only take up handles, nobody reads them.
+ */
+bStatus_t GGS_AddService(uint32 services)
+{
+  (void)services;
+
+  simNextHandle += 7;
+
+  return SUCCESS;
+}
+
+bStatus_t GATTServApp_AddService(uint32 services)
+{
+  (void)services;
+
+  simNextHandle += 4;
+
+  return SUCCESS;
+}
+
+bStatus_t DevInfo_AddService(void)
+{
+  simNextHandle += 19;
+
+  return SUCCESS;
+}
+
+bStatus_t DevInfo_SetParameter(uint8 param, uint8 len, void *value)
+{
+  (void)param;
+  (void)len;
+  (void)value;
+
+  return SUCCESS;
+}
+
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                      uint16 numAttrs, uint8 encKeySize,
+                                      CONST gattServiceCBs_t *pServiceCBs)
+{
+  uint16 i;
+
+  (void)encKeySize;
+
+  if (simNumServices == SIM_MAX_SERVICES)
+  {
+    return bleNoResources;
+  }
+
+  for (i = 0; i < numAttrs; i++)
+  {
+    pAttrs[i].handle = simNextHandle++;
+
+    if (pAttrs[i].type.len == ATT_BT_UUID_SIZE)
+    {
+      Sim_sink("H %u %04x", pAttrs[i].handle,
+               BUILD_UINT16(pAttrs[i].type.uuid[0], pAttrs[i].type.uuid[1]));
+    }
+  }
+
+  simServices[simNumServices].pAttrs = pAttrs;
+  simServices[simNumServices].numAttrs = numAttrs;
+  simServices[simNumServices].pCBs = pServiceCBs;
+  simNumServices++;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * GATT
+ */
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  uint16 max = (uint16)(linkMtu - 3);
+
+  (void)connHandle;
+  (void)opcode;
+
+  if (!linkUp)
+  {
+    return NULL;
+  }
+
+  if (size > max)
+  {
+    size = max;
+  }
+
+  if (pSizeAlloc != NULL)
+  {
+    *pSizeAlloc = size;
+  }
+
+  simBmHeld++;
+
+  return malloc(size ? size : 1);
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+  if (((opcode == ATT_HANDLE_VALUE_NOTI) &&
+       (pMsg->handleValueNoti.pValue != NULL)) ||
+      ((opcode == ATT_HANDLE_VALUE_IND) &&
+       (pMsg->handleValueInd.pValue != NULL)))
+  {
+    simBmHeld--;
+  }
+
+  if (opcode == ATT_HANDLE_VALUE_NOTI)
+  {
+    free(pMsg->handleValueNoti.pValue);
+    pMsg->handleValueNoti.pValue = NULL;
+  }
+  else if (opcode == ATT_HANDLE_VALUE_IND)
+  {
+    free(pMsg->handleValueInd.pValue);
+    pMsg->handleValueInd.pValue = NULL;
+  }
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  (void)connHandle;
+  (void)authenticated;
+
+  return sim_txQueue('N', pNoti->handle, pNoti->len, pNoti->pValue);
+}
+
+/*
+ * Indications share the notification path, the central confirms at once.
+ */
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  (void)connHandle;
+  (void)authenticated;
+  (void)taskId;
+
+  return sim_txQueue('I', pInd->handle, pInd->len, pInd->pValue);
+}
+
+uint16 GATT_GetMTU(uint16 connHandle)
+{
+  (void)connHandle;
+
+  return linkMtu;
+}
+
+bStatus_t GATT_InitClient(void)
+{
+  return SUCCESS;
+}
+
+/*
+ * The central answers at once with the largest MTU it accepts.
+ */
+bStatus_t GATT_ExchangeMTU(uint16 connHandle, attExchangeMTUReq_t *pReq,
+                           uint8 taskId)
+{
+  (void)connHandle;
+  (void)taskId;
+
+  if (!linkUp)
+  {
+    return bleNotConnected;
+  }
+
+  linkMtu = MAX(ATT_MTU_SIZE, MIN(pReq->clientRxMTU, simCfg.mtu));
+  Sim_sink("M %llu %u", (unsigned long long)Sim_nowUs(), linkMtu);
+
+  return SUCCESS;
+}
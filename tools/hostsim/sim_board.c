@@ -0,0 +1,82 @@
+/******************************************************************************
+
+ @file       sim_board.c
+
+ @brief Board stand-ins for the host simulator: keys, pins and the battery
+        monitor. The simulated LaunchPad has no buttons and a full battery.
+
+ *****************************************************************************/
+
+#include <stddef.h>
+
+#include <ti/drivers/PIN.h>
+#include <ti/drivers/pin/PINCC26XX.h>
+#include <driverlib/aon_batmon.h>
+
+#include "board_key.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// 3.0 V in the 8.8 fixed point format of the battery monitor
+#define SIM_BATT_VOLTAGE          0x300
+
+/*********************************************************************
+ * Keys
+ */
+
+void Board_initKeys(keysPressedCB_t appKeyCB)
+{
+  (void)appKeyCB;
+}
+
+/*********************************************************************
+ * PIN
+ */
+
+int PIN_init(const PIN_Config aPinCfg[])
+{
+  (void)aPinCfg;
+
+  return 0;
+}
+
+PIN_Handle PIN_open(PIN_State *state, const PIN_Config pinList[])
+{
+  (void)pinList;
+
+  return state;
+}
+
+void PIN_close(PIN_Handle handle)
+{
+  (void)handle;
+}
+
+int PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId, uint32_t val)
+{
+  (void)handle;
+  (void)pinId;
+  (void)val;
+
+  return 0;
+}
+
+int PINCC26XX_setMux(PIN_Handle handle, PIN_Id pinId, int32_t nMux)
+{
+  (void)handle;
+  (void)pinId;
+  (void)nMux;
+
+  return 0;
+}
+
+/*********************************************************************
+ * Battery monitor
+ */
+
+uint32_t AONBatMonBatteryVoltageGet(void)
+{
+  return SIM_BATT_VOLTAGE;
+}
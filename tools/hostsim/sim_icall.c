@@ -0,0 +1,188 @@
+/******************************************************************************
+
+ @file       sim_icall.c
+
+ @brief ICall stand-in for the host simulator. Each registered application
+        gets an Event as its sync handle and a message queue that the
+        simulated stack fills with Sim_icallSend.
+
+ *****************************************************************************/
+
+#include <stdlib.h>
+
+#include <icall.h>
+#include <ti/sysbios/knl/Queue.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "hostsim.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define SIM_ICALL_MAX_ENTITIES    6
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Queued stack message, the payload follows the header
+typedef struct
+{
+  Queue_Elem elem;
+  void      *pMsg;
+} simIcallRec_t;
+
+typedef struct
+{
+  simCtx_t     *pCtx;       // Registering task
+  Event_Handle  syncEvent;
+  Queue_Struct  msgQ;
+} simIcallEntity_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static simIcallEntity_t icallEntities[SIM_ICALL_MAX_ENTITIES];
+static uint8_t icallNumEntities = 0;
+
+/*********************************************************************
+ * SIMULATOR FUNCTIONS
+ */
+
+/*
+ * Queue a stack message for an application and wake it up. pMsg must come
+ * from ICall_malloc; the application frees it with ICall_freeMsg.
+ */
+void Sim_icallSend(uint8_t entity, void *pMsg)
+{
+  simIcallRec_t *pRec;
+
+  if (entity >= icallNumEntities)
+  {
+    free(pMsg);
+    return;
+  }
+
+  pRec = malloc(sizeof(simIcallRec_t));
+  pRec->pMsg = pMsg;
+  Queue_put(Queue_handle(&icallEntities[entity].msgQ), &pRec->elem);
+  Event_post(icallEntities[entity].syncEvent, ICALL_MSG_EVENT_ID);
+}
+
+/*
+ * Entity of the running task, 0xFF if it never registered.
+ */
+uint8_t Sim_icallEntity(void)
+{
+  simCtx_t *pSelf = Sim_self();
+  uint8_t i;
+
+  for (i = 0; i < icallNumEntities; i++)
+  {
+    if (icallEntities[i].pCtx == pSelf)
+    {
+      return i;
+    }
+  }
+
+  return 0xFF;
+}
+
+/*********************************************************************
+ * ICall
+ */
+
+void ICall_init(void)
+{
+}
+
+void ICall_createRemoteTasks(void)
+{
+  Sim_bleInit();
+}
+
+ICall_Errno ICall_registerApp(ICall_EntityID *pEntity,
+                              ICall_SyncHandle *pMsgSyncHdl)
+{
+  simIcallEntity_t *pEnt;
+
+  if (icallNumEntities == SIM_ICALL_MAX_ENTITIES)
+  {
+    return ICALL_ERRNO_NOMSG;
+  }
+
+  pEnt = &icallEntities[icallNumEntities];
+  pEnt->pCtx = Sim_self();
+  pEnt->syncEvent = Event_create(NULL, NULL);
+  Queue_construct(&pEnt->msgQ, NULL);
+
+  *pEntity = icallNumEntities++;
+  *pMsgSyncHdl = pEnt->syncEvent;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno ICall_fetchServiceMsg(ICall_ServiceEnum *pSrc,
+                                  ICall_EntityID *pDest, void **ppMsg)
+{
+  uint8_t entity = Sim_icallEntity();
+  Queue_Handle q;
+  simIcallRec_t *pRec;
+
+  if (entity == 0xFF)
+  {
+    return ICALL_ERRNO_NOMSG;
+  }
+
+  q = Queue_handle(&icallEntities[entity].msgQ);
+  if (Queue_empty(q))
+  {
+    return ICALL_ERRNO_NOMSG;
+  }
+
+  pRec = Queue_get(q);
+  *pSrc = ICALL_SERVICE_CLASS_BLE;
+  *pDest = entity;
+  *ppMsg = pRec->pMsg;
+  free(pRec);
+
+  // More messages pending, keep the application draining
+  if (!Queue_empty(q))
+  {
+    Event_post(icallEntities[entity].syncEvent, ICALL_MSG_EVENT_ID);
+  }
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+void ICall_freeMsg(void *pMsg)
+{
+  free(pMsg);
+}
+
+void *ICall_malloc(uint_least16_t size)
+{
+  return malloc(size);
+}
+
+void ICall_free(void *pMsg)
+{
+  free(pMsg);
+}
+
+ICall_CSState ICall_enterCriticalSection(void)
+{
+  return Hwi_disable();
+}
+
+void ICall_leaveCriticalSection(ICall_CSState key)
+{
+  Hwi_restore(key);
+}
+
+uint_fast32_t ICall_getMaxMSecs(void)
+{
+  return 0xFFFFFFFFUL / 100;
+}
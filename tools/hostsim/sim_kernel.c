@@ -0,0 +1,690 @@
+/******************************************************************************
+
+ @file       sim_kernel.c
+
+ @brief TI-RTOS stand-in for the host simulator: Task, Event, Clock, Queue,
+        Hwi and BIOS on top of POSIX threads. See hostsim.h for the
+        execution model.
+
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Queue.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "hostsim.h"
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Scheduler state, all guarded by simLock
+static pthread_mutex_t simLock = PTHREAD_MUTEX_INITIALIZER;
+static simCtx_t *simCtxList = NULL;
+static simCtx_t *simRunning = NULL;     // Owns the CPU, NULL when idle
+static uint64_t simSeq = 0;
+static simCtx_t *simTaskLock = NULL;    // Task that called Task_disable
+static unsigned simTaskLockDepth = 0;
+static int simStarted = 0;
+
+static __thread simCtx_t *simSelf = NULL;
+
+// Clock state, guarded by clockLock
+static pthread_mutex_t clockLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clockCv;
+static Clock_Struct *clockList = NULL;  // All constructed clocks
+static simCtx_t *clockIsr;
+
+static uint64_t simStartUs;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint64_t sim_monoUs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static simCtx_t *sim_newCtx(const char *pName, int prio)
+{
+  simCtx_t *pCtx = calloc(1, sizeof(simCtx_t));
+  pthread_condattr_t attr;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&pCtx->cv, &attr);
+  pCtx->pName = pName;
+  pCtx->prio = prio;
+
+  pthread_mutex_lock(&simLock);
+  pCtx->pNext = simCtxList;
+  simCtxList = pCtx;
+  pthread_mutex_unlock(&simLock);
+
+  return pCtx;
+}
+
+// simLock held. Highest priority ready context, FIFO among equals.
+static simCtx_t *sim_pick(void)
+{
+  simCtx_t *pBest = NULL;
+  simCtx_t *pCtx;
+
+  for (pCtx = simCtxList; pCtx != NULL; pCtx = pCtx->pNext)
+  {
+    if (!pCtx->ready)
+    {
+      continue;
+    }
+
+    // Task_disable keeps other tasks off the CPU, interrupts still run
+    if (simTaskLockDepth && (pCtx->prio < SIM_ISR_PRIO) &&
+        (pCtx != simTaskLock))
+    {
+      continue;
+    }
+
+    if ((pBest == NULL) || (pCtx->prio > pBest->prio) ||
+        ((pCtx->prio == pBest->prio) && (pCtx->seq < pBest->seq)))
+    {
+      pBest = pCtx;
+    }
+  }
+
+  return pBest;
+}
+
+static void sim_makeReady(simCtx_t *pCtx)
+{
+  if (!pCtx->ready)
+  {
+    pCtx->ready = 1;
+    pCtx->seq = ++simSeq;
+  }
+}
+
+// simLock held. Hand the CPU to the best context and wait until self gets
+// it back. Self stays ready when preempted, is not ready when blocking.
+static void sim_switch(simCtx_t *pSelf)
+{
+  simCtx_t *pNext = sim_pick();
+
+  if (pNext == pSelf)
+  {
+    return;
+  }
+
+  simRunning = pNext;
+  if (pNext != NULL)
+  {
+    pthread_cond_signal(&pNext->cv);
+  }
+
+  while (simRunning != pSelf)
+  {
+    pthread_cond_wait(&pSelf->cv, &simLock);
+  }
+}
+
+// simLock held. Preemption point for the running task.
+static void sim_preemptLocked(void)
+{
+  simCtx_t *pSelf = simSelf;
+  simCtx_t *pNext;
+
+  if ((pSelf == NULL) || (pSelf->prio >= SIM_ISR_PRIO) ||
+      (pSelf->csDepth > 0) || !simStarted)
+  {
+    return;
+  }
+
+  pNext = sim_pick();
+  if ((pNext != NULL) && (pNext != pSelf) && (pNext->prio > pSelf->prio))
+  {
+    pSelf->seq = ++simSeq;
+    sim_switch(pSelf);
+  }
+}
+
+static void *sim_taskThread(void *arg)
+{
+  simCtx_t *pCtx = arg;
+
+  simSelf = pCtx;
+
+  pthread_mutex_lock(&simLock);
+  while (simRunning != pCtx)
+  {
+    pthread_cond_wait(&pCtx->cv, &simLock);
+  }
+  pthread_mutex_unlock(&simLock);
+
+  pCtx->fxn(pCtx->arg0, pCtx->arg1);
+
+  // Task returned, never runs again
+  pthread_mutex_lock(&simLock);
+  pCtx->ready = 0;
+  simRunning = sim_pick();
+  if (simRunning != NULL)
+  {
+    pthread_cond_signal(&simRunning->cv);
+  }
+  pthread_mutex_unlock(&simLock);
+
+  return NULL;
+}
+
+// clockLock held. Earliest deadline of the active clocks, 0 if none.
+static uint64_t clock_nextDeadline(void)
+{
+  Clock_Struct *pClk;
+  uint64_t next = 0;
+
+  for (pClk = clockList; pClk != NULL; pClk = pClk->pNext)
+  {
+    if (pClk->active && ((next == 0) || (pClk->deadline < next)))
+    {
+      next = pClk->deadline;
+    }
+  }
+
+  return next;
+}
+
+// clockLock held. Pop one expired clock, reloading periodic ones.
+static Clock_Struct *clock_popExpired(uint64_t now)
+{
+  Clock_Struct *pClk;
+
+  for (pClk = clockList; pClk != NULL; pClk = pClk->pNext)
+  {
+    if (pClk->active && (pClk->deadline <= now))
+    {
+      if (pClk->period)
+      {
+        pClk->deadline += pClk->period;
+        if (pClk->deadline <= now)
+        {
+          pClk->deadline = now + pClk->period;
+        }
+      }
+      else
+      {
+        pClk->active = FALSE;
+      }
+
+      return pClk;
+    }
+  }
+
+  return NULL;
+}
+
+// Clock "interrupt": runs expired clock functions in interrupt context
+static void *clock_thread(void *arg)
+{
+  (void)arg;
+
+  for (;;)
+  {
+    uint64_t next;
+    uint64_t now;
+
+    pthread_mutex_lock(&clockLock);
+    next = clock_nextDeadline();
+    now = Clock_getTicks();
+    if ((next == 0) || (next > now))
+    {
+      if (next == 0)
+      {
+        pthread_cond_wait(&clockCv, &clockLock);
+      }
+      else
+      {
+        uint64_t absUs = simStartUs + next * Clock_tickPeriod;
+        struct timespec ts;
+
+        ts.tv_sec = absUs / 1000000u;
+        ts.tv_nsec = (absUs % 1000000u) * 1000u;
+        pthread_cond_timedwait(&clockCv, &clockLock, &ts);
+      }
+      pthread_mutex_unlock(&clockLock);
+      continue;
+    }
+    pthread_mutex_unlock(&clockLock);
+
+    Sim_isrBegin(clockIsr);
+    for (;;)
+    {
+      Clock_Struct *pClk;
+
+      pthread_mutex_lock(&clockLock);
+      pClk = clock_popExpired(Clock_getTicks());
+      pthread_mutex_unlock(&clockLock);
+
+      if (pClk == NULL)
+      {
+        break;
+      }
+
+      pClk->fxn(pClk->arg);
+    }
+    Sim_isrEnd(clockIsr);
+  }
+
+  return NULL;
+}
+
+static void sim_sleepWake(UArg arg)
+{
+  Event_post((Event_Handle)arg, Event_Id_00);
+}
+
+static int event_match(Event_Handle handle)
+{
+  UInt32 posted = handle->posted;
+
+  if (handle->andMask && ((posted & handle->andMask) == handle->andMask))
+  {
+    return 1;
+  }
+
+  return (posted & handle->orMask) != 0;
+}
+
+/*********************************************************************
+ * SIMULATOR FUNCTIONS
+ */
+
+simCtx_t *Sim_isrCreate(const char *pName)
+{
+  return sim_newCtx(pName, SIM_ISR_PRIO);
+}
+
+void Sim_isrBegin(simCtx_t *pIsr)
+{
+  simSelf = pIsr;
+
+  pthread_mutex_lock(&simLock);
+  sim_makeReady(pIsr);
+  if (simRunning == NULL)
+  {
+    simRunning = sim_pick();
+    if ((simRunning != NULL) && (simRunning != pIsr))
+    {
+      pthread_cond_signal(&simRunning->cv);
+    }
+  }
+  while (simRunning != pIsr)
+  {
+    pthread_cond_wait(&pIsr->cv, &simLock);
+  }
+  pthread_mutex_unlock(&simLock);
+}
+
+void Sim_isrEnd(simCtx_t *pIsr)
+{
+  pthread_mutex_lock(&simLock);
+  pIsr->ready = 0;
+  pIsr->csDepth = 0;
+  simRunning = sim_pick();
+  if (simRunning != NULL)
+  {
+    pthread_cond_signal(&simRunning->cv);
+  }
+  pthread_mutex_unlock(&simLock);
+}
+
+simCtx_t *Sim_self(void)
+{
+  return simSelf;
+}
+
+uint64_t Sim_nowUs(void)
+{
+  return sim_monoUs();
+}
+
+void Sim_sleepUs(uint64_t us)
+{
+  struct timespec ts;
+
+  ts.tv_sec = us / 1000000u;
+  ts.tv_nsec = (us % 1000000u) * 1000u;
+  while (nanosleep(&ts, &ts) && (errno == EINTR))
+  {
+  }
+}
+
+/*********************************************************************
+ * BIOS
+ */
+
+void BIOS_start(void)
+{
+  pthread_condattr_t attr;
+  pthread_t thread;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&clockCv, &attr);
+
+  clockIsr = Sim_isrCreate("clock");
+  pthread_create(&thread, NULL, clock_thread, NULL);
+
+  pthread_mutex_lock(&simLock);
+  simStarted = 1;
+  simRunning = sim_pick();
+  if (simRunning != NULL)
+  {
+    pthread_cond_signal(&simRunning->cv);
+  }
+  pthread_mutex_unlock(&simLock);
+}
+
+/*********************************************************************
+ * Task
+ */
+
+void Task_Params_init(Task_Params *pParams)
+{
+  memset(pParams, 0, sizeof(Task_Params));
+  pParams->priority = 1;
+}
+
+Task_Handle Task_construct(Task_Struct *pStruct, Task_FuncPtr fxn,
+                           const Task_Params *pParams, void *pEb)
+{
+  simCtx_t *pCtx;
+
+  (void)pEb;
+
+  pCtx = sim_newCtx("task", pParams->priority);
+  pCtx->fxn = fxn;
+  pCtx->arg0 = pParams->arg0;
+  pCtx->arg1 = pParams->arg1;
+  pStruct->pCtx = pCtx;
+
+  pthread_mutex_lock(&simLock);
+  sim_makeReady(pCtx);
+  pthread_mutex_unlock(&simLock);
+
+  pthread_create(&pCtx->thread, NULL, sim_taskThread, pCtx);
+
+  return pStruct;
+}
+
+UInt Task_disable(void)
+{
+  UInt key;
+
+  pthread_mutex_lock(&simLock);
+  key = simTaskLockDepth++;
+  if (key == 0)
+  {
+    simTaskLock = simSelf;
+  }
+  pthread_mutex_unlock(&simLock);
+
+  return key;
+}
+
+void Task_restore(UInt key)
+{
+  pthread_mutex_lock(&simLock);
+  simTaskLockDepth = key;
+  if (key == 0)
+  {
+    simTaskLock = NULL;
+    sim_preemptLocked();
+  }
+  pthread_mutex_unlock(&simLock);
+}
+
+void Task_yield(void)
+{
+  simCtx_t *pSelf = simSelf;
+
+  pthread_mutex_lock(&simLock);
+  pSelf->seq = ++simSeq;
+  sim_switch(pSelf);
+  pthread_mutex_unlock(&simLock);
+}
+
+void Task_sleep(UInt32 ticks)
+{
+  Event_Struct evt;
+  Clock_Struct clk;
+  Clock_Params params;
+  Clock_Struct **ppClk;
+
+  // One shot clock posting a private event
+  memset(&evt, 0, sizeof(evt));
+  Clock_Params_init(&params);
+  params.arg = (UArg)&evt;
+  Clock_construct(&clk, sim_sleepWake, ticks, &params);
+  Clock_start(&clk);
+  Event_pend(&evt, Event_Id_NONE, Event_Id_00, BIOS_WAIT_FOREVER);
+
+  // The clock lives on this stack, unlink it
+  pthread_mutex_lock(&clockLock);
+  for (ppClk = &clockList; *ppClk != &clk; ppClk = &(*ppClk)->pNext)
+  {
+  }
+  *ppClk = clk.pNext;
+  pthread_mutex_unlock(&clockLock);
+}
+
+/*********************************************************************
+ * Event
+ */
+
+Event_Handle Event_create(void *pParams, void *pEb)
+{
+  (void)pParams;
+  (void)pEb;
+
+  return calloc(1, sizeof(Event_Struct));
+}
+
+void Event_post(Event_Handle handle, UInt eventMask)
+{
+  simCtx_t *pWaiter;
+
+  pthread_mutex_lock(&simLock);
+  handle->posted |= eventMask;
+  pWaiter = handle->pWaiter;
+  if ((pWaiter != NULL) && event_match(handle))
+  {
+    handle->pWaiter = NULL;
+    sim_makeReady(pWaiter);
+  }
+  sim_preemptLocked();
+  pthread_mutex_unlock(&simLock);
+}
+
+UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                UInt32 timeout)
+{
+  simCtx_t *pSelf = simSelf;
+  UInt events;
+
+  // Only BIOS_NO_WAIT and waiting forever are supported
+  pthread_mutex_lock(&simLock);
+  handle->andMask = andMask;
+  handle->orMask = orMask;
+  while (!event_match(handle))
+  {
+    if (timeout == BIOS_NO_WAIT)
+    {
+      pthread_mutex_unlock(&simLock);
+      return 0;
+    }
+
+    handle->pWaiter = pSelf;
+    pSelf->ready = 0;
+    sim_switch(pSelf);
+  }
+
+  events = handle->posted & (andMask | orMask);
+  handle->posted &= ~events;
+  pthread_mutex_unlock(&simLock);
+
+  return events;
+}
+
+/*********************************************************************
+ * Clock
+ */
+
+void Clock_Params_init(Clock_Params *pParams)
+{
+  memset(pParams, 0, sizeof(Clock_Params));
+}
+
+void Clock_construct(Clock_Struct *pStruct, Clock_FuncPtr fxn,
+                     UInt32 timeout, const Clock_Params *pParams)
+{
+  memset(pStruct, 0, sizeof(Clock_Struct));
+  pStruct->fxn = fxn;
+  pStruct->arg = pParams->arg;
+  pStruct->timeout = timeout;
+  pStruct->period = pParams->period;
+
+  pthread_mutex_lock(&clockLock);
+  pStruct->pNext = clockList;
+  clockList = pStruct;
+  pthread_mutex_unlock(&clockLock);
+
+  if (pParams->startFlag)
+  {
+    Clock_start(pStruct);
+  }
+}
+
+void Clock_start(Clock_Handle handle)
+{
+  pthread_mutex_lock(&clockLock);
+  handle->deadline = (UInt64)Clock_getTicks() + handle->timeout;
+  handle->active = TRUE;
+  pthread_cond_signal(&clockCv);
+  pthread_mutex_unlock(&clockLock);
+}
+
+void Clock_stop(Clock_Handle handle)
+{
+  pthread_mutex_lock(&clockLock);
+  handle->active = FALSE;
+  pthread_mutex_unlock(&clockLock);
+}
+
+Bool Clock_isActive(Clock_Handle handle)
+{
+  Bool active;
+
+  pthread_mutex_lock(&clockLock);
+  active = handle->active;
+  pthread_mutex_unlock(&clockLock);
+
+  return active;
+}
+
+void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+  handle->timeout = timeout;
+}
+
+void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+  handle->period = period;
+}
+
+UInt32 Clock_getTicks(void)
+{
+  if (simStartUs == 0)
+  {
+    simStartUs = sim_monoUs();
+  }
+
+  return (UInt32)((sim_monoUs() - simStartUs) / Clock_tickPeriod);
+}
+
+/*********************************************************************
+ * Queue
+ */
+
+void Queue_construct(Queue_Struct *pStruct, void *pParams)
+{
+  (void)pParams;
+
+  pStruct->next = pStruct;
+  pStruct->prev = pStruct;
+}
+
+void Queue_put(Queue_Handle handle, Queue_Elem *pElem)
+{
+  pElem->next = handle;
+  pElem->prev = handle->prev;
+  handle->prev->next = pElem;
+  handle->prev = pElem;
+}
+
+void *Queue_get(Queue_Handle handle)
+{
+  Queue_Elem *pElem = handle->next;
+
+  handle->next = pElem->next;
+  pElem->next->prev = handle;
+
+  return pElem;
+}
+
+Bool Queue_empty(Queue_Handle handle)
+{
+  return handle->next == handle;
+}
+
+/*********************************************************************
+ * Hwi
+ */
+
+UInt Hwi_disable(void)
+{
+  simCtx_t *pSelf = simSelf;
+
+  if (pSelf != NULL)
+  {
+    pSelf->csDepth++;
+  }
+
+  return 0;
+}
+
+void Hwi_restore(UInt key)
+{
+  simCtx_t *pSelf = simSelf;
+
+  (void)key;
+
+  if ((pSelf != NULL) && (--pSelf->csDepth == 0))
+  {
+    pthread_mutex_lock(&simLock);
+    sim_preemptLocked();
+    pthread_mutex_unlock(&simLock);
+  }
+}
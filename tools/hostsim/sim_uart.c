@@ -0,0 +1,577 @@
+/******************************************************************************
+
+ @file       sim_uart.c
+
+ @brief UART driver stand-in for the host simulator. UART0 is the master
+        side of a pseudo terminal; a script talks to the firmware through
+        the slave side exactly as it would through the LaunchPad's
+        virtual COM port.
+
+        Only callback mode with partial returns is modelled, which is what
+        the NPI transport uses. Received bytes land in a 32 byte FIFO.
+        Without flow control bytes that arrive while the FIFO is full are
+        lost; with RTS/CTS the driver stops reading the terminal instead,
+        so the writer blocks. Unless pacing is turned off, both directions
+        take the wire time of the configured baud rate.
+
+ *****************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <ti/drivers/UART.h>
+#include <ti/drivers/uart/UARTCC26XX.h>
+#include <driverlib/uart.h>
+#include <inc/hw_memmap.h>
+#include <inc/hw_ints.h>
+#include <board.h>
+
+#include "hostsim.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Receive FIFO of the driver
+#define SIM_UART_FIFO_SIZE        32
+
+// Bits on the wire per byte: start, 8 data, stop
+#define SIM_UART_BITS_PER_BYTE    10
+
+// A write nobody reads is dropped after this long, in ms
+#define SIM_UART_TX_STALL_MS      100
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static const UARTCC26XX_HWAttrsV2 uartHwAttrs =
+{
+  .baseAddr = UART0_BASE,
+  .intNum   = INT_UART0_COMB,
+};
+
+static UARTCC26XX_Object uartObject;
+
+static UART_Config uartConfig =
+{
+  .fxnTablePtr = NULL,
+  .object      = &uartObject,
+  .hwAttrs     = &uartHwAttrs,
+};
+
+// Driver state, guarded by uartLock
+static pthread_mutex_t uartLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t uartCv = PTHREAD_COND_INITIALIZER;
+static int uartOpen = 0;
+static UART_Params uartParams;
+static uint8_t uartFlowCtrl = 0;
+
+static uint8_t *pReadBuf = NULL;        // Pending read, NULL if none
+static size_t readSize;
+
+static const uint8_t *pWriteBuf = NULL; // Pending write, NULL if none
+static size_t writeSize;
+static unsigned writeGen = 0;           // Bumped on every new or cancelled write
+
+static uint8_t rxFifo[SIM_UART_FIFO_SIZE];
+static size_t rxFifoLen = 0;
+
+// Terminal
+static int ptyMaster = -1;
+static int ptySlave = -1;
+static int uartWakeFd = -1;             // Kicks the receive thread
+static char ptyName[64];
+
+static simCtx_t *rxIsr;
+static simCtx_t *txIsr;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint64_t uart_wireUs(size_t len)
+{
+  uint32_t baud;
+
+  pthread_mutex_lock(&uartLock);
+  baud = uartParams.baudRate ? uartParams.baudRate : 115200;
+  pthread_mutex_unlock(&uartLock);
+
+  return (uint64_t)len * SIM_UART_BITS_PER_BYTE * 1000000u / baud;
+}
+
+/*
+ * Hand FIFO bytes to a pending read in interrupt context.
+ */
+static void uart_deliver(void)
+{
+  UART_Callback cb = NULL;
+  uint8_t *pBuf = NULL;
+  size_t n = 0;
+
+  Sim_isrBegin(rxIsr);
+
+  pthread_mutex_lock(&uartLock);
+  if (uartOpen && (pReadBuf != NULL) && (rxFifoLen > 0))
+  {
+    n = (rxFifoLen < readSize) ? rxFifoLen : readSize;
+    pBuf = pReadBuf;
+    memcpy(pBuf, rxFifo, n);
+    memmove(rxFifo, &rxFifo[n], rxFifoLen - n);
+    rxFifoLen -= n;
+    pReadBuf = NULL;
+    cb = uartParams.readCallback;
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  if (cb != NULL)
+  {
+    cb(&uartConfig, pBuf, n);
+  }
+
+  Sim_isrEnd(rxIsr);
+}
+
+static void *uart_rxThread(void *arg)
+{
+  uint8_t buf[SIM_UART_FIFO_SIZE];
+
+  (void)arg;
+
+  for (;;)
+  {
+    struct pollfd pfd[2];
+    size_t space;
+    ssize_t n;
+    size_t lost = 0;
+    nfds_t nfds = 1;
+    uint64_t wake;
+    int deliver;
+
+    pthread_mutex_lock(&uartLock);
+    space = SIM_UART_FIFO_SIZE - rxFifoLen;
+    deliver = uartOpen && (pReadBuf != NULL) && (rxFifoLen > 0);
+    pthread_mutex_unlock(&uartLock);
+
+    if (deliver)
+    {
+      uart_deliver();
+      continue;
+    }
+
+    // A new read wakes the thread up; with RTS/CTS a full FIFO holds the
+    // sender off, so the terminal is not read until there is space
+    pfd[0].fd = uartWakeFd;
+    pfd[0].events = POLLIN;
+    if ((space > 0) || !uartFlowCtrl)
+    {
+      pfd[1].fd = ptyMaster;
+      pfd[1].events = POLLIN;
+      nfds = 2;
+    }
+
+    if (poll(pfd, nfds, -1) <= 0)
+    {
+      continue;
+    }
+
+    if (pfd[0].revents & POLLIN)
+    {
+      if (read(uartWakeFd, &wake, sizeof(wake)) < 0)
+      {
+        // Already drained
+      }
+    }
+
+    if ((nfds < 2) || !(pfd[1].revents & POLLIN))
+    {
+      continue;
+    }
+
+    // Without flow control the sender does not stop, bytes beyond the
+    // free FIFO space are lost
+    n = read(ptyMaster, buf, (space > 0) ? space : sizeof(buf));
+    if (n <= 0)
+    {
+      if ((n < 0) && (errno != EAGAIN) && (errno != EINTR))
+      {
+        Sim_sleepUs(1000);
+      }
+      continue;
+    }
+
+    if (simCfg.uartPaced)
+    {
+      Sim_sleepUs(uart_wireUs((size_t)n));
+    }
+
+    pthread_mutex_lock(&uartLock);
+    if (!uartOpen)
+    {
+      // Nobody listening, the bytes fall on the floor
+    }
+    else if ((size_t)n > SIM_UART_FIFO_SIZE - rxFifoLen)
+    {
+      size_t keep = SIM_UART_FIFO_SIZE - rxFifoLen;
+
+      memcpy(&rxFifo[rxFifoLen], buf, keep);
+      rxFifoLen += keep;
+      lost = (size_t)n - keep;
+    }
+    else
+    {
+      memcpy(&rxFifo[rxFifoLen], buf, (size_t)n);
+      rxFifoLen += (size_t)n;
+    }
+    pthread_mutex_unlock(&uartLock);
+
+    if (lost > 0)
+    {
+      Sim_sink("O %llu %zu", (unsigned long long)Sim_nowUs(), lost);
+    }
+  }
+
+  return NULL;
+}
+
+static void uart_ptyWrite(const uint8_t *pData, size_t len)
+{
+  while (len > 0)
+  {
+    struct pollfd pfd = { .fd = ptyMaster, .events = POLLOUT };
+    ssize_t n;
+
+    if (poll(&pfd, 1, SIM_UART_TX_STALL_MS) <= 0)
+    {
+      return;
+    }
+
+    n = write(ptyMaster, pData, len);
+    if (n > 0)
+    {
+      pData += n;
+      len -= (size_t)n;
+    }
+    else if ((errno != EAGAIN) && (errno != EINTR))
+    {
+      return;
+    }
+  }
+}
+
+static void *uart_txThread(void *arg)
+{
+  (void)arg;
+
+  for (;;)
+  {
+    const uint8_t *pBuf;
+    size_t len;
+    unsigned gen;
+    UART_Callback cb = NULL;
+
+    pthread_mutex_lock(&uartLock);
+    while (pWriteBuf == NULL)
+    {
+      pthread_cond_wait(&uartCv, &uartLock);
+    }
+    pBuf = pWriteBuf;
+    len = writeSize;
+    gen = writeGen;
+    pthread_mutex_unlock(&uartLock);
+
+    uart_ptyWrite(pBuf, len);
+
+    if (simCfg.uartPaced)
+    {
+      Sim_sleepUs(uart_wireUs(len));
+    }
+
+    Sim_isrBegin(txIsr);
+
+    // A cancel in the meantime already completed the write
+    pthread_mutex_lock(&uartLock);
+    if ((pWriteBuf != NULL) && (writeGen == gen))
+    {
+      pWriteBuf = NULL;
+      cb = uartParams.writeCallback;
+    }
+    pthread_mutex_unlock(&uartLock);
+
+    if (cb != NULL)
+    {
+      cb(&uartConfig, (void *)pBuf, len);
+    }
+
+    Sim_isrEnd(txIsr);
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * SIMULATOR FUNCTIONS
+ */
+
+/*
+ * Create the pseudo terminal behind UART0 and start its interrupt
+ * sources. Returns the slave path, pLink (if not NULL) is made a symlink
+ * to it.
+ */
+const char *Sim_uartOpenPty(const char *pLink)
+{
+  struct termios tio;
+  pthread_t thread;
+
+  ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((ptyMaster < 0) || grantpt(ptyMaster) || unlockpt(ptyMaster) ||
+      ptsname_r(ptyMaster, ptyName, sizeof(ptyName)))
+  {
+    return NULL;
+  }
+
+  // Hold the slave open so the terminal survives clients coming and going
+  ptySlave = open(ptyName, O_RDWR | O_NOCTTY);
+  if (ptySlave < 0)
+  {
+    return NULL;
+  }
+
+  tcgetattr(ptySlave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(ptySlave, TCSANOW, &tio);
+
+  fcntl(ptyMaster, F_SETFL, fcntl(ptyMaster, F_GETFL) | O_NONBLOCK);
+
+  if (pLink != NULL)
+  {
+    unlink(pLink);
+    if (symlink(ptyName, pLink) != 0)
+    {
+      perror(pLink);
+    }
+  }
+
+  uartWakeFd = eventfd(0, EFD_NONBLOCK);
+
+  rxIsr = Sim_isrCreate("uartRx");
+  txIsr = Sim_isrCreate("uartTx");
+  pthread_create(&thread, NULL, uart_rxThread, NULL);
+  pthread_create(&thread, NULL, uart_txThread, NULL);
+
+  return ptyName;
+}
+
+/*********************************************************************
+ * Board
+ */
+
+void Board_initUART(void)
+{
+}
+
+/*********************************************************************
+ * UART
+ */
+
+void UART_init(void)
+{
+}
+
+void UART_Params_init(UART_Params *params)
+{
+  memset(params, 0, sizeof(UART_Params));
+  params->readMode = UART_MODE_BLOCKING;
+  params->writeMode = UART_MODE_BLOCKING;
+  params->readTimeout = UART_WAIT_FOREVER;
+  params->writeTimeout = UART_WAIT_FOREVER;
+  params->readReturnMode = UART_RETURN_NEWLINE;
+  params->readDataMode = UART_DATA_TEXT;
+  params->writeDataMode = UART_DATA_TEXT;
+  params->readEcho = UART_ECHO_ON;
+  params->baudRate = 115200;
+  params->dataLength = UART_LEN_8;
+  params->stopBits = UART_STOP_ONE;
+  params->parityType = UART_PAR_NONE;
+}
+
+UART_Handle UART_open(unsigned int index, UART_Params *params)
+{
+  UART_Handle handle = NULL;
+
+  pthread_mutex_lock(&uartLock);
+  if ((index == Board_UART0) && !uartOpen && (ptyMaster >= 0))
+  {
+    uartParams = *params;
+    uartOpen = 1;
+    pReadBuf = NULL;
+    pWriteBuf = NULL;
+    rxFifoLen = 0;
+    handle = &uartConfig;
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  return handle;
+}
+
+void UART_close(UART_Handle handle)
+{
+  (void)handle;
+
+  pthread_mutex_lock(&uartLock);
+  uartOpen = 0;
+  pReadBuf = NULL;
+  pWriteBuf = NULL;
+  writeGen++;
+  pthread_mutex_unlock(&uartLock);
+}
+
+int UART_control(UART_Handle handle, unsigned int cmd, void *arg)
+{
+  (void)handle;
+  (void)arg;
+
+  // Partial returns are the only mode modelled
+  if (cmd == UARTCC26XX_CMD_RETURN_PARTIAL_ENABLE)
+  {
+    return UART_STATUS_SUCCESS;
+  }
+
+  return UART_STATUS_UNDEFINEDCMD;
+}
+
+int UART_read(UART_Handle handle, void *buffer, size_t size)
+{
+  int status = 0;
+
+  (void)handle;
+
+  pthread_mutex_lock(&uartLock);
+  if (!uartOpen || (pReadBuf != NULL) || (size == 0))
+  {
+    status = UART_ERROR;
+  }
+  else
+  {
+    pReadBuf = buffer;
+    readSize = size;
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  if (status == 0)
+  {
+    uint64_t one = 1;
+
+    if (write(uartWakeFd, &one, sizeof(one)) < 0)
+    {
+      // Counter saturated, the thread is awake anyway
+    }
+  }
+
+  return status;
+}
+
+int UART_write(UART_Handle handle, const void *buffer, size_t size)
+{
+  int status = 0;
+
+  (void)handle;
+
+  pthread_mutex_lock(&uartLock);
+  if (!uartOpen || (pWriteBuf != NULL) || (size == 0))
+  {
+    status = UART_ERROR;
+  }
+  else
+  {
+    pWriteBuf = buffer;
+    writeSize = size;
+    writeGen++;
+    pthread_cond_signal(&uartCv);
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  return status;
+}
+
+void UART_readCancel(UART_Handle handle)
+{
+  UART_Callback cb = NULL;
+  uint8_t *pBuf;
+
+  pthread_mutex_lock(&uartLock);
+  pBuf = pReadBuf;
+  if (pBuf != NULL)
+  {
+    pReadBuf = NULL;
+    cb = uartParams.readCallback;
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  if (cb != NULL)
+  {
+    cb(handle, pBuf, 0);
+  }
+}
+
+void UART_writeCancel(UART_Handle handle)
+{
+  UART_Callback cb = NULL;
+  const uint8_t *pBuf;
+
+  pthread_mutex_lock(&uartLock);
+  pBuf = pWriteBuf;
+  if (pBuf != NULL)
+  {
+    pWriteBuf = NULL;
+    writeGen++;
+    cb = uartParams.writeCallback;
+  }
+  pthread_mutex_unlock(&uartLock);
+
+  if (cb != NULL)
+  {
+    cb(handle, (void *)pBuf, 0);
+  }
+}
+
+/*********************************************************************
+ * driverlib
+ */
+
+void UARTHwFlowControlEnable(uint32_t ui32Base)
+{
+  (void)ui32Base;
+
+  uartFlowCtrl = 1;
+}
+
+void UARTHwFlowControlDisable(uint32_t ui32Base)
+{
+  (void)ui32Base;
+
+  uartFlowCtrl = 0;
+}
+
+bool UARTCharsAvail(uint32_t ui32Base)
+{
+  bool avail;
+
+  (void)ui32Base;
+
+  pthread_mutex_lock(&uartLock);
+  avail = (rxFifoLen > 0);
+  pthread_mutex_unlock(&uartLock);
+
+  return avail;
+}
@@ -0,0 +1,386 @@
+/******************************************************************************
+
+ @file       uart_proto_bench.c
+
+ @brief Host benchmark comparing the AT#HP text command path with the
+        binary framed UART protocol (uart_frame.c). Reports parse cost per
+        HID report and UART bytes per HID report in both directions.
+
+        The AT parser below mirrors the original memcmp chain; the
+        dispatch and binary paths link the firmware's cmd_dispatch.c and
+        uart_frame.c unchanged.
+
+ *****************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "uart_frame.h"
+#include "cmd_dispatch.h"
+
+#define KEYS_PER_RUN        4096
+#define RUNS                200
+#define UART_BAUD           115200
+#define UART_BITS_PER_BYTE  10
+#define KBD_RPT_LEN         8
+
+/*********************************************************************
+ * Report and response sinks
+ */
+
+static uint32_t rptCount;
+static uint32_t rptChecksum;
+static uint32_t txBytes;
+
+static void sinkReport(uint8_t id, uint8_t len, const uint8_t *pData)
+{
+  uint8_t i;
+
+  rptCount++;
+  rptChecksum += id;
+  for (i = 0; i < len; i++)
+  {
+    rptChecksum = (rptChecksum << 1) ^ pData[i];
+  }
+}
+
+static void sinkKey(uint8_t modifier, uint8_t keycode)
+{
+  uint8_t buf[KBD_RPT_LEN] = {0};
+
+  buf[0] = modifier;
+  buf[2] = keycode;
+  sinkReport(0, KBD_RPT_LEN, buf);
+}
+
+static void sinkPrint(const char *str)
+{
+  txBytes += (uint32_t)strlen(str);
+}
+
+/*********************************************************************
+ * AT text path, same logic as the original keyBoardCmdHandler()
+ */
+
+static uint8_t cmdBuf[64];
+static uint8_t cmdLen;
+
+static void atParse(const uint8_t *pBuf, uint32_t len)
+{
+  static const uint8_t modTbl[9] =
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+  uint32_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    if ('\n' == pBuf[i])
+    {
+      cmdLen = 0;
+      memset(cmdBuf, 0, sizeof(cmdBuf));
+      continue;
+    }
+    if ('\r' == pBuf[i])
+    {
+      if ((0 == memcmp(&cmdBuf[0], "AT#", 3)) &&
+          (0 == memcmp(&cmdBuf[3], "MZ", 2)))
+      {
+      }
+      else if ((0 == memcmp(&cmdBuf[0], "AT#", 3)) &&
+               (0 == memcmp(&cmdBuf[3], "MY", 2)))
+      {
+        sinkPrint("\r\n20191231\r\n");
+      }
+      else if ((0 == memcmp(&cmdBuf[0], "AT#", 3)) &&
+               (0 == memcmp(&cmdBuf[3], "HP", 2)))
+      {
+        uint8_t mod;
+        uint16_t key;
+
+        if (cmdBuf[5] < '0' || cmdBuf[5] > '8')
+        {
+          sinkPrint("\r\nER\r\n");
+          cmdLen = 0;
+          memset(cmdBuf, 0, sizeof(cmdBuf));
+          continue;
+        }
+        mod = modTbl[cmdBuf[5] - '0'];
+        key = (cmdBuf[7] - '0') * 100 + (cmdBuf[8] - '0') * 10 +
+              (cmdBuf[9] - '0');
+        sinkPrint((char *)cmdBuf);
+        sinkPrint("\r\n");
+        sinkKey(mod, (uint8_t)key);
+        sinkKey(0, 0);
+        sinkPrint("\r\nOK\r\n");
+      }
+      cmdLen = 0;
+      memset(cmdBuf, 0, sizeof(cmdBuf));
+    }
+    else if (cmdLen < sizeof(cmdBuf))
+    {
+      cmdBuf[cmdLen++] = pBuf[i];
+    }
+  }
+}
+
+/*********************************************************************
+ * Table driven path, cmd_dispatch.c with the firmware's verbs plus filler
+ * verbs so the hash table is as full as a real build would get
+ */
+
+static void cmdNop(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+}
+
+static void cmdMY(const cmdArgs_t *pArgs)
+{
+  (void)pArgs;
+  sinkPrint("\r\n20191231\r\n");
+}
+
+static void cmdHP(const cmdArgs_t *pArgs)
+{
+  sinkPrint((const char *)pArgs->pLine);
+  sinkPrint("\r\n");
+  sinkKey((uint8_t)pArgs->val[0], (uint8_t)pArgs->val[2]);
+  sinkKey(0, 0);
+  sinkPrint("\r\nOK\r\n");
+}
+
+static const cmdVerb_t benchVerbs[] =
+{
+  { {'M','Z'}, "",    cmdNop },
+  { {'M','Y'}, "",    cmdMY },
+  { {'L','T'}, "",    cmdNop },
+  { {'R','X'}, "",    cmdNop },
+  { {'T','S'}, "*",   cmdNop },
+  { {'K','D'}, "b",   cmdNop },
+  { {'K','U'}, "b",   cmdNop },
+  { {'K','R'}, "",    cmdNop },
+  { {'B','R'}, "u",   cmdNop },
+  { {'B','C'}, "",    cmdNop },
+  { {'F','C'}, "d",   cmdNop },
+  { {'C','P'}, "d",   cmdNop },
+  { {'S','F'}, "dbu", cmdNop },
+  { {'H','P'}, "mdb", cmdHP },
+};
+
+// As keyBoardCmdHandler() drains the receive ring
+static void dispatchParse(const uint8_t *pBuf, uint32_t len)
+{
+  uint32_t i = 0;
+  uint16_t used;
+
+  while (i < len)
+  {
+    if (CmdDispatch_inputBuf(&pBuf[i], (uint16_t)(len - i > 0xFFFF ? 0xFFFF :
+                                                  len - i),
+                             &used) == CMD_DISPATCH_BAD_ARGS)
+    {
+      sinkPrint("\r\nER\r\n");
+    }
+    i += used;
+  }
+}
+
+// One call per byte
+static void dispatchParseByte(const uint8_t *pBuf, uint32_t len)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    if (CmdDispatch_input(pBuf[i]) == CMD_DISPATCH_BAD_ARGS)
+    {
+      sinkPrint("\r\nER\r\n");
+    }
+  }
+}
+
+/*********************************************************************
+ * Binary path
+ */
+
+static uartFrameDec_t dec;
+
+static void frameParse(const uint8_t *pBuf, uint32_t len)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    if (UARTFrame_input(&dec, pBuf[i]) != UART_FRAME_COMPLETE)
+    {
+      continue;
+    }
+
+    if (dec.type == UART_FRAME_TYPE_KEYS)
+    {
+      uint8_t k;
+
+      for (k = 0; (k + 1) < dec.len; k += 2)
+      {
+        sinkKey(dec.body[k], dec.body[k + 1]);
+        sinkKey(0, 0);
+      }
+    }
+    else if (dec.type == UART_FRAME_TYPE_REPORT)
+    {
+      uint8_t offset = 0;
+      uint8_t id;
+      uint8_t rptLen;
+      const uint8_t *pData;
+
+      while (UARTFrame_nextRecord(dec.body, dec.len, &offset, &id, &rptLen,
+                                  &pData) == UART_FRAME_COMPLETE)
+      {
+        sinkReport(id, rptLen, pData);
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * Stream builders
+ */
+
+static uint8_t keyMod(uint32_t n)  { return (uint8_t)(n % 3); }
+static uint8_t keyCode(uint32_t n) { return (uint8_t)(4 + n % 36); }
+
+static uint32_t buildAt(uint8_t *pBuf)
+{
+  uint32_t n;
+  uint32_t len = 0;
+
+  for (n = 0; n < KEYS_PER_RUN; n++)
+  {
+    len += (uint32_t)sprintf((char *)&pBuf[len], "AT#HP%c0%03u\r\n",
+                             '0' + keyMod(n), keyCode(n));
+  }
+
+  return len;
+}
+
+static uint32_t buildKeys(uint8_t *pBuf)
+{
+  uint8_t body[UART_FRAME_MAX_BODY];
+  uint32_t n = 0;
+  uint32_t len = 0;
+
+  while (n < KEYS_PER_RUN)
+  {
+    uint8_t bodyLen = 0;
+
+    while ((n < KEYS_PER_RUN) && (bodyLen + 2 <= UART_FRAME_MAX_BODY))
+    {
+      body[bodyLen++] = (uint8_t)(1 << keyMod(n)) >> 1;
+      body[bodyLen++] = keyCode(n);
+      n++;
+    }
+    len += UARTFrame_encode(UART_FRAME_TYPE_KEYS, body, bodyLen, &pBuf[len]);
+  }
+
+  return len;
+}
+
+static uint32_t buildReports(uint8_t *pBuf)
+{
+  uint8_t body[UART_FRAME_MAX_BODY];
+  uint32_t n = 0;
+  uint32_t len = 0;
+  const uint8_t recLen = UART_FRAME_RECORD_HDR_LEN + KBD_RPT_LEN;
+
+  // Two raw reports (press, release) per key
+  while (n < 2 * KEYS_PER_RUN)
+  {
+    uint8_t bodyLen = 0;
+
+    while ((n < 2 * KEYS_PER_RUN) && (bodyLen + recLen <= UART_FRAME_MAX_BODY))
+    {
+      memset(&body[bodyLen], 0, recLen);
+      body[bodyLen + 1] = KBD_RPT_LEN;
+      if ((n & 1) == 0)
+      {
+        body[bodyLen + 2] = (uint8_t)(1 << keyMod(n / 2)) >> 1;
+        body[bodyLen + 4] = keyCode(n / 2);
+      }
+      bodyLen += recLen;
+      n++;
+    }
+    len += UARTFrame_encode(UART_FRAME_TYPE_REPORT, body, bodyLen, &pBuf[len]);
+  }
+
+  return len;
+}
+
+/*********************************************************************
+ * Benchmark
+ */
+
+static double nowNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void run(const char *name, void (*parse)(const uint8_t *, uint32_t),
+                const uint8_t *pBuf, uint32_t len)
+{
+  double t0, t1;
+  double rxPerRpt, txPerRpt;
+  uint32_t r;
+  uint32_t rpts;
+
+  rptCount = 0;
+  txBytes = 0;
+  t0 = nowNs();
+  for (r = 0; r < RUNS; r++)
+  {
+    parse(pBuf, len);
+  }
+  t1 = nowNs();
+
+  rpts = rptCount / RUNS;
+  rxPerRpt = (double)len / rpts;
+  txPerRpt = (double)txBytes / RUNS / rpts;
+
+  printf("%-12s %8u %9.1f %9.2f %9.2f %12.0f\n", name, rpts,
+         (t1 - t0) / rptCount, rxPerRpt, txPerRpt,
+         (double)UART_BAUD / UART_BITS_PER_BYTE / rxPerRpt);
+}
+
+int main(void)
+{
+  static uint8_t stream[KEYS_PER_RUN * 32];
+  uint32_t len;
+
+  UARTFrame_init(&dec);
+  CmdDispatch_init();
+  CmdDispatch_registerVerbs(benchVerbs,
+                            sizeof(benchVerbs) / sizeof(benchVerbs[0]));
+
+  printf("%-12s %8s %9s %9s %9s %12s\n", "format", "reports", "ns/rpt",
+         "rx B/rpt", "tx B/rpt", "rpt/s@115k2");
+
+  len = buildAt(stream);
+  run("AT#HP", atParse, stream, len);
+  run("AT#HP/table", dispatchParse, stream, len);
+  run("AT#HP/byte", dispatchParseByte, stream, len);
+
+  len = buildKeys(stream);
+  run("frame/keys", frameParse, stream, len);
+
+  len = buildReports(stream);
+  run("frame/report", frameParse, stream, len);
+
+  printf("(checksum %08x)\n", rptChecksum);
+
+  return 0;
+}